@@ -1,3 +1,5 @@
+#include <cstring>
+
 #include "azure/azure.h"
 #include "azure/client/client.h"
 
@@ -140,6 +142,49 @@ common::backend_api::ResponseCode_t obj_cancel_all_reads()
     return ret;
 }
 
+common::backend_api::ResponseCode_t obj_cancel_reads(common::backend_api::ObjectClientHandle_t client_handle)
+{
+    auto client = static_cast<AzureClient *>(client_handle);
+    if (client == nullptr)
+    {
+        LOG(ERROR) << "Azure client handle is null";
+        return common::ResponseCode::InvalidParameterError;
+    }
+
+    client->cancel();
+    return common::ResponseCode::Success;
+}
+
+common::backend_api::ResponseCode_t obj_get_object_version(common::backend_api::ObjectClientHandle_t client_handle, const char* path, char* out_version_buffer, unsigned int buffer_len)
+{
+    try
+    {
+        if (!client_handle)
+        {
+            LOG(ERROR) << "Attempt to query object version with null azure client";
+            return common::ResponseCode::UnknownError;
+        }
+        auto ptr = static_cast<AzureClient *>(client_handle);
+        const auto version = ptr->object_version(path);
+        if (version.size() >= buffer_len)
+        {
+            LOG(ERROR) << "Version of object " << path << " does not fit in " << buffer_len << " bytes";
+            return common::ResponseCode::InvalidParameterError;
+        }
+        std::memcpy(out_version_buffer, version.c_str(), version.size() + 1);
+        return common::ResponseCode::Success;
+    }
+    catch(const common::Exception & e)
+    {
+        return e.error();
+    }
+    catch(const std::exception& e)
+    {
+        LOG(ERROR) << "Caught exception while querying object version";
+    }
+    return common::ResponseCode::UnknownError;
+}
+
 common::backend_api::ResponseCode_t obj_request_read(common::backend_api::ObjectClientHandle_t client_handle,
                                                       const char* path,
                                                       common::backend_api::ObjectRange_t range,
@@ -156,6 +201,28 @@ common::backend_api::ResponseCode_t obj_request_read(common::backend_api::Object
     return client->async_read(path, range, destination_buffer, request_id);
 }
 
+common::backend_api::ResponseCode_t obj_set_completion_notification(common::backend_api::ObjectClientHandle_t client_handle,
+                                                                    common::backend_api::ObjectCompletionNotification_t notification,
+                                                                    void* context)
+{
+    auto client = static_cast<AzureClient *>(client_handle);
+    if (client == nullptr)
+    {
+        LOG(ERROR) << "Azure client handle is null";
+        return common::ResponseCode::InvalidParameterError;
+    }
+
+    if (notification == nullptr)
+    {
+        client->set_notification(nullptr);
+    }
+    else
+    {
+        client->set_notification([notification, context]() { notification(context); });
+    }
+    return common::ResponseCode::Success;
+}
+
 common::backend_api::ResponseCode_t obj_wait_for_completions(common::backend_api::ObjectClientHandle_t client_handle,
                                                              common::backend_api::ObjectCompletionEvent_t* event_buffer,
                                                              unsigned int max_events_to_retrieve,
@@ -171,6 +238,20 @@ common::backend_api::ResponseCode_t obj_wait_for_completions(common::backend_api
 
     *out_num_events_retrieved = 0;
 
+    if (wait_mode == common::backend_api::OBJECT_WAIT_MODE_NON_BLOCKING)
+    {
+        std::vector<common::backend_api::Response> responses;
+        auto ret = client->async_read_responses(responses, max_events_to_retrieve);
+        *out_num_events_retrieved = responses.size();
+        for (size_t i = 0; i < responses.size(); ++i)
+        {
+            event_buffer[i].request_id = responses[i].handle;
+            event_buffer[i].response_code = responses[i].ret;
+            event_buffer[i].bytes_transferred = responses[i].bytes_transferred;
+        }
+        return ret;
+    }
+
     for (unsigned int i = 0; i < max_events_to_retrieve; ++i)
     {
         auto response = client->async_read_response();
@@ -178,7 +259,7 @@ common::backend_api::ResponseCode_t obj_wait_for_completions(common::backend_api
         // Always store the response in the event buffer (matching S3/GCS behavior)
         event_buffer[i].request_id = response.handle;
         event_buffer[i].response_code = response.ret;
-        event_buffer[i].bytes_transferred = 0;
+        event_buffer[i].bytes_transferred = response.bytes_transferred;
         (*out_num_events_retrieved)++;
         
         // Break after storing FinishedError so caller can see it
@@ -187,11 +268,6 @@ common::backend_api::ResponseCode_t obj_wait_for_completions(common::backend_api
             break;
         }
 
-        // For non-blocking mode, exit after first attempt
-        if (wait_mode == common::backend_api::OBJECT_WAIT_MODE_NON_BLOCKING && i == 0)
-        {
-            break;
-        }
     }
 
     return common::ResponseCode::Success;
@@ -10,9 +10,34 @@ namespace runai::llm::streamer::impl::azure
 {
 
 void DownloadBlobTask::execute() {
+    // the destination buffer must not be accessed once the download was canceled
+    if (guard != nullptr && !guard->enter()) {
+        callback(common::ResponseCode::FinishedError, 0, "canceled");
+        return;
+    }
+
+    // leave the guard before the callback, since the responder might have been stopped by then
+    auto download = [&]() {
+        size_t bytes_transferred = 0;
+        try {
+            bytes_transferred = taskFn();
+        } catch (...) {
+            if (guard != nullptr) {
+                guard->leave();
+            }
+            throw;
+        }
+        if (guard != nullptr) {
+            guard->leave();
+        }
+        return bytes_transferred;
+    };
+
     try {
-        taskFn();
-        callback(common::ResponseCode::Success, "");
+        const auto bytes_transferred = download();
+        callback(common::ResponseCode::Success, bytes_transferred, "");
+    } catch (const Azure::Core::OperationCancelledException& e) {
+        callback(common::ResponseCode::FinishedError, 0, e.what());
     } catch (const Azure::Core::RequestFailedException& e) {
         std::string error_msg = "Azure RequestFailed: StatusCode=" + std::to_string(static_cast<int>(e.StatusCode)) + " " + e.what();
         // Map HTTP status codes to appropriate response codes
@@ -23,14 +48,13 @@ void DownloadBlobTask::execute() {
             // 416 Range Not Satisfiable - requested range is past EOF
             code = common::ResponseCode::EofError;
         }
-        callback(code, error_msg);
+        callback(code, 0, error_msg);
     } catch (const std::exception& e) {
-        callback(common::ResponseCode::FileAccessError, e.what());
+        callback(common::ResponseCode::FileAccessError, 0, e.what());
     }
 }
 
-AsyncAzureClient::AsyncAzureClient(std::shared_ptr<Azure::Storage::Blobs::BlobServiceClient> client, unsigned int max_pool_size) :
-    _client(client),
+AsyncAzureClient::AsyncAzureClient(unsigned int max_pool_size) :
     _pool([](DownloadBlobTask&& task, std::atomic<bool>& stopped) {
         task.execute();
     }, max_pool_size)
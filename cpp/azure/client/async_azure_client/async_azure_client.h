@@ -8,73 +8,83 @@
 #include <azure/storage/blobs.hpp>
 
 #include "common/response_code/response_code.h"
+#include "utils/cancel_guard/cancel_guard.h"
 #include "utils/logging/logging.h"
 #include "utils/threadpool/threadpool.h"
 
 namespace runai::llm::streamer::impl::azure
 {
 
-typedef std::function<void()> DownloadBlobFn;
-typedef std::function<void(common::ResponseCode response_code, const std::string& error_msg)> CompletionCallback;
+// returns the number of bytes downloaded into the buffer
+typedef std::function<size_t()> DownloadBlobFn;
+typedef std::function<void(common::ResponseCode response_code, size_t bytes_transferred, const std::string& error_msg)> CompletionCallback;
 
 struct DownloadBlobTask {
     DownloadBlobFn taskFn;
     CompletionCallback callback;
+    std::shared_ptr<utils::CancelGuard> guard;
 
 public:
     void execute();
 };
 
+// Downloads a range directly into the destination buffer
+// Ranges larger than chunk_bytesize are downloaded by the SDK in parallel chunks of chunk_bytesize, using up to `concurrency` connections
 inline DownloadBlobFn createDownloadBlobFn(
-    std::shared_ptr<Azure::Storage::Blobs::BlobServiceClient> client,
-    const std::string& container_name,
-    const std::string& blob_name,
+    std::shared_ptr<Azure::Storage::Blobs::BlockBlobClient> blob_client,
     char* buffer,
     size_t offset,
-    size_t length)
+    size_t length,
+    size_t chunk_bytesize,
+    unsigned concurrency,
+    const Azure::Core::Context & context)
 {
-    // Explicitly copy strings to ensure they're captured properly
-    std::string container = container_name;
-    std::string blob = blob_name;
-    
-    return [client, container, blob, buffer, offset, length]() {
+    return [blob_client, buffer, offset, length, chunk_bytesize, concurrency, context]() {
         using namespace Azure::Storage::Blobs;
-        auto container_client = client->GetBlobContainerClient(container);
-        auto blob_client = container_client.GetBlockBlobClient(blob);
-        
+
         DownloadBlobToOptions download_options;
         download_options.Range = Azure::Core::Http::HttpRange();
         download_options.Range.Value().Offset = offset;
         download_options.Range.Value().Length = length;
-        
-        blob_client.DownloadTo(
-            reinterpret_cast<uint8_t*>(buffer), length, download_options
+        download_options.TransferOptions.InitialChunkSize = chunk_bytesize;
+        download_options.TransferOptions.ChunkSize = chunk_bytesize;
+        download_options.TransferOptions.Concurrency = concurrency;
+
+        const auto response = blob_client->DownloadTo(
+            reinterpret_cast<uint8_t*>(buffer), length, download_options, context
         );
+
+        // the length of the downloaded range, which is shorter than requested if the blob ends before the range
+        return static_cast<size_t>(response.Value.ContentRange.Length.ValueOr(0));
     };
 }
 
 /**
  * An async wrapper for Azure Blob Storage client operations.
- * Uses ThreadPool to manage concurrent blob download operations.
+ * Uses ThreadPool to manage concurrent blob download operations, each of which may use several connections of the SDK.
  */
 struct AsyncAzureClient
 {
 public:
-    AsyncAzureClient(std::shared_ptr<Azure::Storage::Blobs::BlobServiceClient> client, unsigned max_pool_size);
+    AsyncAzureClient(unsigned max_pool_size);
 
     inline void DownloadBlobRangeAsync(
-        const std::string& container_name,
-        const std::string& blob_name,
+        std::shared_ptr<Azure::Storage::Blobs::BlockBlobClient> blob_client,
         char* buffer,
         size_t offset,
         size_t length,
-        CompletionCallback callback)
+        size_t chunk_bytesize,
+        unsigned concurrency,
+        CompletionCallback callback,
+        std::shared_ptr<utils::CancelGuard> guard,
+        const Azure::Core::Context & context)
     {
-        DownloadBlobFn downloadFn = createDownloadBlobFn(_client, container_name, blob_name, buffer, offset, length);
+        DownloadBlobFn downloadFn = createDownloadBlobFn(std::move(blob_client), buffer, offset, length, chunk_bytesize, concurrency, context);
 
         DownloadBlobTask task{
             std::move(downloadFn),
-            std::move(callback)
+            std::move(callback),
+            std::move(guard)
         };
 
         push_task(std::move(task));
@@ -83,7 +93,6 @@ public:
 private:
     void push_task(DownloadBlobTask&& task);
 
-    std::shared_ptr<Azure::Storage::Blobs::BlobServiceClient> _client;
     utils::ThreadPool<DownloadBlobTask> _pool;
 };
 
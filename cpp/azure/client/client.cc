@@ -28,7 +28,6 @@ constexpr char kAzureApplicationId[] = "azpartner-runai";
 
 AzureClient::AzureClient(const common::backend_api::ObjectClientConfig_t& config) :
     _stop(false),
-    _responder(nullptr),
     _chunk_bytesize(config.default_storage_chunk_size)
 {
     // ClientConfiguration reads environment variables
@@ -79,7 +78,7 @@ AzureClient::AzureClient(const common::backend_api::ObjectClientConfig_t& config
         // Using Azure SDK defaults for retry policy
         // Reference: https://learn.microsoft.com/en-us/azure/storage/common/storage-retry-policy
 
-        LOG(DEBUG) << "Azure client concurrency: " << _client_config.max_concurrency;
+        LOG(DEBUG) << "Azure client concurrency: " << _client_config.max_concurrency(_chunk_bytesize);
 
 #ifdef AZURITE_TESTING
         if (_connection_string.has_value()) {
@@ -121,7 +120,7 @@ AzureClient::AzureClient(const common::backend_api::ObjectClientConfig_t& config
         }
 
         // Create async client with ThreadPool
-        _async_client = std::make_unique<AsyncAzureClient>(_blob_service_client, _client_config.max_concurrency);
+        _async_client = std::make_unique<AsyncAzureClient>(_client_config.max_concurrency(_chunk_bytesize));
 
     } catch (const std::exception& e) {
         LOG(ERROR) << "Failed to initialize Azure client: " << e.what();
@@ -167,28 +166,63 @@ bool AzureClient::verify_credentials(const common::backend_api::ObjectClientConf
 
 common::backend_api::Response AzureClient::async_read_response()
 {
-    std::shared_ptr<Responder> responder;
-    {
-        std::lock_guard<std::mutex> lock(_responder_mutex);
-        if (_responder == nullptr)
-        {
-            LOG(WARNING) << "Requesting response with uninitialized responder";
-            return common::ResponseCode::FinishedError;
-        }
-        responder = _responder;
-    }
+    return _requests.pop();
+}
 
-    return responder->pop();
+common::ResponseCode AzureClient::async_read_responses(std::vector<common::backend_api::Response> & responses, unsigned max_responses)
+{
+    return _requests.try_pop(responses, max_responses);
+}
+
+void AzureClient::set_notification(std::function<void()> notification)
+{
+    _requests.set_notification(notification);
 }
 
 void AzureClient::stop()
 {
     _stop = true;
-    std::lock_guard<std::mutex> lock(_responder_mutex);
-    if (_responder != nullptr)
+    _requests.stop();
+}
+
+void AzureClient::cancel()
+{
+    std::lock_guard<std::mutex> lock(_context_mutex);
+
+    // abort downloads in progress, and use a fresh context for following requests
+    _context.Cancel();
+    _context = Azure::Core::Context();
+
+    // wait for downloads in progress to stop writing to the destination buffers
+    _requests.cancel();
+
+    LOG(DEBUG) << "Canceled Azure client requests";
+}
+
+std::string AzureClient::object_version(const char * path)
+{
+    const auto uri = common::s3::StorageUri(path);
+
+    try
     {
-        _responder->stop();
+        return blob_client(uri.bucket, uri.path)->GetProperties().Value.ETag.ToString();
     }
+    catch (const Azure::Core::RequestFailedException & e)
+    {
+        LOG(ERROR) << "Failed to query version of Azure blob " << path << ": " << e.what();
+        throw common::Exception(common::ResponseCode::FileAccessError);
+    }
+}
+
+std::shared_ptr<BlockBlobClient> AzureClient::blob_client(const std::string & container_name, const std::string & blob_name)
+{
+    std::lock_guard<std::mutex> lock(_blob_clients_mutex);
+    auto & client = _blob_clients[std::make_pair(container_name, blob_name)];
+    if (client == nullptr)
+    {
+        client = std::make_shared<BlockBlobClient>(_blob_service_client->GetBlobContainerClient(container_name).GetBlockBlobClient(blob_name));
+    }
+    return client;
 }
 
 common::ResponseCode AzureClient::async_read(const char* path, 
@@ -196,78 +230,61 @@ common::ResponseCode AzureClient::async_read(const char* path,
                                              char* destination_buffer, 
                                              common::backend_api::ObjectRequestId_t request_id)
 {
-    std::shared_ptr<Responder> responder;
+    common::Requests::Request pending;
+    Azure::Core::Context context;
     {
-        std::lock_guard<std::mutex> lock(_responder_mutex);
-        if (_responder == nullptr)
-        {
-            _responder = std::make_shared<Responder>(1);
-        }
-        else
-        {
-            _responder->increment(1);
-        }
-        responder = _responder;
+        std::lock_guard<std::mutex> lock(_context_mutex);
+        pending = _requests.add();
+        context = _context;
     }
+    const auto responder = pending.responder;
+    const auto guard = pending.guard;
 
-    char * buffer_ = destination_buffer;
-
-    // Split range into chunks
-    size_t num_chunks = std::max(1UL, range.length / _chunk_bytesize);
-    LOG(SPAM) << "Number of chunks is: " << num_chunks;
-
-    // Counter for tracking chunk completions
-    auto counter = std::make_shared<std::atomic<unsigned>>(num_chunks);
-    auto is_success = std::make_shared<std::atomic<bool>>(true);
+    if (_stop)
+    {
+        return common::ResponseCode::FinishedError;
+    }
 
     // Parse Azure URI az://container/blob
     const auto uri = common::s3::StorageUri(path);
-    std::string container_name(uri.bucket);
-    std::string blob_name(uri.path);
 
-    size_t total_ = range.length;
-    size_t offset_ = range.offset;
+    // The range is downloaded by a single task, and ranges larger than the chunk size are split by the SDK into parallel chunk downloads
+    const size_t num_chunks = std::max(1UL, range.length / _chunk_bytesize);
+    const unsigned concurrency = std::min<size_t>(num_chunks, _client_config.transfer_concurrency);
+    LOG(SPAM) << "Downloading " << range.length << " bytes in " << num_chunks << " chunks over " << concurrency << " connections";
+
+    // Launch async download with callback - AsyncAzureClient ThreadPool handles both download and callback
+    _async_client->DownloadBlobRangeAsync(
+        blob_client(uri.bucket, uri.path),
+        destination_buffer,
+        range.offset,
+        range.length,
+        _chunk_bytesize,
+        concurrency,
+        [request_id, responder, bytesize = range.length](common::ResponseCode response_code, size_t bytes_transferred, const std::string& error_msg) {
+            if (response_code == common::ResponseCode::FinishedError) {
+                // canceled - the responder was already stopped
+                LOG(SPAM) << "Async read request " << request_id << " was canceled";
+                return;
+            }
 
-    for (unsigned i = 0; i < num_chunks && !_stop; ++i)
-    {
-        size_t bytesize_ = (i == num_chunks - 1 ? total_ : _chunk_bytesize);
-
-        // Capture current buffer, offset for this specific chunk
-        char* chunk_buffer = buffer_;
-        size_t chunk_offset = offset_;
-        
-        // Launch async download with callback - AsyncAzureClient ThreadPool handles both download and callback
-        _async_client->DownloadBlobRangeAsync(
-            container_name,
-            blob_name,
-            chunk_buffer,
-            chunk_offset,
-            bytesize_,
-            [request_id, counter, is_success, responder](common::ResponseCode response_code, const std::string& error_msg) {
-                if (response_code == common::ResponseCode::Success) {
-                    const auto running = counter->fetch_sub(1);
-                    LOG(SPAM) << "Async read request " << request_id << " succeeded - " << running << " running";
-                    
-                    if (running == 1) {
-                        common::backend_api::Response r(request_id, common::ResponseCode::Success);
-                        responder->push(std::move(r));
-                    }
-                } else {
-                    LOG(ERROR) << "Failed to download Azure blob of request " << request_id << ": " << error_msg;
-                    bool previous = is_success->exchange(false);
-                    if (previous) {
-                        // Propagate the specific error code from Azure SDK
-                        common::backend_api::Response r(request_id, response_code);
-                        responder->push(std::move(r));
-                    }
-                }
+            // a blob which ends before the range would leave a truncated tensor
+            if (response_code == common::ResponseCode::Success && bytes_transferred < bytesize) {
+                LOG(ERROR) << "Received " << bytes_transferred << " bytes of Azure blob of request " << request_id << " ; expected " << bytesize << " bytes";
+                response_code = common::ResponseCode::EofError;
+            } else if (response_code == common::ResponseCode::Success) {
+                LOG(SPAM) << "Async read request " << request_id << " succeeded";
+            } else {
+                LOG(ERROR) << "Failed to download Azure blob of request " << request_id << ": " << error_msg;
             }
-        );
-        
-        total_ -= bytesize_;
-        offset_ += bytesize_;
-        buffer_ += bytesize_;
-    }
+
+            // Propagate the specific error code from Azure SDK
+            common::backend_api::Response r(request_id, response_code, bytes_transferred);
+            responder->push(std::move(r));
+        },
+        guard,
+        context
+    );
 
     return _stop ? common::ResponseCode::FinishedError : common::ResponseCode::Success;
 }
@@ -1,9 +1,14 @@
 #pragma once
 
 #include <atomic>
+#include <functional>
+#include <map>
 #include <memory>
+#include <mutex>
 #include <string>
 #include <optional>
+#include <utility>
+#include <vector>
 
 #include "azure/client_configuration/client_configuration.h"
 #include "azure/client/async_azure_client/async_azure_client.h"
@@ -12,7 +17,7 @@
 #include "common/backend_api/object_storage/object_storage.h"
 #include "common/client_mgr/client_mgr.h"
 #include "common/storage_uri/storage_uri.h"
-#include "common/shared_queue/shared_queue.h"
+#include "common/requests/requests.h"
 #include "common/range/range.h"
 
 #include <azure/storage/blobs.hpp>
@@ -35,10 +40,25 @@ struct AzureClient : common::IClient
 
     common::backend_api::Response async_read_response();
 
+    // returns up to max_responses ready responses without waiting, or FinishedError if no responses are expected
+    common::ResponseCode async_read_responses(std::vector<common::backend_api::Response> & responses, unsigned max_responses);
+
+    // notification of ready responses, or an empty notification to unregister
+    // when this returns the previous notification is not running and will not be called again
+    void set_notification(std::function<void()> notification);
+
     // Stop sending requests to the object store
     // If stopped before all requests for an async_read() call are sent, subsequent request chunks will not be sent.
     void stop();
 
+    // Cancel the pending requests of the client, which remains usable for further requests
+    // Downloads in progress are aborted through their context
+    // Returns when no more data is written to the destination buffers of the canceled requests
+    void cancel();
+
+    // current version of the object, which changes whenever the object is modified
+    std::string object_version(const char * path);
+
  private:
     std::atomic<bool> _stop;
     ClientConfiguration _client_config;
@@ -55,10 +75,20 @@ struct AzureClient : common::IClient
     std::shared_ptr<Azure::Storage::Blobs::BlobServiceClient> _blob_service_client;
     std::unique_ptr<AsyncAzureClient> _async_client;
 
-    // queue of asynchronous responses
-    using Responder = common::SharedQueue<common::backend_api::Response>;
-    std::shared_ptr<Responder> _responder;
-    std::mutex _responder_mutex;  // Protects _responder access
+    // returns the cached client of the blob, creating it on first use
+    std::shared_ptr<Azure::Storage::Blobs::BlockBlobClient> blob_client(const std::string & container_name, const std::string & blob_name);
+
+    // blob clients by container and blob name, which are reused by all the requests of this client
+    std::map<std::pair<std::string, std::string>, std::shared_ptr<Azure::Storage::Blobs::BlockBlobClient>> _blob_clients;
+    std::mutex _blob_clients_mutex;
+
+    // responses of the asynchronous requests
+    common::Requests _requests;
+
+    // aborts the downloads of the current requests when canceled
+    Azure::Core::Context _context;
+
+    std::mutex _context_mutex;  // Protects _context access, and replaces it together with the requests
 };
 
 } // namespace runai::llm::streamer::impl::azure
@@ -3,7 +3,6 @@
 #include "utils/logging/logging.h"
 #include "utils/env/env.h"
 
-#include <thread>
 #include <algorithm>
 
 namespace runai::llm::streamer::impl::azure
@@ -41,18 +40,19 @@ ClientConfiguration::ClientConfiguration()
         account_name = acct_name;
     }
 
-    unsigned nprocs = std::thread::hardware_concurrency();
-    LOG(SPAM) << "Hardware concurrency detected: " << nprocs;
-    unsigned default_max_concurrency = nprocs == 0 ? 8U : 1U;
-    unsigned worker_concurrency = utils::getenv<unsigned long>("RUNAI_STREAMER_CONCURRENCY", 8UL);
-    LOG(SPAM) << "Streamer worker concurrency: " << worker_concurrency;
-    unsigned process_group_size = utils::getenv<unsigned long>("RUNAI_STREAMER_PROCESS_GROUP_SIZE", 1UL);
-    LOG(SPAM) << "Process group size: " << process_group_size;
-    max_concurrency = std::max(default_max_concurrency, nprocs * 2 / (worker_concurrency * process_group_size));
-    LOG(DEBUG) << "Azure Blob Storage per-client concurrency is set to: " << max_concurrency;
+    max_inflight_bytesize = utils::getenv<size_t>("RUNAI_STREAMER_AZURE_MAX_INFLIGHT_BYTESIZE", max_inflight_bytesize);
+    transfer_concurrency = std::max(1UL, utils::getenv<unsigned long>("RUNAI_STREAMER_AZURE_TRANSFER_CONCURRENCY", transfer_concurrency));
+    LOG(DEBUG) << "Azure Blob Storage per-client bytes in flight " << max_inflight_bytesize << " ; connections per download " << transfer_concurrency;
 
     // Note: Using Azure SDK defaults for timeouts and retries
     // Reference: https://learn.microsoft.com/en-us/azure/storage/common/storage-retry-policy
 }
 
+unsigned int ClientConfiguration::max_concurrency(size_t chunk_bytesize) const
+{
+    // a download has up to transfer_concurrency chunks in flight
+    const size_t download_bytesize = std::max<size_t>(1, chunk_bytesize) * transfer_concurrency;
+    return std::clamp<size_t>(max_inflight_bytesize / download_bytesize, 1, max_pool_size);
+}
+
 }; // namespace runai::llm::streamer::impl::azure
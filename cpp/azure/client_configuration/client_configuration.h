@@ -1,5 +1,7 @@
 #pragma once
 
+#include <stddef.h>
+
 #include <string>
 #include <optional>
 
@@ -17,7 +19,13 @@ struct ClientConfiguration
 #endif
     
     // Concurrency settings
-    unsigned int max_concurrency = 8;
+    // downloads of a client are limited by the number of bytes in flight, and each download uses up to transfer_concurrency connections
+    size_t max_inflight_bytesize = 256 * 1024 * 1024;
+    unsigned int transfer_concurrency = 4;
+    static constexpr size_t max_pool_size = 64;
+
+    // number of concurrent downloads of a client, for the given chunk size
+    unsigned int max_concurrency(size_t chunk_bytesize) const;
     
     ClientConfiguration();
 };
@@ -0,0 +1,57 @@
+#include <benchmark/benchmark.h>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <cstdlib>
+#include <iostream>
+#include <vector>
+
+namespace runai
+{
+
+namespace
+{
+
+unsigned int seed()
+{
+    unsigned int value = 0;
+
+    const int fd = ::open("/dev/urandom", O_RDONLY);
+    if (fd == -1 || ::read(fd, &value, sizeof(value)) != sizeof(value))
+    {
+        perror("Failed reading from /dev/urandom");
+        exit(EXIT_FAILURE);
+    }
+
+    ::close(fd);
+    return value;
+}
+
+} // namespace
+
+extern "C" int main(int argc, char **argv)
+{
+    // the standard output holds the results, so the seed is printed to the standard error
+    const auto value = seed();
+    std::cerr << "Using seed " << value << std::endl;
+    srand(value);
+
+    // results are reported as JSON for tracking them across versions, unless a following argument overrides the format
+    char json[] = "--benchmark_format=json";
+    std::vector<char *> args(argv, argv + argc);
+    args.insert(args.begin() + 1, json);
+
+    int count = args.size();
+    benchmark::Initialize(&count, args.data());
+    if (benchmark::ReportUnrecognizedArguments(count, args.data()))
+    {
+        return EXIT_FAILURE;
+    }
+
+    benchmark::RunSpecifiedBenchmarks();
+    benchmark::Shutdown();
+    return EXIT_SUCCESS;
+}
+
+} // namespace runai
@@ -55,9 +55,14 @@ struct ObjectCompletionEvent_t
 {
     ObjectRequestId_t request_id;     // ID provided by caller in obj_request_read
     ResponseCode response_code;       // Response code from the backend
-    size_t bytes_transferred;         // Actual bytes read into the caller's destination_buffer
+    size_t bytes_transferred;         // Actual bytes read into the caller's destination_buffer (a success with fewer bytes than requested is a short read)
 };
 
+// --- Completion Notification ---
+// Called by the backend when completion events of a client are ready to be retrieved
+// - context - the context passed to obj_set_completion_notification
+typedef void (*ObjectCompletionNotification_t)(void* context);
+
 // --- Backend API ---
 
 /**
@@ -186,6 +191,25 @@ ResponseCode_t obj_wait_for_completions(
     ObjectWaitMode_t wait_mode
 );
 
+/**
+ * Registers a notification for the completion events of a client, so that callers do not block a thread while waiting for completions.
+ * This API is optional - callers wait for completions in blocking mode if the backend does not export it or returns an error.
+ * - client_handle - Handle to the client instance.
+ * - notification - Called from backend threads when completion events are ready, or null to unregister.
+ *                  The notification must not block nor call the backend API, and is called while the backend holds internal locks.
+ *                  Once notified, the caller retrieves the ready events with obj_wait_for_completions in OBJECT_WAIT_MODE_NON_BLOCKING mode.
+ * - context - Passed to the notification.
+ * Backends that support notifications must also support OBJECT_WAIT_MODE_NON_BLOCKING in obj_wait_for_completions.
+ * When this call returns, a previously registered notification is not running and will not be called again.
+ * Callers must unregister the notification before removing the client.
+ * Return success if the notification was registered, or an error code if notifications are not supported.
+ */
+ResponseCode_t obj_set_completion_notification(
+    ObjectClientHandle_t client_handle,
+    ObjectCompletionNotification_t notification,
+    void* context
+);
+
 /**
  * Attempts to cancel all currently active/pending asynchronous read requests
  * associated with all the client handle.
@@ -195,6 +219,34 @@ ResponseCode_t obj_wait_for_completions(
  */
 ResponseCode_t obj_cancel_all_reads();
 
+/**
+ * Cancels all the pending asynchronous read requests of a single client.
+ * As opposed to obj_cancel_all_reads, the client remains usable for further requests after this call.
+ * - client_handle - Handle to the client instance whose requests are canceled.
+ * When this call returns the backend does not write into the destination buffers of the canceled requests anymore,
+ * and no completion events are returned for them - callers waiting for completions receive the Finished response code.
+ * Return success if the requests were canceled, or an error code.
+ */
+ResponseCode_t obj_cancel_reads(
+    ObjectClientHandle_t client_handle
+);
+
+/**
+ * Retrieves the current version of an object, such as its ETag or generation, which changes whenever the object is modified.
+ * This API is optional - callers do not cache the data of objects whose version is unknown.
+ * - client_handle - Handle to the client instance.
+ * - path - The object path.
+ * - out_version_buffer - Filled with the null terminated version of the object.
+ * - buffer_len - The size of the version buffer in bytes.
+ * Return success if the version was retrieved, or an error code.
+ */
+ResponseCode_t obj_get_object_version(
+    ObjectClientHandle_t client_handle,
+    const char* path,
+    char* out_version_buffer,
+    unsigned int buffer_len
+);
+
 /**
  * Attempts to remove all clients.
  * Return success if the request to remove all clients was successfully initiated.
@@ -6,7 +6,14 @@ namespace runai::llm::streamer::common::backend_api
 
 Response::Response(const ObjectCompletionEvent_t & event) :
     handle(event.request_id),
-    ret(event.response_code)
+    ret(event.response_code),
+    bytes_transferred(event.bytes_transferred)
+{}
+
+Response::Response(ObjectRequestId_t handle, common::ResponseCode ret, size_t bytes_transferred) :
+    handle(handle),
+    ret(ret),
+    bytes_transferred(bytes_transferred)
 {}
 
 Response::Response(ObjectRequestId_t handle, common::ResponseCode ret) :
@@ -34,7 +41,7 @@ bool Response::operator!=(const common::ResponseCode other)
 
 std::ostream & operator<<(std::ostream & os, const Response & response)
 {
-    return os << "Handle: " << response.handle << " Response code: " << response.ret;
+    return os << "Handle: " << response.handle << " Response code: " << response.ret << " Bytes: " << response.bytes_transferred;
 }
 
 }; // namespace runai::llm::streamer::common::backend_api
@@ -12,6 +12,7 @@ namespace runai::llm::streamer::common::backend_api
 struct Response
 {
     Response(ObjectRequestId_t handle, common::ResponseCode ret);
+    Response(ObjectRequestId_t handle, common::ResponseCode ret, size_t bytes_transferred);
     Response(ObjectRequestId_t handle);
     Response(common::ResponseCode ret);
     Response(const ObjectCompletionEvent_t & event);
@@ -24,6 +25,9 @@ struct Response
 
     // response code
     common::ResponseCode ret;
+
+    // bytes written to the destination buffer
+    size_t bytes_transferred = 0;
 };
 
 std::ostream & operator<<(std::ostream & os, const Response & response);
@@ -0,0 +1,337 @@
+#include "common/metrics/metrics.h"
+
+#include <algorithm>
+#include <mutex>
+#include <set>
+
+namespace runai::llm::streamer::common
+{
+
+namespace
+{
+
+constexpr unsigned num_backends = static_cast<unsigned>(Metrics::Backend::Count);
+constexpr unsigned num_counters = static_cast<unsigned>(Metrics::Counter::Count);
+constexpr unsigned num_histograms = static_cast<unsigned>(Metrics::Histogram::Count);
+
+// bytes and operations of each backend, followed by the counters
+constexpr unsigned num_values = num_backends * 2 + num_counters;
+
+struct Shard
+{
+    std::array<std::atomic<int64_t>, num_values> values;
+    std::array<std::array<std::atomic<uint64_t>, Metrics::buckets>, num_histograms> histograms;
+};
+
+// only the owning thread writes to its shard, so an update does not need an atomic read-modify-write
+template <typename T>
+void increase(std::atomic<T> & value, T delta)
+{
+    value.store(value.load(std::memory_order_relaxed) + delta, std::memory_order_relaxed);
+}
+
+struct Registry
+{
+    Shard * attach()
+    {
+        auto shard = new Shard();
+        const auto guard = std::unique_lock<std::mutex>(mutex);
+        shards.insert(shard);
+        return shard;
+    }
+
+    // keeps the values of an exiting thread
+    void detach(Shard * shard)
+    {
+        const auto guard = std::unique_lock<std::mutex>(mutex);
+
+        for (unsigned i = 0; i < num_values; ++i)
+        {
+            retired.values[i].fetch_add(shard->values[i].load(std::memory_order_relaxed), std::memory_order_relaxed);
+        }
+
+        for (unsigned h = 0; h < num_histograms; ++h)
+        {
+            for (unsigned b = 0; b < Metrics::buckets; ++b)
+            {
+                retired.histograms[h][b].fetch_add(shard->histograms[h][b].load(std::memory_order_relaxed), std::memory_order_relaxed);
+            }
+        }
+
+        shards.erase(shard);
+        delete shard;
+    }
+
+    std::mutex mutex;
+    std::set<Shard *> shards;
+    Shard retired{};
+};
+
+// never destroyed, so that threads which exit during the process teardown can still detach
+Registry & registry()
+{
+    static auto __registry = new Registry();
+    return *__registry;
+}
+
+struct Local
+{
+    ~Local()
+    {
+        if (shard != nullptr)
+        {
+            registry().detach(shard);
+        }
+    }
+
+    Shard & get()
+    {
+        if (shard == nullptr)
+        {
+            shard = registry().attach();
+        }
+        return *shard;
+    }
+
+    Shard * shard = nullptr;
+};
+
+thread_local Local __local;
+
+std::atomic<bool> __usage(false);
+
+const char * backend_name(Metrics::Backend backend)
+{
+    switch (backend)
+    {
+        case Metrics::Backend::File:     return "file";
+        case Metrics::Backend::S3:       return "s3";
+        case Metrics::Backend::GCS:      return "gcs";
+        case Metrics::Backend::Azure:    return "azure";
+        case Metrics::Backend::Emulated: return "emulated";
+        case Metrics::Backend::Cache:    return "cache";
+        default:                         return "unknown";
+    }
+}
+
+const char * counter_name(Metrics::Counter counter)
+{
+    switch (counter)
+    {
+        case Metrics::Counter::Requests:         return "requests";
+        case Metrics::Counter::Retries:          return "retries";
+        case Metrics::Counter::OpenDescriptors:  return "open_descriptors";
+        case Metrics::Counter::Clients:          return "clients";
+        case Metrics::Counter::QueuedJobs:       return "queued_jobs";
+        case Metrics::Counter::InflightRequests: return "inflight_requests";
+        case Metrics::Counter::Cycles:           return "cpu_cycles";
+        case Metrics::Counter::Instructions:     return "instructions";
+        case Metrics::Counter::PageFaults:       return "page_faults";
+        case Metrics::Counter::ContextSwitches:  return "context_switches";
+        case Metrics::Counter::UserTime:         return "user_us";
+        case Metrics::Counter::SystemTime:       return "system_us";
+        case Metrics::Counter::WallTime:         return "wall_us";
+        default:                                 return "unknown";
+    }
+}
+
+const char * histogram_name(Metrics::Histogram histogram)
+{
+    switch (histogram)
+    {
+        case Metrics::Histogram::ChunkLatency:  return "chunk_latency_us";
+        case Metrics::Histogram::FirstResponse: return "first_response_us";
+        default:                                return "unknown";
+    }
+}
+
+} // namespace
+
+void Metrics::read(Backend backend, size_t bytesize)
+{
+    auto & shard = __local.get();
+    const auto index = static_cast<unsigned>(backend) * 2;
+    increase<int64_t>(shard.values[index], bytesize);
+    increase<int64_t>(shard.values[index + 1], 1);
+}
+
+void Metrics::add(Counter counter, int64_t value)
+{
+    increase<int64_t>(__local.get().values[num_backends * 2 + static_cast<unsigned>(counter)], value);
+}
+
+void Metrics::record(Histogram histogram, std::chrono::steady_clock::duration duration)
+{
+    const auto microseconds = std::chrono::duration_cast<std::chrono::microseconds>(duration).count();
+    increase<uint64_t>(__local.get().histograms[static_cast<unsigned>(histogram)][bucket(std::max<int64_t>(microseconds, 0))], 1);
+}
+
+void Metrics::enable_usage()
+{
+    __usage = true;
+}
+
+Metrics::Usage::Usage() :
+    _recording(__usage.load(std::memory_order_relaxed))
+{
+    if (_recording)
+    {
+        _start = utils::Perf::sample();
+        _start_time = std::chrono::steady_clock::now();
+    }
+}
+
+Metrics::Usage::~Usage()
+{
+    if (!_recording)
+    {
+        return;
+    }
+
+    const auto usage = utils::Perf::sample() - _start;
+    add(Counter::Cycles, usage.cycles);
+    add(Counter::Instructions, usage.instructions);
+    add(Counter::PageFaults, usage.page_faults);
+    add(Counter::ContextSwitches, usage.context_switches);
+    add(Counter::UserTime, usage.user_us);
+    add(Counter::SystemTime, usage.system_us);
+    add(Counter::WallTime, std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - _start_time).count());
+}
+
+unsigned Metrics::bucket(uint64_t microseconds)
+{
+    if (microseconds < sub_buckets)
+    {
+        return microseconds;
+    }
+
+    const unsigned exponent = 63 - __builtin_clzll(microseconds);
+    if (exponent > max_exponent)
+    {
+        return buckets - 1;
+    }
+
+    return sub_buckets + (exponent - sub_bucket_bits) * sub_buckets + ((microseconds >> (exponent - sub_bucket_bits)) & (sub_buckets - 1));
+}
+
+uint64_t Metrics::value(unsigned bucket)
+{
+    if (bucket < sub_buckets)
+    {
+        return bucket;
+    }
+
+    const unsigned exponent = (bucket - sub_buckets) / sub_buckets + sub_bucket_bits;
+    const uint64_t width = uint64_t(1) << (exponent - sub_bucket_bits);
+    const uint64_t lower = (sub_buckets + (bucket - sub_buckets) % sub_buckets) * width;
+    return lower + width - 1;
+}
+
+const std::vector<std::string> & Metrics::names()
+{
+    static const std::vector<std::string> __names = []()
+    {
+        std::vector<std::string> names;
+        for (unsigned i = 0; i < num_backends; ++i)
+        {
+            const std::string name = backend_name(static_cast<Backend>(i));
+            names.push_back(name + "_bytes");
+            names.push_back(name + "_ops");
+        }
+
+        for (unsigned i = 0; i < num_counters; ++i)
+        {
+            names.push_back(counter_name(static_cast<Counter>(i)));
+        }
+
+        for (unsigned i = 0; i < num_histograms; ++i)
+        {
+            const std::string name = histogram_name(static_cast<Histogram>(i));
+            names.push_back(name + "_count");
+            for (const auto percentile : percentiles)
+            {
+                names.push_back(name + "_p" + std::to_string(percentile % 10 == 0 ? percentile / 10 : percentile));
+            }
+        }
+        return names;
+    }();
+
+    return __names;
+}
+
+std::vector<uint64_t> Metrics::values()
+{
+    std::array<int64_t, num_values> totals{};
+    std::array<std::array<uint64_t, buckets>, num_histograms> histograms{};
+
+    {
+        auto & r = registry();
+        const auto guard = std::unique_lock<std::mutex>(r.mutex);
+
+        const auto merge = [&](const Shard & shard)
+        {
+            for (unsigned i = 0; i < num_values; ++i)
+            {
+                totals[i] += shard.values[i].load(std::memory_order_relaxed);
+            }
+
+            for (unsigned h = 0; h < num_histograms; ++h)
+            {
+                for (unsigned b = 0; b < buckets; ++b)
+                {
+                    histograms[h][b] += shard.histograms[h][b].load(std::memory_order_relaxed);
+                }
+            }
+        };
+
+        merge(r.retired);
+        for (const auto shard : r.shards)
+        {
+            merge(*shard);
+        }
+    }
+
+    std::vector<uint64_t> values;
+    values.reserve(names().size());
+
+    // gauges may be released by another thread than the one which took them, so only their sum is meaningful
+    for (const auto total : totals)
+    {
+        values.push_back(std::max<int64_t>(total, 0));
+    }
+
+    for (const auto & histogram : histograms)
+    {
+        uint64_t count = 0;
+        for (const auto n : histogram)
+        {
+            count += n;
+        }
+        values.push_back(count);
+
+        for (const auto percentile : percentiles)
+        {
+            uint64_t value = 0;
+            if (count > 0)
+            {
+                // the rank of the percentile, rounded up
+                const uint64_t rank = (count * percentile + 999) / 1000;
+                uint64_t seen = 0;
+                for (unsigned b = 0; b < buckets; ++b)
+                {
+                    seen += histogram[b];
+                    if (seen >= rank)
+                    {
+                        value = Metrics::value(b);
+                        break;
+                    }
+                }
+            }
+            values.push_back(value);
+        }
+    }
+
+    return values;
+}
+
+}; // namespace runai::llm::streamer::common
@@ -0,0 +1,124 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <string>
+#include <vector>
+
+#include "utils/perf/perf.h"
+
+namespace runai::llm::streamer::common
+{
+
+// Process wide metrics of the streamers
+//
+// Every thread records into its own shard, so that recording is a plain load and store of a counter which no other thread writes
+// Reading merges the shards of the running threads with the values left by the threads which exited
+//
+// Values are exposed as a flat list of named statistics, which are identified by their names
+//
+// Usage of the threads (CPU cycles, page faults, context switches and CPU times) is recorded for the scopes of Usage once enabled, as it costs system calls
+
+struct Metrics
+{
+    enum class Backend : unsigned
+    {
+        File,
+        S3,
+        GCS,
+        Azure,
+        // the emulated object store, which serves a local directory
+        Emulated,
+        // ranges read from the local caches instead of object storage
+        Cache,
+        Count,
+    };
+
+    enum class Counter : unsigned
+    {
+        // requests sent to the streamers
+        Requests,
+        // object storage requests sent again after a failure, e.g. to another mirror
+        Retries,
+        // file descriptors opened by the file readers and not yet closed
+        OpenDescriptors,
+        // object storage clients taken from the client pools of the backends and not yet released
+        Clients,
+        // jobs waiting for the shared workers
+        QueuedJobs,
+        // object storage requests submitted and not yet completed
+        InflightRequests,
+        // usage of the threads during the scopes of Usage
+        Cycles,
+        Instructions,
+        PageFaults,
+        ContextSwitches,
+        UserTime,
+        SystemTime,
+        // wall time of the scopes, where the time which was not spent on CPU was spent blocked (e.g. waiting for I/O)
+        WallTime,
+        Count,
+    };
+
+    enum class Histogram : unsigned
+    {
+        // a single read from storage - a file system block or an object storage request
+        ChunkLatency,
+        // from sending a request until its first sub request completes
+        FirstResponse,
+        Count,
+    };
+
+    // records a read of the given size from a backend
+    static void read(Backend backend, size_t bytesize);
+
+    // adds to a counter, where a negative value releases a gauge
+    static void add(Counter counter, int64_t value = 1);
+
+    static void record(Histogram histogram, std::chrono::steady_clock::duration duration);
+
+    // starts recording the usage of the threads
+    static void enable_usage();
+
+    // records the usage of the calling thread during a scope, e.g. a job of a worker
+    struct Usage
+    {
+        Usage();
+        ~Usage();
+
+        Usage(const Usage &)             = delete;
+        Usage & operator=(const Usage &) = delete;
+
+     private:
+        const bool _recording;
+        utils::Perf::Counters _start;
+        std::chrono::steady_clock::time_point _start_time;
+    };
+
+    // names of the statistics, in the order of their values
+    static const std::vector<std::string> & names();
+
+    // current values of the statistics, in the order of their names
+    // latencies are in microseconds
+    static std::vector<uint64_t> values();
+
+    // percentiles of each histogram, in parts per thousand
+    static constexpr std::array<unsigned, 3> percentiles = { 500, 990, 999 };
+
+    // log-linear histogram buckets of microseconds, with relative error of 1/sub_buckets
+    static constexpr unsigned sub_bucket_bits = 4;
+    static constexpr unsigned sub_buckets = 1u << sub_bucket_bits;
+    static constexpr unsigned max_exponent = 40;
+    static constexpr unsigned buckets = sub_buckets + (max_exponent - sub_bucket_bits + 1) * sub_buckets;
+
+    static unsigned bucket(uint64_t microseconds);
+
+    // the value which represents a bucket, which is its upper bound
+    static uint64_t value(unsigned bucket);
+};
+
+}; // namespace runai::llm::streamer::common
@@ -0,0 +1,161 @@
+#include "common/metrics/metrics.h"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <chrono>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "utils/random/random.h"
+
+namespace runai::llm::streamer::common
+{
+
+namespace
+{
+
+uint64_t stat(const std::string & name)
+{
+    const auto & names = Metrics::names();
+    const auto it = std::find(names.begin(), names.end(), name);
+    EXPECT_NE(it, names.end()) << name;
+
+    const auto values = Metrics::values();
+    EXPECT_EQ(values.size(), names.size());
+    return values.at(it - names.begin());
+}
+
+} // namespace
+
+TEST(Metrics, Names)
+{
+    const auto & names = Metrics::names();
+    EXPECT_EQ(names.size(), Metrics::values().size());
+
+    for (const auto & name : { "file_bytes", "s3_ops", "cache_bytes", "retries", "queued_jobs", "chunk_latency_us_p50", "chunk_latency_us_p99", "chunk_latency_us_p999", "first_response_us_count" })
+    {
+        EXPECT_NE(std::find(names.begin(), names.end(), name), names.end()) << name;
+    }
+}
+
+TEST(Metrics, Buckets)
+{
+    uint64_t previous = 0;
+    for (uint64_t microseconds = 0; microseconds < 100000; microseconds += utils::random::number(1, 100))
+    {
+        const auto bucket = Metrics::bucket(microseconds);
+        ASSERT_LT(bucket, Metrics::buckets);
+
+        // the value of a bucket bounds its values within the relative error
+        const auto value = Metrics::value(bucket);
+        EXPECT_GE(value, microseconds);
+        EXPECT_LE(value - microseconds, microseconds / Metrics::sub_buckets);
+
+        EXPECT_GE(value, previous);
+        previous = value;
+    }
+
+    EXPECT_EQ(Metrics::bucket(uint64_t(1) << 62), Metrics::buckets - 1);
+}
+
+TEST(Metrics, Threads)
+{
+    const auto bytes_before = stat("gcs_bytes");
+    const auto ops_before = stat("gcs_ops");
+    const auto retries_before = stat("retries");
+
+    const auto num_threads = utils::random::number(1, 8);
+    const auto reads = utils::random::number(1, 1000);
+    const auto bytesize = utils::random::number(1, 1000000);
+
+    // values of exited threads are kept
+    std::vector<std::thread> threads;
+    for (unsigned i = 0; i < num_threads; ++i)
+    {
+        threads.emplace_back([&]()
+        {
+            for (unsigned j = 0; j < reads; ++j)
+            {
+                Metrics::read(Metrics::Backend::GCS, bytesize);
+                Metrics::add(Metrics::Counter::Retries);
+            }
+        });
+    }
+
+    for (auto & thread : threads)
+    {
+        thread.join();
+    }
+
+    EXPECT_EQ(stat("gcs_bytes") - bytes_before, static_cast<uint64_t>(num_threads) * reads * bytesize);
+    EXPECT_EQ(stat("gcs_ops") - ops_before, static_cast<uint64_t>(num_threads) * reads);
+    EXPECT_EQ(stat("retries") - retries_before, static_cast<uint64_t>(num_threads) * reads);
+}
+
+TEST(Metrics, Gauge)
+{
+    const auto before = stat("clients");
+
+    // taken by one thread and released by another
+    Metrics::add(Metrics::Counter::Clients, 3);
+    EXPECT_EQ(stat("clients"), before + 3);
+
+    std::thread([]() { Metrics::add(Metrics::Counter::Clients, -3); }).join();
+    EXPECT_EQ(stat("clients"), before);
+}
+
+TEST(Metrics, Percentiles)
+{
+    EXPECT_EQ(stat("first_response_us_count"), 0);
+    EXPECT_EQ(stat("first_response_us_p50"), 0);
+
+    // 1000 samples of 1..1000 milliseconds
+    for (int i = 1; i <= 1000; ++i)
+    {
+        Metrics::record(Metrics::Histogram::FirstResponse, std::chrono::milliseconds(i));
+    }
+
+    EXPECT_EQ(stat("first_response_us_count"), 1000);
+
+    const auto expect = [](const std::string & name, uint64_t microseconds)
+    {
+        const auto value = stat(name);
+        EXPECT_GE(value, microseconds) << name;
+        EXPECT_LE(value, microseconds + microseconds / Metrics::sub_buckets) << name;
+    };
+
+    expect("first_response_us_p50", 500000);
+    expect("first_response_us_p99", 990000);
+    expect("first_response_us_p999", 999000);
+}
+
+TEST(Metrics, Usage)
+{
+    const auto before = stat("wall_us");
+
+    {
+        // not recorded until enabled
+        Metrics::Usage usage;
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    EXPECT_EQ(stat("wall_us"), before);
+
+    Metrics::enable_usage();
+
+    const auto page_faults = stat("page_faults");
+    const auto context_switches = stat("context_switches");
+
+    {
+        Metrics::Usage usage;
+        std::vector<char> buffer(utils::random::number(1, 16) * 1024 * 1024, 1);
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+
+    EXPECT_GE(stat("wall_us") - before, 10000);
+    EXPECT_GT(stat("page_faults"), page_faults);
+    EXPECT_GT(stat("context_switches"), context_switches);
+}
+
+}; // namespace runai::llm::streamer::common
@@ -0,0 +1,151 @@
+#include "common/mirrors/mirrors.h"
+
+#include <memory>
+#include <sstream>
+
+#include "common/exception/exception.h"
+
+#include "utils/logging/logging.h"
+
+namespace runai::llm::streamer::common::s3
+{
+
+namespace
+{
+
+std::vector<std::string> split(const std::string & str, char delimiter)
+{
+    std::vector<std::string> tokens;
+    std::stringstream stream(str);
+    std::string token;
+    while (std::getline(stream, token, delimiter))
+    {
+        if (!token.empty())
+        {
+            tokens.push_back(token);
+        }
+    }
+    return tokens;
+}
+
+Mirrors::Location parse(const std::string & description)
+{
+    Mirrors::Location location;
+
+    const auto separator = description.find("://");
+    if (separator == std::string::npos || separator == 0)
+    {
+        LOG(ERROR) << "Mirror location '" << description << "' is not in the format <scheme>://<bucket>[@<endpoint>]";
+        throw common::Exception(common::ResponseCode::InvalidParameterError);
+    }
+
+    location.scheme = description.substr(0, separator);
+    location.bucket = description.substr(separator + 3);
+
+    const auto at = location.bucket.find('@');
+    if (at != std::string::npos)
+    {
+        location.endpoint = location.bucket.substr(at + 1);
+        location.bucket = location.bucket.substr(0, at);
+    }
+
+    if (location.bucket.empty() || location.bucket.find('/') != std::string::npos || (location.endpoint.has_value() && location.endpoint.value().empty()))
+    {
+        LOG(ERROR) << "Mirror location '" << description << "' is not in the format <scheme>://<bucket>[@<endpoint>]";
+        throw common::Exception(common::ResponseCode::InvalidParameterError);
+    }
+
+    // all the mirrors are read by the same storage backend
+    try
+    {
+        const StorageUri uri(location.scheme + "://" + location.bucket + "/path");
+    }
+    catch (const std::exception &)
+    {
+        LOG(ERROR) << "Mirror location '" << description << "' has an unsupported scheme";
+        throw common::Exception(common::ResponseCode::InvalidParameterError);
+    }
+
+    return location;
+}
+
+} // namespace
+
+bool Mirrors::Location::contains(const StorageUri & uri) const
+{
+    return uri.scheme == scheme && uri.bucket == bucket;
+}
+
+Mirrors::Mirrors(const std::string & description)
+{
+    for (const auto & set_description : split(description, ';'))
+    {
+        std::vector<Location> set;
+        for (const auto & location_description : split(set_description, ','))
+        {
+            set.push_back(parse(location_description));
+
+            if (set.back().scheme != set.front().scheme)
+            {
+                LOG(ERROR) << "Mirror set '" << set_description << "' contains locations of different storage backends";
+                throw common::Exception(common::ResponseCode::InvalidParameterError);
+            }
+        }
+
+        if (set.size() < 2)
+        {
+            LOG(WARNING) << "Ignoring mirror set '" << set_description << "' with a single location";
+            continue;
+        }
+
+        LOG(DEBUG) << "Mirror set of " << set.size() << " locations: " << set_description;
+        _sets.push_back(std::move(set));
+    }
+}
+
+std::vector<Mirrors::Location> Mirrors::of(const StorageUri & uri) const
+{
+    for (const auto & set : _sets)
+    {
+        for (const auto & location : set)
+        {
+            if (location.contains(uri))
+            {
+                return set;
+            }
+        }
+    }
+    return {};
+}
+
+S3ClientWrapper::Params Mirrors::mirror(const S3ClientWrapper::Params & params, const Location & location)
+{
+    ASSERT(params.valid()) << "Mirroring invalid object storage parameters";
+
+    auto uri = std::make_shared<StorageUri>(location.scheme + "://" + location.bucket + "/" + params.uri->path);
+
+    auto credentials = params.credentials;
+    if (location.endpoint.has_value())
+    {
+        credentials.endpoint = location.endpoint;
+    }
+
+    return S3ClientWrapper::Params(uri, credentials, params.chunk_bytesize);
+}
+
+size_t Mirrors::size() const
+{
+    return _sets.size();
+}
+
+std::ostream & operator<<(std::ostream & os, const Mirrors::Location & location)
+{
+    os << location.scheme << "://" << location.bucket;
+    if (location.endpoint.has_value())
+    {
+        os << "@" << location.endpoint.value();
+    }
+    return os;
+}
+
+}; // namespace runai::llm::streamer::common::s3
@@ -0,0 +1,51 @@
+#pragma once
+
+#include <optional>
+#include <ostream>
+#include <string>
+#include <vector>
+
+#include "common/s3_wrapper/s3_wrapper.h"
+#include "common/storage_uri/storage_uri.h"
+
+namespace runai::llm::streamer::common::s3
+{
+
+// Sets of object storage locations which hold the same objects under the same paths (e.g. regional buckets, an on-prem cache, a gateway)
+//
+// Described by sets separated by ';', each a list of locations separated by ','
+// A location is <scheme>://<bucket>[@<endpoint url>], and a location without an endpoint uses the endpoint of the request
+//
+// e.g. "s3://models,s3://models-eu@https://s3.eu-west-1.amazonaws.com,s3://models@http://minio:9000"
+
+struct Mirrors
+{
+    struct Location
+    {
+        std::string scheme;
+        std::string bucket;
+        std::optional<std::string> endpoint;
+
+        bool contains(const StorageUri & uri) const;
+    };
+
+    Mirrors() = default;
+
+    // throws InvalidParameterError if the description is malformed
+    Mirrors(const std::string & description);
+
+    // the locations of the set which contains the given uri, or an empty list if the uri is not mirrored
+    std::vector<Location> of(const StorageUri & uri) const;
+
+    // parameters for reading the object of the given parameters from another location
+    static S3ClientWrapper::Params mirror(const S3ClientWrapper::Params & params, const Location & location);
+
+    size_t size() const;
+
+ private:
+    std::vector<std::vector<Location>> _sets;
+};
+
+std::ostream & operator<<(std::ostream &, const Mirrors::Location &);
+
+}; //namespace runai::llm::streamer::common::s3
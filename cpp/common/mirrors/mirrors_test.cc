@@ -0,0 +1,113 @@
+#include "common/mirrors/mirrors.h"
+
+#include <gtest/gtest.h>
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "common/exception/exception.h"
+
+#include "utils/random/random.h"
+
+namespace runai::llm::streamer::common::s3
+{
+
+TEST(Mirrors, Empty)
+{
+    Mirrors mirrors("");
+    EXPECT_EQ(mirrors.size(), 0);
+    EXPECT_TRUE(mirrors.of(StorageUri("s3://" + utils::random::string() + "/" + utils::random::string())).empty());
+}
+
+TEST(Mirrors, Parse)
+{
+    const auto bucket = utils::random::string();
+    const auto other = utils::random::string();
+    const auto endpoint = "http://" + utils::random::string() + ":9000";
+
+    Mirrors mirrors("s3://" + bucket + ",s3://" + other + "@" + endpoint + ";gs://a,gs://b");
+    EXPECT_EQ(mirrors.size(), 2);
+
+    const auto locations = mirrors.of(StorageUri("s3://" + other + "/" + utils::random::string()));
+    ASSERT_EQ(locations.size(), 2);
+    EXPECT_EQ(locations[0].scheme, "s3");
+    EXPECT_EQ(locations[0].bucket, bucket);
+    EXPECT_FALSE(locations[0].endpoint.has_value());
+    EXPECT_EQ(locations[1].bucket, other);
+    ASSERT_TRUE(locations[1].endpoint.has_value());
+    EXPECT_EQ(locations[1].endpoint.value(), endpoint);
+
+    EXPECT_EQ(mirrors.of(StorageUri("gs://b/" + utils::random::string())).size(), 2);
+    EXPECT_TRUE(mirrors.of(StorageUri("gs://" + bucket + "/" + utils::random::string())).empty());
+    EXPECT_TRUE(mirrors.of(StorageUri("s3://" + utils::random::string() + "/" + utils::random::string())).empty());
+}
+
+TEST(Mirrors, Single_Location)
+{
+    Mirrors mirrors("s3://" + utils::random::string());
+    EXPECT_EQ(mirrors.size(), 0);
+}
+
+TEST(Mirrors, Invalid)
+{
+    const std::vector<std::string> descriptions = {
+        "bucket,s3://other",
+        "s3://,s3://other",
+        "s3://bucket/path,s3://other",
+        "s3://bucket@,s3://other",
+        "ftp://bucket,ftp://other",
+        "s3://bucket,gs://other",
+    };
+
+    for (const auto & description : descriptions)
+    {
+        try
+        {
+            Mirrors mirrors(description);
+            FAIL() << "Expected failure of " << description;
+        }
+        catch (const common::Exception & e)
+        {
+            EXPECT_EQ(e.error(), common::ResponseCode::InvalidParameterError);
+        }
+    }
+}
+
+TEST(Mirrors, Mirror_Params)
+{
+    const auto path = utils::random::string() + "/" + utils::random::string();
+    const auto chunk_bytesize = utils::random::number<size_t>(1, 1024);
+    const auto endpoint = "http://" + utils::random::string();
+
+    Credentials credentials("key", "secret", nullptr, "region", "http://original");
+    S3ClientWrapper::Params params(std::make_shared<StorageUri>("s3://bucket/" + path), credentials, chunk_bytesize);
+
+    Mirrors mirrors("s3://bucket,s3://other@" + endpoint + ",s3://third");
+    const auto locations = mirrors.of(*params.uri);
+    ASSERT_EQ(locations.size(), 3);
+
+    {
+        const auto mirror = Mirrors::mirror(params, locations[1]);
+        EXPECT_EQ(mirror.uri->uri, "s3://other/" + path);
+        EXPECT_EQ(mirror.chunk_bytesize, chunk_bytesize);
+        EXPECT_EQ(mirror.credentials.access_key_id, credentials.access_key_id);
+        EXPECT_EQ(mirror.credentials.region, credentials.region);
+
+        std::vector<common::backend_api::ObjectConfigParam_t> initial_params;
+        const auto config = mirror.to_config(initial_params);
+        EXPECT_EQ(std::string(config.endpoint_url), endpoint);
+    }
+
+    {
+        // a location without an endpoint keeps the endpoint of the request
+        const auto mirror = Mirrors::mirror(params, locations[2]);
+        EXPECT_EQ(mirror.uri->uri, "s3://third/" + path);
+
+        std::vector<common::backend_api::ObjectConfigParam_t> initial_params;
+        const auto config = mirror.to_config(initial_params);
+        EXPECT_EQ(std::string(config.endpoint_url), "http://original");
+    }
+}
+
+}; // namespace runai::llm::streamer::common::s3
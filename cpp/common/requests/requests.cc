@@ -0,0 +1,111 @@
+#include "common/requests/requests.h"
+
+#include <utility>
+
+#include "utils/logging/logging.h"
+
+namespace runai::llm::streamer::common
+{
+
+Requests::Request Requests::add()
+{
+    const auto guard = std::unique_lock<std::mutex>(_mutex);
+    if (_responder == nullptr)
+    {
+        _responder = std::make_shared<Responder>(1);
+        _responder->set_notification(_notification);
+        _guard = std::make_shared<utils::CancelGuard>();
+    }
+    else
+    {
+        _responder->increment(1);
+    }
+
+    return Request{_responder, _guard};
+}
+
+backend_api::Response Requests::pop()
+{
+    std::shared_ptr<Responder> responder;
+    {
+        const auto guard = std::unique_lock<std::mutex>(_mutex);
+        responder = _responder;
+    }
+
+    if (responder == nullptr)
+    {
+        LOG(WARNING) << "Requesting response with uninitialized responder";
+        return ResponseCode::FinishedError;
+    }
+
+    return responder->pop();
+}
+
+ResponseCode Requests::try_pop(std::vector<backend_api::Response> & responses, unsigned max_responses)
+{
+    std::shared_ptr<Responder> responder;
+    {
+        const auto guard = std::unique_lock<std::mutex>(_mutex);
+        responder = _responder;
+    }
+
+    if (responder == nullptr)
+    {
+        responses.clear();
+        return ResponseCode::FinishedError;
+    }
+
+    return responder->try_pop(responses, max_responses);
+}
+
+void Requests::set_notification(Responder::Notification notification)
+{
+    const auto guard = std::unique_lock<std::mutex>(_mutex);
+    _notification = notification;
+    if (_responder != nullptr)
+    {
+        _responder->set_notification(notification);
+    }
+}
+
+void Requests::stop()
+{
+    const auto guard = std::unique_lock<std::mutex>(_mutex);
+    if (_responder != nullptr)
+    {
+        _responder->stop();
+    }
+}
+
+void Requests::cancel()
+{
+    std::shared_ptr<Responder> responder;
+    std::shared_ptr<utils::CancelGuard> cancel_guard;
+    {
+        const auto guard = std::unique_lock<std::mutex>(_mutex);
+        responder = std::move(_responder);
+        cancel_guard = std::move(_guard);
+        _responder = nullptr;
+        _guard = nullptr;
+    }
+
+    if (responder != nullptr)
+    {
+        // the canceled requests do not notify the caller anymore
+        responder->set_notification(nullptr);
+    }
+
+    if (cancel_guard != nullptr)
+    {
+        // wait for writes in progress to the destination buffers
+        cancel_guard->cancel();
+    }
+
+    if (responder != nullptr)
+    {
+        // ignore the responses of the canceled requests and notify waiting callers
+        responder->stop();
+    }
+}
+
+} // namespace runai::llm::streamer::common
@@ -0,0 +1,66 @@
+#pragma once
+
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "common/backend_api/response/response.h"
+#include "common/response_code/response_code.h"
+#include "common/shared_queue/shared_queue.h"
+
+#include "utils/cancel_guard/cancel_guard.h"
+
+namespace runai::llm::streamer::common
+{
+
+// Pending asynchronous requests of an object storage client
+//
+// Holds the queue of responses of the current requests, and the guard of the writes to their destination buffers
+// Canceling the requests replaces both, so that the client remains usable for further requests while the canceled ones are ignored
+
+struct Requests
+{
+    using Responder = SharedQueue<backend_api::Response>;
+
+    // what a new request reports to and writes under
+    struct Request
+    {
+        std::shared_ptr<Responder> responder;
+        std::shared_ptr<utils::CancelGuard> guard;
+    };
+
+    // registers a new request, which is expected to push exactly one response
+    Request add();
+
+    // waits for the next response, or returns FinishedError if no responses are expected
+    backend_api::Response pop();
+
+    // returns up to max_responses ready responses without waiting, or FinishedError if no responses are expected
+    ResponseCode try_pop(std::vector<backend_api::Response> & responses, unsigned max_responses);
+
+    // notification of ready responses, or an empty notification to unregister
+    // when this returns the previous notification is not running and will not be called again
+    void set_notification(Responder::Notification notification);
+
+    // notify the waiting callers that no more responses are expected
+    void stop();
+
+    // Ignore the responses of the current requests
+    // Returns when no more data is written to the destination buffers of the canceled requests
+    void cancel();
+
+ private:
+    std::shared_ptr<Responder> _responder;
+
+    // notification of ready responses, which is set on every new responder
+    Responder::Notification _notification;
+
+    // guards the writes to the destination buffers of the current requests
+    std::shared_ptr<utils::CancelGuard> _guard;
+
+    // responder and guard are replaced when the requests are canceled
+    std::mutex _mutex;
+};
+
+} // namespace runai::llm::streamer::common
@@ -0,0 +1,121 @@
+#include "common/requests/requests.h"
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <unistd.h>
+#include <vector>
+
+#include "utils/random/random.h"
+#include "utils/thread/thread.h"
+
+namespace runai::llm::streamer::common
+{
+
+TEST(Pop, Uninitialized)
+{
+    Requests requests;
+
+    EXPECT_EQ(requests.pop().ret, ResponseCode::FinishedError);
+
+    std::vector<backend_api::Response> responses;
+    EXPECT_EQ(requests.try_pop(responses, 1), ResponseCode::FinishedError);
+    EXPECT_EQ(responses.size(), 0);
+}
+
+TEST(Add, Sanity)
+{
+    Requests requests;
+    const auto size = utils::random::number(1, 100);
+
+    for (unsigned i = 0; i < size; ++i)
+    {
+        auto request = requests.add();
+        request.responder->push(backend_api::Response(i, ResponseCode::Success));
+    }
+
+    for (unsigned i = 0; i < size; ++i)
+    {
+        const auto r = requests.pop();
+        EXPECT_EQ(r.ret, ResponseCode::Success);
+        EXPECT_EQ(r.handle, i);
+    }
+
+    EXPECT_EQ(requests.pop().ret, ResponseCode::FinishedError);
+}
+
+TEST(Notification, Set_Before_Request)
+{
+    Requests requests;
+    std::atomic<unsigned> notified = 0;
+    requests.set_notification([&]() { ++notified; });
+
+    auto request = requests.add();
+    request.responder->push(backend_api::Response(0, ResponseCode::Success));
+
+    EXPECT_GE(notified, 1);
+}
+
+TEST(Cancel, Waits_For_Writes)
+{
+    Requests requests;
+    auto request = requests.add();
+
+    std::atomic<bool> left = false;
+    ASSERT_TRUE(request.guard->enter());
+
+    auto writer = utils::Thread([&]()
+    {
+        usleep(utils::random::number(10 * 1000));
+        left = true;
+        request.guard->leave();
+    });
+
+    requests.cancel();
+    EXPECT_TRUE(left);
+    EXPECT_FALSE(request.guard->enter());
+
+    writer.join();
+}
+
+TEST(Cancel, Remains_Usable)
+{
+    Requests requests;
+    std::atomic<unsigned> notified = 0;
+    requests.set_notification([&]() { ++notified; });
+
+    auto canceled = requests.add();
+    requests.cancel();
+
+    // the canceled request neither responds nor notifies
+    canceled.responder->push(backend_api::Response(0, ResponseCode::Success));
+    EXPECT_EQ(notified, 0);
+
+    auto request = requests.add();
+    EXPECT_NE(request.responder, canceled.responder);
+    EXPECT_FALSE(request.guard->cancelled());
+
+    request.responder->push(backend_api::Response(1, ResponseCode::Success));
+    EXPECT_GE(notified, 1);
+
+    const auto r = requests.pop();
+    EXPECT_EQ(r.ret, ResponseCode::Success);
+    EXPECT_EQ(r.handle, 1);
+}
+
+TEST(Stop, Waiting_Consumer)
+{
+    Requests requests;
+    requests.add();
+
+    auto waiting = utils::Thread([&]()
+    {
+        EXPECT_EQ(requests.pop().ret, ResponseCode::FinishedError);
+    });
+
+    usleep(utils::random::number(10 * 1000));
+    requests.stop();
+    waiting.join();
+}
+
+} // namespace runai::llm::streamer::common
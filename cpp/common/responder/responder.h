@@ -1,6 +1,13 @@
 
 #pragma once
 
+#include <atomic>
+#include <chrono>
+#include <utility>
+#include <vector>
+
+#include "common/metrics/metrics.h"
+#include "common/trace/trace.h"
 #include "common/shared_queue/shared_queue.h"
 #include "common/response/response.h"
 
@@ -18,6 +25,53 @@ namespace runai::llm::streamer::common
 
 // Designed for multi producers that push responses and a single consumer that is waiting for responses
 
-using Responder = SharedQueue<Response>;
+// The time from creating the responder of a request until its first response is recorded in the metrics, and pushes and pops are traced
+
+struct Responder : SharedQueue<Response>
+{
+    Responder(unsigned running) :
+        SharedQueue<Response>(running),
+        _created(std::chrono::steady_clock::now())
+    {}
+
+    Response pop()
+    {
+        Trace::Scope span("pop");
+        return SharedQueue<Response>::pop();
+    }
+
+    void push(Response && response)
+    {
+        Trace::Scope span("push");
+        first_response();
+        SharedQueue<Response>::push(std::move(response));
+    }
+
+    void push(Response && response, size_t bytesize)
+    {
+        Trace::Scope span("push", bytesize);
+        first_response();
+        SharedQueue<Response>::push(std::move(response), bytesize);
+    }
+
+    void push(std::vector<Response> && responses, size_t bytesize)
+    {
+        Trace::Scope span("push", bytesize);
+        first_response();
+        SharedQueue<Response>::push(std::move(responses), bytesize);
+    }
+
+ private:
+    void first_response()
+    {
+        if (!_responded.load(std::memory_order_relaxed) && !_responded.exchange(true))
+        {
+            Metrics::record(Metrics::Histogram::FirstResponse, std::chrono::steady_clock::now() - _created);
+        }
+    }
+
+    const std::chrono::steady_clock::time_point _created;
+    std::atomic<bool> _responded{false};
+};
 
 } // namespace runai::llm::streamer::common
@@ -1,10 +1,13 @@
 #include <regex>
 #include <vector>
 #include <chrono>
+#include <tuple>
+#include <utility>
 
 #include "common/s3_wrapper/s3_wrapper.h"
 #include "common/s3_credentials/s3_credentials.h"
 #include "common/exception/exception.h"
+#include "common/metrics/metrics.h"
 
 #include "utils/env/env.h"
 #include "utils/logging/logging.h"
@@ -91,12 +94,15 @@ S3ClientWrapper::BackendHandle::~BackendHandle()
 const ObjectPluginType ObjectPluginType::ObjStorageGCS(PluginID::GCS, obj_plugin_gcs_name, lib_streamer_gcs_so_name);
 const ObjectPluginType ObjectPluginType::ObjStorageS3(PluginID::S3, obj_plugin_s3_name, lib_streamer_s3_so_name);
 const ObjectPluginType ObjectPluginType::ObjStorageAzure(PluginID::AZURE, obj_plugin_azure_name, lib_streamer_azure_so_name);
+const ObjectPluginType ObjectPluginType::ObjStorageEmulated(PluginID::EMULATED, obj_plugin_emulated_name, lib_streamer_emulated_so_name);
 
 const ObjectPluginType S3ClientWrapper::BackendHandle::get_libstreamers_plugin_type(const std::shared_ptr<common::s3::StorageUri> & uri) {
     if (uri != nullptr && uri->is_gcs()) {
         return ObjectPluginType::ObjStorageGCS;
     } else if (uri != nullptr && uri->is_azure()) {
         return ObjectPluginType::ObjStorageAzure;
+    } else if (uri != nullptr && uri->is_emulated()) {
+        return ObjectPluginType::ObjStorageEmulated;
     } else {
         return ObjectPluginType::ObjStorageS3;
     }
@@ -121,6 +127,8 @@ std::shared_ptr<utils::Dylib> S3ClientWrapper::BackendHandle::open_object_storag
             throw Exception(ResponseCode::S3NotSupported);
         case PluginID::AZURE:
             throw Exception(ResponseCode::AzureBlobNotSupported);
+        case PluginID::EMULATED:
+            throw Exception(ResponseCode::ObjPluginLoadError);
     }
     return nullptr;
 }
@@ -161,12 +169,111 @@ void S3ClientWrapper::stop()
     }
 }
 
+void S3ClientWrapper::cancel()
+{
+    try
+    {
+        auto cancel_reads_ = _backend_handle->dylib_ptr->dlsym<common::backend_api::ResponseCode_t(*)(common::backend_api::ObjectClientHandle_t)>("obj_cancel_reads");
+        auto ret = cancel_reads_(_s3_client);
+        if (ret != common::ResponseCode::Success)
+        {
+            LOG(ERROR) << "Failed to cancel client reads: " << ret;
+        }
+    }
+    catch(...)
+    {
+        LOG(WARNING) << "Object storage backend does not support canceling reads - waiting for pending reads to complete";
+    }
+
+    // wake up the caller, which retrieves the canceled requests without blocking
+    if (_notification != nullptr)
+    {
+        _notification(_notification_context);
+    }
+}
+
+std::optional<std::string> S3ClientWrapper::object_version(const Params & params)
+{
+    if (!_backend_handle->dylib_ptr->has("obj_get_object_version"))
+    {
+        LOG(DEBUG) << "Object storage backend does not support object versions";
+        return std::nullopt;
+    }
+
+    auto get_object_version_ = _backend_handle->dylib_ptr->dlsym<common::backend_api::ResponseCode_t(*)(common::backend_api::ObjectClientHandle_t, const char*, char*, unsigned int)>("obj_get_object_version");
+    std::vector<char> version(max_version_length);
+    const auto ret = get_object_version_(_s3_client, params.uri->uri.c_str(), version.data(), version.size());
+    if (ret != common::ResponseCode::Success)
+    {
+        LOG(WARNING) << "Failed to retrieve version of object " << params.uri->uri << ": " << ret;
+        return std::nullopt;
+    }
+    return std::string(version.data());
+}
+
+bool S3ClientWrapper::notification_supported(const Params & params)
+{
+    try
+    {
+        std::shared_ptr<BackendHandle> handle = manage_backend_handle(params, ManageBackendHandleOp::CREATE);
+        return handle != nullptr && handle->dylib_ptr->has("obj_set_completion_notification");
+    }
+    catch(...)
+    {
+    }
+    return false;
+}
+
+void S3ClientWrapper::notified(void * context)
+{
+    auto client = static_cast<S3ClientWrapper *>(context);
+    {
+        const auto guard = std::unique_lock<std::mutex>(client->_notified_mutex);
+        client->_notified.push_back(std::chrono::steady_clock::now());
+    }
+    client->_notification(client->_notification_context);
+}
+
+bool S3ClientWrapper::set_notification(backend_api::ObjectCompletionNotification_t notification, void * context)
+{
+    // the backend calls notified(), which calls the notification of the caller, and which is not running once the backend unregisters it
+    const auto previous = std::make_pair(_notification, _notification_context);
+    if (notification != nullptr)
+    {
+        _notification = notification;
+        _notification_context = context;
+    }
+
+    try
+    {
+        auto set_notification_ = _backend_handle->dylib_ptr->dlsym<common::backend_api::ResponseCode_t(*)(common::backend_api::ObjectClientHandle_t, common::backend_api::ObjectCompletionNotification_t, void*)>("obj_set_completion_notification");
+        auto ret = set_notification_(_s3_client, notification == nullptr ? nullptr : notified, this);
+        if (ret != common::ResponseCode::Success)
+        {
+            LOG(ERROR) << "Failed to set completion notification of client: " << ret;
+            std::tie(_notification, _notification_context) = previous;
+            return false;
+        }
+    }
+    catch(...)
+    {
+        LOG(DEBUG) << "Object storage backend does not support completion notifications";
+        std::tie(_notification, _notification_context) = previous;
+        return false;
+    }
+
+    _notification = notification;
+    _notification_context = context;
+    return true;
+}
+
 S3ClientWrapper::S3ClientWrapper(const Params & params) :
     _backend_handle(manage_backend_handle(params, ManageBackendHandleOp::CREATE)),
     _s3_client(create_client(params))
 {
     LOG(SPAM) << "Created client for uri " << *params.uri;
     ASSERT(_backend_handle != nullptr) << "Backend handle is alreday closed";
+    Metrics::add(Metrics::Counter::Clients);
 }
 
 S3ClientWrapper::~S3ClientWrapper()
@@ -174,8 +281,13 @@ S3ClientWrapper::~S3ClientWrapper()
     try
     {
         ASSERT(_backend_handle != nullptr) << "Backend handle is alreday closed";
+        if (_notification != nullptr)
+        {
+            set_notification(nullptr, nullptr);
+        }
         auto remove_client_ = _backend_handle->dylib_ptr->dlsym<common::backend_api::ResponseCode_t(*)(common::backend_api::ObjectClientHandle_t)>("obj_remove_client");
         remove_client_(_s3_client);
+        Metrics::add(Metrics::Counter::Clients, -1);
     }
     catch(...)
     {
@@ -245,7 +357,7 @@ ResponseCode S3ClientWrapper::async_read(const Params & params, common::backend_
     return common::ResponseCode::Success;
 }
 
-common::ResponseCode S3ClientWrapper::async_read_response(std::vector<backend_api::ObjectCompletionEvent_t> & event_buffer, unsigned max_events_to_retrieve)
+common::ResponseCode S3ClientWrapper::async_read_response(std::vector<backend_api::ObjectCompletionEvent_t> & event_buffer, unsigned max_events_to_retrieve, backend_api::ObjectWaitMode_t wait_mode, std::vector<std::chrono::steady_clock::time_point> * completed)
 {
     if (max_events_to_retrieve == 0)
     {
@@ -254,14 +366,46 @@ common::ResponseCode S3ClientWrapper::async_read_response(std::vector<backend_ap
     }
 
     event_buffer.resize(max_events_to_retrieve);
-    unsigned int out_num_events_retrieved;
+    unsigned int out_num_events_retrieved = 0;
+    const auto polled = std::chrono::steady_clock::now();
     auto s3_async_response_ = _backend_handle->dylib_ptr->dlsym<ResponseCode(*)(common::backend_api::ObjectClientHandle_t, common::backend_api::ObjectCompletionEvent_t*, unsigned int, unsigned int*, common::backend_api::ObjectWaitMode_t)>("obj_wait_for_completions");
-    auto ret = s3_async_response_(_s3_client, event_buffer.data(), max_events_to_retrieve, &out_num_events_retrieved, common::backend_api::OBJECT_WAIT_MODE_BLOCK);
+    auto ret = s3_async_response_(_s3_client, event_buffer.data(), max_events_to_retrieve, &out_num_events_retrieved, wait_mode);
 
     if (ret == common::ResponseCode::Success)
     {
         ASSERT(out_num_events_retrieved >= 0 && out_num_events_retrieved <= max_events_to_retrieve);
         event_buffer.resize(out_num_events_retrieved);
+
+        // a backend may notify once for several events, which are then ready by the time of the last notification
+        auto last = std::chrono::steady_clock::now();
+        if (completed != nullptr)
+        {
+            completed->clear();
+        }
+
+        const auto guard = std::unique_lock<std::mutex>(_notified_mutex);
+        for (unsigned i = 0; i < out_num_events_retrieved; ++i)
+        {
+            if (!_notified.empty())
+            {
+                last = _notified.front();
+                _notified.pop_front();
+            }
+
+            if (completed != nullptr)
+            {
+                completed->push_back(last);
+            }
+        }
+
+        // all the ready events were retrieved, so notifications from before the poll which are left had no event (e.g. of a cancellation)
+        if (out_num_events_retrieved < max_events_to_retrieve)
+        {
+            while (!_notified.empty() && _notified.front() <= polled)
+            {
+                _notified.pop_front();
+            }
+        }
     }
     return ret;
 }
@@ -1,9 +1,12 @@
 #pragma once
 
+#include <chrono>
+#include <deque>
 #include <memory>
 #include <string>
 #include <vector>
 #include <mutex>
+#include <optional>
 #include "common/range/range.h"
 #include "common/response_code/response_code.h"
 #include "common/storage_uri/storage_uri.h"
@@ -20,14 +23,17 @@ namespace runai::llm::streamer::common::s3
 static const std::string lib_streamer_s3_so_name = "libstreamers3.so";
 static const std::string lib_streamer_gcs_so_name = "libstreamergcs.so";
 static const std::string lib_streamer_azure_so_name = "libstreamerazure.so";
+static const std::string lib_streamer_emulated_so_name = "libstreameremulated.so";
 static const std::string obj_plugin_s3_name = "s3";
 static const std::string obj_plugin_gcs_name = "gcs";
 static const std::string obj_plugin_azure_name = "azure";
+static const std::string obj_plugin_emulated_name = "emulated";
 
 enum struct PluginID {
     GCS,
     S3,
-    AZURE
+    AZURE,
+    EMULATED
 };
 
 /**
@@ -46,6 +52,7 @@ public:
     static const ObjectPluginType ObjStorageGCS;
     static const ObjectPluginType ObjStorageS3;
     static const ObjectPluginType ObjStorageAzure;
+    static const ObjectPluginType ObjStorageEmulated;
 
     std::string name() const { return _name; }
     std::string so_name() const { return _so_name; }
@@ -106,7 +113,27 @@ struct S3ClientWrapper
       // chunk_bytesize - size of chunk for reading in multi parts (minimal size is 5 MB)
 
       common::ResponseCode async_read(const Params & params, backend_api::ObjectRequestId_t request_id, const Range & ranges, char * buffer);
-      common::ResponseCode async_read_response(std::vector<backend_api::ObjectCompletionEvent_t> & event_buffer, unsigned max_events_to_retrieve);
+      // completed - if not null, the completion time of each retrieved event, which is the time the backend notified that it was ready,
+      //             or the time it was retrieved if no notification is registered
+      common::ResponseCode async_read_response(std::vector<backend_api::ObjectCompletionEvent_t> & event_buffer, unsigned max_events_to_retrieve, backend_api::ObjectWaitMode_t wait_mode = backend_api::OBJECT_WAIT_MODE_BLOCK, std::vector<std::chrono::steady_clock::time_point> * completed = nullptr);
+
+      // register a notification which the backend calls whenever completions are ready, instead of blocking a thread on waiting for them
+      // the client records the time of every notification as the completion time of the next ready event, and forwards it
+      // a null notification unregisters - the client unregisters on destruction
+      // returns false if the backend does not support completion notifications
+      bool set_notification(backend_api::ObjectCompletionNotification_t notification, void * context);
+
+      // whether the object storage backend supports completion notifications
+      static bool notification_supported(const Params & params);
+
+      // cancel the pending requests of this client, and wait until the backend stops writing into their destination buffers
+      // the client can be used for further requests
+      // a registered notification is called once the requests were canceled
+      void cancel();
+
+      // current version of an object, which changes whenever the object is modified
+      // returns nullopt if the backend does not support object versions, or failed to retrieve the version
+      std::optional<std::string> object_version(const Params & params);
 
       // stop - stops the responder of each S3 client, in order to notify callers which sent a request and are waiting for a response
       //        required for stopping the threadpool workers, which are bloking on the client responder
@@ -117,6 +144,7 @@ struct S3ClientWrapper
 
       static constexpr size_t min_chunk_bytesize = 5 * 1024 * 1024;
       static constexpr size_t default_chunk_bytesize = 8 * 1024 * 1024;
+      static constexpr size_t max_version_length = 1024;
 
  private:
       void * create_client(const Params & params);
@@ -128,12 +156,22 @@ struct S3ClientWrapper
       static std::shared_ptr<BackendHandle> manage_backend_handle(const Params & params, ManageBackendHandleOp op);
       static common::backend_api::ObjectShutdownPolicy_t get_backend_shutdown_policy(std::shared_ptr<BackendHandle> handle);
 
+      // the notification registered in the backend, which records the completion time and calls the notification of the caller
+      static void notified(void * context);
+
  private:
       static std::mutex _backend_handle_mutex;
       std::shared_ptr<BackendHandle> _backend_handle;
 
       // Handle to s3 client
       void * _s3_client;
+
+      backend_api::ObjectCompletionNotification_t _notification = nullptr;
+      void * _notification_context = nullptr;
+
+      // times of the notifications whose events were not retrieved yet, in the order of the events
+      std::mutex _notified_mutex;
+      std::deque<std::chrono::steady_clock::time_point> _notified;
 };
 
 }; //namespace runai::llm::streamer::common::s3
@@ -1,7 +1,10 @@
 #include "common/s3_wrapper/s3_wrapper.h"
 
 #include <gtest/gtest.h>
+#include <atomic>
+#include <chrono>
 #include <cstdint>
+#include <thread>
 
 #include "utils/dylib/dylib.h"
 #include "utils/random/random.h"
@@ -78,6 +81,37 @@ TEST_F(S3WrappertTest, Response)
     EXPECT_EQ(event_buffer.at(0).response_code, common::ResponseCode::Success);
 }
 
+TEST_F(S3WrappertTest, Completion_Time)
+{
+    utils::Dylib dylib("libstreamers3.so");
+    auto mock_response_time = dylib.dlsym<void(*)(unsigned)>("runai_mock_s3_set_response_time_ms");
+    mock_response_time(utils::random::number(1, 20));
+
+    std::atomic<bool> notified(false);
+    S3ClientWrapper wrapper(params);
+    ASSERT_TRUE(wrapper.set_notification([](void * context) { static_cast<std::atomic<bool> *>(context)->store(true); }, &notified));
+
+    Range range;
+    EXPECT_EQ(wrapper.async_read(params, request_id, range, nullptr), common::ResponseCode::Success);
+    while (!notified)
+    {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    const auto ready = std::chrono::steady_clock::now();
+
+    // the response is retrieved later, and its completion time is the time it was ready
+    std::this_thread::sleep_for(std::chrono::milliseconds(utils::random::number(50, 100)));
+
+    std::vector<backend_api::ObjectCompletionEvent_t> event_buffer;
+    std::vector<std::chrono::steady_clock::time_point> completed;
+    EXPECT_EQ(wrapper.async_read_response(event_buffer, 1, backend_api::OBJECT_WAIT_MODE_NON_BLOCKING, &completed), common::ResponseCode::Success);
+    ASSERT_EQ(event_buffer.size(), 1);
+    ASSERT_EQ(completed.size(), 1);
+    EXPECT_LE(completed.at(0), ready);
+
+    mock_response_time(0);
+}
+
 TEST_F(S3WrappertTest, Cleanup)
 {
     utils::Dylib dylib("libstreamers3.so");
@@ -2,11 +2,14 @@
 
 #include <atomic>
 #include <chrono>
+#include <condition_variable>
 #include <deque>
+#include <functional>
 #include <mutex>
 #include <type_traits> // For std::is_constructible
 #include <typeinfo>
 #include <utility>
+#include <vector>
 
 #include "utils/semaphore/semaphore.h"
 #include "common/response_code/response_code.h"
@@ -29,6 +32,15 @@ namespace runai::llm::streamer::common
 //          if no responses are expected returns a ResponseType indicating FinishedError
 
 // Designed for multi producers that push responses and a single consumer that is waiting for responses
+//
+// Alternatively to waiting, the consumer can be notified:
+//    handler      : pushed responses are passed to the handler from the pushing thread, and are not queued
+//    notification : called from the pushing thread after responses were queued, and the consumer drains them with try_pop
+//                   also called once the queue is stopped, so that the consumer finds out that no more responses are expected
+//                   the notification is called while holding the queue lock and must not call the queue
+//                   once set_notification() returns the previous notification is not running and will not be called again
+//    completion   : called once from the pushing thread which pushed the last expected response, if all the responses succeeded,
+//                   with the bytesize of the responses and the time since the queue was created
 
 template <typename ResponseType>
 struct SharedQueue
@@ -44,16 +56,41 @@ struct SharedQueue
 
     void increment(unsigned running);
 
+    // handler of pushed responses - called concurrently from the pushing threads
+    using Handler = std::function<void(const std::vector<ResponseType> &)>;
+
+    // notification of queued responses - called concurrently from the pushing threads
+    using Notification = std::function<void()>;
+
+    // completion of all the expected responses
+    using Completion = std::function<void(size_t bytesize, std::chrono::steady_clock::duration elapsed)>;
+
+    // must be set before responses are pushed
+    void set_handler(Handler handler);
+    void set_notification(Notification notification);
+    void set_completion(Completion completion);
+
     ResponseType pop();
 
+    // pop up to max_responses ready responses without waiting
+    // returns common::ResponseCode::FinishedError if no responses are expected
+    common::ResponseCode try_pop(std::vector<ResponseType> & responses, unsigned max_responses);
+
     void push(ResponseType && response);
     void push(ResponseType && response, size_t bytesize);
 
+    // push several responses at once, with a single notification
+    void push(std::vector<ResponseType> && responses, size_t bytesize);
+
     void cancel();
     void stop();
 
     bool finished() const;
 
+    // blocks until all the expected responses were pushed, or until the queue was canceled or stopped
+    // does not consume the responses
+    void wait_until_done();
+
     // return throughput in bytes per second
     size_t bytes_per_second() const;
 
@@ -72,6 +109,9 @@ struct SharedQueue
     // mutex to make the queue thread safe
     mutable std::mutex _mutex;
 
+    // signals that no more responses are expected
+    std::condition_variable _done;
+
     bool _canceled = false;
     std::atomic<bool> _stopped;
 
@@ -81,6 +121,10 @@ struct SharedQueue
     bool _successful = true;
 
     std::atomic<bool> _unexpected_push_error;
+
+    Handler _handler;
+    Notification _notification;
+    Completion _completion;
 };
 
 
@@ -112,9 +156,43 @@ void SharedQueue<ResponseType>::increment(unsigned running)
     LOG(DEBUG) << "Responder incremented, new running count: " << _running;
 }
 
+template <typename ResponseType>
+void SharedQueue<ResponseType>::set_handler(Handler handler)
+{
+    const auto guard = std::unique_lock<std::mutex>(_mutex);
+    _handler = handler;
+}
+
+template <typename ResponseType>
+void SharedQueue<ResponseType>::set_notification(Notification notification)
+{
+    const auto guard = std::unique_lock<std::mutex>(_mutex);
+    _notification = notification;
+}
+
+template <typename ResponseType>
+void SharedQueue<ResponseType>::set_completion(Completion completion)
+{
+    const auto guard = std::unique_lock<std::mutex>(_mutex);
+    _completion = completion;
+}
+
 template <typename ResponseType>
 ResponseType SharedQueue<ResponseType>::pop()
 {
+    bool has_handler = false;
+    {
+        const auto guard = std::unique_lock<std::mutex>(_mutex);
+        has_handler = static_cast<bool>(_handler);
+    }
+
+    if (has_handler)
+    {
+        // responses are passed to the handler and are not queued
+        wait_until_done();
+        return ResponseType(common::ResponseCode::FinishedError);
+    }
+
     if (_stopped.load(std::memory_order_acquire) || finished()) // Use acquire for atomic read
     {
         LOG(DEBUG) << (_stopped.load(std::memory_order_relaxed) ? "responder stopped" : "responder does not expect any more responses") << " (Type: " << typeid(ResponseType).name() << ")";
@@ -131,6 +209,12 @@ ResponseType SharedQueue<ResponseType>::pop()
         return ResponseType(common::ResponseCode::FinishedError);
     }
 
+    if (_canceled)
+    {
+        LOG(DEBUG) << "responder canceled while waiting (Type: " << typeid(ResponseType).name() << ")";
+        return ResponseType(common::ResponseCode::FinishedError);
+    }
+
     ASSERT(!_responses.empty()) << "responder is empty after notification. Current running " << _running << " (Type: " << typeid(ResponseType).name() << ")";
 
     ResponseType response = std::move(_responses.front());
@@ -140,10 +224,56 @@ ResponseType SharedQueue<ResponseType>::pop()
     return response;
 }
 
+template <typename ResponseType>
+common::ResponseCode SharedQueue<ResponseType>::try_pop(std::vector<ResponseType> & responses, unsigned max_responses)
+{
+    responses.clear();
+
+    const auto guard = std::unique_lock<std::mutex>(_mutex);
+
+    if (_stopped.load(std::memory_order_relaxed) || _canceled || (_running == 0 && _responses.empty()))
+    {
+        return common::ResponseCode::FinishedError;
+    }
+
+    // a queued response is ready only after the semaphore was posted for it
+    while (responses.size() < max_responses && !_responses.empty() && _ready.try_wait())
+    {
+        responses.push_back(std::move(_responses.front()));
+        _responses.pop_front();
+    }
+
+    LOG(SPAM) << "Sending " << responses.size() << " responses";
+    return common::ResponseCode::Success;
+}
+
 template <typename ResponseType>
 void SharedQueue<ResponseType>::push(ResponseType && response)
 {
-    bool posted_to_semaphore = false;
+    std::vector<ResponseType> responses;
+    responses.push_back(std::move(response));
+    push(std::move(responses), 0);
+}
+
+template <typename ResponseType>
+void SharedQueue<ResponseType>::push(ResponseType && response, size_t bytesize)
+{
+    std::vector<ResponseType> responses;
+    responses.push_back(std::move(response));
+    push(std::move(responses), bytesize);
+}
+
+template <typename ResponseType>
+void SharedQueue<ResponseType>::push(std::vector<ResponseType> && responses, size_t bytesize)
+{
+    _total_bytesize.fetch_add(bytesize, std::memory_order_relaxed);
+
+    if (responses.empty())
+    {
+        return;
+    }
+
+    Handler handler;
     {
         const auto guard = std::unique_lock<std::mutex>(_mutex);
 
@@ -154,42 +284,73 @@ void SharedQueue<ResponseType>::push(ResponseType && response)
             return;
         }
 
-        // Assuming ResponseType has a member 'ret' of type common::ResponseCode
-        _successful  = _successful && (response.ret == common::ResponseCode::Success);
+        handler = _handler;
+    }
+
+    // the handler is called before the responses are accounted, so that the queue is not finished while the handler is running
+    if (handler)
+    {
+        handler(responses);
+    }
+
+    unsigned posted_to_semaphore = 0;
+    bool completed = false;
+    Completion completion;
+    {
+        const auto guard = std::unique_lock<std::mutex>(_mutex);
 
-        if (_running > 0) // Check _running before decrementing
+        for (auto & response : responses)
         {
-            LOG(SPAM) << response << " ; " << _running << " running requests (Type: " << typeid(ResponseType).name() << ")";
-            _responses.push_back(std::move(response)); // Use std::move
-            --_running;
-            posted_to_semaphore = true;
+            // Assuming ResponseType has a member 'ret' of type common::ResponseCode
+            _successful  = _successful && (response.ret == common::ResponseCode::Success);
 
-            if (_running == 0 && _successful && _total_bytesize.load(std::memory_order_relaxed) > 100 * 1024 * 1024)
+            if (_running > 0) // Check _running before decrementing
+            {
+                LOG(SPAM) << response << " ; " << _running << " running requests (Type: " << typeid(ResponseType).name() << ")";
+                if (!handler)
+                {
+                    _responses.push_back(std::move(response)); // Use std::move
+                    ++posted_to_semaphore;
+                }
+                --_running;
+                completed = (_running == 0);
+            }
+            else
             {
-                const auto throughput = bytes_per_second(); // bytes_per_second uses _mutex internally if needed
-                // Consider if std::cout is appropriate here or if it should be logged.
-                // This might also be better placed outside the lock if bytes_per_second is slow.
-                LOG(INFO) << "Read throughput is " << utils::logging::human_readable_size(throughput) << " per second " << std::endl;
+                LOG(ERROR) << "Received unexpected response (no running requests) " << response << " (Type: " << typeid(ResponseType).name() << ")";
+                _unexpected_push_error.store(true, std::memory_order_relaxed);
             }
         }
-        else
+
+        if (completed && _successful && _total_bytesize.load(std::memory_order_relaxed) > 100 * 1024 * 1024)
+        {
+            const auto throughput = bytes_per_second();
+            LOG(INFO) << "Read throughput is " << utils::logging::human_readable_size(throughput) << " per second " << std::endl;
+        }
+
+        if (completed && _successful)
+        {
+            completion = _completion;
+        }
+
+        // post while holding the mutex, so that try_pop() does not take a response before its post
+        for (unsigned i = 0; i < posted_to_semaphore; ++i)
+        {
+            _ready.post(); // Signal that a response is ready
+        }
+
+        if (posted_to_semaphore > 0 && _notification)
         {
-            LOG(ERROR) << "Received unexpected response (no running requests) " << response << " (Type: " << typeid(ResponseType).name() << ")";
-            _unexpected_push_error.store(true, std::memory_order_relaxed);
+            _notification();
         }
     } // Mutex guard released
 
-    if (posted_to_semaphore)
+    if (completion)
     {
-        _ready.post(); // Signal that a response is ready
+        completion(_total_bytesize.load(std::memory_order_relaxed), std::chrono::steady_clock::now() - _start_time);
     }
-}
 
-template <typename ResponseType>
-void SharedQueue<ResponseType>::push(ResponseType && response, size_t bytesize)
-{
-    _total_bytesize.fetch_add(bytesize, std::memory_order_relaxed);
-    push(std::move(response)); // Forward to the other push method
+    _done.notify_all();
 }
 
 template <typename ResponseType>
@@ -223,6 +384,8 @@ void SharedQueue<ResponseType>::cancel()
     {
         _ready.post();
     }
+
+    _done.notify_all();
 }
 
 template <typename ResponseType>
@@ -236,6 +399,11 @@ void SharedQueue<ResponseType>::stop()
             // If there are threads potentially blocked in pop() waiting on _ready,
             // we need to signal them to wake up and see the _stopped flag.
             needs_post = true; // Post regardless of _running, to unblock any waiter
+
+            if (_notification)
+            {
+                _notification();
+            }
         }
     }
 
@@ -249,6 +417,16 @@ void SharedQueue<ResponseType>::stop()
     {
         LOG(DEBUG) << "Responder already stopped or stop initiated by another thread (Type: " << typeid(ResponseType).name() << ")";
     }
+
+    _done.notify_all();
+}
+
+template <typename ResponseType>
+void SharedQueue<ResponseType>::wait_until_done()
+{
+    auto guard = std::unique_lock<std::mutex>(_mutex);
+    _done.wait(guard, [this]() { return _running == 0 || _canceled || _stopped.load(std::memory_order_relaxed); });
+    LOG(DEBUG) << "Responder done, responses in queue: " << _responses.size() << " (Type: " << typeid(ResponseType).name() << ")";
 }
 
 template <typename ResponseType>
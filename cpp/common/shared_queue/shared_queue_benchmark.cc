@@ -0,0 +1,92 @@
+#include "common/shared_queue/shared_queue.h"
+
+#include <benchmark/benchmark.h>
+
+#include <thread>
+#include <vector>
+
+#include "common/response/response.h"
+
+namespace runai::llm::streamer::common
+{
+
+// a single consumer popping the responses pushed by a number of producers
+void BM_SharedQueue(benchmark::State & state)
+{
+    const unsigned producers = state.range(0);
+    const unsigned responses = 1 << 16;
+    const unsigned per_producer = responses / producers;
+
+    for (auto _ : state)
+    {
+        SharedQueue<Response> queue(per_producer * producers);
+
+        std::vector<std::thread> threads;
+        for (unsigned i = 0; i < producers; ++i)
+        {
+            threads.emplace_back([&queue, i, per_producer]()
+            {
+                for (unsigned j = 0; j < per_producer; ++j)
+                {
+                    queue.push(Response(i, j, ResponseCode::Success));
+                }
+            });
+        }
+
+        for (unsigned i = 0; i < per_producer * producers; ++i)
+        {
+            benchmark::DoNotOptimize(queue.pop());
+        }
+
+        for (auto & thread : threads)
+        {
+            thread.join();
+        }
+    }
+
+    state.SetItemsProcessed(state.iterations() * per_producer * producers);
+}
+
+BENCHMARK(BM_SharedQueue)->RangeMultiplier(2)->Range(1, 32)->ArgName("producers")->UseRealTime();
+
+// a single consumer draining the responses without waiting, as the completion notifications do
+void BM_SharedQueue_TryPop(benchmark::State & state)
+{
+    const unsigned producers = state.range(0);
+    const unsigned responses = 1 << 16;
+    const unsigned per_producer = responses / producers;
+
+    for (auto _ : state)
+    {
+        SharedQueue<Response> queue(per_producer * producers);
+
+        std::vector<std::thread> threads;
+        for (unsigned i = 0; i < producers; ++i)
+        {
+            threads.emplace_back([&queue, i, per_producer]()
+            {
+                for (unsigned j = 0; j < per_producer; ++j)
+                {
+                    queue.push(Response(i, j, ResponseCode::Success));
+                }
+            });
+        }
+
+        std::vector<Response> popped;
+        while (queue.try_pop(popped, 1024) != ResponseCode::FinishedError)
+        {
+            benchmark::DoNotOptimize(popped.data());
+        }
+
+        for (auto & thread : threads)
+        {
+            thread.join();
+        }
+    }
+
+    state.SetItemsProcessed(state.iterations() * per_producer * producers);
+}
+
+BENCHMARK(BM_SharedQueue_TryPop)->RangeMultiplier(2)->Range(1, 32)->ArgName("producers")->UseRealTime();
+
+}; // namespace runai::llm::streamer::common
@@ -1,6 +1,7 @@
 #include "common/shared_queue/shared_queue.h"
 
 #include <gtest/gtest.h>
+#include <mutex>
 #include <set>
 #include <utility>
 
@@ -246,4 +247,244 @@ TEST(Stop, Sanity)
     }
 }
 
+TEST(Cancel, Waiting_Consumer)
+{
+    auto responder = SharedQueue<Response>(utils::random::number(1, 100));
+
+    auto waiting = utils::Thread([&]()
+    {
+        auto r = responder.pop();
+        EXPECT_EQ(r.ret, ResponseCode::FinishedError);
+    });
+
+    usleep(utils::random::number(100 * 1000));
+    responder.cancel();
+    waiting.join();
+
+    EXPECT_TRUE(responder.finished());
+}
+
+TEST(WaitUntilDone, Sanity)
+{
+    auto size = utils::random::number(1, 100);
+    auto responder = SharedQueue<Response>(size);
+
+    auto pool = utils::ThreadPool<unsigned>([&](unsigned i, std::atomic<bool> &)
+    {
+        usleep(utils::random::number(1000));
+        responder.push(i);
+    }, utils::random::number(1, 10));
+
+    for (unsigned i = 0; i < size; ++i)
+    {
+        unsigned value = i;
+        pool.push(std::move(value));
+    }
+
+    responder.wait_until_done();
+
+    // responses are not consumed
+    for (unsigned i = 0; i < size; ++i)
+    {
+        auto r = responder.pop();
+        EXPECT_EQ(r.ret, ResponseCode::Success);
+    }
+
+    EXPECT_TRUE(responder.finished());
+}
+
+TEST(WaitUntilDone, Stop)
+{
+    auto responder = SharedQueue<Response>(utils::random::number(1, 100));
+
+    auto waiting = utils::Thread([&]()
+    {
+        responder.wait_until_done();
+    });
+
+    usleep(utils::random::number(100 * 1000));
+    responder.stop();
+}
+
+TEST(TryPop, Sanity)
+{
+    auto size = utils::random::number(1, 100);
+    auto responder = SharedQueue<Response>(size);
+
+    std::vector<Response> responses;
+    EXPECT_EQ(responder.try_pop(responses, size), ResponseCode::Success);
+    EXPECT_EQ(responses.size(), 0);
+
+    std::vector<Response> pushed;
+    for (unsigned i = 0; i < size; ++i)
+    {
+        pushed.emplace_back(i);
+    }
+    responder.push(std::move(pushed), size);
+
+    const auto max = utils::random::number(1, size);
+    EXPECT_EQ(responder.try_pop(responses, max), ResponseCode::Success);
+    EXPECT_EQ(responses.size(), max);
+
+    for (unsigned i = 0; i < max; ++i)
+    {
+        EXPECT_EQ(responses[i].index, i);
+    }
+
+    // the remaining responses can be popped
+    for (unsigned i = max; i < size; ++i)
+    {
+        auto r = responder.pop();
+        EXPECT_EQ(r.index, i);
+    }
+
+    EXPECT_EQ(responder.try_pop(responses, size), ResponseCode::FinishedError);
+}
+
+TEST(Handler, Sanity)
+{
+    auto size = utils::random::number(1, 100);
+    auto responder = SharedQueue<Response>(size);
+
+    std::mutex mutex;
+    std::set<unsigned> handled;
+    responder.set_handler([&](const std::vector<Response> & responses)
+    {
+        const auto guard = std::unique_lock<std::mutex>(mutex);
+        for (const auto & r : responses)
+        {
+            EXPECT_EQ(r.ret, ResponseCode::Success);
+            handled.insert(r.index);
+        }
+    });
+
+    auto pool = utils::ThreadPool<unsigned>([&](unsigned i, std::atomic<bool> &)
+    {
+        responder.push(i);
+    }, utils::random::number(1, 10));
+
+    for (unsigned i = 0; i < size; ++i)
+    {
+        unsigned value = i;
+        pool.push(std::move(value));
+    }
+
+    // returns after all the responses were handled
+    auto r = responder.pop();
+    EXPECT_EQ(r.ret, ResponseCode::FinishedError);
+    EXPECT_EQ(handled.size(), size);
+    EXPECT_TRUE(responder.finished());
+}
+
+TEST(Notification, Sanity)
+{
+    auto size = utils::random::number(1, 100);
+    auto responder = SharedQueue<Response>(size);
+
+    utils::Semaphore notified(0);
+    responder.set_notification([&]()
+    {
+        notified.post();
+    });
+
+    auto pool = utils::ThreadPool<unsigned>([&](unsigned i, std::atomic<bool> &)
+    {
+        responder.push(i);
+    }, utils::random::number(1, 10));
+
+    for (unsigned i = 0; i < size; ++i)
+    {
+        unsigned value = i;
+        pool.push(std::move(value));
+    }
+
+    unsigned received = 0;
+    std::vector<Response> responses;
+    while (true)
+    {
+        notified.wait();
+        if (responder.try_pop(responses, utils::random::number(1, 10)) == ResponseCode::FinishedError)
+        {
+            break;
+        }
+        received += responses.size();
+        // drain the remaining ready responses
+        while (responder.try_pop(responses, size) == ResponseCode::Success && responses.size() > 0)
+        {
+            received += responses.size();
+        }
+        if (received == size)
+        {
+            break;
+        }
+    }
+
+    EXPECT_EQ(received, size);
+    EXPECT_TRUE(responder.finished());
+}
+
+TEST(Notification, Stop)
+{
+    auto responder = SharedQueue<Response>(utils::random::number(1, 100));
+
+    unsigned notifications = 0;
+    responder.set_notification([&]()
+    {
+        ++notifications;
+    });
+
+    responder.stop();
+    EXPECT_EQ(notifications, 1);
+
+    std::vector<Response> responses;
+    EXPECT_EQ(responder.try_pop(responses, 1), ResponseCode::FinishedError);
+
+    // stopping again does not notify
+    responder.stop();
+    EXPECT_EQ(notifications, 1);
+}
+
+TEST(Completion, Sanity)
+{
+    auto size = utils::random::number(1, 100);
+    auto bytesize = utils::random::number(1, 1000);
+    auto responder = SharedQueue<Response>(size);
+
+    unsigned completions = 0;
+    size_t completed_bytesize = 0;
+    responder.set_completion([&](size_t bytesize, std::chrono::steady_clock::duration elapsed)
+    {
+        ++completions;
+        completed_bytesize = bytesize;
+        EXPECT_GE(elapsed.count(), 0);
+    });
+
+    for (unsigned i = 0; i < size; ++i)
+    {
+        EXPECT_EQ(completions, 0);
+        responder.push(i, bytesize);
+    }
+
+    EXPECT_EQ(completions, 1);
+    EXPECT_EQ(completed_bytesize, size * bytesize);
+}
+
+TEST(Completion, Failure)
+{
+    auto size = utils::random::number(1, 100);
+    auto responder = SharedQueue<Response>(size);
+
+    bool completed = false;
+    responder.set_completion([&](size_t, std::chrono::steady_clock::duration) { completed = true; });
+
+    const auto failed = utils::random::number(size);
+    for (unsigned i = 0; i < size; ++i)
+    {
+        responder.push(Response(i, i == failed ? ResponseCode::FileAccessError : ResponseCode::Success));
+    }
+
+    // a failed request is not completed
+    EXPECT_FALSE(completed);
+}
+
 }; // namespace runai::llm::streamer::common
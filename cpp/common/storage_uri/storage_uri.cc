@@ -10,10 +10,11 @@ namespace runai::llm::streamer::common::s3
 
 static const std::string gcsProtocol("gs");
 static const std::string azureProtocol("az");
+static const std::string emulatedProtocol("emu");
 
 StorageUri::StorageUri(const std::string & uri) : uri(uri)
 {
-    static const std::regex awsRegex("^(s3|gs|az)://([^/]+)/(.+)$");
+    static const std::regex awsRegex("^(s3|gs|az|emu)://([^/]+)/(.+)$");
 
     std::smatch match;
 
@@ -47,6 +48,11 @@ bool StorageUri::is_azure() const
     return scheme == azureProtocol;
 }
 
+bool StorageUri::is_emulated() const
+{
+    return scheme == emulatedProtocol;
+}
+
 StorageUri_C::StorageUri_C(const StorageUri & uri) :
     bucket(uri.bucket.c_str()),
     path(uri.path.c_str())
@@ -39,6 +39,20 @@ TEST(Uri, Valid_GCS_Path)
     EXPECT_EQ(uri->path, path);
 }
 
+TEST(Uri, Valid_Emulated_Path)
+{
+    auto bucket = utils::random::string();
+    auto path = utils::random::string() + "/" + utils::random::string();
+    std::unique_ptr<StorageUri> uri;
+    EXPECT_NO_THROW(uri = std::make_unique<StorageUri>("emu://" + bucket + "/" + path));
+    EXPECT_EQ(uri->scheme, "emu");
+    EXPECT_EQ(uri->bucket, bucket);
+    EXPECT_EQ(uri->path, path);
+    EXPECT_TRUE(uri->is_emulated());
+    EXPECT_FALSE(uri->is_gcs());
+    EXPECT_FALSE(uri->is_azure());
+}
+
 TEST(Valid, Empty_Path)
 {
     auto bucket = utils::random::string();
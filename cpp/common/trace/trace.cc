@@ -0,0 +1,215 @@
+#include "common/trace/trace.h"
+
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include <deque>
+#include <fstream>
+#include <iomanip>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <vector>
+
+#include "common/exception/exception.h"
+#include "utils/logging/logging.h"
+
+namespace runai::llm::streamer::common
+{
+
+std::atomic<bool> Trace::_enabled(false);
+
+namespace
+{
+
+struct Event
+{
+    const char * name;
+    Trace::Clock::time_point start;
+    Trace::Clock::duration duration;
+    size_t bytesize;
+};
+
+struct Ring
+{
+    Ring() : tid(::syscall(SYS_gettid))
+    {}
+
+    // written by the owning thread, and read while writing the trace
+    void push(const Event & event)
+    {
+        const auto guard = std::unique_lock<std::mutex>(mutex);
+        if (events.size() < Trace::capacity)
+        {
+            events.push_back(event);
+        }
+        else
+        {
+            events[recorded % Trace::capacity] = event;
+        }
+        ++recorded;
+    }
+
+    // the recorded events from the oldest
+    std::vector<Event> snapshot()
+    {
+        const auto guard = std::unique_lock<std::mutex>(mutex);
+        if (recorded <= Trace::capacity)
+        {
+            return events;
+        }
+
+        const auto oldest = events.begin() + recorded % Trace::capacity;
+        std::vector<Event> ordered(oldest, events.end());
+        ordered.insert(ordered.end(), events.begin(), oldest);
+        return ordered;
+    }
+
+    const long tid;
+    std::mutex mutex;
+    std::vector<Event> events;
+    size_t recorded = 0;
+};
+
+struct Registry
+{
+    std::shared_ptr<Ring> attach()
+    {
+        auto ring = std::make_shared<Ring>();
+        const auto guard = std::unique_lock<std::mutex>(mutex);
+        running.insert(ring);
+        return ring;
+    }
+
+    void detach(const std::shared_ptr<Ring> & ring)
+    {
+        const auto guard = std::unique_lock<std::mutex>(mutex);
+        running.erase(ring);
+
+        if (!ring->events.empty())
+        {
+            exited.push_back(ring);
+            if (exited.size() > Trace::max_exited)
+            {
+                exited.pop_front();
+            }
+        }
+    }
+
+    std::vector<std::shared_ptr<Ring>> rings()
+    {
+        const auto guard = std::unique_lock<std::mutex>(mutex);
+        std::vector<std::shared_ptr<Ring>> rings(exited.begin(), exited.end());
+        rings.insert(rings.end(), running.begin(), running.end());
+        return rings;
+    }
+
+    std::mutex mutex;
+    std::set<std::shared_ptr<Ring>> running;
+    std::deque<std::shared_ptr<Ring>> exited;
+    Trace::Clock::time_point origin;
+};
+
+// never destroyed, so that threads which exit during the process teardown can still detach
+Registry & registry()
+{
+    static auto __registry = new Registry();
+    return *__registry;
+}
+
+struct Local
+{
+    ~Local()
+    {
+        if (ring != nullptr)
+        {
+            registry().detach(ring);
+        }
+    }
+
+    Ring & get()
+    {
+        if (ring == nullptr)
+        {
+            ring = registry().attach();
+        }
+        return *ring;
+    }
+
+    std::shared_ptr<Ring> ring;
+};
+
+thread_local Local __local;
+
+double microseconds(Trace::Clock::duration duration)
+{
+    return std::chrono::duration<double, std::micro>(duration).count();
+}
+
+} // namespace
+
+void Trace::enable()
+{
+    static std::once_flag __once;
+    std::call_once(__once, []()
+    {
+        registry().origin = Clock::now();
+        LOG(INFO) << "Recording trace of the streamer threads";
+    });
+
+    _enabled = true;
+}
+
+void Trace::span(const char * name, Clock::time_point start, Clock::time_point end, size_t bytesize)
+{
+    if (!enabled())
+    {
+        return;
+    }
+
+    __local.get().push(Event{name, start, end - start, bytesize});
+}
+
+void Trace::write(const std::string & path)
+{
+    std::ofstream file(path);
+    if (!file)
+    {
+        LOG(ERROR) << "Failed to open trace file " << path;
+        throw Exception(ResponseCode::FileAccessError);
+    }
+
+    const auto origin = registry().origin;
+    const auto pid = ::getpid();
+
+    size_t written = 0;
+    file << std::fixed << std::setprecision(3) << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+    for (const auto & ring : registry().rings())
+    {
+        for (const auto & event : ring->snapshot())
+        {
+            file << (written++ ? ",\n" : "\n")
+                 << "{\"name\":\"" << event.name << "\",\"cat\":\"streamer\",\"ph\":\"X\""
+                 << ",\"ts\":" << microseconds(event.start - origin)
+                 << ",\"dur\":" << microseconds(event.duration)
+                 << ",\"pid\":" << pid << ",\"tid\":" << ring->tid;
+
+            if (event.bytesize)
+            {
+                file << ",\"args\":{\"bytes\":" << event.bytesize << "}";
+            }
+            file << "}";
+        }
+    }
+    file << "\n]}\n";
+
+    if (!file)
+    {
+        LOG(ERROR) << "Failed to write trace file " << path;
+        throw Exception(ResponseCode::FileAccessError);
+    }
+
+    LOG(INFO) << "Wrote " << written << " spans to trace file " << path;
+}
+
+}; // namespace runai::llm::streamer::common
@@ -0,0 +1,80 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <atomic>
+#include <chrono>
+#include <string>
+
+namespace runai::llm::streamer::common
+{
+
+// Timeline of the spans recorded by the threads of the process, written in the Chrome trace event format which Perfetto and chrome://tracing open
+//
+// Recording is opt-in, and a span costs a check of a flag while disabled
+// Every thread records into its own ring buffer, which keeps the most recent spans of the thread once it is full
+// Span names must be string literals, since only their address is recorded
+
+struct Trace
+{
+    using Clock = std::chrono::steady_clock;
+
+    // starts recording the spans of all the threads
+    static void enable();
+
+    static bool enabled()
+    {
+        return _enabled.load(std::memory_order_relaxed);
+    }
+
+    // records a span of the calling thread, with the number of bytes it handled if any
+    static void span(const char * name, Clock::time_point start, Clock::time_point end, size_t bytesize = 0);
+
+    // records the span of a scope
+    struct Scope
+    {
+        Scope(const char * name, size_t bytesize = 0) :
+            _name(name),
+            _bytesize(bytesize),
+            _recording(enabled())
+        {
+            if (_recording)
+            {
+                _start = Clock::now();
+            }
+        }
+
+        ~Scope()
+        {
+            if (_recording)
+            {
+                span(_name, _start, Clock::now(), _bytesize);
+            }
+        }
+
+        Scope(const Scope &)             = delete;
+        Scope & operator=(const Scope &) = delete;
+
+     private:
+        const char * _name;
+        size_t _bytesize;
+        const bool _recording;
+        Clock::time_point _start;
+    };
+
+    // writes the recorded spans of all the threads to a file, including the threads which exited
+    // throws FileAccessError if the file could not be written
+    static void write(const std::string & path);
+
+    // spans kept by each thread
+    static constexpr size_t capacity = 1 << 16;
+
+    // threads which exited and whose spans are kept
+    static constexpr size_t max_exited = 64;
+
+ private:
+    static std::atomic<bool> _enabled;
+};
+
+}; // namespace runai::llm::streamer::common
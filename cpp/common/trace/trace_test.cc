@@ -0,0 +1,117 @@
+#include "common/trace/trace.h"
+
+#include <gtest/gtest.h>
+
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "common/exception/exception.h"
+#include "utils/fd/fd.h"
+#include "utils/random/random.h"
+#include "utils/temp/file/file.h"
+
+namespace runai::llm::streamer::common
+{
+
+namespace
+{
+
+std::string read(const std::string & path)
+{
+    const auto data = utils::Fd::read(path);
+    return std::string(data.begin(), data.end());
+}
+
+size_t count(const std::string & text, const std::string & pattern)
+{
+    size_t count = 0;
+    for (auto pos = text.find(pattern); pos != std::string::npos; pos = text.find(pattern, pos + 1))
+    {
+        ++count;
+    }
+    return count;
+}
+
+} // namespace
+
+// runs first, before recording is enabled for the rest of the process
+TEST(Trace, Disabled)
+{
+    EXPECT_FALSE(Trace::enabled());
+
+    {
+        Trace::Scope scope("disabled");
+    }
+    Trace::span("disabled", Trace::Clock::now(), Trace::Clock::now());
+
+    utils::temp::Path path;
+    Trace::write(path.path);
+    EXPECT_EQ(count(read(path.path), "\"disabled\""), 0);
+}
+
+TEST(Trace, Spans)
+{
+    Trace::enable();
+    EXPECT_TRUE(Trace::enabled());
+
+    const auto num_threads = utils::random::number(1, 8);
+    const auto spans = utils::random::number(1, 100);
+    const auto bytesize = utils::random::number<size_t>(1, 1000000);
+
+    // spans of threads which exited are kept
+    std::vector<std::thread> threads;
+    for (unsigned i = 0; i < num_threads; ++i)
+    {
+        threads.emplace_back([&]()
+        {
+            for (unsigned j = 0; j < spans; ++j)
+            {
+                Trace::Scope scope("spans", bytesize);
+            }
+        });
+    }
+
+    for (auto & thread : threads)
+    {
+        thread.join();
+    }
+
+    utils::temp::Path path;
+    Trace::write(path.path);
+
+    const auto trace = read(path.path);
+    EXPECT_EQ(trace.find("{\"displayTimeUnit\":\"ms\",\"traceEvents\":["), 0);
+    EXPECT_EQ(trace.substr(trace.size() - 4), "\n]}\n");
+    EXPECT_EQ(count(trace, "\"name\":\"spans\""), num_threads * spans);
+    EXPECT_EQ(count(trace, "\"args\":{\"bytes\":" + std::to_string(bytesize) + "}"), num_threads * spans);
+}
+
+TEST(Trace, Ring)
+{
+    Trace::enable();
+
+    // the most recent spans of a thread are kept
+    std::thread([]()
+    {
+        const auto now = Trace::Clock::now();
+        for (size_t i = 0; i < Trace::capacity + 10; ++i)
+        {
+            Trace::span(i < 10 ? "ring_oldest" : "ring", now, now);
+        }
+    }).join();
+
+    utils::temp::Path path;
+    Trace::write(path.path);
+
+    const auto trace = read(path.path);
+    EXPECT_EQ(count(trace, "\"name\":\"ring_oldest\""), 0);
+    EXPECT_EQ(count(trace, "\"name\":\"ring\""), Trace::capacity);
+}
+
+TEST(Trace, Write_Error)
+{
+    EXPECT_THROW(Trace::write("/" + utils::random::string() + "/" + utils::random::string()), Exception);
+}
+
+}; // namespace runai::llm::streamer::common
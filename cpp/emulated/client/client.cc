@@ -0,0 +1,259 @@
+#include "emulated/client/client.h"
+
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <string>
+#include <thread>
+#include <utility>
+
+#include "common/exception/exception.h"
+#include "common/storage_uri/storage_uri.h"
+
+#include "utils/fd/fd.h"
+#include "utils/logging/logging.h"
+
+namespace runai::llm::streamer::impl::emulated
+{
+
+namespace
+{
+
+// connections poll for cancellation while waiting
+constexpr auto poll_interval = std::chrono::milliseconds(10);
+
+// chunks are copied in slices, which are paced separately
+constexpr size_t slice_bytesize = 256 * 1024;
+
+// returns false if canceled before the time point
+bool sleep_until(std::chrono::steady_clock::time_point time_point, const std::function<bool()> & canceled)
+{
+    while (!canceled())
+    {
+        const auto now = std::chrono::steady_clock::now();
+        if (now >= time_point)
+        {
+            return true;
+        }
+        std::this_thread::sleep_for(std::min<std::chrono::steady_clock::duration>(time_point - now, poll_interval));
+    }
+    return false;
+}
+
+// the aggregate bandwidth is set by the first client
+Pacer & bandwidth(size_t limit)
+{
+    static Pacer __bandwidth(limit);
+    return __bandwidth;
+}
+
+// clients draw from different streams of the seed
+std::atomic<unsigned> __clients(0);
+
+} // namespace
+
+EmulatedClient::EmulatedClient(const common::backend_api::ObjectClientConfig_t & config) :
+    _stop(false),
+    _chunk_bytesize(config.default_storage_chunk_size),
+    _model(Profile::from_env(), __clients++),
+    _bandwidth(bandwidth(_model.profile().bandwidth)),
+    _connections([this](Chunk && chunk, std::atomic<bool> & stopped) { transfer(std::move(chunk), stopped); }, _model.profile().connections)
+{}
+
+EmulatedClient::~EmulatedClient()
+{
+    // stop the connections from writing before they are joined
+    stop();
+    _requests.cancel();
+}
+
+bool EmulatedClient::verify_credentials(const common::backend_api::ObjectClientConfig_t & config) const
+{
+    return true;
+}
+
+std::string EmulatedClient::file(const char * path) const
+{
+    const auto uri = common::s3::StorageUri(path);
+    const auto & root = _model.profile().root;
+    return (root.empty() ? "" : root + "/") + uri.bucket + "/" + uri.path;
+}
+
+common::backend_api::Response EmulatedClient::async_read_response()
+{
+    return _requests.pop();
+}
+
+common::ResponseCode EmulatedClient::async_read_responses(std::vector<common::backend_api::Response> & responses, unsigned max_responses)
+{
+    return _requests.try_pop(responses, max_responses);
+}
+
+void EmulatedClient::set_notification(std::function<void()> notification)
+{
+    _requests.set_notification(notification);
+}
+
+common::ResponseCode EmulatedClient::async_read(const char * path, common::backend_api::ObjectRange_t range, char * destination_buffer, common::backend_api::ObjectRequestId_t request_id)
+{
+    if (_stop)
+    {
+        return common::ResponseCode::FinishedError;
+    }
+
+    // the range is divided into chunks (the last chunk takes the remainder)
+    const size_t chunks = (_chunk_bytesize == 0 ? 1UL : std::max(1UL, range.length / _chunk_bytesize));
+
+    auto request = std::make_shared<Request>();
+    request->id = request_id;
+    request->bytesize = range.length;
+    request->file = file(path);
+    request->remaining = chunks;
+
+    const auto pending = _requests.add();
+    request->responder = pending.responder;
+    const auto cancel_guard = pending.guard;
+
+    const auto now = std::chrono::steady_clock::now();
+
+    size_t offset = range.offset;
+    size_t remaining = range.length;
+    char * buffer = destination_buffer;
+
+    const auto guard = std::unique_lock<std::mutex>(_model_mutex);
+    for (size_t i = 0; i < chunks; ++i)
+    {
+        Chunk chunk;
+        chunk.request = request;
+        chunk.guard = cancel_guard;
+        chunk.offset = offset;
+        chunk.bytesize = (i == chunks - 1 ? remaining : _chunk_bytesize);
+        chunk.buffer = buffer;
+        chunk.outcome = _model.draw();
+        chunk.due = now + chunk.outcome.delay;
+
+        offset += chunk.bytesize;
+        remaining -= chunk.bytesize;
+        buffer += chunk.bytesize;
+
+        LOG(SPAM) << "Chunk of request " << request_id << " is delayed by " << chunk.outcome.delay.count() << " us after " << chunk.outcome.throttled << " throttled attempts";
+        _connections.push(std::move(chunk));
+    }
+
+    return common::ResponseCode::Success;
+}
+
+void EmulatedClient::transfer(Chunk && chunk, std::atomic<bool> & stopped)
+{
+    const auto canceled = [&]() { return stopped || _stop || chunk.guard->cancelled(); };
+
+    auto response_code = chunk.outcome.response_code;
+    if (!sleep_until(chunk.due, canceled))
+    {
+        response_code = common::ResponseCode::FinishedError;
+    }
+    else if (response_code == common::ResponseCode::Success)
+    {
+        response_code = copy(chunk, canceled);
+    }
+
+    auto & request = *chunk.request;
+    if (response_code == common::ResponseCode::FinishedError)
+    {
+        // canceled - the responder was already stopped
+        return;
+    }
+
+    if (response_code == common::ResponseCode::Success)
+    {
+        // send success response only if all the chunks have succeeded
+        if (request.remaining.fetch_sub(1) == 1)
+        {
+            request.responder->push(common::backend_api::Response(request.id, response_code, request.bytesize));
+        }
+    }
+    else if (!request.failed.exchange(true))
+    {
+        // a failure of any chunk fails the entire request, and is sent once
+        LOG(DEBUG) << "Emulated request " << request.id << " failed" << (chunk.outcome.throttled == Profile::max_attempts ? " after throttled attempts" : "");
+        request.responder->push(common::backend_api::Response(request.id, response_code));
+    }
+}
+
+common::ResponseCode EmulatedClient::copy(const Chunk & chunk, const std::function<bool()> & canceled)
+{
+    const auto & file = chunk.request->file;
+
+    utils::Fd fd(::open(file.c_str(), O_RDONLY));
+    if (fd.fd() == -1)
+    {
+        LOG(ERROR) << "Failed to open emulated object " << file;
+        return common::ResponseCode::FileAccessError;
+    }
+
+    // the chunk is transferred on a single connection
+    Pacer connection(_model.profile().connection_bandwidth);
+
+    size_t copied = 0;
+    while (copied < chunk.bytesize)
+    {
+        const auto bytesize = std::min(slice_bytesize, chunk.bytesize - copied);
+        if (!sleep_until(std::max(connection.reserve(bytesize), _bandwidth.reserve(bytesize)), canceled))
+        {
+            return common::ResponseCode::FinishedError;
+        }
+
+        if (!chunk.guard->enter())
+        {
+            return common::ResponseCode::FinishedError;
+        }
+        const auto result = ::pread(fd, chunk.buffer + copied, bytesize, chunk.offset + copied);
+        chunk.guard->leave();
+
+        if (result < 0)
+        {
+            LOG(ERROR) << "Failed to read emulated object " << file;
+            return common::ResponseCode::FileAccessError;
+        }
+
+        if (result == 0)
+        {
+            LOG(ERROR) << "Range of " << chunk.bytesize << " bytes at offset " << chunk.offset << " exceeds emulated object " << file;
+            return common::ResponseCode::EofError;
+        }
+
+        copied += result;
+    }
+
+    return common::ResponseCode::Success;
+}
+
+void EmulatedClient::stop()
+{
+    _stop = true;
+    _requests.stop();
+}
+
+void EmulatedClient::cancel()
+{
+    _requests.cancel();
+    LOG(DEBUG) << "Canceled emulated client requests";
+}
+
+std::string EmulatedClient::object_version(const char * path)
+{
+    const auto name = file(path);
+
+    struct stat st;
+    if (::stat(name.c_str(), &st) != 0)
+    {
+        LOG(ERROR) << "Failed to query version of emulated object " << name;
+        throw common::Exception(common::ResponseCode::FileAccessError);
+    }
+
+    return std::to_string(st.st_mtim.tv_sec) + "." + std::to_string(st.st_mtim.tv_nsec) + "-" + std::to_string(st.st_size);
+}
+
+}; // namespace runai::llm::streamer::impl::emulated
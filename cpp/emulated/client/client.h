@@ -0,0 +1,105 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "emulated/model/model.h"
+
+#include "common/backend_api/response/response.h"
+#include "common/client_mgr/client_mgr.h"
+#include "common/requests/requests.h"
+
+#include "utils/cancel_guard/cancel_guard.h"
+#include "utils/threadpool/threadpool.h"
+
+namespace runai::llm::streamer::impl::emulated
+{
+
+// Client of the emulated object store
+//
+// Reads are divided into chunks like the object storage clients do, and each chunk is a request on one of the connections of the client
+// A connection waits for the drawn latency of its request, and then copies the range of the object file into the destination buffer at the paced bandwidth
+
+struct EmulatedClient : common::IClient
+{
+    EmulatedClient(const common::backend_api::ObjectClientConfig_t & config);
+    ~EmulatedClient();
+
+    // the emulated object store does not authenticate
+    bool verify_credentials(const common::backend_api::ObjectClientConfig_t & config) const override;
+
+    common::ResponseCode async_read(const char * path, common::backend_api::ObjectRange_t range, char * destination_buffer, common::backend_api::ObjectRequestId_t request_id);
+
+    common::backend_api::Response async_read_response();
+
+    // returns up to max_responses ready responses without waiting, or FinishedError if no responses are expected
+    common::ResponseCode async_read_responses(std::vector<common::backend_api::Response> & responses, unsigned max_responses);
+
+    // notification of ready responses, or an empty notification to unregister
+    // when this returns the previous notification is not running and will not be called again
+    void set_notification(std::function<void()> notification);
+
+    // Stop sending requests and notify the waiting callers
+    void stop();
+
+    // Cancel the pending requests of the client, which remains usable for further requests
+    // Returns when no more data is written to the destination buffers of the canceled requests
+    void cancel();
+
+    // version of the object file, which changes whenever the file is modified
+    std::string object_version(const char * path);
+
+    // file of an object uri
+    std::string file(const char * path) const;
+
+ private:
+    using Responder = common::Requests::Responder;
+
+    struct Request
+    {
+        common::backend_api::ObjectRequestId_t id;
+        size_t bytesize;
+        std::string file;
+        std::shared_ptr<Responder> responder;
+        std::atomic<unsigned> remaining;
+        std::atomic<bool> failed = false;
+    };
+
+    struct Chunk
+    {
+        std::shared_ptr<Request> request;
+        std::shared_ptr<utils::CancelGuard> guard;
+        size_t offset = 0;
+        size_t bytesize = 0;
+        char * buffer = nullptr;
+        Outcome outcome;
+        // when the first byte arrives
+        std::chrono::steady_clock::time_point due;
+    };
+
+    // handles a chunk on a connection
+    void transfer(Chunk && chunk, std::atomic<bool> & stopped);
+    common::ResponseCode copy(const Chunk & chunk, const std::function<bool()> & canceled);
+
+    std::atomic<bool> _stop;
+    const size_t _chunk_bytesize;
+
+    Model _model;
+    std::mutex _model_mutex;
+
+    // bandwidth shared by the connections of all the clients
+    Pacer & _bandwidth;
+
+    // responses of the asynchronous requests
+    common::Requests _requests;
+
+    // last, so that the connections are joined before the members they use are destroyed
+    utils::ThreadPool<Chunk> _connections;
+};
+
+}; //namespace runai::llm::streamer::impl::emulated
@@ -0,0 +1,219 @@
+#include "emulated/client/client.h"
+
+#include <fcntl.h>
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "common/exception/exception.h"
+
+#include "utils/fd/fd.h"
+#include "utils/random/random.h"
+#include "utils/temp/dir/dir.h"
+#include "utils/temp/env/env.h"
+#include "utils/temp/file/file.h"
+
+namespace runai::llm::streamer::impl::emulated
+{
+
+struct ClientTest : ::testing::Test
+{
+    ClientTest() :
+        bucket(root.path),
+        data(utils::random::buffer(utils::random::number(1024, 1024 * 1024))),
+        object(bucket.path, utils::random::string(), data),
+        uri("emu://" + bucket.name + "/" + object.name),
+        env("RUNAI_STREAMER_EMULATED_ROOT", root.path)
+    {}
+
+    std::unique_ptr<EmulatedClient> create(size_t chunk_bytesize)
+    {
+        common::backend_api::ObjectClientConfig_t config;
+        config.endpoint_url = nullptr;
+        config.default_storage_chunk_size = chunk_bytesize;
+        config.initial_params = nullptr;
+        config.num_initial_params = 0;
+        return std::make_unique<EmulatedClient>(config);
+    }
+
+    utils::temp::Dir root;
+    utils::temp::Dir bucket;
+    std::vector<uint8_t> data;
+    utils::temp::File object;
+    std::string uri;
+    utils::temp::Env env;
+};
+
+TEST_F(ClientTest, File)
+{
+    auto client = create(utils::random::number(1024, 64 * 1024));
+    EXPECT_EQ(client->file(uri.c_str()), object.path);
+}
+
+TEST_F(ClientTest, Read)
+{
+    auto client = create(utils::random::number(1024, data.size() + 1));
+
+    std::vector<uint8_t> buffer(data.size());
+    const auto request_id = utils::random::number();
+    EXPECT_EQ(client->async_read(uri.c_str(), {0, data.size()}, reinterpret_cast<char *>(buffer.data()), request_id), common::ResponseCode::Success);
+
+    const auto response = client->async_read_response();
+    EXPECT_EQ(response.ret, common::ResponseCode::Success);
+    EXPECT_EQ(response.handle, request_id);
+    EXPECT_EQ(response.bytes_transferred, data.size());
+    EXPECT_EQ(buffer, data);
+}
+
+TEST_F(ClientTest, Ranges)
+{
+    auto client = create(utils::random::number(1024, 64 * 1024));
+
+    std::vector<uint8_t> buffer(data.size());
+    const auto ranges = utils::random::chunks(data.size(), utils::random::number(1, 10));
+
+    size_t offset = 0;
+    for (unsigned i = 0; i < ranges.size(); ++i)
+    {
+        EXPECT_EQ(client->async_read(uri.c_str(), {offset, ranges[i]}, reinterpret_cast<char *>(buffer.data()) + offset, i), common::ResponseCode::Success);
+        offset += ranges[i];
+    }
+
+    for (unsigned i = 0; i < ranges.size(); ++i)
+    {
+        EXPECT_EQ(client->async_read_response().ret, common::ResponseCode::Success);
+    }
+    EXPECT_EQ(client->async_read_response().ret, common::ResponseCode::FinishedError);
+    EXPECT_EQ(buffer, data);
+}
+
+TEST_F(ClientTest, Latency)
+{
+    const unsigned long latency = utils::random::number(20, 50);
+    utils::temp::Env latency_env("RUNAI_STREAMER_EMULATED_LATENCY_US", latency * 1000);
+
+    auto client = create(data.size());
+
+    std::vector<uint8_t> buffer(data.size());
+    const auto start = std::chrono::steady_clock::now();
+    EXPECT_EQ(client->async_read(uri.c_str(), {0, data.size()}, reinterpret_cast<char *>(buffer.data()), 0), common::ResponseCode::Success);
+    EXPECT_EQ(client->async_read_response().ret, common::ResponseCode::Success);
+
+    EXPECT_GE(std::chrono::steady_clock::now() - start, std::chrono::milliseconds(latency));
+    EXPECT_EQ(buffer, data);
+}
+
+TEST_F(ClientTest, Bandwidth)
+{
+    // the object is transferred in about 100 milliseconds
+    const unsigned long bandwidth = data.size() * 10;
+    utils::temp::Env bandwidth_env("RUNAI_STREAMER_EMULATED_CONNECTION_BANDWIDTH", bandwidth);
+
+    auto client = create(data.size());
+
+    std::vector<uint8_t> buffer(data.size());
+    const auto start = std::chrono::steady_clock::now();
+    EXPECT_EQ(client->async_read(uri.c_str(), {0, data.size()}, reinterpret_cast<char *>(buffer.data()), 0), common::ResponseCode::Success);
+    EXPECT_EQ(client->async_read_response().ret, common::ResponseCode::Success);
+
+    EXPECT_GE(std::chrono::steady_clock::now() - start, std::chrono::milliseconds(90));
+    EXPECT_EQ(buffer, data);
+}
+
+TEST_F(ClientTest, Fault)
+{
+    utils::temp::Env fault_env("RUNAI_STREAMER_EMULATED_FAULT_PROBABILITY", "1");
+
+    auto client = create(utils::random::number(1024, 64 * 1024));
+
+    std::vector<uint8_t> buffer(data.size());
+    const auto request_id = utils::random::number();
+    EXPECT_EQ(client->async_read(uri.c_str(), {0, data.size()}, reinterpret_cast<char *>(buffer.data()), request_id), common::ResponseCode::Success);
+
+    // a failed request has a single response
+    const auto response = client->async_read_response();
+    EXPECT_EQ(response.ret, common::ResponseCode::FileAccessError);
+    EXPECT_EQ(response.handle, request_id);
+    EXPECT_EQ(client->async_read_response().ret, common::ResponseCode::FinishedError);
+}
+
+TEST_F(ClientTest, Missing_Object)
+{
+    auto client = create(data.size());
+
+    std::vector<uint8_t> buffer(data.size());
+    const auto missing = "emu://" + bucket.name + "/" + utils::random::string();
+    EXPECT_EQ(client->async_read(missing.c_str(), {0, data.size()}, reinterpret_cast<char *>(buffer.data()), 0), common::ResponseCode::Success);
+    EXPECT_EQ(client->async_read_response().ret, common::ResponseCode::FileAccessError);
+}
+
+TEST_F(ClientTest, Out_Of_Range)
+{
+    auto client = create(data.size());
+
+    std::vector<uint8_t> buffer(data.size());
+    EXPECT_EQ(client->async_read(uri.c_str(), {1, data.size()}, reinterpret_cast<char *>(buffer.data()), 0), common::ResponseCode::Success);
+    EXPECT_EQ(client->async_read_response().ret, common::ResponseCode::EofError);
+}
+
+TEST_F(ClientTest, Cancel)
+{
+    utils::temp::Env latency_env("RUNAI_STREAMER_EMULATED_LATENCY_US", 10UL * 1000 * 1000);
+
+    auto client = create(utils::random::number(1024, 64 * 1024));
+
+    std::vector<uint8_t> buffer(data.size());
+    const auto start = std::chrono::steady_clock::now();
+    EXPECT_EQ(client->async_read(uri.c_str(), {0, data.size()}, reinterpret_cast<char *>(buffer.data()), 0), common::ResponseCode::Success);
+
+    client->cancel();
+    std::vector<common::backend_api::Response> responses;
+    EXPECT_EQ(client->async_read_responses(responses, 1), common::ResponseCode::FinishedError);
+    EXPECT_TRUE(responses.empty());
+
+    // the connections do not wait for the latency of the canceled requests
+    client.reset();
+    EXPECT_LT(std::chrono::steady_clock::now() - start, std::chrono::seconds(1));
+}
+
+TEST_F(ClientTest, Stop)
+{
+    utils::temp::Env latency_env("RUNAI_STREAMER_EMULATED_LATENCY_US", 10UL * 1000 * 1000);
+
+    auto client = create(data.size());
+
+    std::vector<uint8_t> buffer(data.size());
+    EXPECT_EQ(client->async_read(uri.c_str(), {0, data.size()}, reinterpret_cast<char *>(buffer.data()), 0), common::ResponseCode::Success);
+
+    std::thread stopper([&]()
+    {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        client->stop();
+    });
+
+    EXPECT_EQ(client->async_read_response().ret, common::ResponseCode::FinishedError);
+    stopper.join();
+
+    EXPECT_EQ(client->async_read(uri.c_str(), {0, data.size()}, reinterpret_cast<char *>(buffer.data()), 0), common::ResponseCode::FinishedError);
+}
+
+TEST_F(ClientTest, Version)
+{
+    auto client = create(data.size());
+
+    const auto version = client->object_version(uri.c_str());
+    EXPECT_EQ(client->object_version(uri.c_str()), version);
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    utils::Fd::write(object.path, utils::random::buffer(data.size() + 1), O_WRONLY | O_TRUNC, 0644);
+    EXPECT_NE(client->object_version(uri.c_str()), version);
+
+    const auto missing = "emu://" + bucket.name + "/" + utils::random::string();
+    EXPECT_THROW(client->object_version(missing.c_str()), common::Exception);
+}
+
+}; // namespace runai::llm::streamer::impl::emulated
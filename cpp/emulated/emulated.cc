@@ -0,0 +1,259 @@
+#include <cstring>
+
+#include "emulated/emulated.h"
+#include "emulated/client/client.h"
+#include "common/client_mgr/client_mgr.h"
+
+#include "common/exception/exception.h"
+
+namespace runai::llm::streamer::impl::emulated
+{
+
+inline constexpr char EmulatedClientName[] = "Emulated";
+using EmulatedClientMgr = common::ClientMgr<EmulatedClient, EmulatedClientName>;
+
+common::backend_api::ResponseCode_t obj_open_backend(common::backend_api::ObjectBackendHandle_t* out_backend_handle)
+{
+    // the emulated object store does not require any global initialization
+    return common::ResponseCode::Success;
+}
+
+common::backend_api::ResponseCode_t obj_close_backend(common::backend_api::ObjectBackendHandle_t backend_handle)
+{
+    return common::ResponseCode::Success;
+}
+
+common::backend_api::ObjectShutdownPolicy_t obj_get_backend_shutdown_policy()
+{
+    return common::backend_api::OBJECT_SHUTDOWN_POLICY_ON_PROCESS_EXIT;
+}
+
+common::backend_api::ResponseCode_t obj_create_client(common::backend_api::ObjectBackendHandle_t backend_handle,
+                                                       const common::backend_api::ObjectClientConfig_t* client_initial_config,
+                                                       common::backend_api::ObjectClientHandle_t* out_client_handle)
+{
+    common::ResponseCode ret = common::ResponseCode::Success;
+    try
+    {
+        *out_client_handle = EmulatedClientMgr::pop(*client_initial_config);
+    }
+    catch(const common::Exception & e)
+    {
+        ret = e.error();
+        *out_client_handle = nullptr;
+    }
+    catch(const std::exception & e)
+    {
+        LOG(ERROR) << "Failed to create emulated client";
+        ret = common::ResponseCode::FileAccessError;
+        *out_client_handle = nullptr;
+    }
+    return ret;
+}
+
+common::backend_api::ResponseCode_t obj_remove_client(common::backend_api::ObjectClientHandle_t client_handle)
+{
+    common::ResponseCode ret = common::ResponseCode::Success;
+    try
+    {
+        if (client_handle)
+        {
+           EmulatedClientMgr::push(static_cast<EmulatedClient *>(client_handle));
+        }
+    }
+    catch(const std::exception & e)
+    {
+        LOG(ERROR) << "Failed to remove emulated client";
+        ret = common::ResponseCode::UnknownError;
+    }
+    return ret;
+}
+
+common::backend_api::ResponseCode_t obj_remove_all_clients()
+{
+    common::ResponseCode ret = common::ResponseCode::Success;
+    try
+    {
+        EmulatedClientMgr::clear();
+    }
+    catch(const std::exception & e)
+    {
+        LOG(ERROR) << "Failed to remove all emulated clients";
+        ret = common::ResponseCode::UnknownError;
+    }
+    return ret;
+}
+
+common::backend_api::ResponseCode_t obj_cancel_all_reads()
+{
+    common::ResponseCode ret = common::ResponseCode::Success;
+    try
+    {
+        EmulatedClientMgr::stop();
+    }
+    catch(const std::exception & e)
+    {
+        LOG(ERROR) << "Failed to stop all emulated clients";
+        ret = common::ResponseCode::UnknownError;
+    }
+    return ret;
+}
+
+common::backend_api::ResponseCode_t obj_cancel_reads(common::backend_api::ObjectClientHandle_t client_handle)
+{
+    try
+    {
+        if (!client_handle)
+        {
+            LOG(ERROR) << "Attempt to cancel reads of null emulated client";
+            return common::ResponseCode::UnknownError;
+        }
+        auto ptr = static_cast<EmulatedClient *>(client_handle);
+        ptr->cancel();
+        return common::ResponseCode::Success;
+    }
+    catch(const std::exception& e)
+    {
+        LOG(ERROR) << "Caught exception while canceling reads";
+    }
+    return common::ResponseCode::UnknownError;
+}
+
+common::backend_api::ResponseCode_t obj_get_object_version(common::backend_api::ObjectClientHandle_t client_handle, const char* path, char* out_version_buffer, unsigned int buffer_len)
+{
+    try
+    {
+        if (!client_handle)
+        {
+            LOG(ERROR) << "Attempt to query object version with null emulated client";
+            return common::ResponseCode::UnknownError;
+        }
+        auto ptr = static_cast<EmulatedClient *>(client_handle);
+        const auto version = ptr->object_version(path);
+        if (version.size() >= buffer_len)
+        {
+            LOG(ERROR) << "Version of object " << path << " does not fit in " << buffer_len << " bytes";
+            return common::ResponseCode::InvalidParameterError;
+        }
+        std::memcpy(out_version_buffer, version.c_str(), version.size() + 1);
+        return common::ResponseCode::Success;
+    }
+    catch(const common::Exception & e)
+    {
+        return e.error();
+    }
+    catch(const std::exception& e)
+    {
+        LOG(ERROR) << "Caught exception while querying object version";
+    }
+    return common::ResponseCode::UnknownError;
+}
+
+common::backend_api::ResponseCode_t obj_request_read(common::backend_api::ObjectClientHandle_t client_handle,
+                                                     const char* path,
+                                                     common::backend_api::ObjectRange_t range,
+                                                     char* destination_buffer,
+                                                     common::backend_api::ObjectRequestId_t request_id)
+{
+    try
+    {
+        if (!client_handle)
+        {
+            LOG(ERROR) << "Attempt to read with null emulated client";
+            return common::ResponseCode::UnknownError;
+        }
+        auto ptr = static_cast<EmulatedClient *>(client_handle);
+        return ptr->async_read(path, range, destination_buffer, request_id);
+    }
+    catch(const std::exception& e)
+    {
+        LOG(ERROR) << "Caught exception while sending async request";
+    }
+    return common::ResponseCode::UnknownError;
+}
+
+common::backend_api::ResponseCode_t obj_set_completion_notification(common::backend_api::ObjectClientHandle_t client_handle,
+                                                                     common::backend_api::ObjectCompletionNotification_t notification,
+                                                                     void* context)
+{
+    try
+    {
+        if (!client_handle)
+        {
+            LOG(ERROR) << "Attempt to set completion notification of null emulated client";
+            return common::ResponseCode::UnknownError;
+        }
+        auto ptr = static_cast<EmulatedClient *>(client_handle);
+        if (notification == nullptr)
+        {
+            ptr->set_notification(nullptr);
+        }
+        else
+        {
+            ptr->set_notification([notification, context]() { notification(context); });
+        }
+        return common::ResponseCode::Success;
+    }
+    catch(const std::exception& e)
+    {
+        LOG(ERROR) << "Caught exception while setting completion notification";
+    }
+    return common::ResponseCode::UnknownError;
+}
+
+common::backend_api::ResponseCode_t obj_wait_for_completions(common::backend_api::ObjectClientHandle_t client_handle,
+                                                              common::backend_api::ObjectCompletionEvent_t* event_buffer,
+                                                              unsigned int max_events_to_retrieve,
+                                                              unsigned int* out_num_events_retrieved,
+                                                              common::backend_api::ObjectWaitMode_t wait_mode)
+{
+    try
+    {
+        if (!client_handle)
+        {
+            LOG(ERROR) << "Attempt to get read response with null emulated client";
+            return common::ResponseCode::UnknownError;
+        }
+        if (max_events_to_retrieve == 0)
+        {
+            LOG(ERROR) << "Attempt to get read response with max_events_to_retrieve = 0";
+            return common::ResponseCode::UnknownError;
+        }
+        if (!event_buffer || !out_num_events_retrieved)
+        {
+            LOG(ERROR) << "Attempt to get read response with null event_buffer or out_num_events_retrieved";
+            return common::ResponseCode::UnknownError;
+        }
+
+        auto ptr = static_cast<EmulatedClient *>(client_handle);
+
+        if (wait_mode == common::backend_api::OBJECT_WAIT_MODE_NON_BLOCKING)
+        {
+            std::vector<common::backend_api::Response> responses;
+            auto ret = ptr->async_read_responses(responses, max_events_to_retrieve);
+            *out_num_events_retrieved = responses.size();
+            for (size_t i = 0; i < responses.size(); ++i)
+            {
+                event_buffer[i].request_id = responses[i].handle;
+                event_buffer[i].response_code = responses[i].ret;
+                event_buffer[i].bytes_transferred = responses[i].bytes_transferred;
+            }
+            return ret;
+        }
+
+        // for now reads a single event
+        auto response = ptr->async_read_response();
+        *out_num_events_retrieved = 1;
+        event_buffer[0].request_id = response.handle;
+        event_buffer[0].response_code = response.ret;
+        event_buffer[0].bytes_transferred = response.bytes_transferred;
+        return common::ResponseCode::Success;
+    }
+    catch(const std::exception& e)
+    {
+        LOG(ERROR) << "Caught exception while sending async request";
+    }
+    return common::ResponseCode::UnknownError;
+}
+
+}; // namespace runai::llm::streamer::impl::emulated
\ No newline at end of file
@@ -0,0 +1,191 @@
+#include "emulated/model/model.h"
+
+#include <algorithm>
+#include <cmath>
+#include <string>
+
+#include "common/exception/exception.h"
+
+#include "utils/env/env.h"
+#include "utils/logging/logging.h"
+
+namespace runai::llm::streamer::impl::emulated
+{
+
+namespace
+{
+
+double real(const std::string & variable, double def)
+{
+    std::string value;
+    if (!utils::try_getenv(variable, value))
+    {
+        return def;
+    }
+
+    double result;
+    try
+    {
+        result = std::stod(value);
+    }
+    catch (const std::exception &)
+    {
+        LOG(ERROR) << "Invalid value '" << value << "' of " << variable;
+        throw common::Exception(common::ResponseCode::InvalidParameterError);
+    }
+    return result;
+}
+
+double probability(const std::string & variable)
+{
+    const auto result = real(variable, 0);
+    if (!(result >= 0 && result <= 1))
+    {
+        LOG(ERROR) << variable << " must be a probability between 0 and 1 ; got " << result;
+        throw common::Exception(common::ResponseCode::InvalidParameterError);
+    }
+    return result;
+}
+
+std::mt19937_64 engine(unsigned seed, unsigned stream)
+{
+    std::seed_seq sequence{seed, stream};
+    return std::mt19937_64(sequence);
+}
+
+} // namespace
+
+Profile Profile::from_env()
+{
+    Profile profile;
+    profile.root = utils::getenv<std::string>("RUNAI_STREAMER_EMULATED_ROOT", "");
+    profile.latency = std::chrono::microseconds(utils::getenv<unsigned long>("RUNAI_STREAMER_EMULATED_LATENCY_US", 0UL));
+    profile.latency_sigma = real("RUNAI_STREAMER_EMULATED_LATENCY_SIGMA", 0);
+    profile.tail_probability = probability("RUNAI_STREAMER_EMULATED_TAIL_PROBABILITY");
+    profile.tail_alpha = real("RUNAI_STREAMER_EMULATED_TAIL_ALPHA", 1.5);
+    profile.connections = utils::getenv<unsigned long>("RUNAI_STREAMER_EMULATED_CONNECTIONS", 8UL);
+    profile.connection_bandwidth = utils::getenv<unsigned long>("RUNAI_STREAMER_EMULATED_CONNECTION_BANDWIDTH", 0UL);
+    profile.bandwidth = utils::getenv<unsigned long>("RUNAI_STREAMER_EMULATED_BANDWIDTH", 0UL);
+    profile.throttle_probability = probability("RUNAI_STREAMER_EMULATED_THROTTLE_PROBABILITY");
+    profile.fault_probability = probability("RUNAI_STREAMER_EMULATED_FAULT_PROBABILITY");
+    profile.seed = utils::getenv<unsigned long>("RUNAI_STREAMER_EMULATED_SEED", 0UL);
+
+    if (profile.connections == 0 || !(profile.latency_sigma >= 0) || !(profile.tail_alpha > 0))
+    {
+        LOG(ERROR) << "Invalid emulated object storage profile - " << profile;
+        throw common::Exception(common::ResponseCode::InvalidParameterError);
+    }
+
+    LOG(DEBUG) << "Emulated object storage profile - " << profile;
+    return profile;
+}
+
+std::ostream & operator<<(std::ostream & os, const Profile & profile)
+{
+    return os << "root '" << profile.root << "' ; latency " << profile.latency.count() << " us (sigma " << profile.latency_sigma
+              << ") ; tail probability " << profile.tail_probability << " alpha " << profile.tail_alpha
+              << " ; " << profile.connections << " connections of " << profile.connection_bandwidth << " bytes per second ; bandwidth " << profile.bandwidth
+              << " bytes per second ; throttle probability " << profile.throttle_probability << " ; fault probability " << profile.fault_probability
+              << " ; seed " << profile.seed;
+}
+
+Model::Model(const Profile & profile, unsigned stream) :
+    _profile(profile),
+    _engine(engine(profile.seed, stream))
+{}
+
+const Profile & Model::profile() const
+{
+    return _profile;
+}
+
+bool Model::chance(double probability)
+{
+    return probability > 0 && std::uniform_real_distribution<double>(0, 1)(_engine) < probability;
+}
+
+std::chrono::microseconds Model::latency()
+{
+    double microseconds = _profile.latency.count();
+
+    if (microseconds > 0 && _profile.latency_sigma > 0)
+    {
+        microseconds = std::lognormal_distribution<double>(std::log(microseconds), _profile.latency_sigma)(_engine);
+    }
+
+    if (chance(_profile.tail_probability))
+    {
+        // Pareto distributed factor of at least 1
+        const double u = std::uniform_real_distribution<double>(0, 1)(_engine);
+        microseconds *= std::pow(1 - u, -1 / _profile.tail_alpha);
+    }
+
+    // very heavy tails are capped to an hour
+    return std::chrono::microseconds(static_cast<int64_t>(std::min(microseconds, 3600e6)));
+}
+
+Outcome Model::attempt()
+{
+    Outcome outcome;
+    outcome.delay = latency();
+
+    if (chance(_profile.throttle_probability))
+    {
+        outcome.throttled = 1;
+        outcome.response_code = common::ResponseCode::FileAccessError;
+    }
+    else if (chance(_profile.fault_probability))
+    {
+        outcome.response_code = common::ResponseCode::FileAccessError;
+    }
+
+    return outcome;
+}
+
+Outcome Model::draw()
+{
+    Outcome outcome;
+
+    for (unsigned i = 0; ; ++i)
+    {
+        const auto result = attempt();
+        outcome.delay += result.delay;
+        outcome.response_code = result.response_code;
+
+        if (result.throttled == 0)
+        {
+            return outcome;
+        }
+
+        ++outcome.throttled;
+        if (outcome.throttled == Profile::max_attempts)
+        {
+            return outcome;
+        }
+
+        // exponential back off with full jitter
+        const auto backoff = std::chrono::duration_cast<std::chrono::microseconds>(Profile::backoff * (1u << i));
+        outcome.delay += std::chrono::microseconds(std::uniform_int_distribution<int64_t>(0, backoff.count())(_engine));
+    }
+}
+
+Pacer::Pacer(size_t bandwidth) :
+    _bandwidth(bandwidth)
+{}
+
+std::chrono::steady_clock::time_point Pacer::reserve(size_t bytesize)
+{
+    const auto now = std::chrono::steady_clock::now();
+    if (_bandwidth == 0)
+    {
+        return now;
+    }
+
+    const auto duration = std::chrono::duration_cast<std::chrono::steady_clock::duration>(std::chrono::duration<double>(static_cast<double>(bytesize) / _bandwidth));
+
+    const auto guard = std::unique_lock<std::mutex>(_mutex);
+    _next = std::max(now, _next) + duration;
+    return _next;
+}
+
+}; // namespace runai::llm::streamer::impl::emulated
@@ -0,0 +1,108 @@
+#pragma once
+
+#include <stddef.h>
+
+#include <chrono>
+#include <mutex>
+#include <ostream>
+#include <random>
+#include <string>
+
+#include "common/response_code/response_code.h"
+
+namespace runai::llm::streamer::impl::emulated
+{
+
+// Behavior of an emulated object store, which serves objects from a local directory
+//
+// Every request of a chunk waits for its first byte, drawn from a log-normal distribution around the median latency,
+// where a fraction of the requests takes a heavy tail latency - the drawn latency scaled by a Pareto distributed factor
+// The bytes are transferred on a connection capped to its own bandwidth, while all the connections share the aggregate bandwidth
+// Attempts may be throttled, and are then retried after an exponential back off like the SDKs do, until the request fails
+// Requests may also fail with an injected fault
+//
+// Drawing is reproducible for a given seed and order of requests
+
+struct Profile
+{
+    // reads the profile from the environment
+    static Profile from_env();
+
+    // directory of the buckets, where object emu://bucket/path is the file <root>/bucket/path
+    std::string root;
+
+    // median latency until the first byte, and the standard deviation of its logarithm
+    std::chrono::microseconds latency = std::chrono::microseconds(0);
+    double latency_sigma = 0;
+
+    // probability of a heavy tail latency, and the shape of its Pareto distribution (smaller is heavier)
+    double tail_probability = 0;
+    double tail_alpha = 1.5;
+
+    // connections of each client, which transfer chunks concurrently
+    unsigned connections = 8;
+
+    // bytes per second of a single connection and of all the connections together, where zero is unlimited
+    size_t connection_bandwidth = 0;
+    size_t bandwidth = 0;
+
+    // probabilities of a throttled attempt and of a failed request
+    double throttle_probability = 0;
+    double fault_probability = 0;
+
+    unsigned seed = 0;
+
+    // attempts of a throttled request, and the base of the back off between them
+    static constexpr unsigned max_attempts = 3;
+    static constexpr std::chrono::milliseconds backoff = std::chrono::milliseconds(50);
+};
+
+std::ostream & operator<<(std::ostream &, const Profile &);
+
+// Drawn behavior of a single request
+struct Outcome
+{
+    // time until the first byte, including the latencies and back offs of throttled attempts
+    std::chrono::microseconds delay = std::chrono::microseconds(0);
+    unsigned throttled = 0;
+    common::ResponseCode response_code = common::ResponseCode::Success;
+};
+
+struct Model
+{
+    // streams of the same seed draw different sequences, e.g. for different clients
+    Model(const Profile & profile, unsigned stream);
+
+    // a request, whose throttled attempts are retried
+    Outcome draw();
+
+    // a single attempt, which is not retried when throttled - e.g. a single HTTP request
+    Outcome attempt();
+
+    const Profile & profile() const;
+
+ private:
+    bool chance(double probability);
+    std::chrono::microseconds latency();
+
+    const Profile _profile;
+    std::mt19937_64 _engine;
+};
+
+// Paces transfers to a bandwidth - every transfer reserves its time after the transfers before it
+// A reservation which was not used is not given back, like bandwidth which was not used
+struct Pacer
+{
+    // bytes per second, where zero is unlimited
+    Pacer(size_t bandwidth);
+
+    // returns the time at which the transfer of the bytes completes
+    std::chrono::steady_clock::time_point reserve(size_t bytesize);
+
+ private:
+    const size_t _bandwidth;
+    std::mutex _mutex;
+    std::chrono::steady_clock::time_point _next;
+};
+
+}; // namespace runai::llm::streamer::impl::emulated
@@ -0,0 +1,248 @@
+#include "emulated/model/model.h"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <chrono>
+#include <vector>
+
+#include "common/exception/exception.h"
+
+#include "utils/random/random.h"
+#include "utils/temp/env/env.h"
+
+namespace runai::llm::streamer::impl::emulated
+{
+
+TEST(Profile, Default)
+{
+    const auto profile = Profile::from_env();
+    EXPECT_EQ(profile.root, "");
+    EXPECT_EQ(profile.latency.count(), 0);
+    EXPECT_EQ(profile.connections, 8);
+    EXPECT_EQ(profile.bandwidth, 0);
+    EXPECT_EQ(profile.throttle_probability, 0);
+    EXPECT_EQ(profile.fault_probability, 0);
+
+    Model model(profile, utils::random::number());
+    for (unsigned i = 0; i < 100; ++i)
+    {
+        const auto outcome = model.draw();
+        EXPECT_EQ(outcome.delay.count(), 0);
+        EXPECT_EQ(outcome.throttled, 0);
+        EXPECT_EQ(outcome.response_code, common::ResponseCode::Success);
+    }
+}
+
+TEST(Profile, Env)
+{
+    const auto root = utils::random::string();
+    const unsigned long latency = utils::random::number(1, 1000);
+    const unsigned long connections = utils::random::number(1, 100);
+
+    utils::temp::Env root_env("RUNAI_STREAMER_EMULATED_ROOT", root);
+    utils::temp::Env latency_env("RUNAI_STREAMER_EMULATED_LATENCY_US", latency);
+    utils::temp::Env sigma_env("RUNAI_STREAMER_EMULATED_LATENCY_SIGMA", "0.5");
+    utils::temp::Env tail_env("RUNAI_STREAMER_EMULATED_TAIL_PROBABILITY", "0.01");
+    utils::temp::Env connections_env("RUNAI_STREAMER_EMULATED_CONNECTIONS", connections);
+    utils::temp::Env throttle_env("RUNAI_STREAMER_EMULATED_THROTTLE_PROBABILITY", "0.25");
+
+    const auto profile = Profile::from_env();
+    EXPECT_EQ(profile.root, root);
+    EXPECT_EQ(profile.latency.count(), latency);
+    EXPECT_DOUBLE_EQ(profile.latency_sigma, 0.5);
+    EXPECT_DOUBLE_EQ(profile.tail_probability, 0.01);
+    EXPECT_DOUBLE_EQ(profile.tail_alpha, 1.5);
+    EXPECT_EQ(profile.connections, connections);
+    EXPECT_DOUBLE_EQ(profile.throttle_probability, 0.25);
+    EXPECT_EQ(profile.fault_probability, 0);
+}
+
+TEST(Profile, Invalid)
+{
+    {
+        utils::temp::Env env("RUNAI_STREAMER_EMULATED_FAULT_PROBABILITY", "1.5");
+        EXPECT_THROW(Profile::from_env(), common::Exception);
+    }
+    {
+        utils::temp::Env env("RUNAI_STREAMER_EMULATED_THROTTLE_PROBABILITY", "none");
+        EXPECT_THROW(Profile::from_env(), common::Exception);
+    }
+    {
+        utils::temp::Env env("RUNAI_STREAMER_EMULATED_CONNECTIONS", 0UL);
+        EXPECT_THROW(Profile::from_env(), common::Exception);
+    }
+}
+
+TEST(Model, Reproducible)
+{
+    Profile profile;
+    profile.latency = std::chrono::microseconds(utils::random::number(100, 1000));
+    profile.latency_sigma = 1;
+    profile.tail_probability = 0.1;
+    profile.throttle_probability = 0.1;
+    profile.fault_probability = 0.1;
+    profile.seed = utils::random::number();
+
+    const auto stream = utils::random::number();
+    Model model(profile, stream);
+    Model same(profile, stream);
+    Model other(profile, stream + 1);
+
+    bool different = false;
+    for (unsigned i = 0; i < 100; ++i)
+    {
+        const auto outcome = model.draw();
+        const auto expected = same.draw();
+        EXPECT_EQ(outcome.delay, expected.delay);
+        EXPECT_EQ(outcome.throttled, expected.throttled);
+        EXPECT_EQ(outcome.response_code, expected.response_code);
+
+        different |= (outcome.delay != other.draw().delay);
+    }
+    EXPECT_TRUE(different);
+}
+
+TEST(Model, Latency)
+{
+    Profile profile;
+    profile.latency = std::chrono::microseconds(utils::random::number(1000, 10000));
+    profile.latency_sigma = 0.5;
+
+    Model model(profile, utils::random::number());
+
+    std::vector<int64_t> delays;
+    for (unsigned i = 0; i < 10000; ++i)
+    {
+        delays.push_back(model.draw().delay.count());
+    }
+
+    std::sort(delays.begin(), delays.end());
+    const auto median = delays[delays.size() / 2];
+    EXPECT_NEAR(median, profile.latency.count(), profile.latency.count() * 0.1);
+    EXPECT_LT(delays.front(), profile.latency.count());
+    EXPECT_GT(delays.back(), profile.latency.count());
+}
+
+TEST(Model, Tail)
+{
+    Profile profile;
+    profile.latency = std::chrono::microseconds(utils::random::number(1000, 10000));
+    profile.tail_probability = 1;
+    profile.tail_alpha = 1;
+
+    Model model(profile, utils::random::number());
+
+    unsigned heavy = 0;
+    for (unsigned i = 0; i < 10000; ++i)
+    {
+        const auto delay = model.draw().delay;
+        EXPECT_GE(delay, profile.latency);
+        if (delay > profile.latency * 10)
+        {
+            ++heavy;
+        }
+    }
+
+    // a factor of alpha 1 exceeds 10 with probability 1/10
+    EXPECT_NEAR(heavy, 1000, 200);
+}
+
+TEST(Model, Throttle)
+{
+    Profile profile;
+    profile.throttle_probability = 1;
+
+    Model model(profile, utils::random::number());
+    for (unsigned i = 0; i < 10; ++i)
+    {
+        const auto outcome = model.draw();
+        EXPECT_EQ(outcome.throttled, Profile::max_attempts);
+        EXPECT_EQ(outcome.response_code, common::ResponseCode::FileAccessError);
+    }
+
+    profile.throttle_probability = 0.5;
+    Model half(profile, utils::random::number());
+
+    unsigned failed = 0;
+    for (unsigned i = 0; i < 10000; ++i)
+    {
+        const auto outcome = half.draw();
+        if (outcome.response_code != common::ResponseCode::Success)
+        {
+            ++failed;
+        }
+        else if (outcome.throttled > 0)
+        {
+            // backed off before the successful attempt
+            EXPECT_LE(outcome.delay, Profile::backoff * ((1u << outcome.throttled) - 1));
+        }
+    }
+
+    // failed if all the attempts were throttled
+    EXPECT_NEAR(failed, 10000 / 8, 200);
+}
+
+TEST(Model, Attempt)
+{
+    Profile profile;
+    profile.throttle_probability = 0.5;
+
+    Model model(profile, utils::random::number());
+
+    unsigned throttled = 0;
+    for (unsigned i = 0; i < 10000; ++i)
+    {
+        const auto outcome = model.attempt();
+        EXPECT_LE(outcome.throttled, 1);
+        EXPECT_EQ(outcome.response_code == common::ResponseCode::Success, outcome.throttled == 0);
+        throttled += outcome.throttled;
+    }
+
+    // throttled attempts are not retried
+    EXPECT_NEAR(throttled, 5000, 300);
+}
+
+TEST(Model, Fault)
+{
+    Profile profile;
+    profile.fault_probability = 1;
+
+    Model model(profile, utils::random::number());
+    for (unsigned i = 0; i < 10; ++i)
+    {
+        const auto outcome = model.draw();
+        EXPECT_EQ(outcome.throttled, 0);
+        EXPECT_EQ(outcome.response_code, common::ResponseCode::FileAccessError);
+    }
+}
+
+TEST(Pacer, Unlimited)
+{
+    Pacer pacer(0);
+    for (unsigned i = 0; i < 10; ++i)
+    {
+        const auto start = std::chrono::steady_clock::now();
+        const auto reserved = pacer.reserve(utils::random::number(1, 1000000));
+        EXPECT_GE(reserved, start);
+        EXPECT_LE(reserved, std::chrono::steady_clock::now());
+    }
+}
+
+TEST(Pacer, Rate)
+{
+    const size_t bandwidth = utils::random::number(1, 100) * 1024 * 1024;
+    Pacer pacer(bandwidth);
+
+    const auto start = std::chrono::steady_clock::now();
+    std::chrono::steady_clock::time_point end;
+    for (unsigned i = 0; i < 10; ++i)
+    {
+        end = pacer.reserve(bandwidth / 10);
+    }
+
+    // the transfers of a second of bandwidth complete a second after the first one started
+    EXPECT_NEAR(std::chrono::duration<double>(end - start).count(), 1, 0.05);
+}
+
+}; // namespace runai::llm::streamer::impl::emulated
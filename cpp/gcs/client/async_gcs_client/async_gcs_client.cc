@@ -9,6 +9,12 @@ namespace runai::llm::streamer::impl::gcs
 {
 
 void ReadObjectTask::execute() {
+    if (guard != nullptr && guard->cancelled()) {
+        // do not send canceled requests - the stream is not associated with any object
+        promise.set_value(google::cloud::storage::ObjectReadStream());
+        return;
+    }
+
     auto stream = taskFn();
     promise.set_value(std::move(stream));
 }
@@ -7,6 +7,7 @@
 #include "google/cloud/future.h"
 #include "google/cloud/storage/client.h"
 
+#include "utils/cancel_guard/cancel_guard.h"
 #include "utils/threadpool/threadpool.h"
 
 namespace runai::llm::streamer::impl::gcs
@@ -17,6 +18,7 @@ typedef std::function<google::cloud::storage::ObjectReadStream()> ReadObjectFn;
 struct ReadObjectTask {
     ReadObjectFn taskFn;
     google::cloud::promise<google::cloud::storage::ObjectReadStream> promise;
+    std::shared_ptr<utils::CancelGuard> guard;
 
 public:
     void execute();
@@ -39,6 +41,7 @@ public:
 
     template<typename... Options>
     google::cloud::future<google::cloud::storage::ObjectReadStream> ReadObjectAsync(
+        std::shared_ptr<utils::CancelGuard> guard,
         std::string const& bucket_name,
         std::string const& object_name,
         Options&&... opts)
@@ -51,7 +54,8 @@ public:
 
         ReadObjectTask task{
             std::move(readFn),
-            std::move(promise)
+            std::move(promise),
+            std::move(guard)
         };
 
         // Push the request onto the thread pool's queue for processing.
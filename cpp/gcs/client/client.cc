@@ -26,9 +26,14 @@ namespace runai::llm::streamer::impl::gcs
 
 GCSClient::GCSClient(const common::backend_api::ObjectClientConfig_t& config) :
     _stop(false),
-    _responder(nullptr),
     _chunk_bytesize(config.default_storage_chunk_size)
 {
+    if (_client_config.use_async)
+    {
+        _streaming_client = std::make_unique<StreamingGcsClient>(_client_config.options);
+        return;
+    }
+
     _client = std::make_unique<AsyncGcsClient>(
         _client_config.options, 
         _client_config.max_concurrency,
@@ -44,23 +49,45 @@ bool GCSClient::verify_credentials(const common::backend_api::ObjectClientConfig
 
 common::backend_api::Response GCSClient::async_read_response()
 {
-    if (_responder == nullptr)
-    {
-        LOG(WARNING) << "Requesting response with uninitialized responder";
-        return common::ResponseCode::FinishedError;
-    }
+    return _requests.pop();
+}
+
+common::ResponseCode GCSClient::async_read_responses(std::vector<common::backend_api::Response> & responses, unsigned max_responses)
+{
+    return _requests.try_pop(responses, max_responses);
+}
 
-    return _responder->pop();
+void GCSClient::set_notification(std::function<void()> notification)
+{
+    _requests.set_notification(notification);
 }
 
+// the stream is read in slices, so that a canceled read stops writing to the destination buffer without waiting for the entire range
+constexpr size_t slice_bytesize = 1024 * 1024;
+
 common::ResponseCode write_stream_to_buffer(
         google::cloud::storage::ObjectReadStream && stream,
         char * dest_buffer,
         size_t bytesize,
-        common::backend_api::ObjectRequestId_t request_id) {
+        common::backend_api::ObjectRequestId_t request_id,
+        utils::CancelGuard & cancel_guard) {
     size_t bytes_received = 0;
-    while (stream.read(dest_buffer, bytesize)) {
-        bytes_received += stream.gcount();
+    while (bytes_received < bytesize) {
+        if (!cancel_guard.enter()) {
+            LOG(SPAM) << "GCS read of request " << request_id << " was canceled";
+            stream.Close();
+            return common::ResponseCode::FinishedError;
+        }
+
+        stream.read(dest_buffer + bytes_received, std::min(slice_bytesize, bytesize - bytes_received));
+        const auto received = stream.gcount();
+
+        cancel_guard.leave();
+
+        bytes_received += received;
+        if (!stream || received == 0) {
+            break;
+        }
     }
     stream.Close();
     if (bytes_received != bytesize) {
@@ -81,14 +108,9 @@ common::ResponseCode write_stream_to_buffer(
 
 common::ResponseCode GCSClient::async_read(const char* path, common::backend_api::ObjectRange_t range, char* destination_buffer, common::backend_api::ObjectRequestId_t request_id)
 {
-    if (_responder == nullptr)
-    {
-        _responder = std::make_shared<Responder>(1);
-    }
-    else
-    {
-        _responder->increment(1);
-    }
+    const auto pending = _requests.add();
+    const auto responder = pending.responder;
+    const auto cancel_guard = pending.guard;
 
     char * buffer_ = destination_buffer;
     // split range into chunks
@@ -110,39 +132,57 @@ common::ResponseCode GCSClient::async_read(const char* path, common::backend_api
     size_t total_ = range.length;
     size_t offset_ = range.offset;
 
-    for (unsigned i = 0; i < size && !_stop; ++i)
+    // called once per chunk
+    auto on_chunk = [responder, request_id, counter, is_success, bytesize = range.length](common::ResponseCode response_code)
     {
-        size_t bytesize_ = (i == size - 1 ? total_ : _chunk_bytesize);
-
-        _client->ReadObjectAsync(bucket_name, path_name, google::cloud::storage::ReadRange(offset_, offset_ + bytesize_)).then(
-            [dest_buffer = buffer_, responder = _responder, request_id, bytesize_, counter, is_success](auto f) {
-            auto stream = f.get();
-            auto response_code = write_stream_to_buffer(std::move(stream), dest_buffer, bytesize_, request_id);
-            if (response_code == common::ResponseCode::Success)
+        if (response_code == common::ResponseCode::FinishedError)
+        {
+            // canceled - the responder was already stopped
+            return;
+        }
+        if (response_code == common::ResponseCode::Success)
+        {
+            const auto running = counter->fetch_sub(1);
+            LOG(SPAM) << "Async read request " << request_id << " succeeded - " << running << " running";
+            // send success response only if all the requests have succeeded
+            // note that unsuccessful attempts do not update the counter
+            if (running == 1)
             {
-                const auto running = counter->fetch_sub(1);
-                LOG(SPAM) << "Async read request " << request_id << " succeeded - " << running << " running";
-                // send success response only if all the requests have succeeded
-                // note that unsuccessful attempts do not update the counter
-                if (running == 1)
-                {
-                    common::backend_api::Response r(request_id, response_code);
-                    responder->push(std::move(r));
-                }
+                // every chunk verified that it received exactly its bytes
+                common::backend_api::Response r(request_id, response_code, bytesize);
+                responder->push(std::move(r));
             }
-            else
+        }
+        else
+        {
+            // Note: currently a failure to read any sub range fails the entire read request
+            //       a retry mechanism should be added for failed reads
+            bool previous = is_success->exchange(false);
+            // send error response only once
+            if (previous)
             {
-                // Note: currently a failure to read any sub range fails the entire read request
-                //       a retry mechanism should be added for failed reads
-                bool previous = is_success->exchange(false);
-                // send error response only once
-                if (previous)
-                {
-                    common::backend_api::Response r(request_id, response_code);
-                    responder->push(std::move(r));
-                }
+                common::backend_api::Response r(request_id, response_code);
+                responder->push(std::move(r));
             }
-        });
+        }
+    };
+
+    for (unsigned i = 0; i < size && !_stop; ++i)
+    {
+        size_t bytesize_ = (i == size - 1 ? total_ : _chunk_bytesize);
+
+        if (_streaming_client)
+        {
+            _streaming_client->read(cancel_guard, bucket_name, path_name, offset_, bytesize_, buffer_, on_chunk);
+        }
+        else
+        {
+            _client->ReadObjectAsync(cancel_guard, bucket_name, path_name, google::cloud::storage::ReadRange(offset_, offset_ + bytesize_)).then(
+                [dest_buffer = buffer_, cancel_guard, request_id, bytesize_, on_chunk](auto f) {
+                auto stream = f.get();
+                on_chunk(write_stream_to_buffer(std::move(stream), dest_buffer, bytesize_, request_id, *cancel_guard));
+            });
+        }
 
         total_ -= bytesize_;
         offset_ += bytesize_;
@@ -155,10 +195,29 @@ common::ResponseCode GCSClient::async_read(const char* path, common::backend_api
 void GCSClient::stop()
 {
     _stop = true;
-    if (_responder != nullptr)
+    _requests.stop();
+}
+
+void GCSClient::cancel()
+{
+    _requests.cancel();
+    LOG(DEBUG) << "Canceled GCS client requests";
+}
+
+std::string GCSClient::object_version(const char * path)
+{
+    const auto uri = common::s3::StorageUri(path);
+
+    // metadata queries are rare, and are sent by a synchronous client regardless of the reading mode
+    google::cloud::storage::Client client(_client_config.options);
+    const auto metadata = client.GetObjectMetadata(uri.bucket, uri.path);
+    if (!metadata)
     {
-        _responder->stop();
+        LOG(ERROR) << "Failed to query version of gcs object " << path << ": " << metadata.status().message();
+        throw common::Exception(common::ResponseCode::FileAccessError);
     }
+
+    return std::to_string(metadata->generation());
 }
 
 }; // namespace runai::llm::streamer::impl::gcs
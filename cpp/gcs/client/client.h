@@ -1,14 +1,17 @@
 #pragma once
 
 #include <atomic>
+#include <functional>
 #include <memory>
 #include <string>
 #include <optional>
 #include <vector>
 #include <future>
+#include <mutex>
 
 #include "gcs/client_configuration/client_configuration.h"
 #include "gcs/client/async_gcs_client/async_gcs_client.h"
+#include "gcs/client/streaming_gcs_client/streaming_gcs_client.h"
 
 #include "google/cloud/storage/client.h"
 #include "google/cloud/options.h"
@@ -17,7 +20,7 @@
 #include "common/client_mgr/client_mgr.h"
 #include "common/storage_uri/storage_uri.h"
 #include "common/s3_wrapper/s3_wrapper.h"
-#include "common/shared_queue/shared_queue.h"
+#include "common/requests/requests.h"
 #include "common/range/range.h"
 
 namespace runai::llm::streamer::impl::gcs
@@ -34,19 +37,34 @@ struct GCSClient : common::IClient
 
     common::backend_api::Response async_read_response();
 
+    // returns up to max_responses ready responses without waiting, or FinishedError if no responses are expected
+    common::ResponseCode async_read_responses(std::vector<common::backend_api::Response> & responses, unsigned max_responses);
+
+    // notification of ready responses, or an empty notification to unregister
+    // when this returns the previous notification is not running and will not be called again
+    void set_notification(std::function<void()> notification);
+
     // Stop sending requests to the object store
     // If stopped before all requests for an async_read() call are sent, subsequent request chunks will not be sent.
     void stop();
 
+    // Cancel the pending requests of the client, which remains usable for further requests
+    // Returns when no more data is written to the destination buffers of the canceled requests
+    void cancel();
+
+    // current version of the object, which changes whenever the object is modified
+    std::string object_version(const char * path);
+
  private:
     std::atomic<bool> _stop;
     ClientConfiguration _client_config;
     const size_t _chunk_bytesize;
+    // either a thread pool around the synchronous client, or native asynchronous streaming reads
     std::unique_ptr<AsyncGcsClient> _client;
+    std::unique_ptr<StreamingGcsClient> _streaming_client;
 
-    // queue of asynchronous responses
-    using Responder = common::SharedQueue<common::backend_api::Response>;
-    std::shared_ptr<Responder> _responder;
+    // responses of the asynchronous requests
+    common::Requests _requests;
 };
 
 }; //namespace runai::llm::streamer::impl::gcs
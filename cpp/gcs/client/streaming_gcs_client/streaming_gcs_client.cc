@@ -0,0 +1,145 @@
+#include "gcs/client/streaming_gcs_client/streaming_gcs_client.h"
+
+#include <cstring>
+#include <memory>
+#include <string>
+#include <utility>
+
+#include "google/storage/v2/storage.pb.h"
+
+#include "utils/logging/logging.h"
+
+namespace runai::llm::streamer::impl::gcs
+{
+
+namespace gcs_ex = google::cloud::storage_experimental;
+
+namespace
+{
+
+// state of a single read, owned by its pending continuation
+struct StreamingRead
+{
+    std::shared_ptr<utils::CancelGuard> guard;
+    char * destination_buffer;
+    size_t bytesize;
+    size_t received = 0;
+    gcs_ex::AsyncReader reader;
+    StreamingGcsClient::Callback callback;
+};
+
+void read_next(std::shared_ptr<StreamingRead> state, gcs_ex::AsyncToken token)
+{
+    if (!token.valid())
+    {
+        // end of stream
+        if (state->received != state->bytesize)
+        {
+            LOG(ERROR) << "GCS streaming read received " << state->received << " bytes, but " << state->bytesize << " were requested";
+            state->callback(common::ResponseCode::FileAccessError);
+            return;
+        }
+        state->callback(common::ResponseCode::Success);
+        return;
+    }
+
+    auto & reader = state->reader;
+    reader.Read(std::move(token)).then([state = std::move(state)](auto f) mutable
+    {
+        auto result = f.get();
+        if (!result)
+        {
+            LOG(ERROR) << "Failed to read GCS object " << result.status().code() << ": " << result.status().message();
+            state->callback(common::ResponseCode::FileAccessError);
+            return;
+        }
+
+        auto payload = std::move(result->first);
+        auto next_token = std::move(result->second);
+
+        if (!state->guard->enter())
+        {
+            // dropping the reader cancels the streaming rpc
+            LOG(SPAM) << "GCS streaming read was canceled";
+            state->callback(common::ResponseCode::FinishedError);
+            return;
+        }
+
+        bool overflow = false;
+        for (const auto & piece : payload.contents())
+        {
+            if (state->received + piece.size() > state->bytesize)
+            {
+                overflow = true;
+                break;
+            }
+            std::memcpy(state->destination_buffer + state->received, piece.data(), piece.size());
+            state->received += piece.size();
+        }
+
+        state->guard->leave();
+
+        if (overflow)
+        {
+            LOG(ERROR) << "GCS streaming read received more than the requested " << state->bytesize << " bytes";
+            state->callback(common::ResponseCode::FileAccessError);
+            return;
+        }
+
+        read_next(std::move(state), std::move(next_token));
+    });
+}
+
+} // namespace
+
+StreamingGcsClient::StreamingGcsClient(google::cloud::Options options) :
+    _client(std::make_unique<gcs_ex::AsyncClient>(std::move(options)))
+{
+    LOG(DEBUG) << "GCS client initialized with native asynchronous gRPC streaming reads";
+}
+
+void StreamingGcsClient::read(
+    std::shared_ptr<utils::CancelGuard> guard,
+    const std::string & bucket_name,
+    const std::string & object_name,
+    size_t offset,
+    size_t bytesize,
+    char * destination_buffer,
+    Callback callback)
+{
+    if (guard->cancelled())
+    {
+        // do not send canceled requests
+        callback(common::ResponseCode::FinishedError);
+        return;
+    }
+
+    google::storage::v2::ReadObjectRequest request;
+    // global bucket resource name of the gRPC api
+    request.set_bucket("projects/_/buckets/" + bucket_name);
+    request.set_object(object_name);
+    request.set_read_offset(static_cast<std::int64_t>(offset));
+    request.set_read_limit(static_cast<std::int64_t>(bytesize));
+
+    auto state = std::make_shared<StreamingRead>();
+    state->guard = std::move(guard);
+    state->destination_buffer = destination_buffer;
+    state->bytesize = bytesize;
+    state->callback = std::move(callback);
+
+    _client->ReadObject(std::move(request)).then([state = std::move(state)](auto f) mutable
+    {
+        auto result = f.get();
+        if (!result)
+        {
+            LOG(ERROR) << "Failed to open GCS object for reading " << result.status().code() << ": " << result.status().message();
+            state->callback(common::ResponseCode::FileAccessError);
+            return;
+        }
+
+        state->reader = std::move(result->first);
+        read_next(std::move(state), std::move(result->second));
+    });
+}
+
+}; // namespace runai::llm::streamer::impl::gcs
@@ -0,0 +1,44 @@
+#pragma once
+
+#include <functional>
+#include <memory>
+#include <string>
+
+#include "google/cloud/options.h"
+#include "google/cloud/storage/async/client.h"
+
+#include "common/response_code/response_code.h"
+
+#include "utils/cancel_guard/cancel_guard.h"
+
+namespace runai::llm::streamer::impl::gcs
+{
+
+/**
+ * Native asynchronous reads over the gRPC streaming API of google::cloud::storage_experimental::AsyncClient.
+ *
+ * Each read is a chain of continuations on the library's completion queue threads, which copy every
+ * received payload straight into the destination buffer - no thread is occupied while the read is in flight
+ * and the bytes do not pass through an iostream buffer.
+ */
+struct StreamingGcsClient
+{
+    // called once per read with Success, an error, or FinishedError if the read was canceled
+    using Callback = std::function<void(common::ResponseCode)>;
+
+    StreamingGcsClient(google::cloud::Options options);
+
+    void read(
+        std::shared_ptr<utils::CancelGuard> guard,
+        const std::string & bucket_name,
+        const std::string & object_name,
+        size_t offset,
+        size_t bytesize,
+        char * destination_buffer,
+        Callback callback);
+
+ private:
+    std::unique_ptr<google::cloud::storage_experimental::AsyncClient> _client;
+};
+
+}; // namespace runai::llm::streamer::impl::gcs
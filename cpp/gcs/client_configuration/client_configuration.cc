@@ -18,6 +18,12 @@ namespace runai::llm::streamer::impl::gcs
 ClientConfiguration::ClientConfiguration()
 {
     use_grpc = utils::getenv<bool>("RUNAI_STREAMER_GCS_USE_GRPC", false);
+    use_async = utils::getenv<bool>("RUNAI_STREAMER_GCS_USE_ASYNC", false);
+    if (use_async && !use_grpc)
+    {
+        LOG(DEBUG) << "GCS native asynchronous reads use the gRPC transport";
+        use_grpc = true;
+    }
 
     const auto max_connections = utils::getenv<unsigned long>("RUNAI_STREAMER_S3_MAX_CONNECTIONS", 0);
     if (max_connections) {
@@ -13,6 +13,8 @@ struct ClientConfiguration
     google::cloud::Options options;
     unsigned max_concurrency;
     bool use_grpc;
+    // native asynchronous streaming reads, which require the gRPC transport
+    bool use_async;
 };
 
 }; //namespace runai::llm::streamer::impl::gcs
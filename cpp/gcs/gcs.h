@@ -32,6 +32,12 @@ extern "C" common::backend_api::ResponseCode_t obj_request_read(
     common::backend_api::ObjectRequestId_t request_id
 );
 
+extern "C" common::backend_api::ResponseCode_t obj_set_completion_notification(
+    common::backend_api::ObjectClientHandle_t client_handle,
+    common::backend_api::ObjectCompletionNotification_t notification,
+    void* context
+);
+
 extern "C" common::backend_api::ResponseCode_t obj_wait_for_completions(common::backend_api::ObjectClientHandle_t client_handle,
                                                                         common::backend_api::ObjectCompletionEvent_t* event_buffer,
                                                                         unsigned int max_events_to_retrieve,
@@ -43,6 +49,13 @@ extern "C" common::backend_api::ResponseCode_t obj_wait_for_completions(common::
 // Stops the responder of each client, in order to notify callers which sent a request and are waiting for a response
 extern "C" common::backend_api::ResponseCode_t obj_cancel_all_reads();
 
+// cancel the pending reads of a single client
+// Returns when the client does not write to the destination buffers of the canceled reads anymore
+extern "C" common::backend_api::ResponseCode_t obj_cancel_reads(common::backend_api::ObjectClientHandle_t client_handle);
+
+// query the current version of an object, which changes whenever the object is modified
+extern "C" common::backend_api::ResponseCode_t obj_get_object_version(common::backend_api::ObjectClientHandle_t client_handle, const char* path, char* out_version_buffer, unsigned int buffer_len);
+
 // release clients
 extern "C" common::backend_api::ResponseCode_t obj_remove_all_clients();
 
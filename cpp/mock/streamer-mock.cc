@@ -1,6 +1,7 @@
 #include <fcntl.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <algorithm>
 #include <cstring>
 #include <vector>
 #include "utils/fd/fd.h"
@@ -23,6 +24,18 @@ std::vector<State> __multi_state;
 unsigned __multi_file_count = 0;
 unsigned __current_multi_file = 0;
 
+// statistics of the mock, named as the statistics of the library
+enum Stat : unsigned
+{
+    Requests,
+    FileBytes,
+    FileOps,
+    NumStats,
+};
+
+const char * __stat_names[NumStats] = { "requests", "file_bytes", "file_ops" };
+size_t __stats[NumStats] = {};
+
 
 int request(void * streamer, const char * path, size_t file_offset, size_t bytesize, char * dst, unsigned num_sizes, size_t * internal_sizes, State * state)
 {
@@ -72,6 +85,8 @@ int response(void * streamer, unsigned * index, State * state)
     }
 
     state->current_dst_offset += to_read;
+    __stats[FileBytes] += to_read;
+    ++__stats[FileOps];
     *index = state->current_item;
     state->current_item++;
     return 0;
@@ -107,6 +122,7 @@ extern "C" int runai_request(
     __multi_state.clear();
     __current_multi_file = 0;
     __multi_file_count = num_files;
+    ++__stats[Requests];
 
     int buffer_start = 0;
     for (unsigned i = 0; i < num_files; ++i) {
@@ -136,6 +152,153 @@ extern "C" int runai_response(void * streamer, unsigned * file_index, unsigned *
     return response(streamer, index, &state);
 }
 
+extern "C" int runai_responses(void * streamer, unsigned max_responses, unsigned * file_indices, unsigned * indices, int * response_codes, unsigned * num_responses)
+{
+    *num_responses = 0;
+    if (max_responses == 0)
+    {
+        return 0;
+    }
+
+    if (__current_multi_file >= __multi_state.size())
+    {
+        return 1; // finished
+    }
+
+    const auto ret = runai_response(streamer, file_indices, indices);
+    if (ret != 0)
+    {
+        return ret;
+    }
+
+    response_codes[0] = 0;
+    *num_responses = 1;
+    return 0;
+}
+
+extern "C" int runai_response_eventfd(void * streamer, int * fd)
+{
+    // not supported by the mock
+    return -1;
+}
+
+extern "C" int runai_set_completion_callback(void * streamer, void (*callback)(void *, unsigned, const unsigned *, const unsigned *, const int *), void * user_data)
+{
+    // not supported by the mock
+    return -1;
+}
+
+extern "C" int runai_set_readiness(void * streamer, unsigned * entries, unsigned num_entries)
+{
+    // not supported by the mock
+    return -1;
+}
+
+extern "C" int runai_wait_ready(unsigned * entry)
+{
+    // not supported by the mock
+    return -1;
+}
+
+extern "C" int runai_prefetch(
+    void * streamer,
+    unsigned num_files,
+    const char ** paths,
+    size_t * file_offsets,
+    size_t * bytesizes,
+    const char * key,
+    const char * secret,
+    const char * token,
+    const char * region,
+    const char * endpoint
+)
+{
+    if (streamer == nullptr)
+    {
+        return 7; // invalid parameter
+    }
+
+    // the mock has no local cache to prefetch object storage paths into, and reads files only when they are requested
+    for (unsigned i = 0; i < num_files; ++i)
+    {
+        if (std::strstr(paths[i], "://") != nullptr)
+        {
+            LOG(ERROR) << "Prefetching object storage path " << paths[i] << " without a local cache";
+            return 7; // invalid parameter
+        }
+    }
+
+    return 0;
+}
+
+extern "C" int runai_cancel_prefetch(void * streamer)
+{
+    return streamer == nullptr ? 7 : 0;
+}
+
+extern "C" int runai_set_weight(void * streamer, unsigned weight)
+{
+    if (streamer == nullptr || weight == 0)
+    {
+        return 7; // invalid parameter
+    }
+
+    // every streamer of the mock is served alone
+    return 0;
+}
+
+extern "C" int runai_get_stats(size_t * values, unsigned max_values, unsigned * num_values)
+{
+    if (num_values == nullptr || (values == nullptr && max_values > 0))
+    {
+        return 7; // invalid parameter
+    }
+
+    *num_values = NumStats;
+    if (values != nullptr)
+    {
+        std::memcpy(values, __stats, std::min<unsigned>(max_values, NumStats) * sizeof(size_t));
+    }
+    return 0;
+}
+
+extern "C" const char * runai_stat_name(unsigned index)
+{
+    return index < NumStats ? __stat_names[index] : nullptr;
+}
+
+extern "C" int runai_write_trace(const char * path)
+{
+    if (path == nullptr)
+    {
+        return 7; // invalid parameter
+    }
+
+    // the mock records no spans, and writes an empty trace in the format of the library
+    FILE * file = ::fopen(path, "w");
+    if (file == nullptr)
+    {
+        LOG(ERROR) << "Failed to open trace file " << path;
+        return 2; // file access error
+    }
+
+    const bool written = ::fputs("{\"displayTimeUnit\":\"ms\",\"traceEvents\":[]}\n", file) >= 0;
+    if (::fclose(file) != 0 || !written)
+    {
+        LOG(ERROR) << "Failed to write trace file " << path;
+        return 2; // file access error
+    }
+
+    return 0;
+}
+
+extern "C" int runai_cancel(void * streamer)
+{
+    __multi_state.clear();
+    __current_multi_file = 0;
+    return 0;
+}
+
 extern "C" const char * runai_response_str(int response_code)
 {
     return 0;
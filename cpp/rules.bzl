@@ -11,6 +11,17 @@ def runai_cc_test_dependencies():
         strip_prefix = "googletest-9816b96a6ddc0430671693df90192bbee57108b6",
     )
 
+def runai_cc_benchmark_dependencies():
+    http_archive(
+        name = "com_github_google_benchmark",
+        urls = [
+            "https://mirror.bazel.build/github.com/google/benchmark/archive/refs/tags/v1.8.3.tar.gz",
+            "https://github.com/google/benchmark/archive/refs/tags/v1.8.3.tar.gz",
+        ],
+        sha256 = "6bc180a57d23d4d9515519f92b0c83d61b05b5bab188961f36ac7b06b0d9e9ce",
+        strip_prefix = "benchmark-1.8.3",
+    )
+
 def _runai_cc_binary(rule, linkopts=[], rpath_origin=False, **kwargs):
     linkopts = linkopts + ["-Wl,--gc-sections", "-Wl,--fatal-warnings"]
 
@@ -32,6 +43,15 @@ def runai_cc_test(deps=[], linkopts=[], **kwargs):
         linkopts = linkopts + ["-lm"],
         **kwargs)
 
+# micro benchmarks are binaries tagged "benchmark", which `make benchmark` runs and collects their results as JSON
+def runai_cc_benchmark(deps=[], tags=[], linkopts=[], **kwargs):
+    _runai_cc_binary(
+        native.cc_binary,
+        deps=deps + ["//cc/benchmarking"],
+        tags=tags + ["benchmark"],
+        linkopts = linkopts + ["-lm"],
+        **kwargs)
+
 def runai_cc_library(copts=[], linkstatic=True, visibility=["//visibility:public"], **kwargs):
     native.cc_library(
         copts=copts + [
@@ -46,7 +66,7 @@ def runai_cc_library(copts=[], linkstatic=True, visibility=["//visibility:public
 def runai_cc_auto_library(hdrs=None, srcs=None, **kwargs):
     runai_cc_library(
         hdrs = hdrs if hdrs else native.glob(["**/*.h"]),
-        srcs = srcs if srcs else native.glob(["**/*.cc","**/*.inc"], exclude=["**/*_test*.cc"]),
+        srcs = srcs if srcs else native.glob(["**/*.cc","**/*.inc"], exclude=["**/*_test*.cc", "**/*_benchmark.cc"]),
         **kwargs
     )
 
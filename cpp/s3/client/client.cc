@@ -1,5 +1,7 @@
 
 #include <aws/s3-crt/model/GetObjectRequest.h>
+#include <aws/s3-crt/model/HeadObjectRequest.h>
+#include <aws/core/http/HttpRequest.h>
 
 #include <cstring>
 #include <algorithm>
@@ -9,6 +11,7 @@
 
 #include "common/backend_api/object_storage/object_storage.h"
 #include "s3/client/client.h"
+#include "s3/client/stream.h"
 
 #include "common/exception/exception.h"
 
@@ -100,8 +103,7 @@ bool S3ClientBase::verify_credentials(const common::backend_api::ObjectClientCon
 
 S3Client::S3Client(const common::backend_api::ObjectClientConfig_t & config) :
     S3ClientBase(config),
-    _stop(false),
-    _responder(nullptr)
+    _stop(false)
 {
     if (_endpoint.has_value()) // endpoint passed as parameter by user application (in credentials)
     {
@@ -131,6 +133,13 @@ S3Client::S3Client(const common::backend_api::ObjectClientConfig_t & config) :
         }
     }
 
+    if (_client_config.crt_multipart && _chunk_bytesize)
+    {
+        // the CRT downloads every range in parallel parts of the chunk size
+        LOG(DEBUG) << "Setting s3 configuration partSize to " << _chunk_bytesize;
+        _client_config.config.partSize = _chunk_bytesize;
+    }
+
     if (_client_credentials == nullptr)
     {
         _client = std::make_unique<Aws::S3Crt::S3CrtClient>(_client_config.config);
@@ -146,13 +155,17 @@ S3Client::S3Client(const common::backend_api::ObjectClientConfig_t & config) :
 // returns response object that contains the index of the range in ranges vector  which was passed in the request (0... number of ranges - 1)
 common::backend_api::Response S3Client::async_read_response()
 {
-    if (_responder == nullptr)
-    {
-        LOG(WARNING) << "Requesting response with uninitialized responder";
-        return common::ResponseCode::FinishedError;
-    }
+    return _requests.pop();
+}
 
-    return _responder->pop();
+common::ResponseCode S3Client::async_read_responses(std::vector<common::backend_api::Response> & responses, unsigned max_responses)
+{
+    return _requests.try_pop(responses, max_responses);
+}
+
+void S3Client::set_notification(std::function<void()> notification)
+{
+    _requests.set_notification(notification);
 }
 
 
@@ -161,14 +174,9 @@ common::backend_api::ResponseCode_t S3Client::async_read(const char* path,
                                                          char* destination_buffer,
                                                          common::backend_api::ObjectRequestId_t request_id)
 {
-    if (_responder == nullptr)
-    {
-        _responder = std::make_shared<Responder>(1);
-    }
-    else
-    {
-        _responder->increment(1);
-    }
+    const auto pending = _requests.add();
+    const auto responder = pending.responder;
+    const auto cancel_guard = pending.guard;
 
     const auto uri = common::s3::StorageUri(path);
 
@@ -176,8 +184,8 @@ common::backend_api::ResponseCode_t S3Client::async_read(const char* path,
     Aws::String path_name(uri.path);
 
     char * buffer_ = destination_buffer;
-    // split range into chunks
-    size_t size = std::max(1UL, range.length/_chunk_bytesize);
+    // split range into chunks, unless the CRT splits the range into parts by itself
+    size_t size = _client_config.crt_multipart ? 1UL : std::max(1UL, range.length/_chunk_bytesize);
     LOG(SPAM) <<"Number of chunks is " << size;
 
     // each range is divided into chunks (size is the number of chunks)
@@ -186,6 +194,8 @@ common::backend_api::ResponseCode_t S3Client::async_read(const char* path,
     auto counter = std::make_shared< std::atomic<unsigned> >(size);
     // success flag for the current range is passed to the client
     auto is_success = std::make_shared< std::atomic<bool> >(true);
+    // bytes written to the destination buffer by the succeeded chunks
+    auto transferred = std::make_shared< std::atomic<size_t> >(0);
 
     size_t total_ = range.length;
     size_t offset_ = range.offset;
@@ -202,44 +212,69 @@ common::backend_api::ResponseCode_t S3Client::async_read(const char* path,
         request->SetRange(range_str.c_str());
 
         request->SetResponseStreamFactory(
-            [buffer_, bytesize_]()
+            [buffer_, bytesize_, cancel_guard]()
             {
-                std::unique_ptr<Aws::StringStream>
-                        stream(Aws::New<Aws::StringStream>("RunaiBuffer"));
-
-                stream->rdbuf()->pubsetbuf(buffer_, bytesize_);
+                return Aws::New<BufferStream>("RunaiBuffer", buffer_, bytesize_, cancel_guard);
+            });
 
-                return stream.release();
+        // abort receiving the body of canceled requests
+        request->SetContinueRequestHandler(
+            [cancel_guard](const Aws::Http::HttpRequest *)
+            {
+                return !cancel_guard->cancelled();
             });
 
-        _client->GetObjectAsync(*request, [request, responder = _responder, request_id, counter, is_success](const Aws::S3Crt::S3CrtClient*, const Aws::S3Crt::Model::GetObjectRequest&,
+        _client->GetObjectAsync(*request, [request, responder, request_id, counter, is_success, transferred, bytesize_](const Aws::S3Crt::S3CrtClient*, const Aws::S3Crt::Model::GetObjectRequest&,
                                                                         const Aws::S3Crt::Model::GetObjectOutcome& outcome,
                                                                         const std::shared_ptr<const Aws::Client::AsyncCallerContext>&) {
-            if (outcome.IsSuccess())
+            // Note: currently a failure to read any sub range fails the entire read request
+            //       a retry mechanism should be added for failed reads
+            auto fail = [&](common::ResponseCode response_code)
             {
-                const auto running = counter->fetch_sub(1);
-                LOG(SPAM) << "Async read request " << request_id << " succeeded - " << running << " running";
-                // send success response only if all the requests have succeeded
-                // note that unsuccessful attempts do not update the counter
-                if (running == 1)
-                {
-                    common::backend_api::Response r(request_id, common::ResponseCode::Success);
-                    responder->push(std::move(r));
-                }
-            }
-            else
-            {
-                // Note: currently a failure to read any sub range fails the entire read request
-                //       a retry mechanism should be added for failed reads
                 bool previous = is_success->exchange(false);
                 // send error response only once
                 if (previous)
                 {
-                    const auto & err = outcome.GetError();
-                    LOG(ERROR) << "Failed to download s3 object of request " << request_id << " " << err.GetExceptionName() << ": " << err.GetMessage();
-                    common::backend_api::Response r(request_id, common::ResponseCode::FileAccessError);
+                    common::backend_api::Response r(request_id, response_code);
                     responder->push(std::move(r));
                 }
+            };
+
+            if (!outcome.IsSuccess())
+            {
+                const auto & err = outcome.GetError();
+                LOG(ERROR) << "Failed to download s3 object of request " << request_id << " " << err.GetExceptionName() << ": " << err.GetMessage();
+                fail(common::ResponseCode::FileAccessError);
+                return;
+            }
+
+            // the body is the stream created by the response stream factory
+            const auto * stream = dynamic_cast<const BufferStream *>(&outcome.GetResult().GetBody());
+            if (stream == nullptr)
+            {
+                LOG(ERROR) << "Unexpected body stream of request " << request_id;
+                fail(common::ResponseCode::UnknownError);
+                return;
+            }
+
+            // a body which does not fill the chunk exactly would leave a truncated tensor
+            if (stream->overflowed() || stream->bytes_written() != bytesize_)
+            {
+                LOG(ERROR) << "Received " << (stream->overflowed() ? "more than " : "") << stream->bytes_written() << " bytes of s3 object of request " << request_id << " ; expected " << bytesize_ << " bytes";
+                fail(stream->overflowed() ? common::ResponseCode::FileAccessError : common::ResponseCode::EofError);
+                return;
+            }
+
+            transferred->fetch_add(bytesize_);
+            const auto running = counter->fetch_sub(1);
+            LOG(SPAM) << "Async read request " << request_id << " succeeded - " << running << " running";
+            // send success response only if all the requests have succeeded
+            // note that unsuccessful attempts do not update the counter
+            if (running == 1)
+            {
+                // every chunk counted its bytes before counting itself as done
+                common::backend_api::Response r(request_id, common::ResponseCode::Success, transferred->load());
+                responder->push(std::move(r));
             }
         });
 
@@ -254,10 +289,32 @@ common::backend_api::ResponseCode_t S3Client::async_read(const char* path,
 void S3Client::stop()
 {
     _stop = true;
-    if (_responder != nullptr)
+    _requests.stop();
+}
+
+void S3Client::cancel()
+{
+    _requests.cancel();
+    LOG(DEBUG) << "Canceled S3 client requests";
+}
+
+std::string S3Client::object_version(const char * path)
+{
+    const auto uri = common::s3::StorageUri(path);
+
+    Aws::S3Crt::Model::HeadObjectRequest request;
+    request.SetBucket(Aws::String(uri.bucket));
+    request.SetKey(Aws::String(uri.path));
+
+    const auto outcome = _client->HeadObject(request);
+    if (!outcome.IsSuccess())
     {
-        _responder->stop();
+        const auto & err = outcome.GetError();
+        LOG(ERROR) << "Failed to query version of s3 object " << path << " " << err.GetExceptionName() << ": " << err.GetMessage();
+        throw common::Exception(common::ResponseCode::FileAccessError);
     }
+
+    return std::string(outcome.GetResult().GetETag().c_str());
 }
 
 }; // namespace runai::llm::streamer::impl::s3
@@ -1,9 +1,12 @@
 #pragma once
 
 #include <atomic>
+#include <functional>
 #include <memory>
+#include <mutex>
 #include <string>
 #include <optional>
+#include <vector>
 
 #include "s3/client_configuration/client_configuration.h"
 #include "common/backend_api/response/response.h"
@@ -12,7 +15,7 @@
 #include "common/client_mgr/client_mgr.h"
 #include "common/storage_uri/storage_uri.h"
 #include "common/s3_wrapper/s3_wrapper.h"
-#include "common/shared_queue/shared_queue.h"
+#include "common/requests/requests.h"
 #include "common/range/range.h"
 
 namespace runai::llm::streamer::impl::s3
@@ -49,11 +52,26 @@ struct S3Client : S3ClientBase
 
     common::backend_api::Response async_read_response();
 
+    // returns up to max_responses ready responses without waiting, or FinishedError if no responses are expected
+    common::ResponseCode async_read_responses(std::vector<common::backend_api::Response> & responses, unsigned max_responses);
+
+    // notification of ready responses, or an empty notification to unregister
+    // when this returns the previous notification is not running and will not be called again
+    void set_notification(std::function<void()> notification);
+
     // Stop sending requests to the object store
     // Requests that were already sent cannot be cancelled, since the Aws S3CrtClient does not support aborting requests
     // The S3CrtClient d'tor will wait for response of all teh sent requests, which can take a while
     void stop();
 
+    // Cancel the pending requests of the client, which remains usable for further requests
+    // Requests that were already sent keep running in the S3CrtClient, but their body is not written to the destination buffers anymore
+    // Returns when no more data is written to the destination buffers of the canceled requests
+    void cancel();
+
+    // current version of the object, which changes whenever the object is modified
+    std::string object_version(const char * path);
+
     using S3ClientBase::verify_credentials;
 
  private:
@@ -61,9 +79,8 @@ struct S3Client : S3ClientBase
     ClientConfiguration _client_config;
     std::unique_ptr<Aws::S3Crt::S3CrtClient> _client;
 
-    // queue of asynchronous responses
-    using Responder = common::SharedQueue<common::backend_api::Response>;
-    std::shared_ptr<Responder> _responder;
+    // responses of the asynchronous requests
+    common::Requests _requests;
 };
 
 }; //namespace runai::llm::streamer::impl::s3
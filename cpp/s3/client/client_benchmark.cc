@@ -0,0 +1,70 @@
+#include "s3/client/client.h"
+
+#include <benchmark/benchmark.h>
+
+#include <algorithm>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+#include "s3/s3_init/s3_init.h"
+
+#include "utils/env/env.h"
+#include "utils/temp/env/env.h"
+
+namespace runai::llm::streamer::impl::s3
+{
+
+// reading an S3 object in ranges, where the ranges are split into chunk requests by the client, or every range is a single request which the CRT splits into parts
+// the object is given by RUNAI_STREAMER_BENCHMARK_URI and RUNAI_STREAMER_BENCHMARK_BYTESIZE, and the object store by the usual environment variables (e.g. AWS_ENDPOINT_URL)
+void BM_Read(benchmark::State & state)
+{
+    const bool crt_multipart = state.range(0);
+    const size_t range_bytesize = state.range(1) * 1024 * 1024;
+    const size_t chunk_bytesize = 8 * 1024 * 1024;
+
+    const auto uri = utils::getenv<std::string>("RUNAI_STREAMER_BENCHMARK_URI", "");
+    const auto bytesize = utils::getenv<size_t>("RUNAI_STREAMER_BENCHMARK_BYTESIZE", 0);
+    if (uri.empty() || bytesize == 0)
+    {
+        state.SkipWithMessage("RUNAI_STREAMER_BENCHMARK_URI and RUNAI_STREAMER_BENCHMARK_BYTESIZE are not set");
+        return;
+    }
+
+    S3Init init;
+    const auto mode = utils::temp::Env("RUNAI_STREAMER_S3_CRT_MULTIPART", crt_multipart);
+    const char * endpoint = std::getenv("AWS_ENDPOINT_URL");
+    common::backend_api::ObjectClientConfig_t config{endpoint, chunk_bytesize, nullptr, 0};
+    S3Client client(config);
+
+    std::vector<char> buffer(bytesize);
+
+    for (auto _ : state)
+    {
+        size_t ranges = 0;
+        for (size_t offset = 0; offset < buffer.size(); offset += range_bytesize, ++ranges)
+        {
+            common::backend_api::ObjectRange_t range{offset, std::min(range_bytesize, buffer.size() - offset)};
+            if (client.async_read(uri.c_str(), range, buffer.data() + offset, ranges) != common::ResponseCode::Success)
+            {
+                state.SkipWithError("Failed sending a request");
+                return;
+            }
+        }
+
+        for (size_t i = 0; i < ranges; ++i)
+        {
+            if (client.async_read_response().ret != common::ResponseCode::Success)
+            {
+                state.SkipWithError("Failed reading a range");
+                return;
+            }
+        }
+    }
+
+    state.SetBytesProcessed(state.iterations() * bytesize);
+}
+
+BENCHMARK(BM_Read)->ArgsProduct({{0, 1}, {64, 1024}})->ArgNames({"crt_multipart", "range_mib"})->UseRealTime()->Unit(benchmark::kMillisecond);
+
+}; // namespace runai::llm::streamer::impl::s3
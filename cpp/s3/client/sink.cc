@@ -0,0 +1,58 @@
+#include "s3/client/sink.h"
+
+#include <algorithm>
+#include <cstring>
+
+#include "utils/logging/logging.h"
+
+namespace runai::llm::streamer::impl::s3
+{
+
+BufferStreambuf::BufferStreambuf(char * buffer, size_t bytesize) :
+    _buffer(buffer),
+    _bytesize(bytesize)
+{}
+
+std::streamsize BufferStreambuf::xsputn(const char * s, std::streamsize n)
+{
+    if (n <= 0)
+    {
+        return 0;
+    }
+
+    const auto bytesize = std::min(static_cast<size_t>(n), _bytesize - _offset);
+    std::memcpy(_buffer + _offset, s, bytesize);
+    _offset += bytesize;
+
+    if (bytesize < static_cast<size_t>(n))
+    {
+        LOG(ERROR) << "Received " << n << " bytes with only " << bytesize << " bytes left in destination buffer";
+        _overflowed = true;
+    }
+
+    return static_cast<std::streamsize>(bytesize);
+}
+
+BufferStreambuf::int_type BufferStreambuf::overflow(int_type ch)
+{
+    if (traits_type::eq_int_type(ch, traits_type::eof()))
+    {
+        return traits_type::not_eof(ch);
+    }
+
+    const char c = traits_type::to_char_type(ch);
+    return xsputn(&c, 1) == 1 ? ch : traits_type::eof();
+}
+
+BufferStreambuf::pos_type BufferStreambuf::seekoff(off_type off, std::ios_base::seekdir dir, std::ios_base::openmode which)
+{
+    // only reporting the current write position is supported
+    if (off == 0 && dir == std::ios_base::cur)
+    {
+        return pos_type(static_cast<off_type>(_offset));
+    }
+
+    return pos_type(off_type(-1));
+}
+
+}; // namespace runai::llm::streamer::impl::s3
@@ -0,0 +1,32 @@
+#pragma once
+
+#include <streambuf>
+
+namespace runai::llm::streamer::impl::s3
+{
+
+// Stream buffer over the destination buffer of a ranged read, so that the object body is written in place
+// The written bytes are counted, so that a body shorter or longer than the requested range is detected
+
+struct BufferStreambuf : std::streambuf
+{
+    BufferStreambuf(char * buffer, size_t bytesize);
+
+    size_t bytes_written() const { return _offset; }
+
+    // whether the body did not fit in the destination buffer
+    bool overflowed() const { return _overflowed; }
+
+ protected:
+    std::streamsize xsputn(const char * s, std::streamsize n) override;
+    int_type overflow(int_type ch) override;
+    pos_type seekoff(off_type off, std::ios_base::seekdir dir, std::ios_base::openmode which) override;
+
+ private:
+    char * _buffer;
+    size_t _bytesize;
+    size_t _offset = 0;
+    bool _overflowed = false;
+};
+
+}; // namespace runai::llm::streamer::impl::s3
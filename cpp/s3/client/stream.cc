@@ -0,0 +1,56 @@
+#include "s3/client/stream.h"
+
+#include "utils/logging/logging.h"
+
+namespace runai::llm::streamer::impl::s3
+{
+
+GuardedStreambuf::GuardedStreambuf(std::streambuf & streambuf, std::shared_ptr<utils::CancelGuard> guard) :
+    _streambuf(streambuf),
+    _guard(guard)
+{}
+
+std::streamsize GuardedStreambuf::xsputn(const char * s, std::streamsize n)
+{
+    if (n <= 0)
+    {
+        return 0;
+    }
+
+    if (!_guard->enter())
+    {
+        LOG(SPAM) << "Read was canceled - dropping " << n << " bytes";
+        return 0;
+    }
+
+    const auto written = _streambuf.sputn(s, n);
+
+    _guard->leave();
+    return written;
+}
+
+GuardedStreambuf::int_type GuardedStreambuf::overflow(int_type ch)
+{
+    if (traits_type::eq_int_type(ch, traits_type::eof()))
+    {
+        return traits_type::not_eof(ch);
+    }
+
+    const char c = traits_type::to_char_type(ch);
+    return xsputn(&c, 1) == 1 ? ch : traits_type::eof();
+}
+
+GuardedStreambuf::pos_type GuardedStreambuf::seekoff(off_type off, std::ios_base::seekdir dir, std::ios_base::openmode which)
+{
+    return _streambuf.pubseekoff(off, dir, which);
+}
+
+BufferStream::BufferStream(char * buffer, size_t bytesize, std::shared_ptr<utils::CancelGuard> guard) :
+    Aws::IOStream(nullptr),
+    _sink(buffer, bytesize),
+    _streambuf(_sink, guard)
+{
+    rdbuf(&_streambuf);
+}
+
+}; // namespace runai::llm::streamer::impl::s3
@@ -0,0 +1,44 @@
+#pragma once
+
+#include <aws/core/utils/memory/stl/AWSStreamFwd.h>
+
+#include <memory>
+#include <streambuf>
+
+#include "s3/client/sink.h"
+#include "utils/cancel_guard/cancel_guard.h"
+
+namespace runai::llm::streamer::impl::s3
+{
+
+// Stream buffer which guards the writes into another stream buffer, so that its memory is not accessed once the read was canceled
+
+struct GuardedStreambuf : std::streambuf
+{
+    GuardedStreambuf(std::streambuf & streambuf, std::shared_ptr<utils::CancelGuard> guard);
+
+ protected:
+    std::streamsize xsputn(const char * s, std::streamsize n) override;
+    int_type overflow(int_type ch) override;
+    pos_type seekoff(off_type off, std::ios_base::seekdir dir, std::ios_base::openmode which) override;
+
+ private:
+    std::streambuf & _streambuf;
+    std::shared_ptr<utils::CancelGuard> _guard;
+};
+
+// Body stream of a ranged read, which writes into the destination buffer unless the read was canceled
+
+struct BufferStream : Aws::IOStream
+{
+    BufferStream(char * buffer, size_t bytesize, std::shared_ptr<utils::CancelGuard> guard);
+
+    size_t bytes_written() const { return _sink.bytes_written(); }
+    bool overflowed() const { return _sink.overflowed(); }
+
+ private:
+    BufferStreambuf _sink;
+    GuardedStreambuf _streambuf;
+};
+
+}; // namespace runai::llm::streamer::impl::s3
@@ -21,6 +21,12 @@ ClientConfiguration::ClientConfiguration()
         config.throughputTargetGbps = target_gbps;
     }
 
+    crt_multipart = utils::getenv<bool>("RUNAI_STREAMER_S3_CRT_MULTIPART", false);
+    if (crt_multipart)
+    {
+        LOG(DEBUG) << "S3 ranges are split into parts by the CRT";
+    }
+
     // if the transfer speed is less than the low speed limit for request_timeout_ms milliseconds the transfer is aborted and retried
     const auto request_timeout_ms = utils::getenv<unsigned long>("RUNAI_STREAMER_S3_REQUEST_TIMEOUT_MS", 1000);
     if (request_timeout_ms)
@@ -14,6 +14,9 @@ struct ClientConfiguration
 {
     ClientConfiguration();
     Aws::S3Crt::ClientConfiguration config;
+
+    // submit a single request per range, and let the CRT split it into parts of config.partSize
+    bool crt_multipart = false;
 };
 
 }; //namespace runai::llm::streamer::impl::s3
@@ -1,3 +1,5 @@
+#include <cstring>
+
 #include "s3/s3.h"
 #include "s3/s3_init/s3_init.h"
 #include "s3/client/client.h"
@@ -145,6 +147,56 @@ common::backend_api::ResponseCode_t obj_cancel_all_reads()
     return ret;
 }
 
+common::backend_api::ResponseCode_t obj_cancel_reads(common::backend_api::ObjectClientHandle_t client_handle)
+{
+    try
+    {
+        if (!client_handle)
+        {
+            LOG(ERROR) << "Attempt to cancel reads of null s3 client";
+            return common::ResponseCode::UnknownError;
+        }
+        auto ptr = static_cast<S3Client *>(client_handle);
+        ptr->cancel();
+        return common::ResponseCode::Success;
+    }
+    catch(const std::exception& e)
+    {
+        LOG(ERROR) << "Caught exception while canceling reads";
+    }
+    return common::ResponseCode::UnknownError;
+}
+
+common::backend_api::ResponseCode_t obj_get_object_version(common::backend_api::ObjectClientHandle_t client_handle, const char* path, char* out_version_buffer, unsigned int buffer_len)
+{
+    try
+    {
+        if (!client_handle)
+        {
+            LOG(ERROR) << "Attempt to query object version with null s3 client";
+            return common::ResponseCode::UnknownError;
+        }
+        auto ptr = static_cast<S3Client *>(client_handle);
+        const auto version = ptr->object_version(path);
+        if (version.size() >= buffer_len)
+        {
+            LOG(ERROR) << "Version of object " << path << " does not fit in " << buffer_len << " bytes";
+            return common::ResponseCode::InvalidParameterError;
+        }
+        std::memcpy(out_version_buffer, version.c_str(), version.size() + 1);
+        return common::ResponseCode::Success;
+    }
+    catch(const common::Exception & e)
+    {
+        return e.error();
+    }
+    catch(const std::exception& e)
+    {
+        LOG(ERROR) << "Caught exception while querying object version";
+    }
+    return common::ResponseCode::UnknownError;
+}
+
 common::backend_api::ResponseCode_t obj_request_read(common::backend_api::ObjectClientHandle_t client_handle,
                                                      const char* path,
                                                      common::backend_api::ObjectRange_t range,
@@ -168,6 +220,35 @@ common::backend_api::ResponseCode_t obj_request_read(common::backend_api::Object
     return common::ResponseCode::UnknownError;
 }
 
+common::backend_api::ResponseCode_t obj_set_completion_notification(common::backend_api::ObjectClientHandle_t client_handle,
+                                                                     common::backend_api::ObjectCompletionNotification_t notification,
+                                                                     void* context)
+{
+    try
+    {
+        if (!client_handle)
+        {
+            LOG(ERROR) << "Attempt to set completion notification of null s3 client";
+            return common::ResponseCode::UnknownError;
+        }
+        auto ptr = static_cast<S3Client *>(client_handle);
+        if (notification == nullptr)
+        {
+            ptr->set_notification(nullptr);
+        }
+        else
+        {
+            ptr->set_notification([notification, context]() { notification(context); });
+        }
+        return common::ResponseCode::Success;
+    }
+    catch(const std::exception& e)
+    {
+        LOG(ERROR) << "Caught exception while setting completion notification";
+    }
+    return common::ResponseCode::UnknownError;
+}
+
 common::backend_api::ResponseCode_t obj_wait_for_completions(common::backend_api::ObjectClientHandle_t client_handle,
                                                               common::backend_api::ObjectCompletionEvent_t* event_buffer,
                                                               unsigned int max_events_to_retrieve,
@@ -192,13 +273,28 @@ common::backend_api::ResponseCode_t obj_wait_for_completions(common::backend_api
             return common::ResponseCode::UnknownError;
         }
 
-        // for now reads a single event
-
         auto ptr = static_cast<S3Client *>(client_handle);
+
+        if (wait_mode == common::backend_api::OBJECT_WAIT_MODE_NON_BLOCKING)
+        {
+            std::vector<common::backend_api::Response> responses;
+            auto ret = ptr->async_read_responses(responses, max_events_to_retrieve);
+            *out_num_events_retrieved = responses.size();
+            for (size_t i = 0; i < responses.size(); ++i)
+            {
+                event_buffer[i].request_id = responses[i].handle;
+                event_buffer[i].response_code = responses[i].ret;
+                event_buffer[i].bytes_transferred = responses[i].bytes_transferred;
+            }
+            return ret;
+        }
+
+        // for now reads a single event
         auto response = ptr->async_read_response();
         *out_num_events_retrieved = 1;
         event_buffer[0].request_id = response.handle;
         event_buffer[0].response_code = response.ret;
+        event_buffer[0].bytes_transferred = response.bytes_transferred;
         return common::ResponseCode::Success;
     }
     catch(const std::exception& e)
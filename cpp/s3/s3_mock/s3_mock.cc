@@ -2,10 +2,15 @@
 
 #include <unistd.h>
 
+#include <chrono>
 #include <map>
 #include <mutex>
 #include <set>
 #include <atomic>
+#include <thread>
+#include <utility>
+#include <cstring>
+#include <string>
 
 #include "common/s3_credentials/s3_credentials.h"
 
@@ -17,7 +22,16 @@ namespace runai::llm::streamer::common::s3
 {
 
 std::set<common::backend_api::ObjectClientHandle_t> __mock_clients;
-std::map<common::backend_api::ObjectClientHandle_t /* client */, std::set<common::backend_api::ObjectRequestId_t /* request id */>> __mock_client_requests;
+// requests are completed after the response time which was set when they were requested
+struct MockRequest
+{
+    std::chrono::steady_clock::time_point due;
+    size_t bytesize = 0;
+    bool notified = false;
+};
+
+std::map<common::backend_api::ObjectClientHandle_t /* client */, std::map<common::backend_api::ObjectRequestId_t /* request id */, MockRequest>> __mock_client_requests;
+std::map<common::backend_api::ObjectClientHandle_t /* client */, std::pair<common::backend_api::ObjectCompletionNotification_t, void * /* context */>> __mock_notifications;
 std::set<common::backend_api::ObjectClientHandle_t> __mock_unused;
 unsigned __mock_response_time_ms = 0;
 std::mutex __mutex;
@@ -25,6 +39,57 @@ std::atomic<bool> __stopped(false);
 std::atomic<bool> __opened(false);
 common::backend_api::ObjectShutdownPolicy_t __shutdown_policy = common::backend_api::OBJECT_SHUTDOWN_POLICY_ON_PROCESS_EXIT;
 
+// notifies clients when their delayed requests are due - must be called while holding __mutex
+void notify_due_requests()
+{
+    const auto now = std::chrono::steady_clock::now();
+    for (auto & [client, notification] : __mock_notifications)
+    {
+        bool due = false;
+        for (auto & [request_id, request] : __mock_client_requests[client])
+        {
+            if (!request.notified && (__stopped || request.due <= now))
+            {
+                request.notified = true;
+                due = true;
+            }
+        }
+
+        if (due)
+        {
+            notification.first(notification.second);
+        }
+    }
+}
+
+// timer for delayed responses of clients with a completion notification
+struct MockTimer
+{
+    MockTimer() :
+        _thread([this]()
+        {
+            while (!_stopped)
+            {
+                {
+                    const auto guard = std::unique_lock<std::mutex>(__mutex);
+                    notify_due_requests();
+                }
+                std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            }
+        })
+    {}
+
+    ~MockTimer()
+    {
+        _stopped = true;
+        _thread.join();
+    }
+
+ private:
+    std::atomic<bool> _stopped = false;
+    std::thread _thread;
+};
+
 void runai_s3_mock_set_backend_shutdown_policy(common::backend_api::ObjectShutdownPolicy_t policy)
 {
     __shutdown_policy = policy;
@@ -118,6 +183,7 @@ common::backend_api::ResponseCode_t obj_remove_client(common::backend_api::Objec
         ASSERT(client_handle) << "No client";
         ASSERT(__mock_client_requests.find(client_handle) != __mock_client_requests.end()) << "Client " << client_handle << " not found";
         __mock_client_requests.erase(client_handle);
+        __mock_notifications.erase(client_handle);
         __mock_unused.insert(client_handle);
         LOG(DEBUG) << "Removed S3 client " << client_handle << " - mock size is " << __mock_client_requests.size();
     }
@@ -166,11 +232,50 @@ common::backend_api::ResponseCode_t obj_request_read(
     auto r = get_response_code(client_handle);
 
     ASSERT(__mock_client_requests.find(client_handle) != __mock_client_requests.end()) << "Client " << client_handle << " not found";
-    __mock_client_requests[client_handle].insert(request_id);
+    auto & request = __mock_client_requests[client_handle][request_id];
+    request.due = std::chrono::steady_clock::now() + std::chrono::milliseconds(__mock_response_time_ms);
+    request.bytesize = range.length;
+
+    if (__mock_notifications.count(client_handle))
+    {
+        if (__mock_response_time_ms)
+        {
+            static MockTimer timer;
+        }
+        else
+        {
+            notify_due_requests();
+        }
+    }
 
     return r;
 }
 
+common::backend_api::ResponseCode_t obj_set_completion_notification(
+    common::backend_api::ObjectClientHandle_t client_handle,
+    common::backend_api::ObjectCompletionNotification_t notification,
+    void* context)
+{
+    const auto guard = std::unique_lock<std::mutex>(__mutex);
+
+    if (!__mock_clients.count(client_handle) || __mock_unused.count(client_handle))
+    {
+        LOG(ERROR) << "Mock client " << client_handle << " not found or unused";
+        return common::ResponseCode::UnknownError;
+    }
+
+    if (notification == nullptr)
+    {
+        __mock_notifications.erase(client_handle);
+    }
+    else
+    {
+        __mock_notifications[client_handle] = std::make_pair(notification, context);
+    }
+
+    return common::ResponseCode::Success;
+}
+
 common::backend_api::ResponseCode_t obj_wait_for_completions(common::backend_api::ObjectClientHandle_t client_handle,
                                                               common::backend_api::ObjectCompletionEvent_t* event_buffer,
                                                               unsigned int max_events_to_retrieve,
@@ -197,6 +302,39 @@ common::backend_api::ResponseCode_t obj_wait_for_completions(common::backend_api
         return common::ResponseCode::UnknownError;
     }
 
+    if (wait_mode == common::backend_api::OBJECT_WAIT_MODE_NON_BLOCKING)
+    {
+        if (__stopped)
+        {
+            return common::ResponseCode::FinishedError;
+        }
+
+        auto it = __mock_client_requests.find(client_handle);
+        if (it == __mock_client_requests.end() || it->second.empty())
+        {
+            return common::ResponseCode::FinishedError;
+        }
+
+        // return only the requests which are due
+        auto r = get_response_code(client_handle);
+        const auto now = std::chrono::steady_clock::now();
+        *out_num_events_retrieved = 0;
+        for (auto request = it->second.begin(); request != it->second.end() && *out_num_events_retrieved < max_events_to_retrieve; )
+        {
+            if (request->second.due > now)
+            {
+                ++request;
+                continue;
+            }
+            event_buffer[*out_num_events_retrieved].request_id = request->first;
+            event_buffer[*out_num_events_retrieved].response_code = r;
+            event_buffer[*out_num_events_retrieved].bytes_transferred = (r == common::ResponseCode::Success ? request->second.bytesize : 0);
+            request = it->second.erase(request);
+            ++*out_num_events_retrieved;
+        }
+        return common::ResponseCode::Success;
+    }
+
     if (__mock_response_time_ms)
     {
         unsigned counter = 100;
@@ -226,8 +364,9 @@ common::backend_api::ResponseCode_t obj_wait_for_completions(common::backend_api
     *out_num_events_retrieved = 0;
     for (auto it = client_requests.begin(); it != client_requests.end() && *out_num_events_retrieved < max_events_to_retrieve; )
     {
-        event_buffer[*out_num_events_retrieved].request_id = *it;
+        event_buffer[*out_num_events_retrieved].request_id = it->first;
         event_buffer[*out_num_events_retrieved].response_code = r;
+        event_buffer[*out_num_events_retrieved].bytes_transferred = (r == common::ResponseCode::Success ? it->second.bytesize : 0);
         it = client_requests.erase(it);
         ++*out_num_events_retrieved;
     }
@@ -255,17 +394,62 @@ common::backend_api::ResponseCode_t obj_remove_all_clients()
         __mock_clients.clear();
         __mock_unused.clear();
         __mock_client_requests.clear();
+        __mock_notifications.clear();
     }
     return common::ResponseCode::Success;
 }
 
 common::backend_api::ResponseCode_t obj_cancel_all_reads()
 {
+    // blocking waits poll the flag while holding the lock
     __stopped = true;
+
+    // notify the waiting callers
+    const auto guard = std::unique_lock<std::mutex>(__mutex);
+    for (auto & [client, notification] : __mock_notifications)
+    {
+        notification.first(notification.second);
+    }
     LOG(DEBUG) << "Stopped S3 clients ";
     return common::ResponseCode::Success;
 }
 
+common::backend_api::ResponseCode_t obj_cancel_reads(common::backend_api::ObjectClientHandle_t client_handle)
+{
+    const auto guard = std::unique_lock<std::mutex>(__mutex);
+
+    auto it = __mock_client_requests.find(client_handle);
+    if (it == __mock_client_requests.end())
+    {
+        LOG(ERROR) << "Mock client " << client_handle << " not found";
+        return common::ResponseCode::UnknownError;
+    }
+
+    LOG(DEBUG) << "Canceled " << it->second.size() << " requests of client " << client_handle;
+    it->second.clear();
+    return common::ResponseCode::Success;
+}
+
+common::backend_api::ResponseCode_t obj_get_object_version(common::backend_api::ObjectClientHandle_t client_handle, const char* path, char* out_version_buffer, unsigned int buffer_len)
+{
+    {
+        const auto guard = std::unique_lock<std::mutex>(__mutex);
+        if (__mock_client_requests.find(client_handle) == __mock_client_requests.end())
+        {
+            LOG(ERROR) << "Mock client " << client_handle << " not found";
+            return common::ResponseCode::UnknownError;
+        }
+    }
+
+    const auto version = utils::getenv<std::string>("RUNAI_STREAMER_S3_MOCK_OBJECT_VERSION", "1");
+    if (version.size() >= buffer_len)
+    {
+        return common::ResponseCode::InvalidParameterError;
+    }
+    std::memcpy(out_version_buffer, version.c_str(), version.size() + 1);
+    return common::ResponseCode::Success;
+}
+
 void runai_mock_s3_cleanup()
 {
     runai_mock_s3_set_response_time_ms(0);
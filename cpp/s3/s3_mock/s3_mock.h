@@ -34,6 +34,12 @@ extern "C" common::backend_api::ResponseCode_t obj_request_read(
     common::backend_api::ObjectRequestId_t request_id
 );
 
+extern "C" common::backend_api::ResponseCode_t obj_set_completion_notification(
+    common::backend_api::ObjectClientHandle_t client_handle,
+    common::backend_api::ObjectCompletionNotification_t notification,
+    void* context
+);
+
 extern "C" common::backend_api::ResponseCode_t obj_wait_for_completions(
     common::backend_api::ObjectClientHandle_t client_handle,
     common::backend_api::ObjectCompletionEvent_t* event_buffer,
@@ -43,6 +49,8 @@ extern "C" common::backend_api::ResponseCode_t obj_wait_for_completions(
 );
 
 extern "C" common::backend_api::ResponseCode_t obj_cancel_all_reads();
+extern "C" common::backend_api::ResponseCode_t obj_cancel_reads(common::backend_api::ObjectClientHandle_t client_handle);
+extern "C" common::backend_api::ResponseCode_t obj_get_object_version(common::backend_api::ObjectClientHandle_t client_handle, const char* path, char* out_version_buffer, unsigned int buffer_len);
 extern "C" common::backend_api::ResponseCode_t obj_remove_all_clients();
 
 extern "C" void runai_mock_s3_set_response_time_ms(unsigned milliseconds);
@@ -0,0 +1,172 @@
+// Measures loading safetensors files with the streamer from a local S3 stub, which serves them over loopback
+// with the latency, bandwidth and throttling of the emulated object storage
+//
+// Usage: benchmark <directory | file>... [bench options]
+//
+// The files (or the safetensors files of the directories) are served as objects of a bucket, and are loaded by //streamer/bench
+// with their s3:// URIs, so that the whole object storage path of the streamer is measured: its chunking, its client pool
+// (e.g. RUNAI_STREAMER_S3_MAX_CONNECTIONS) and the S3 client
+//
+// The stub is configured by the RUNAI_STREAMER_EMULATED_* environment variables (the root is a temporary directory),
+// and the streamer by the usual environment variables and by the options of the bench, which are passed as is
+
+#include <dirent.h>
+#include <limits.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "emulated/model/model.h"
+#include "s3/s3_stub/s3_stub.h"
+#include "streamer/bench/bench.h"
+
+#include "utils/logging/logging.h"
+#include "utils/temp/dir/dir.h"
+#include "utils/temp/env/env.h"
+
+namespace runai::llm::streamer::impl::s3
+{
+
+namespace
+{
+
+bool is_safetensors(const std::string & name)
+{
+    const std::string suffix = ".safetensors";
+    return name.size() > suffix.size() && name.compare(name.size() - suffix.size(), suffix.size(), suffix) == 0;
+}
+
+std::string basename(const std::string & path)
+{
+    const auto slash = path.find_last_of('/');
+    return slash == std::string::npos ? path : path.substr(slash + 1);
+}
+
+std::string absolute(const std::string & path)
+{
+    if (!path.empty() && path.front() == '/')
+    {
+        return path;
+    }
+
+    char cwd[PATH_MAX];
+    PASSERT(::getcwd(cwd, sizeof(cwd)) != nullptr) << "Failed getting the working directory";
+    return std::string(cwd) + "/" + path;
+}
+
+// links the file into the bucket, and returns the name of its object
+std::string link(const std::string & path, const utils::temp::Dir & bucket)
+{
+    const auto name = basename(path);
+    PASSERT(::symlink(absolute(path).c_str(), (bucket.path + "/" + name).c_str()) == 0) << "Failed linking " << path << " into the bucket";
+    return name;
+}
+
+// serves the files, or the safetensors files of the directories, as objects of the bucket
+std::vector<std::string> serve(const std::vector<std::string> & paths, const utils::temp::Dir & bucket)
+{
+    std::vector<std::string> objects;
+    for (const auto & path : paths)
+    {
+        DIR * dir = ::opendir(path.c_str());
+        if (dir == nullptr)
+        {
+            objects.push_back(link(path, bucket));
+            continue;
+        }
+
+        std::vector<std::string> names;
+        while (const auto entry = ::readdir(dir))
+        {
+            if (is_safetensors(entry->d_name))
+            {
+                names.push_back(entry->d_name);
+            }
+        }
+        ::closedir(dir);
+
+        std::sort(names.begin(), names.end());
+        for (const auto & name : names)
+        {
+            objects.push_back(link(path + "/" + name, bucket));
+        }
+    }
+    return objects;
+}
+
+} // namespace
+
+int benchmark(int argc, char * argv[])
+{
+    std::vector<std::string> paths;
+    std::vector<std::string> options;
+    for (int i = 1; i < argc; ++i)
+    {
+        const std::string arg = argv[i];
+        (arg.compare(0, 2, "--") == 0 ? options : paths).push_back(arg);
+    }
+
+    if (paths.empty())
+    {
+        std::cerr << "Usage: " << argv[0] << " <directory | file>... [bench options]" << std::endl;
+        return 1;
+    }
+
+    utils::temp::Dir root;
+    utils::temp::Dir bucket(root.path);
+    const auto objects = serve(paths, bucket);
+    if (objects.empty())
+    {
+        std::cerr << "No safetensors files in " << paths.front() << std::endl;
+        return 1;
+    }
+
+    auto profile = emulated::Profile::from_env();
+    profile.root = root.path;
+    S3Stub stub(profile);
+
+    // the stub does not resolve buckets by host name, and does not authenticate requests
+    const auto endpoint = utils::temp::Env("AWS_ENDPOINT_URL", stub.endpoint());
+    const auto addressing = utils::temp::Env("RUNAI_STREAMER_S3_USE_VIRTUAL_ADDRESSING", false);
+    const auto metadata = utils::temp::Env("AWS_EC2_METADATA_DISABLED", "true");
+    const auto access_key = utils::temp::Env("AWS_ACCESS_KEY_ID", "stub");
+    const auto secret_key = utils::temp::Env("AWS_SECRET_ACCESS_KEY", "stub");
+    const auto region = utils::temp::Env("AWS_REGION", "us-east-1");
+
+    std::cout << "S3 stub at " << stub.endpoint() << " - " << profile << std::endl;
+
+    std::vector<std::string> args = { argv[0] };
+    for (const auto & object : objects)
+    {
+        args.push_back("s3://" + bucket.name + "/" + object);
+    }
+    args.insert(args.end(), options.begin(), options.end());
+
+    std::vector<char *> bench_argv;
+    for (auto & arg : args)
+    {
+        bench_argv.push_back(arg.data());
+    }
+    bench_argv.push_back(nullptr);
+
+    const auto result = streamer::bench(static_cast<int>(args.size()), bench_argv.data());
+
+    const auto stats = stub.stats();
+    std::cout << "stub: " << stats.connections << " connections, "
+              << stats.max_open_connections << " maximal open connections, "
+              << stats.requests << " requests, "
+              << stats.throttled << " throttled, "
+              << stats.faulted << " faulted" << std::endl;
+
+    return result;
+}
+
+}; // namespace runai::llm::streamer::impl::s3
+
+int main(int argc, char * argv[])
+{
+    return runai::llm::streamer::impl::s3::benchmark(argc, argv);
+}
@@ -0,0 +1,534 @@
+#include "s3/s3_stub/s3_stub.h"
+
+#include <arpa/inet.h>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <strings.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <chrono>
+#include <ctime>
+#include <map>
+#include <optional>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "utils/fd/fd.h"
+#include "utils/logging/logging.h"
+
+namespace runai::llm::streamer::impl::s3
+{
+
+namespace
+{
+
+// request headers larger than this are rejected
+constexpr size_t max_header_bytesize = 64 * 1024;
+
+// bodies are sent in slices, which are paced separately
+constexpr size_t slice_bytesize = 64 * 1024;
+
+struct Request
+{
+    std::string method;
+    std::string target;
+    std::string version;
+    // header names are lowercase
+    std::map<std::string, std::string> headers;
+
+    std::string header(const std::string & name) const
+    {
+        auto it = headers.find(name);
+        return it == headers.end() ? "" : it->second;
+    }
+};
+
+struct Range
+{
+    size_t offset;
+    size_t bytesize;
+};
+
+std::string lowercase(std::string s)
+{
+    std::transform(s.begin(), s.end(), s.begin(), [](unsigned char c) { return std::tolower(c); });
+    return s;
+}
+
+std::string trim(const std::string & s)
+{
+    const auto begin = s.find_first_not_of(" \t");
+    if (begin == std::string::npos)
+    {
+        return "";
+    }
+    return s.substr(begin, s.find_last_not_of(" \t") - begin + 1);
+}
+
+std::string decode(const std::string & s)
+{
+    std::string result;
+    for (size_t i = 0; i < s.size(); ++i)
+    {
+        if (s[i] == '%' && i + 2 < s.size())
+        {
+            result += static_cast<char>(std::stoi(s.substr(i + 1, 2), nullptr, 16));
+            i += 2;
+        }
+        else
+        {
+            result += s[i];
+        }
+    }
+    return result;
+}
+
+bool send_all(int fd, const char * data, size_t bytesize)
+{
+    while (bytesize > 0)
+    {
+        const auto sent = ::send(fd, data, bytesize, MSG_NOSIGNAL);
+        if (sent <= 0)
+        {
+            if (sent < 0 && errno == EINTR)
+            {
+                continue;
+            }
+            return false;
+        }
+        data += sent;
+        bytesize -= sent;
+    }
+    return true;
+}
+
+bool send_all(int fd, const std::string & s)
+{
+    return send_all(fd, s.data(), s.size());
+}
+
+// reads the next request of a connection, where the bytes after it are kept for the next requests
+// returns nullopt if the connection was closed
+std::optional<Request> receive(int fd, std::string & pending)
+{
+    size_t end;
+    while ((end = pending.find("\r\n\r\n")) == std::string::npos)
+    {
+        if (pending.size() > max_header_bytesize)
+        {
+            LOG(ERROR) << "Request headers exceed " << max_header_bytesize << " bytes";
+            return std::nullopt;
+        }
+
+        char buffer[4096];
+        const auto received = ::recv(fd, buffer, sizeof(buffer), 0);
+        if (received < 0 && errno == EINTR)
+        {
+            continue;
+        }
+        if (received <= 0)
+        {
+            return std::nullopt;
+        }
+        pending.append(buffer, received);
+    }
+
+    std::istringstream stream(pending.substr(0, end));
+    pending.erase(0, end + 4);
+
+    Request request;
+    std::string line;
+    std::getline(stream, line);
+    std::istringstream(line) >> request.method >> request.target >> request.version;
+
+    while (std::getline(stream, line))
+    {
+        const auto colon = line.find(':');
+        if (colon != std::string::npos)
+        {
+            request.headers[lowercase(trim(line.substr(0, colon)))] = trim(line.substr(colon + 1, line.find_last_not_of('\r') - colon));
+        }
+    }
+
+    // requests of objects do not have a body, but a body is skipped to keep the connection in sync
+    const auto content_length = request.header("content-length");
+    size_t body = content_length.empty() ? 0 : std::stoul(content_length);
+    while (pending.size() < body)
+    {
+        char buffer[4096];
+        const auto received = ::recv(fd, buffer, sizeof(buffer), 0);
+        if (received <= 0)
+        {
+            return std::nullopt;
+        }
+        pending.append(buffer, received);
+    }
+    pending.erase(0, body);
+
+    return request;
+}
+
+// parses a single range of "bytes=<first>-<last>", "bytes=<first>-" or "bytes=-<suffix>"
+// returns nullopt if the range is not satisfiable
+std::optional<Range> parse_range(const std::string & header, size_t size)
+{
+    const std::string prefix = "bytes=";
+    if (header.compare(0, prefix.size(), prefix) != 0)
+    {
+        return std::nullopt;
+    }
+
+    const auto spec = header.substr(prefix.size());
+    const auto dash = spec.find('-');
+    if (dash == std::string::npos || spec.find(',') != std::string::npos)
+    {
+        return std::nullopt;
+    }
+
+    try
+    {
+        const auto first = spec.substr(0, dash);
+        const auto last = spec.substr(dash + 1);
+
+        if (first.empty())
+        {
+            const size_t suffix = std::stoul(last);
+            if (suffix == 0 || size == 0)
+            {
+                return std::nullopt;
+            }
+            const auto bytesize = std::min(suffix, size);
+            return Range{size - bytesize, bytesize};
+        }
+
+        const size_t offset = std::stoul(first);
+        if (offset >= size)
+        {
+            return std::nullopt;
+        }
+
+        const size_t end = last.empty() ? size - 1 : std::min<size_t>(std::stoul(last), size - 1);
+        if (end < offset)
+        {
+            return std::nullopt;
+        }
+        return Range{offset, end - offset + 1};
+    }
+    catch (const std::exception &)
+    {
+        return std::nullopt;
+    }
+}
+
+std::string http_date(time_t time)
+{
+    struct tm tm;
+    ::gmtime_r(&time, &tm);
+    char buffer[64];
+    ::strftime(buffer, sizeof(buffer), "%a, %d %b %Y %H:%M:%S GMT", &tm);
+    return buffer;
+}
+
+std::string status_line(unsigned status)
+{
+    switch (status)
+    {
+        case 200: return "HTTP/1.1 200 OK\r\n";
+        case 206: return "HTTP/1.1 206 Partial Content\r\n";
+        case 400: return "HTTP/1.1 400 Bad Request\r\n";
+        case 404: return "HTTP/1.1 404 Not Found\r\n";
+        case 416: return "HTTP/1.1 416 Requested Range Not Satisfiable\r\n";
+        case 500: return "HTTP/1.1 500 Internal Server Error\r\n";
+        case 501: return "HTTP/1.1 501 Not Implemented\r\n";
+        case 503: return "HTTP/1.1 503 Slow Down\r\n";
+        default:  return "HTTP/1.1 " + std::to_string(status) + "\r\n";
+    }
+}
+
+// error response in the format of S3
+bool send_error(int fd, const Request & request, unsigned status, const std::string & code, const std::string & message, bool keep_alive)
+{
+    const auto body = "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n<Error><Code>" + code + "</Code><Message>" + message + "</Message></Error>";
+
+    std::ostringstream response;
+    response << status_line(status)
+             << "Content-Type: application/xml\r\n"
+             << "Content-Length: " << body.size() << "\r\n"
+             << "Date: " << http_date(::time(nullptr)) << "\r\n"
+             << "Connection: " << (keep_alive ? "keep-alive" : "close") << "\r\n"
+             << "\r\n";
+
+    // responses to HEAD requests do not have a body
+    return send_all(fd, response.str() + (request.method == "HEAD" ? "" : body));
+}
+
+bool sleep_until(std::chrono::steady_clock::time_point time_point, const std::atomic<bool> & stopped)
+{
+    while (!stopped)
+    {
+        const auto now = std::chrono::steady_clock::now();
+        if (now >= time_point)
+        {
+            return true;
+        }
+        std::this_thread::sleep_for(std::min<std::chrono::steady_clock::duration>(time_point - now, std::chrono::milliseconds(10)));
+    }
+    return false;
+}
+
+} // namespace
+
+S3Stub::S3Stub(const emulated::Profile & profile) :
+    _model(profile, 0),
+    _bandwidth(profile.bandwidth),
+    _stopped(false)
+{
+    _listener = ::socket(AF_INET, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    PASSERT(_listener != -1) << "Failed creating the S3 stub socket";
+
+    const int enable = 1;
+    ::setsockopt(_listener, SOL_SOCKET, SO_REUSEADDR, &enable, sizeof(enable));
+
+    struct sockaddr_in address = {};
+    address.sin_family = AF_INET;
+    address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    address.sin_port = 0;
+
+    socklen_t length = sizeof(address);
+    if (::bind(_listener, reinterpret_cast<struct sockaddr *>(&address), sizeof(address)) != 0 ||
+        ::listen(_listener, SOMAXCONN) != 0 ||
+        ::getsockname(_listener, reinterpret_cast<struct sockaddr *>(&address), &length) != 0)
+    {
+        ::close(_listener);
+        PASSERT(false) << "Failed listening on loopback for the S3 stub";
+    }
+
+    _port = ntohs(address.sin_port);
+    _acceptor = utils::Thread([this]() { accept(); });
+
+    LOG(DEBUG) << "S3 stub is listening on " << endpoint() << " - " << profile;
+}
+
+S3Stub::~S3Stub()
+{
+    _stopped = true;
+
+    // wakes up the acceptor
+    ::shutdown(_listener, SHUT_RDWR);
+    _acceptor.join();
+    ::close(_listener);
+
+    std::list<utils::Thread> connections;
+    {
+        const auto guard = std::unique_lock<std::mutex>(_mutex);
+        for (const auto fd : _open)
+        {
+            // wakes up connections waiting for requests
+            ::shutdown(fd, SHUT_RDWR);
+        }
+        connections = std::move(_connections);
+    }
+
+    // joined on destruction
+}
+
+unsigned short S3Stub::port() const
+{
+    return _port;
+}
+
+std::string S3Stub::endpoint() const
+{
+    return "http://127.0.0.1:" + std::to_string(_port);
+}
+
+S3Stub::Stats S3Stub::stats() const
+{
+    const auto guard = std::unique_lock<std::mutex>(_mutex);
+    return _stats;
+}
+
+void S3Stub::accept()
+{
+    while (!_stopped)
+    {
+        const int fd = ::accept4(_listener, nullptr, nullptr, SOCK_CLOEXEC);
+        if (fd == -1)
+        {
+            if (errno == EINTR || errno == ECONNABORTED)
+            {
+                continue;
+            }
+            if (!_stopped)
+            {
+                LOG(ERROR) << "S3 stub failed accepting a connection";
+            }
+            return;
+        }
+
+        const int enable = 1;
+        ::setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &enable, sizeof(enable));
+
+        const auto guard = std::unique_lock<std::mutex>(_mutex);
+        if (_stopped)
+        {
+            ::close(fd);
+            return;
+        }
+
+        _open.insert(fd);
+        ++_stats.connections;
+        _stats.max_open_connections = std::max<unsigned>(_stats.max_open_connections, _open.size());
+        _connections.emplace_back([this, fd]() { serve(fd); });
+    }
+}
+
+void S3Stub::serve(int fd)
+{
+    const auto & profile = _model.profile();
+
+    std::string pending;
+    while (!_stopped)
+    {
+        const auto request = receive(fd, pending);
+        if (!request.has_value())
+        {
+            break;
+        }
+
+        const bool keep_alive = request->version == "HTTP/1.1" && lowercase(request->header("connection")) != "close";
+
+        emulated::Outcome outcome;
+        {
+            const auto guard = std::unique_lock<std::mutex>(_model_mutex);
+            outcome = _model.attempt();
+        }
+
+        unsigned request_id;
+        {
+            const auto guard = std::unique_lock<std::mutex>(_mutex);
+            request_id = ++_stats.requests;
+            _stats.throttled += outcome.throttled;
+            _stats.faulted += (outcome.throttled == 0 && outcome.response_code != common::ResponseCode::Success);
+        }
+
+        // time to first byte
+        if (!sleep_until(std::chrono::steady_clock::now() + outcome.delay, _stopped))
+        {
+            break;
+        }
+
+        // path style target /bucket/key, where the query (e.g. x-id=GetObject) is ignored
+        auto path = decode(request->target.substr(0, request->target.find('?')));
+        LOG(SPAM) << "S3 stub received " << request->method << " " << path << " range '" << request->header("range") << "'";
+
+        bool sent;
+        if (request->method != "GET" && request->method != "HEAD")
+        {
+            sent = send_error(fd, *request, 501, "NotImplemented", "The stub serves only GetObject and HeadObject", keep_alive);
+        }
+        else if (outcome.throttled)
+        {
+            sent = send_error(fd, *request, 503, "SlowDown", "Please reduce your request rate.", keep_alive);
+        }
+        else if (outcome.response_code != common::ResponseCode::Success)
+        {
+            sent = send_error(fd, *request, 500, "InternalError", "We encountered an internal error. Please try again.", keep_alive);
+        }
+        else if (path.size() < 2 || path.find('/', 1) == std::string::npos)
+        {
+            sent = send_error(fd, *request, 400, "InvalidRequest", "Expected a path style request of /bucket/key", keep_alive);
+        }
+        else
+        {
+            const auto file = profile.root.empty() ? path.substr(1) : profile.root + path;
+            utils::Fd object(::open(file.c_str(), O_RDONLY | O_CLOEXEC));
+            struct stat st;
+
+            if (object.fd() == -1 || ::fstat(object.fd(), &st) != 0 || !S_ISREG(st.st_mode))
+            {
+                sent = send_error(fd, *request, 404, "NoSuchKey", "The specified key does not exist.", keep_alive);
+            }
+            else
+            {
+                const size_t size = st.st_size;
+                const auto range_header = request->header("range");
+                std::optional<Range> range = Range{0, size};
+                if (!range_header.empty())
+                {
+                    range = parse_range(range_header, size);
+                }
+
+                if (!range.has_value())
+                {
+                    sent = send_error(fd, *request, 416, "InvalidRange", "The requested range is not satisfiable", keep_alive);
+                }
+                else
+                {
+                    std::ostringstream response;
+                    response << status_line(range_header.empty() ? 200 : 206)
+                             << "Accept-Ranges: bytes\r\n"
+                             << "Content-Type: application/octet-stream\r\n"
+                             << "Content-Length: " << range->bytesize << "\r\n";
+                    if (!range_header.empty())
+                    {
+                        response << "Content-Range: bytes " << range->offset << "-" << range->offset + range->bytesize - 1 << "/" << size << "\r\n";
+                    }
+                    response << "ETag: \"" << st.st_mtim.tv_sec << "." << st.st_mtim.tv_nsec << "-" << size << "\"\r\n"
+                             << "Last-Modified: " << http_date(st.st_mtim.tv_sec) << "\r\n"
+                             << "Date: " << http_date(::time(nullptr)) << "\r\n"
+                             << "x-amz-request-id: " << request_id << "\r\n"
+                             << "Connection: " << (keep_alive ? "keep-alive" : "close") << "\r\n"
+                             << "\r\n";
+                    sent = send_all(fd, response.str());
+
+                    if (request->method == "GET")
+                    {
+                        // the body is paced by the bandwidth of the connection and the bandwidth of the server
+                        emulated::Pacer connection(profile.connection_bandwidth);
+                        std::vector<char> buffer(slice_bytesize);
+
+                        for (size_t copied = 0; sent && copied < range->bytesize; )
+                        {
+                            const auto bytesize = std::min(slice_bytesize, range->bytesize - copied);
+                            const auto result = ::pread(object.fd(), buffer.data(), bytesize, range->offset + copied);
+                            if (result <= 0 || !sleep_until(std::max(connection.reserve(result), _bandwidth.reserve(result)), _stopped))
+                            {
+                                // the response can not be completed, so the connection is closed
+                                LOG(ERROR) << "S3 stub failed sending " << path;
+                                sent = false;
+                                break;
+                            }
+
+                            {
+                                const auto guard = std::unique_lock<std::mutex>(_mutex);
+                                _stats.bytesize += result;
+                            }
+
+                            sent = send_all(fd, buffer.data(), result);
+                            copied += result;
+                        }
+                    }
+                }
+            }
+        }
+
+        if (!sent || !keep_alive)
+        {
+            break;
+        }
+    }
+
+    const auto guard = std::unique_lock<std::mutex>(_mutex);
+    _open.erase(fd);
+    ::close(fd);
+}
+
+}; // namespace runai::llm::streamer::impl::s3
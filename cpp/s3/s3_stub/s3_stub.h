@@ -0,0 +1,77 @@
+#pragma once
+
+#include <stddef.h>
+
+#include <atomic>
+#include <list>
+#include <mutex>
+#include <set>
+#include <string>
+
+#include "emulated/model/model.h"
+
+#include "utils/thread/thread.h"
+
+namespace runai::llm::streamer::impl::s3
+{
+
+// Local S3 compatible HTTP server, which serves the files of a directory over loopback for testing and benchmarking the S3 client
+//
+// Speaks enough of the S3 protocol for GetObject and HeadObject with byte ranges, in path style addressing (http://127.0.0.1:<port>/bucket/key),
+// where object s3://bucket/key is the file <root>/bucket/key of the profile
+// Requests are not authenticated, and connections are kept alive between requests
+//
+// Every request is delayed and its body is paced by the emulated object storage model of the profile
+// A throttled request is answered with 503 SlowDown and a faulted request with 500 InternalError, which the SDK retries
+
+struct S3Stub
+{
+    S3Stub(const emulated::Profile & profile);
+    ~S3Stub();
+
+    S3Stub(const S3Stub &)             = delete;
+    S3Stub & operator=(const S3Stub &) = delete;
+
+    unsigned short port() const;
+
+    // endpoint url of the server, e.g. for AWS_ENDPOINT_URL
+    std::string endpoint() const;
+
+    struct Stats
+    {
+        // accepted connections, and the maximal number of connections which were open at the same time
+        unsigned connections = 0;
+        unsigned max_open_connections = 0;
+        unsigned requests = 0;
+        unsigned throttled = 0;
+        unsigned faulted = 0;
+        // bytes of the response bodies
+        size_t bytesize = 0;
+    };
+
+    Stats stats() const;
+
+ private:
+    void accept();
+    void serve(int fd);
+
+    emulated::Model _model;
+    std::mutex _model_mutex;
+
+    // bandwidth shared by all the connections
+    emulated::Pacer _bandwidth;
+
+    int _listener = -1;
+    unsigned short _port = 0;
+    std::atomic<bool> _stopped;
+
+    mutable std::mutex _mutex;
+    Stats _stats;
+    // connections which are open, which are shut down when stopping
+    std::set<int> _open;
+    std::list<utils::Thread> _connections;
+
+    utils::Thread _acceptor;
+};
+
+}; // namespace runai::llm::streamer::impl::s3
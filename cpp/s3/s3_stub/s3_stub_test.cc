@@ -0,0 +1,316 @@
+#include "s3/s3_stub/s3_stub.h"
+
+#include <arpa/inet.h>
+#include <gtest/gtest.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <chrono>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "utils/random/random.h"
+#include "utils/temp/dir/dir.h"
+#include "utils/temp/file/file.h"
+
+namespace runai::llm::streamer::impl::s3
+{
+
+namespace
+{
+
+struct Response
+{
+    unsigned status = 0;
+    std::string headers;
+    std::string body;
+};
+
+// minimal http client of a single connection
+struct Connection
+{
+    Connection(unsigned short port)
+    {
+        fd = ::socket(AF_INET, SOCK_STREAM, 0);
+        EXPECT_NE(fd, -1);
+
+        struct sockaddr_in address = {};
+        address.sin_family = AF_INET;
+        address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        address.sin_port = htons(port);
+        EXPECT_EQ(::connect(fd, reinterpret_cast<struct sockaddr *>(&address), sizeof(address)), 0);
+    }
+
+    ~Connection()
+    {
+        ::close(fd);
+    }
+
+    Response request(const std::string & method, const std::string & target, const std::string & headers = "")
+    {
+        const auto request = method + " " + target + " HTTP/1.1\r\nHost: 127.0.0.1\r\n" + headers + "\r\n";
+        EXPECT_EQ(::send(fd, request.data(), request.size(), 0), request.size());
+
+        while (pending.find("\r\n\r\n") == std::string::npos && receive())
+        {}
+
+        Response response;
+        const auto end = pending.find("\r\n\r\n");
+        if (end == std::string::npos)
+        {
+            return response;
+        }
+
+        response.headers = pending.substr(0, end + 2);
+        pending.erase(0, end + 4);
+        response.status = std::stoul(response.headers.substr(response.headers.find(' ') + 1, 3));
+
+        const size_t length = std::stoul(header(response, "Content-Length"));
+        const size_t bytesize = method == "HEAD" ? 0 : length;
+        while (pending.size() < bytesize && receive())
+        {}
+
+        response.body = pending.substr(0, bytesize);
+        pending.erase(0, bytesize);
+        return response;
+    }
+
+    static std::string header(const Response & response, const std::string & name)
+    {
+        const auto begin = response.headers.find(name + ": ");
+        if (begin == std::string::npos)
+        {
+            return "";
+        }
+        const auto value = begin + name.size() + 2;
+        return response.headers.substr(value, response.headers.find("\r\n", value) - value);
+    }
+
+    bool receive()
+    {
+        char buffer[4096];
+        const auto received = ::recv(fd, buffer, sizeof(buffer), 0);
+        if (received <= 0)
+        {
+            return false;
+        }
+        pending.append(buffer, received);
+        return true;
+    }
+
+    int fd;
+    std::string pending;
+};
+
+} // namespace
+
+struct S3StubTest : ::testing::Test
+{
+    S3StubTest() :
+        bucket(root.path),
+        data(utils::random::buffer(utils::random::number(1024, 1024 * 1024))),
+        object(bucket.path, utils::random::string(), data),
+        target("/" + bucket.name + "/" + object.name)
+    {
+        profile.root = root.path;
+    }
+
+    std::string expected(size_t offset, size_t bytesize) const
+    {
+        return std::string(reinterpret_cast<const char *>(data.data()) + offset, bytesize);
+    }
+
+    utils::temp::Dir root;
+    utils::temp::Dir bucket;
+    std::vector<uint8_t> data;
+    utils::temp::File object;
+    std::string target;
+    emulated::Profile profile;
+};
+
+TEST_F(S3StubTest, Endpoint)
+{
+    S3Stub stub(profile);
+    EXPECT_NE(stub.port(), 0);
+    EXPECT_EQ(stub.endpoint(), "http://127.0.0.1:" + std::to_string(stub.port()));
+}
+
+TEST_F(S3StubTest, Get)
+{
+    S3Stub stub(profile);
+    Connection connection(stub.port());
+
+    // the query of the sdk is ignored
+    const auto response = connection.request("GET", target + "?x-id=GetObject");
+    EXPECT_EQ(response.status, 200);
+    EXPECT_EQ(Connection::header(response, "Content-Length"), std::to_string(data.size()));
+    EXPECT_FALSE(Connection::header(response, "ETag").empty());
+    EXPECT_EQ(response.body, expected(0, data.size()));
+}
+
+TEST_F(S3StubTest, Range)
+{
+    S3Stub stub(profile);
+    Connection connection(stub.port());
+
+    const size_t offset = utils::random::number(0, data.size() - 1);
+    const size_t bytesize = utils::random::number(1, data.size() - offset);
+
+    const auto response = connection.request("GET", target, "Range: bytes=" + std::to_string(offset) + "-" + std::to_string(offset + bytesize - 1) + "\r\n");
+    EXPECT_EQ(response.status, 206);
+    EXPECT_EQ(Connection::header(response, "Content-Range"), "bytes " + std::to_string(offset) + "-" + std::to_string(offset + bytesize - 1) + "/" + std::to_string(data.size()));
+    EXPECT_EQ(response.body, expected(offset, bytesize));
+
+    // the range is clamped to the object
+    const auto open = connection.request("GET", target, "Range: bytes=" + std::to_string(offset) + "-\r\n");
+    EXPECT_EQ(open.status, 206);
+    EXPECT_EQ(open.body, expected(offset, data.size() - offset));
+
+    const auto suffix = connection.request("GET", target, "Range: bytes=-" + std::to_string(bytesize) + "\r\n");
+    EXPECT_EQ(suffix.status, 206);
+    EXPECT_EQ(suffix.body, expected(data.size() - bytesize, bytesize));
+}
+
+TEST_F(S3StubTest, Head)
+{
+    S3Stub stub(profile);
+    Connection connection(stub.port());
+
+    const auto response = connection.request("HEAD", target);
+    EXPECT_EQ(response.status, 200);
+    EXPECT_EQ(Connection::header(response, "Content-Length"), std::to_string(data.size()));
+    EXPECT_TRUE(response.body.empty());
+
+    // the connection is still in sync
+    EXPECT_EQ(connection.request("GET", target).body, expected(0, data.size()));
+}
+
+TEST_F(S3StubTest, Errors)
+{
+    S3Stub stub(profile);
+    Connection connection(stub.port());
+
+    const auto missing = connection.request("GET", "/" + bucket.name + "/" + utils::random::string());
+    EXPECT_EQ(missing.status, 404);
+    EXPECT_NE(missing.body.find("<Code>NoSuchKey</Code>"), std::string::npos);
+
+    const auto invalid = connection.request("GET", target, "Range: bytes=" + std::to_string(data.size()) + "-\r\n");
+    EXPECT_EQ(invalid.status, 416);
+    EXPECT_NE(invalid.body.find("<Code>InvalidRange</Code>"), std::string::npos);
+
+    EXPECT_EQ(connection.request("PUT", target, "Content-Length: 0\r\n").status, 501);
+    EXPECT_EQ(connection.request("GET", "/" + bucket.name).status, 400);
+}
+
+TEST_F(S3StubTest, Keep_Alive)
+{
+    S3Stub stub(profile);
+
+    const unsigned requests = utils::random::number(2, 10);
+    {
+        Connection connection(stub.port());
+        for (unsigned i = 0; i < requests; ++i)
+        {
+            EXPECT_EQ(connection.request("GET", target).status, 200);
+        }
+    }
+
+    const auto stats = stub.stats();
+    EXPECT_EQ(stats.connections, 1);
+    EXPECT_EQ(stats.max_open_connections, 1);
+    EXPECT_EQ(stats.requests, requests);
+    EXPECT_EQ(stats.bytesize, requests * data.size());
+}
+
+TEST_F(S3StubTest, Connections)
+{
+    S3Stub stub(profile);
+
+    const unsigned count = utils::random::number(2, 10);
+    {
+        std::vector<std::unique_ptr<Connection>> connections;
+        for (unsigned i = 0; i < count; ++i)
+        {
+            connections.push_back(std::make_unique<Connection>(stub.port()));
+            EXPECT_EQ(connections.back()->request("HEAD", target).status, 200);
+        }
+    }
+
+    const auto stats = stub.stats();
+    EXPECT_EQ(stats.connections, count);
+    EXPECT_EQ(stats.max_open_connections, count);
+}
+
+TEST_F(S3StubTest, Throttle)
+{
+    profile.throttle_probability = 1;
+    S3Stub stub(profile);
+    Connection connection(stub.port());
+
+    // every attempt is throttled, and the retries are up to the client
+    for (unsigned i = 0; i < 3; ++i)
+    {
+        const auto response = connection.request("GET", target);
+        EXPECT_EQ(response.status, 503);
+        EXPECT_NE(response.body.find("<Code>SlowDown</Code>"), std::string::npos);
+    }
+    EXPECT_EQ(stub.stats().throttled, 3);
+}
+
+TEST_F(S3StubTest, Fault)
+{
+    profile.fault_probability = 1;
+    S3Stub stub(profile);
+    Connection connection(stub.port());
+
+    const auto response = connection.request("GET", target);
+    EXPECT_EQ(response.status, 500);
+    EXPECT_NE(response.body.find("<Code>InternalError</Code>"), std::string::npos);
+    EXPECT_EQ(stub.stats().faulted, 1);
+}
+
+TEST_F(S3StubTest, Latency)
+{
+    const auto latency = std::chrono::milliseconds(utils::random::number(20, 50));
+    profile.latency = latency;
+    S3Stub stub(profile);
+    Connection connection(stub.port());
+
+    const auto start = std::chrono::steady_clock::now();
+    EXPECT_EQ(connection.request("HEAD", target).status, 200);
+    EXPECT_GE(std::chrono::steady_clock::now() - start, latency);
+}
+
+TEST_F(S3StubTest, Bandwidth)
+{
+    // the object is transferred in about 100 milliseconds
+    profile.connection_bandwidth = data.size() * 10;
+    S3Stub stub(profile);
+    Connection connection(stub.port());
+
+    const auto start = std::chrono::steady_clock::now();
+    EXPECT_EQ(connection.request("GET", target).body, expected(0, data.size()));
+    EXPECT_GE(std::chrono::steady_clock::now() - start, std::chrono::milliseconds(90));
+}
+
+TEST_F(S3StubTest, Stop)
+{
+    profile.latency = std::chrono::seconds(10);
+    const auto start = std::chrono::steady_clock::now();
+    {
+        S3Stub stub(profile);
+        Connection connection(stub.port());
+
+        const auto request = "GET " + target + " HTTP/1.1\r\n\r\n";
+        EXPECT_EQ(::send(connection.fd, request.data(), request.size(), 0), request.size());
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+
+    // the connections do not wait for the latency of the requests in progress
+    EXPECT_LT(std::chrono::steady_clock::now() - start, std::chrono::seconds(1));
+}
+
+}; // namespace runai::llm::streamer::impl::s3
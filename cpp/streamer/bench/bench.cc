@@ -0,0 +1,742 @@
+// Measures loading the tensors of safetensors files with the streamer, optionally sweeping its configuration
+//
+// Usage: bench <directory | file | uri>... [--concurrency=<n>,...] [--chunk-bytesize=<n>,...] [--executor-threads=<n>,...]
+//              [--responses=<response|responses|callback>,...] [--cache=<cold|dropped|warm>,...] [--iterations=<n>]
+//
+// A directory stands for the safetensors files in it, and paths with a scheme (e.g. s3://bucket/model.safetensors) are read from object storage
+// Every combination of the given values is measured for the given number of iterations (default 3), and the best combination is printed at the end
+// Options which are not given keep the configuration of the environment (e.g. RUNAI_STREAMER_CONCURRENCY), which also configures the object storage
+//
+// Responses are received either by runai_response, by runai_responses on the event file descriptor, or by a completion callback
+// Cache modes apply to local files before every iteration:
+//     cold    - drops the page cache of the system, which requires root
+//     dropped - evicts the files from the page cache with posix_fadvise(POSIX_FADV_DONTNEED)
+//     warm    - reads the files once before measuring (default)
+//
+// Every iteration is measured from starting the streamer, including reading the safetensors headers, and reports:
+//     time to first tensor, total time and throughput, CPU time of the process,
+//     file skew (the latest completion of a file relative to the earliest one) and
+//     worker skew (the busiest worker relative to the average worker, from the timeline of the streamer threads)
+
+#include "streamer/bench/bench.h"
+
+#include <dirent.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/resource.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <list>
+#include <map>
+#include <mutex>
+#include <regex>
+#include <string>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+#include "streamer/streamer.h"
+
+#include "common/response_code/response_code.h"
+
+#include "utils/fd/fd.h"
+#include "utils/temp/env/env.h"
+#include "utils/temp/file/file.h"
+
+namespace runai::llm::streamer
+{
+
+namespace
+{
+
+using Clock = std::chrono::steady_clock;
+
+enum class Responses
+{
+    Response,
+    Responses,
+    Callback,
+};
+
+enum class Cache
+{
+    Cold,
+    Dropped,
+    Warm,
+};
+
+const std::map<std::string, Responses> __responses = {
+    { "response", Responses::Response },
+    { "responses", Responses::Responses },
+    { "callback", Responses::Callback },
+};
+
+const std::map<std::string, Cache> __caches = {
+    { "cold", Cache::Cold },
+    { "dropped", Cache::Dropped },
+    { "warm", Cache::Warm },
+};
+
+struct Options
+{
+    std::vector<std::string> paths;
+
+    // values of the environment variables, where an empty value keeps the environment
+    std::vector<std::string> concurrency = { "" };
+    std::vector<std::string> chunk_bytesize = { "" };
+    std::vector<std::string> executor_threads = { "" };
+
+    std::vector<std::string> responses = { "response" };
+    std::vector<std::string> caches = { "warm" };
+    unsigned iterations = 3;
+};
+
+struct Configuration
+{
+    std::string concurrency;
+    std::string chunk_bytesize;
+    std::string executor_threads;
+    std::string responses;
+    std::string cache;
+};
+
+std::ostream & operator<<(std::ostream & os, const Configuration & configuration)
+{
+    const auto value = [](const std::string & s) { return s.empty() ? std::string("env") : s; };
+
+    return os << "concurrency " << value(configuration.concurrency)
+              << ", chunk bytesize " << value(configuration.chunk_bytesize)
+              << ", executor threads " << value(configuration.executor_threads)
+              << ", " << configuration.responses << ", " << configuration.cache;
+}
+
+// tensors of a safetensors file, which follow its header
+struct Layout
+{
+    size_t offset = 0;
+    size_t bytesize = 0;
+    std::vector<size_t> sizes;
+};
+
+struct Result
+{
+    bool success = true;
+    size_t bytesize = 0;
+    double first = 0;
+    double seconds = 0;
+    double cpu = 0;
+    double file_skew = 1;
+    double worker_skew = 1;
+};
+
+double since(Clock::time_point start)
+{
+    return std::chrono::duration<double>(Clock::now() - start).count();
+}
+
+double cpu_seconds()
+{
+    struct rusage usage;
+    ::getrusage(RUSAGE_SELF, &usage);
+    return usage.ru_utime.tv_sec + usage.ru_stime.tv_sec + (usage.ru_utime.tv_usec + usage.ru_stime.tv_usec) / 1e6;
+}
+
+bool is_local(const std::string & path)
+{
+    return path.find("://") == std::string::npos;
+}
+
+std::vector<std::string> split(const std::string & s)
+{
+    std::vector<std::string> values;
+    size_t begin = 0;
+    while (begin <= s.size())
+    {
+        const auto end = std::min(s.find(',', begin), s.size());
+        values.push_back(s.substr(begin, end - begin));
+        begin = end + 1;
+    }
+    return values;
+}
+
+bool parse(int argc, char * argv[], Options & options)
+{
+    for (int i = 1; i < argc; ++i)
+    {
+        const std::string arg = argv[i];
+        if (arg.compare(0, 2, "--") != 0)
+        {
+            options.paths.push_back(arg);
+            continue;
+        }
+
+        const auto equal = arg.find('=');
+        if (equal == std::string::npos)
+        {
+            std::cerr << "Expected --<option>=<value> instead of " << arg << std::endl;
+            return false;
+        }
+
+        const auto name = arg.substr(2, equal - 2);
+        const auto values = split(arg.substr(equal + 1));
+
+        if (name == "concurrency")
+        {
+            options.concurrency = values;
+        }
+        else if (name == "chunk-bytesize")
+        {
+            options.chunk_bytesize = values;
+        }
+        else if (name == "executor-threads")
+        {
+            options.executor_threads = values;
+        }
+        else if (name == "responses")
+        {
+            options.responses = values;
+        }
+        else if (name == "cache")
+        {
+            options.caches = values;
+        }
+        else if (name == "iterations")
+        {
+            options.iterations = std::stoul(values.at(0));
+        }
+        else
+        {
+            std::cerr << "Unknown option " << arg << std::endl;
+            return false;
+        }
+    }
+
+    for (const auto & value : options.responses)
+    {
+        if (__responses.count(value) == 0)
+        {
+            std::cerr << "Unknown response mode " << value << std::endl;
+            return false;
+        }
+    }
+
+    for (const auto & value : options.caches)
+    {
+        if (__caches.count(value) == 0)
+        {
+            std::cerr << "Unknown cache mode " << value << std::endl;
+            return false;
+        }
+    }
+
+    return !options.paths.empty() && options.iterations > 0;
+}
+
+// replaces directories by the safetensors files in them
+std::vector<std::string> expand(const std::vector<std::string> & paths)
+{
+    std::vector<std::string> files;
+    for (const auto & path : paths)
+    {
+        DIR * dir = is_local(path) ? ::opendir(path.c_str()) : nullptr;
+        if (dir == nullptr)
+        {
+            files.push_back(path);
+            continue;
+        }
+
+        std::vector<std::string> names;
+        while (const auto entry = ::readdir(dir))
+        {
+            const std::string name = entry->d_name;
+            const std::string suffix = ".safetensors";
+            if (name.size() > suffix.size() && name.compare(name.size() - suffix.size(), suffix.size(), suffix) == 0)
+            {
+                names.push_back(path + "/" + name);
+            }
+        }
+        ::closedir(dir);
+
+        std::sort(names.begin(), names.end());
+        files.insert(files.end(), names.begin(), names.end());
+    }
+    return files;
+}
+
+// receives the responses of a request, and returns false if any of them failed
+bool drain(void * streamer)
+{
+    unsigned file_index;
+    unsigned index;
+    int response_code;
+    while ((response_code = runai_response(streamer, &file_index, &index)) == static_cast<int>(common::ResponseCode::Success))
+    {}
+
+    if (response_code != static_cast<int>(common::ResponseCode::FinishedError))
+    {
+        std::cerr << "Failed reading - " << runai_response_str(response_code) << std::endl;
+        return false;
+    }
+    return true;
+}
+
+// reads ranges of the given sizes from the files, a single range from every file
+bool read(void * streamer, std::vector<const char *> & paths, std::vector<size_t> & offsets, std::vector<size_t> & sizes, char * buffer)
+{
+    const unsigned num_files = paths.size();
+    std::vector<void *> dsts = { buffer };
+    std::vector<unsigned> num_sizes(num_files, 1);
+    std::vector<size_t *> internal_sizes(num_files);
+    for (unsigned i = 0; i < num_files; ++i)
+    {
+        internal_sizes[i] = &sizes[i];
+    }
+
+    const auto response_code = runai_request(streamer, num_files, paths.data(), offsets.data(), sizes.data(), dsts.data(), num_sizes.data(), internal_sizes.data(), nullptr, nullptr, nullptr, nullptr, nullptr);
+    if (response_code != static_cast<int>(common::ResponseCode::Success))
+    {
+        std::cerr << "Failed requesting - " << runai_response_str(response_code) << std::endl;
+        return false;
+    }
+
+    return drain(streamer);
+}
+
+// reads the headers of the files through the streamer, as a loader does
+//
+// a safetensors file starts with the little endian bytesize of its JSON header, where every tensor has "data_offsets":[begin,end] relative to the end of the header
+bool headers(void * streamer, std::vector<const char *> & paths, std::vector<Layout> & layouts)
+{
+    const unsigned num_files = paths.size();
+
+    std::vector<size_t> offsets(num_files, 0);
+    std::vector<size_t> sizes(num_files, sizeof(uint64_t));
+    std::vector<uint64_t> lengths(num_files);
+    if (!read(streamer, paths, offsets, sizes, reinterpret_cast<char *>(lengths.data())))
+    {
+        return false;
+    }
+
+    size_t total = 0;
+    for (unsigned i = 0; i < num_files; ++i)
+    {
+        offsets[i] = sizeof(uint64_t);
+        sizes[i] = lengths[i];
+        total += lengths[i];
+    }
+
+    std::vector<char> buffer(total);
+    if (!read(streamer, paths, offsets, sizes, buffer.data()))
+    {
+        return false;
+    }
+
+    layouts.resize(num_files);
+
+    const std::regex data_offsets("\"data_offsets\"\\s*:\\s*\\[\\s*([0-9]+)\\s*,\\s*([0-9]+)\\s*\\]");
+    const char * header = buffer.data();
+    for (unsigned i = 0; i < num_files; ++i)
+    {
+        std::vector<std::pair<size_t, size_t>> tensors;
+        for (std::cregex_iterator it(header, header + lengths[i], data_offsets), end; it != end; ++it)
+        {
+            tensors.emplace_back(std::stoul((*it)[1]), std::stoul((*it)[2]));
+        }
+        header += lengths[i];
+
+        std::sort(tensors.begin(), tensors.end());
+        if (tensors.empty() || tensors.front().first != 0)
+        {
+            std::cerr << "Invalid safetensors header of " << paths[i] << std::endl;
+            return false;
+        }
+
+        // every tensor extends until the next one, so that the sub requests are contiguous
+        auto & layout = layouts[i];
+        layout.offset = sizeof(uint64_t) + lengths[i];
+        for (unsigned j = 0; j < tensors.size(); ++j)
+        {
+            const auto end = (j + 1 < tensors.size() ? tensors[j + 1].first : tensors[j].second);
+            layout.sizes.push_back(end - tensors[j].first);
+        }
+        layout.bytesize = tensors.back().second;
+    }
+
+    return true;
+}
+
+// completion times of the files, recorded from the thread which receives the responses or from the callbacks
+struct Completions
+{
+    Completions(unsigned num_files, Clock::time_point start) :
+        start(start),
+        files(num_files, 0)
+    {}
+
+    void record(unsigned num_responses, const unsigned * file_indices, const int * response_codes)
+    {
+        const auto now = since(start);
+
+        const auto guard = std::unique_lock<std::mutex>(mutex);
+        if (first == 0)
+        {
+            first = now;
+        }
+
+        for (unsigned i = 0; i < num_responses; ++i)
+        {
+            files.at(file_indices[i]) = now;
+            success &= (response_codes[i] == static_cast<int>(common::ResponseCode::Success));
+        }
+    }
+
+    static void callback(void * user_data, unsigned num_responses, const unsigned * file_indices, const unsigned *, const int * response_codes)
+    {
+        static_cast<Completions *>(user_data)->record(num_responses, file_indices, response_codes);
+    }
+
+    const Clock::time_point start;
+    std::mutex mutex;
+    double first = 0;
+    std::vector<double> files;
+    bool success = true;
+};
+
+bool receive(void * streamer, Responses mode, Completions & completions)
+{
+    if (mode == Responses::Callback)
+    {
+        // returns once all the callbacks have returned
+        unsigned file_index;
+        unsigned index;
+        return runai_response(streamer, &file_index, &index) == static_cast<int>(common::ResponseCode::FinishedError);
+    }
+
+    if (mode == Responses::Response)
+    {
+        unsigned file_index;
+        unsigned index;
+        int response_code;
+        while ((response_code = runai_response(streamer, &file_index, &index)) != static_cast<int>(common::ResponseCode::FinishedError))
+        {
+            completions.record(1, &file_index, &response_code);
+        }
+        return true;
+    }
+
+    int fd;
+    runai_response_eventfd(streamer, &fd);
+
+    constexpr unsigned max_responses = 1024;
+    std::vector<unsigned> file_indices(max_responses);
+    std::vector<unsigned> indices(max_responses);
+    std::vector<int> response_codes(max_responses);
+
+    while (true)
+    {
+        unsigned num_responses = 0;
+        if (runai_responses(streamer, max_responses, file_indices.data(), indices.data(), response_codes.data(), &num_responses) == static_cast<int>(common::ResponseCode::FinishedError))
+        {
+            return true;
+        }
+
+        if (num_responses > 0)
+        {
+            completions.record(num_responses, file_indices.data(), response_codes.data());
+            continue;
+        }
+
+        struct pollfd pfd = { fd, POLLIN, 0 };
+        if (::poll(&pfd, 1, -1) > 0)
+        {
+            uint64_t value;
+            ::read(fd, &value, sizeof(value));
+        }
+    }
+}
+
+// busiest worker relative to the average worker, by the duration of the workloads of the last request in the timeline
+double worker_skew(const std::string & path)
+{
+    std::ifstream file(path);
+
+    const std::regex event("\"name\":\"(\\w+)\".*\"ts\":([0-9.]+),\"dur\":([0-9.]+).*\"tid\":([0-9]+)");
+
+    double plan = 0;
+    std::vector<std::tuple<double, double, unsigned>> workloads;
+
+    std::string line;
+    std::smatch match;
+    while (std::getline(file, line))
+    {
+        if (!std::regex_search(line, match, event))
+        {
+            continue;
+        }
+
+        const double ts = std::stod(match[2]);
+        if (match[1] == "plan")
+        {
+            plan = std::max(plan, ts);
+        }
+        else if (match[1] == "workload")
+        {
+            workloads.emplace_back(ts, std::stod(match[3]), std::stoul(match[4]));
+        }
+    }
+
+    std::map<unsigned, double> busy;
+    for (const auto & [ts, duration, tid] : workloads)
+    {
+        if (ts >= plan)
+        {
+            busy[tid] += duration;
+        }
+    }
+
+    if (busy.empty())
+    {
+        return 1;
+    }
+
+    double max = 0;
+    double total = 0;
+    for (const auto & [tid, duration] : busy)
+    {
+        max = std::max(max, duration);
+        total += duration;
+    }
+    return total > 0 ? max / (total / busy.size()) : 1;
+}
+
+void drop(const std::vector<std::string> & paths, Cache cache)
+{
+    if (cache == Cache::Cold)
+    {
+        ::sync();
+        std::ofstream drop_caches("/proc/sys/vm/drop_caches");
+        if (!(drop_caches << "3" << std::flush))
+        {
+            std::cerr << "Failed dropping the page cache of the system (requires root), evicting the files instead" << std::endl;
+        }
+    }
+
+    for (const auto & path : paths)
+    {
+        if (is_local(path))
+        {
+            utils::Fd fd(::open(path.c_str(), O_RDONLY));
+            if (fd.fd() != -1)
+            {
+                ::posix_fadvise(fd.fd(), 0, 0, POSIX_FADV_DONTNEED);
+            }
+        }
+    }
+}
+
+Result run(const std::vector<std::string> & files, const Configuration & configuration, std::vector<char> & buffer)
+{
+    std::list<utils::temp::Env> env;
+    for (const auto & [name, value] : std::vector<std::pair<const char *, std::string>>{
+            { "RUNAI_STREAMER_CONCURRENCY", configuration.concurrency },
+            { "RUNAI_STREAMER_CHUNK_BYTESIZE", configuration.chunk_bytesize },
+            { "RUNAI_STREAMER_EXECUTOR_THREADS", configuration.executor_threads } })
+    {
+        if (!value.empty())
+        {
+            env.emplace_back(name, value);
+        }
+    }
+
+    // the timeline of the streamer threads is written when the streamer ends
+    const utils::temp::Path trace("/tmp", "runai-streamer-bench-" + std::to_string(::getpid()) + ".json");
+    env.emplace_back("RUNAI_STREAMER_TRACE", trace.path);
+
+    std::vector<const char *> paths;
+    for (const auto & file : files)
+    {
+        paths.push_back(file.c_str());
+    }
+
+    const auto cache = __caches.at(configuration.cache);
+    if (cache != Cache::Warm)
+    {
+        drop(files, cache);
+    }
+
+    Result result;
+    const auto cpu = cpu_seconds();
+    const auto start = Clock::now();
+
+    void * streamer;
+    if (runai_start(&streamer) != static_cast<int>(common::ResponseCode::Success))
+    {
+        std::cerr << "Failed starting the streamer" << std::endl;
+        result.success = false;
+        return result;
+    }
+
+    std::vector<Layout> layouts;
+    result.success = headers(streamer, paths, layouts);
+
+    Completions completions(files.size(), start);
+    const auto mode = __responses.at(configuration.responses);
+
+    if (result.success)
+    {
+        std::vector<size_t> offsets;
+        std::vector<size_t> bytesizes;
+        std::vector<unsigned> num_sizes;
+        std::vector<size_t *> internal_sizes;
+        size_t total = 0;
+        for (auto & layout : layouts)
+        {
+            offsets.push_back(layout.offset);
+            bytesizes.push_back(layout.bytesize);
+            num_sizes.push_back(layout.sizes.size());
+            internal_sizes.push_back(layout.sizes.data());
+            total += layout.bytesize;
+        }
+        result.bytesize = total;
+
+        if (buffer.size() < total)
+        {
+            // the memory is touched before measuring, so that its page faults are not measured
+            buffer.resize(total);
+        }
+
+        if (mode == Responses::Callback)
+        {
+            runai_set_completion_callback(streamer, &Completions::callback, &completions);
+        }
+
+        std::vector<void *> dsts = { buffer.data() };
+        const auto response_code = runai_request(streamer, paths.size(), paths.data(), offsets.data(), bytesizes.data(), dsts.data(), num_sizes.data(), internal_sizes.data(), nullptr, nullptr, nullptr, nullptr, nullptr);
+        if (response_code != static_cast<int>(common::ResponseCode::Success))
+        {
+            std::cerr << "Failed requesting - " << runai_response_str(response_code) << std::endl;
+            result.success = false;
+        }
+        else
+        {
+            result.success = receive(streamer, mode, completions) && completions.success;
+        }
+    }
+
+    result.seconds = since(start);
+    result.cpu = cpu_seconds() - cpu;
+    result.first = completions.first;
+
+    runai_end(streamer);
+
+    if (result.success)
+    {
+        const auto [earliest, latest] = std::minmax_element(completions.files.begin(), completions.files.end());
+        result.file_skew = *earliest > 0 ? *latest / *earliest : 1;
+        result.worker_skew = worker_skew(trace.path);
+    }
+
+    return result;
+}
+
+} // namespace
+
+int bench(int argc, char * argv[])
+{
+    Options options;
+    if (!parse(argc, argv, options))
+    {
+        std::cerr << "Usage: " << argv[0] << " <directory | file | uri>... [--concurrency=<n>,...] [--chunk-bytesize=<n>,...] [--executor-threads=<n>,...]" << std::endl
+                  << "       [--responses=<response|responses|callback>,...] [--cache=<cold|dropped|warm>,...] [--iterations=<n>]" << std::endl;
+        return 1;
+    }
+
+    const auto files = expand(options.paths);
+    if (files.empty())
+    {
+        std::cerr << "No safetensors files in " << options.paths.front() << std::endl;
+        return 1;
+    }
+
+    std::vector<char> buffer;
+
+    std::vector<Configuration> configurations;
+    for (const auto & concurrency : options.concurrency)
+    {
+        for (const auto & chunk_bytesize : options.chunk_bytesize)
+        {
+            for (const auto & executor_threads : options.executor_threads)
+            {
+                for (const auto & responses : options.responses)
+                {
+                    for (const auto & cache : options.caches)
+                    {
+                        configurations.push_back({concurrency, chunk_bytesize, executor_threads, responses, cache});
+                    }
+                }
+            }
+        }
+    }
+
+    std::cout << std::fixed << std::setprecision(3);
+
+    const Configuration * best = nullptr;
+    double best_throughput = 0;
+
+    for (const auto & configuration : configurations)
+    {
+        std::cout << configuration << std::endl;
+
+        // the files are read once to warm the page cache, which also finds their bytesize
+        if (__caches.at(configuration.cache) == Cache::Warm && !run(files, configuration, buffer).success)
+        {
+            return 1;
+        }
+
+        size_t bytesize = 0;
+        double throughput = 0;
+        for (unsigned i = 0; i < options.iterations; ++i)
+        {
+            const auto result = run(files, configuration, buffer);
+            if (!result.success)
+            {
+                std::cerr << "Failed reading with " << configuration << std::endl;
+                return 1;
+            }
+
+            bytesize = result.bytesize;
+            const auto mib_per_second = bytesize / result.seconds / (1024 * 1024);
+            throughput += mib_per_second / options.iterations;
+
+            std::cout << "    iteration " << i << ": "
+                      << "first tensor " << result.first << " seconds, "
+                      << "total " << result.seconds << " seconds, "
+                      << mib_per_second << " MiB/s, "
+                      << "cpu " << result.cpu << " seconds, "
+                      << "file skew " << result.file_skew << ", "
+                      << "worker skew " << result.worker_skew << std::endl;
+        }
+
+        std::cout << "    average " << throughput << " MiB/s of " << bytesize << " bytes in " << files.size() << " files" << std::endl;
+
+        if (throughput > best_throughput)
+        {
+            best_throughput = throughput;
+            best = &configuration;
+        }
+    }
+
+    if (configurations.size() > 1 && best != nullptr)
+    {
+        std::cout << "best: " << *best << " - " << best_throughput << " MiB/s" << std::endl;
+    }
+
+    return 0;
+}
+
+}; // namespace runai::llm::streamer
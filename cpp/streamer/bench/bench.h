@@ -0,0 +1,10 @@
+#pragma once
+
+namespace runai::llm::streamer
+{
+
+// measures loading the given safetensors files with the streamer, as described in bench.cc
+// returns the exit code of the benchmark
+int bench(int argc, char * argv[]);
+
+}; // namespace runai::llm::streamer
@@ -0,0 +1,6 @@
+#include "streamer/bench/bench.h"
+
+int main(int argc, char * argv[])
+{
+    return runai::llm::streamer::bench(argc, argv);
+}
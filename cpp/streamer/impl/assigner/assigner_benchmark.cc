@@ -0,0 +1,45 @@
+#include "streamer/impl/assigner/assigner.h"
+
+#include <benchmark/benchmark.h>
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "streamer/impl/config/config.h"
+
+#include "utils/random/random.h"
+
+namespace runai::llm::streamer::impl
+{
+
+// planning the reads of files of 1 GiB each against the number of files, for the file system and object storage
+void BM_Assigner(benchmark::State & state)
+{
+    const unsigned num_files = state.range(0);
+    const bool is_object_storage = state.range(1);
+
+    std::vector<std::string> paths;
+    std::vector<size_t> offsets(num_files, 0);
+    std::vector<size_t> sizes(num_files, 1024UL * 1024 * 1024);
+    std::vector<void *> dsts(num_files, nullptr);
+
+    for (unsigned i = 0; i < num_files; ++i)
+    {
+        paths.push_back((is_object_storage ? "s3://bucket/" : "") + utils::random::string());
+    }
+
+    auto config = std::make_shared<Config>();
+
+    for (auto _ : state)
+    {
+        Assigner assigner(paths, offsets, sizes, dsts, config);
+        benchmark::DoNotOptimize(assigner.num_workloads());
+    }
+
+    state.SetItemsProcessed(state.iterations() * num_files);
+}
+
+BENCHMARK(BM_Assigner)->ArgsProduct({benchmark::CreateRange(1, 1024, 4), {false, true}})->ArgNames({"files", "object_storage"});
+
+}; // namespace runai::llm::streamer::impl
@@ -0,0 +1,308 @@
+#include "streamer/impl/autotune/autotune.h"
+
+#include <fcntl.h>
+#include <limits.h>
+#include <stdlib.h>
+#include <sys/file.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <fstream>
+#include <sstream>
+#include <tuple>
+#include <utility>
+
+#include "common/exception/exception.h"
+#include "common/s3_wrapper/s3_wrapper.h"
+#include "common/storage_uri/storage_uri.h"
+
+#include "utils/env/env.h"
+#include "utils/fd/fd.h"
+#include "utils/logging/logging.h"
+
+namespace runai::llm::streamer::impl
+{
+
+namespace
+{
+
+bool is_object_storage(const std::string & target)
+{
+    return target.find("://") != std::string::npos;
+}
+
+// the top directory of the file system of a path
+std::string mount_point(const std::string & path)
+{
+    char resolved[PATH_MAX];
+    std::string current = ::realpath(path.c_str(), resolved) != nullptr ? resolved : path;
+
+    struct stat st = {};
+    if (::stat(current.c_str(), &st) != 0)
+    {
+        return current;
+    }
+    const auto device = st.st_dev;
+
+    while (current != "/")
+    {
+        const auto slash = current.rfind('/');
+        const auto parent = slash == 0 || slash == std::string::npos ? std::string("/") : current.substr(0, slash);
+        if (::stat(parent.c_str(), &st) != 0 || st.st_dev != device)
+        {
+            break;
+        }
+        current = parent;
+    }
+    return current;
+}
+
+} // namespace
+
+bool Autotune::Setting::operator==(const Setting & other) const
+{
+    return concurrency == other.concurrency && block_bytesize == other.block_bytesize;
+}
+
+bool Autotune::Setting::operator<(const Setting & other) const
+{
+    return std::tie(concurrency, block_bytesize) < std::tie(other.concurrency, other.block_bytesize);
+}
+
+bool Autotune::Measurement::complete() const
+{
+    return throughputs.size() >= samples;
+}
+
+double Autotune::Measurement::median() const
+{
+    if (throughputs.empty())
+    {
+        return 0;
+    }
+
+    auto sorted = throughputs;
+    const auto middle = sorted.begin() + sorted.size() / 2;
+    std::nth_element(sorted.begin(), middle, sorted.end());
+    return *middle;
+}
+
+Autotune::Autotune(const std::string & path, const Config & config) :
+    _path(path),
+    _fs{std::min(config.concurrency, max_concurrency), config.fs_block_bytesize},
+    _object_storage{std::min(config.s3_concurrency, max_concurrency), config.s3_block_bytesize}
+{
+    std::ifstream file(_path);
+    unsigned concurrency;
+    size_t block_bytesize;
+    double throughput;
+    bool converged;
+    std::string target;
+    while (file >> concurrency >> block_bytesize >> throughput >> converged && std::getline(file >> std::ws, target))
+    {
+        if (concurrency == 0 || block_bytesize == 0)
+        {
+            LOG(WARNING) << "Ignoring invalid autotune setting of " << target << " in " << _path;
+            continue;
+        }
+
+        // the persisted throughput is the median of the measurements of a previous search
+        auto & state = _states[target];
+        state.best = Setting{std::min(concurrency, max_concurrency), block_bytesize};
+        state.measurement.throughputs.assign(samples, throughput);
+        state.converged = converged;
+    }
+
+    LOG(DEBUG) << "Autotune profile " << _path << " holds " << _states.size() << " targets";
+}
+
+std::string Autotune::target(const std::string & path)
+{
+    try
+    {
+        const common::s3::StorageUri uri(path);
+        const auto endpoint = utils::getenv<std::string>("AWS_ENDPOINT_URL", "");
+        return uri.scheme + "://" + uri.bucket + (endpoint.empty() || uri.scheme != "s3" ? "" : "@" + endpoint);
+    }
+    catch (const std::exception &)
+    {
+    }
+
+    return mount_point(path);
+}
+
+Autotune::State & Autotune::state(const std::string & target)
+{
+    auto it = _states.find(target);
+    if (it == _states.end())
+    {
+        it = _states.emplace(target, State()).first;
+        it->second.best = is_object_storage(target) ? _object_storage : _fs;
+        LOG(INFO) << "Autotuning " << target << " from " << it->second.best;
+    }
+    return it->second;
+}
+
+std::vector<Autotune::Setting> Autotune::neighbours(const std::string & target, const Setting & setting) const
+{
+    const size_t min_block_bytesize = is_object_storage(target) ? common::s3::S3ClientWrapper::min_chunk_bytesize : Config::min_fs_block_bytesize;
+
+    std::vector<Setting> result;
+    const auto add = [&](unsigned concurrency, size_t block_bytesize)
+    {
+        concurrency = std::clamp(concurrency, 1U, max_concurrency);
+        block_bytesize = std::clamp(block_bytesize, min_block_bytesize, std::max(min_block_bytesize, max_block_bytesize));
+
+        const Setting neighbour{concurrency, block_bytesize};
+        if (!(neighbour == setting) && std::find(result.begin(), result.end(), neighbour) == result.end())
+        {
+            result.push_back(neighbour);
+        }
+    };
+
+    add(setting.concurrency * 2, setting.block_bytesize);
+    add(setting.concurrency / 2, setting.block_bytesize);
+    add(setting.concurrency, setting.block_bytesize * 2);
+    add(setting.concurrency, setting.block_bytesize / 2);
+    return result;
+}
+
+Autotune::Setting Autotune::next(const std::string & target)
+{
+    const auto guard = std::unique_lock<std::mutex>(_mutex);
+    auto & state = this->state(target);
+
+    if (state.converged || !state.measurement.complete())
+    {
+        return state.best;
+    }
+
+    // the neighbour with the fewest measurements, so that the neighbours are measured in turns
+    const auto candidates = neighbours(target, state.best);
+    const Setting * next = nullptr;
+    size_t fewest = samples;
+    for (const auto & neighbour : candidates)
+    {
+        const auto it = state.neighbours.find(neighbour);
+        const size_t measured = it == state.neighbours.end() ? 0 : it->second.throughputs.size();
+        if (measured < fewest)
+        {
+            next = &neighbour;
+            fewest = measured;
+        }
+    }
+    return next == nullptr ? state.best : *next;
+}
+
+void Autotune::report(const std::string & target, const Setting & setting, size_t bytesize, std::chrono::steady_clock::duration elapsed)
+{
+    const double seconds = std::chrono::duration<double>(elapsed).count();
+    if (bytesize < min_bytesize || seconds <= 0)
+    {
+        LOG(DEBUG) << "Not measuring a request of " << bytesize << " bytes to " << target;
+        return;
+    }
+
+    const double throughput = bytesize / seconds;
+
+    const auto guard = std::unique_lock<std::mutex>(_mutex);
+    auto & state = this->state(target);
+    if (state.converged)
+    {
+        return;
+    }
+
+    LOG(DEBUG) << "Autotune measured " << utils::logging::human_readable_size(throughput) << " per second with " << setting << " from " << target;
+
+    const auto candidates = neighbours(target, state.best);
+    if (setting == state.best)
+    {
+        state.measurement.throughputs.push_back(throughput);
+    }
+    else if (std::find(candidates.begin(), candidates.end(), setting) != candidates.end())
+    {
+        state.neighbours[setting].throughputs.push_back(throughput);
+    }
+    else
+    {
+        // measured with a setting of a previous round
+        return;
+    }
+
+    // the settings are compared once the best setting and all its neighbours were measured by enough requests
+    const bool complete = state.measurement.complete() && std::all_of(candidates.begin(), candidates.end(), [&](const Setting & candidate)
+        {
+            const auto it = state.neighbours.find(candidate);
+            return it != state.neighbours.end() && it->second.complete();
+        });
+
+    if (complete)
+    {
+        const auto best = std::max_element(state.neighbours.begin(), state.neighbours.end(), [](const auto & a, const auto & b) { return a.second.median() < b.second.median(); });
+        if (best->second.median() > state.measurement.median() * (1 + tolerance))
+        {
+            LOG(INFO) << "Autotune of " << target << " moves to " << best->first << " - " << utils::logging::human_readable_size(best->second.median()) << " per second";
+            state.best = best->first;
+            state.measurement = best->second;
+        }
+        else
+        {
+            LOG(INFO) << "Autotune of " << target << " converged to " << state.best << " - " << utils::logging::human_readable_size(state.measurement.median()) << " per second";
+            state.converged = true;
+        }
+        state.neighbours.clear();
+    }
+
+    try
+    {
+        save(target, state);
+    }
+    catch (const std::exception &)
+    {
+        LOG(WARNING) << "Failed saving the autotune profile " << _path;
+    }
+}
+
+void Autotune::save(const std::string & target, const State & state) const
+{
+    // the processes of the host update the profile one at a time, and closing the lock file releases the lock
+    const auto lock_path = _path + ".lock";
+    utils::Fd lock(::open(lock_path.c_str(), O_RDWR | O_CREAT | O_CLOEXEC, 0666));
+    PASSERT(lock.fd() != -1) << "Failed opening autotune lock file " << lock_path;
+    PASSERT(::flock(lock.fd(), LOCK_EX) == 0) << "Failed locking autotune lock file " << lock_path;
+
+    std::stringstream contents;
+    {
+        std::ifstream file(_path);
+        std::string line;
+        while (std::getline(file, line))
+        {
+            std::stringstream ss(line);
+            std::string skip;
+            std::string other;
+            if (ss >> skip >> skip >> skip >> skip && std::getline(ss >> std::ws, other) && other != target)
+            {
+                contents << line << '\n';
+            }
+        }
+    }
+    contents << state.best.concurrency << ' ' << state.best.block_bytesize << ' ' << static_cast<size_t>(state.measurement.median()) << ' ' << state.converged << ' ' << target << '\n';
+    const auto str = contents.str();
+
+    // replace the profile atomically
+    const auto temp = _path + "." + std::to_string(::getpid()) + ".tmp";
+    {
+        utils::Fd fd(::open(temp.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0666));
+        PASSERT(fd.fd() != -1) << "Failed creating autotune profile " << temp;
+        fd.write(str.data(), str.size());
+    }
+    PASSERT(::rename(temp.c_str(), _path.c_str()) == 0) << "Failed renaming autotune profile " << temp;
+}
+
+std::ostream & operator<<(std::ostream & os, const Autotune::Setting & setting)
+{
+    return os << "concurrency " << setting.concurrency << " ; block size " << setting.block_bytesize << " bytes";
+}
+
+}; // namespace runai::llm::streamer::impl
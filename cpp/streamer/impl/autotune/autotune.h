@@ -0,0 +1,101 @@
+#pragma once
+
+#include <stddef.h>
+
+#include <chrono>
+#include <map>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <vector>
+
+#include "streamer/impl/config/config.h"
+
+namespace runai::llm::streamer::impl
+{
+
+// Tunes the block size and the concurrency of every storage target by the measured throughput of the requests read from it
+//
+// A target is an object storage bucket (with its endpoint if one is configured) or the mount point of a local path
+// Every request to a target reads with a setting, and the search climbs from the best setting to its neighbours - doubling or halving
+// either the concurrency or the block size - until none of them improves the throughput of the best setting by more than the tolerance
+// Every setting is measured by several requests, and compared by the median of its measurements, so that a single noisy request does not move the search
+// Requests which are too small or fail are not measured, as their throughput says little about the setting
+//
+// The best setting of every target is persisted in a profile file of the host, from which the search starts the next time,
+// and a converged target is read with its best setting without searching
+// The file holds a line per target - "<concurrency> <block bytesize> <bytes per second> <converged> <target>"
+// and is shared by the processes of the host, where every process replaces only the lines of the targets it measured
+
+struct Autotune
+{
+    struct Setting
+    {
+        unsigned concurrency;
+        size_t block_bytesize;
+
+        bool operator==(const Setting & other) const;
+        bool operator<(const Setting & other) const;
+    };
+
+    // reads the profile file, and starts new targets from the setting of the configuration
+    Autotune(const std::string & path, const Config & config);
+
+    // storage target of a path
+    static std::string target(const std::string & path);
+
+    // setting of the next request to the target
+    Setting next(const std::string & target);
+
+    // reports the throughput of a successful request to the target which was read with the setting
+    void report(const std::string & target, const Setting & setting, size_t bytesize, std::chrono::steady_clock::duration elapsed);
+
+    // bounds of the search
+    static constexpr unsigned max_concurrency = 64;
+    static constexpr size_t max_block_bytesize = 64 * 1024 * 1024;
+
+    // requests below this bytesize are not measured
+    static constexpr size_t min_bytesize = 64 * 1024 * 1024;
+
+    // relative improvement of the throughput required to move to a neighbour
+    static constexpr double tolerance = 0.05;
+
+    // measurements of every setting before the settings are compared
+    static constexpr unsigned samples = 3;
+
+ private:
+    // bytes per second of the requests read with a setting
+    struct Measurement
+    {
+        std::vector<double> throughputs;
+
+        bool complete() const;
+        double median() const;
+    };
+
+    struct State
+    {
+        Setting best;
+        Measurement measurement;
+        bool converged = false;
+        // measurements of the neighbours of the best setting
+        std::map<Setting, Measurement> neighbours;
+    };
+
+    State & state(const std::string & target);
+    std::vector<Setting> neighbours(const std::string & target, const Setting & setting) const;
+
+    // replaces the line of the target in the profile file
+    void save(const std::string & target, const State & state) const;
+
+    const std::string _path;
+    const Setting _fs;
+    const Setting _object_storage;
+
+    std::mutex _mutex;
+    std::map<std::string, State> _states;
+};
+
+std::ostream & operator<<(std::ostream &, const Autotune::Setting &);
+
+}; // namespace runai::llm::streamer::impl
@@ -0,0 +1,210 @@
+#include "streamer/impl/autotune/autotune.h"
+
+#include <gtest/gtest.h>
+#include <limits.h>
+#include <stdlib.h>
+
+#include <chrono>
+#include <fstream>
+#include <map>
+#include <set>
+#include <string>
+
+#include "utils/random/random.h"
+#include "utils/temp/dir/dir.h"
+#include "utils/temp/env/env.h"
+#include "utils/temp/file/file.h"
+
+namespace runai::llm::streamer::impl
+{
+
+struct AutotuneTest : ::testing::Test
+{
+    AutotuneTest() :
+        path(dir.path + "/profile"),
+        config(utils::random::number(2, 32), utils::random::number(2, 32), 16 * 1024 * 1024, 16 * 1024 * 1024, false),
+        target("/" + utils::random::string())
+    {}
+
+    // reports a request of the minimal measured bytesize, which took the given milliseconds
+    static void report(Autotune & autotune, const std::string & target, const Autotune::Setting & setting, unsigned milliseconds)
+    {
+        autotune.report(target, setting, Autotune::min_bytesize, std::chrono::milliseconds(milliseconds));
+    }
+
+    utils::temp::Dir dir;
+    std::string path;
+    Config config;
+    std::string target;
+};
+
+TEST_F(AutotuneTest, Target)
+{
+    const auto bucket = utils::random::string();
+    EXPECT_EQ(Autotune::target("s3://" + bucket + "/" + utils::random::string()), "s3://" + bucket);
+    EXPECT_EQ(Autotune::target("gs://" + bucket + "/" + utils::random::string()), "gs://" + bucket);
+
+    {
+        const auto endpoint = "http://127.0.0.1:" + std::to_string(utils::random::number(1024, 65535));
+        utils::temp::Env endpoint_("AWS_ENDPOINT_URL", endpoint);
+        EXPECT_EQ(Autotune::target("s3://" + bucket + "/" + utils::random::string()), "s3://" + bucket + "@" + endpoint);
+    }
+
+    // files of a directory are on the same mount point, which contains them
+    utils::temp::File file(dir.path);
+    const auto mount_point = Autotune::target(file.path);
+    EXPECT_EQ(Autotune::target(dir.path), mount_point);
+    char resolved[PATH_MAX];
+    ASSERT_NE(::realpath(file.path.c_str(), resolved), nullptr);
+    EXPECT_EQ(std::string(resolved).compare(0, mount_point.size(), mount_point), 0) << resolved << " is not under " << mount_point;
+}
+
+TEST_F(AutotuneTest, Initial)
+{
+    Autotune autotune(path, config);
+
+    const auto fs = autotune.next(target);
+    EXPECT_EQ(fs.concurrency, config.concurrency);
+    EXPECT_EQ(fs.block_bytesize, config.fs_block_bytesize);
+
+    const auto object_storage = autotune.next("s3://" + utils::random::string());
+    EXPECT_EQ(object_storage.concurrency, config.s3_concurrency);
+    EXPECT_EQ(object_storage.block_bytesize, config.s3_block_bytesize);
+}
+
+TEST_F(AutotuneTest, Converge)
+{
+    Autotune autotune(path, config);
+
+    const auto initial = autotune.next(target);
+    for (unsigned i = 0; i < Autotune::samples; ++i)
+    {
+        EXPECT_EQ(autotune.next(target), initial);
+        report(autotune, target, initial, 100);
+    }
+
+    // every neighbour is tried by several requests, and none of them is faster
+    std::map<Autotune::Setting, unsigned> tried;
+    while (true)
+    {
+        const auto setting = autotune.next(target);
+        if (setting == initial)
+        {
+            break;
+        }
+        EXPECT_LT(tried[setting]++, Autotune::samples);
+        EXPECT_TRUE(setting.concurrency == initial.concurrency || setting.block_bytesize == initial.block_bytesize);
+        report(autotune, target, setting, 100 + utils::random::number(0, 100));
+    }
+    EXPECT_EQ(tried.size(), 4);
+    for (const auto & [setting, count] : tried)
+    {
+        EXPECT_EQ(count, Autotune::samples);
+    }
+
+    // converged
+    report(autotune, target, initial, 1000);
+    EXPECT_EQ(autotune.next(target), initial);
+
+    // persisted, and read without searching
+    Autotune other(path, config);
+    EXPECT_EQ(other.next(target), initial);
+    report(other, target, initial, 1);
+    EXPECT_EQ(other.next(target), initial);
+}
+
+TEST_F(AutotuneTest, Move)
+{
+    Autotune autotune(path, config);
+
+    const auto initial = autotune.next(target);
+    for (unsigned i = 0; i < Autotune::samples; ++i)
+    {
+        report(autotune, target, initial, 100);
+    }
+
+    // the fastest neighbour becomes the best setting, whose neighbours are tried next
+    const Autotune::Setting faster{initial.concurrency * 2, initial.block_bytesize};
+    for (unsigned i = 0; i < 4 * Autotune::samples; ++i)
+    {
+        const auto setting = autotune.next(target);
+        report(autotune, target, setting, setting == faster ? 50 : 100);
+    }
+
+    const auto next = autotune.next(target);
+    EXPECT_FALSE(next == initial);
+    EXPECT_FALSE(next == faster);
+    EXPECT_TRUE(next.concurrency == faster.concurrency || next.block_bytesize == faster.block_bytesize);
+
+    // the search continues from the persisted best setting
+    Autotune other(path, config);
+    EXPECT_EQ(other.next(target), next);
+
+    std::ifstream file(path);
+    std::string line;
+    ASSERT_TRUE(std::getline(file, line));
+    EXPECT_EQ(line.compare(0, std::to_string(faster.concurrency).size() + 1, std::to_string(faster.concurrency) + " "), 0);
+    EXPECT_FALSE(std::getline(file, line));
+}
+
+TEST_F(AutotuneTest, Noise)
+{
+    Autotune autotune(path, config);
+
+    const auto initial = autotune.next(target);
+    for (unsigned i = 0; i < Autotune::samples; ++i)
+    {
+        report(autotune, target, initial, 100);
+    }
+
+    // a single fast request of a neighbour is outweighed by its other requests
+    std::set<Autotune::Setting> fast;
+    while (true)
+    {
+        const auto setting = autotune.next(target);
+        if (setting == initial)
+        {
+            break;
+        }
+        report(autotune, target, setting, fast.insert(setting).second ? 10 : 100 + utils::random::number(0, 100));
+    }
+
+    // converged
+    EXPECT_EQ(fast.size(), 4);
+    report(autotune, target, initial, 1000);
+    EXPECT_EQ(autotune.next(target), initial);
+}
+
+TEST_F(AutotuneTest, Small_Requests)
+{
+    Autotune autotune(path, config);
+
+    const auto initial = autotune.next(target);
+    autotune.report(target, initial, Autotune::min_bytesize - 1, std::chrono::milliseconds(1));
+
+    // not measured
+    EXPECT_EQ(autotune.next(target), initial);
+    EXPECT_FALSE(utils::temp::Path::exists(path));
+}
+
+TEST_F(AutotuneTest, Targets)
+{
+    const auto other_target = "/" + utils::random::string();
+    {
+        Autotune autotune(path, config);
+        report(autotune, target, autotune.next(target), 100);
+        report(autotune, other_target, autotune.next(other_target), 100);
+    }
+
+    // every target keeps its line
+    std::ifstream file(path);
+    unsigned lines = 0;
+    std::string line;
+    while (std::getline(file, line))
+    {
+        ++lines;
+    }
+    EXPECT_EQ(lines, 2);
+}
+
+}; // namespace runai::llm::streamer::impl
@@ -0,0 +1,289 @@
+#include "streamer/impl/bandwidth/bandwidth.h"
+
+#include <algorithm>
+#include <thread>
+#include <utility>
+
+#include "utils/logging/logging.h"
+
+namespace runai::llm::streamer::impl
+{
+
+struct Bandwidth::Header
+{
+    // limit of the node in bytes per second
+    std::atomic<uint64_t> limit;
+    // tokens of the bucket in bytes, which are negative while reads wait for them
+    std::atomic<int64_t> tokens;
+    // monotonic time of the last refill of the bucket, which is shared by the processes of the node
+    std::atomic<int64_t> refilled;
+};
+
+struct Bandwidth::Slot
+{
+    // weight of the process which holds the lock of the slot, or zero if the slot is free
+    std::atomic<uint32_t> weight;
+    // monotonic time the process last waited for tokens
+    std::atomic<int64_t> competing;
+};
+
+static_assert(std::atomic<uint64_t>::is_always_lock_free && std::atomic<int64_t>::is_always_lock_free, "Shared atomics must be lock free");
+
+namespace
+{
+
+constexpr auto poll_interval = std::chrono::milliseconds(10);
+constexpr auto open_timeout = std::chrono::seconds(10);
+
+int64_t now_ns()
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+} // namespace
+
+Bandwidth::Bandwidth(size_t limit, unsigned weight, const std::string & name) :
+    _weight(weight),
+    _refilled(Clock::now())
+{
+    ASSERT(limit > 0) << "Bandwidth limit must be positive";
+    ASSERT(weight > 0) << "Bandwidth weight must be positive";
+
+    // the segment is zeroed when created, which is a valid state with no registered processes
+    const size_t bytesize = sizeof(Header) + max_slots * sizeof(Slot);
+    const auto deadline = Clock::now() + open_timeout;
+    while (true)
+    {
+        auto shm = utils::Shm::create(name, bytesize);
+        if (!shm)
+        {
+            shm = utils::Shm::open(name);
+        }
+
+        // the segment is not sized until its creator has allocated it
+        if (shm && shm->size() != 0)
+        {
+            ASSERT(shm->size() >= bytesize) << "Shared memory segment " << name << " of " << shm->size() << " bytes is too small for the bandwidth limit";
+            _shm = std::move(*shm);
+            break;
+        }
+
+        ASSERT(Clock::now() < deadline) << "Timed out opening shared memory segment " << name;
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+
+    const auto previous = header().limit.exchange(limit);
+    if (previous != 0 && previous != limit)
+    {
+        LOG(WARNING) << "Changing node bandwidth limit from " << previous << " to " << limit << " bytes per second";
+    }
+
+    claim();
+
+    LOG(DEBUG) << "Node bandwidth limit is " << limit << " bytes per second ; process weight " << weight;
+}
+
+Bandwidth::~Bandwidth()
+{
+    // the lock of the slot is released with the segment
+    if (_slot < max_slots)
+    {
+        auto & s = slot(_slot);
+        s.weight = 0;
+        s.competing = 0;
+    }
+}
+
+std::shared_ptr<Bandwidth> Bandwidth::instance(size_t limit, unsigned weight, const std::string & name)
+{
+    static std::mutex mutex;
+    static std::weak_ptr<Bandwidth> instance;
+
+    const auto lock = std::unique_lock<std::mutex>(mutex);
+    auto bandwidth = instance.lock();
+    if (bandwidth == nullptr)
+    {
+        bandwidth = std::make_shared<Bandwidth>(limit, weight, name);
+        instance = bandwidth;
+    }
+    else if (bandwidth->limit() != limit || bandwidth->weight() != weight)
+    {
+        LOG(WARNING) << "Node bandwidth limit of the process is already " << bandwidth->limit() << " bytes per second with weight " << bandwidth->weight() << " ; ignoring limit " << limit << " with weight " << weight;
+    }
+    return bandwidth;
+}
+
+Bandwidth::Header & Bandwidth::header() const
+{
+    return *reinterpret_cast<Header *>(_shm.data());
+}
+
+Bandwidth::Slot & Bandwidth::slot(unsigned index) const
+{
+    return reinterpret_cast<Slot *>(_shm.data() + sizeof(Header))[index];
+}
+
+void Bandwidth::claim()
+{
+    // slots are locked at their offset in the segment, where the lock of a process which exited is already released
+    for (unsigned i = 0; i < max_slots; ++i)
+    {
+        if (_shm.lock(i))
+        {
+            auto & s = slot(i);
+            s.competing = 0;
+            s.weight = _weight;
+            _slot = i;
+            return;
+        }
+    }
+
+    // this process is limited only by the shared bucket
+    LOG(WARNING) << "All " << max_slots << " slots of the node bandwidth limit are in use";
+}
+
+void Bandwidth::touch()
+{
+    if (_slot < max_slots)
+    {
+        slot(_slot).competing = now_ns();
+    }
+}
+
+double Bandwidth::share() const
+{
+    const auto now = now_ns();
+    const auto window = std::chrono::duration_cast<std::chrono::nanoseconds>(compete_window).count();
+
+    // slots of processes which exited stop competing once the window passes
+    uint64_t total = _weight;
+    for (unsigned i = 0; i < max_slots; ++i)
+    {
+        if (i == _slot)
+        {
+            continue;
+        }
+
+        const auto & s = slot(i);
+        const auto weight = s.weight.load();
+        if (weight != 0 && now - s.competing.load() < window)
+        {
+            total += weight;
+        }
+    }
+
+    return static_cast<double>(limit()) * _weight / total;
+}
+
+void Bandwidth::add(int64_t tokens)
+{
+    const auto burst = static_cast<int64_t>(limit() * std::chrono::duration<double>(burst_window).count());
+
+    auto current = header().tokens.load();
+    while (!header().tokens.compare_exchange_weak(current, std::max(current, std::min(current + tokens, burst))))
+    {}
+}
+
+void Bandwidth::refill(int64_t now)
+{
+    // the process which advances the refill time adds the tokens of the elapsed interval
+    auto refilled = header().refilled.load();
+    while (now > refilled)
+    {
+        if (header().refilled.compare_exchange_weak(refilled, now))
+        {
+            // the bucket of a new segment starts full
+            const double elapsed = refilled == 0 ? std::chrono::duration<double>(burst_window).count() : (now - refilled) / 1e9;
+            add(static_cast<int64_t>(limit() * elapsed));
+            return;
+        }
+    }
+}
+
+Bandwidth::Clock::time_point Bandwidth::reserve(size_t bytesize)
+{
+    if (bytesize == 0)
+    {
+        return Clock::now();
+    }
+
+    const auto now = Clock::now();
+    const auto now_ = std::chrono::duration_cast<std::chrono::nanoseconds>(now.time_since_epoch()).count();
+
+    // reads larger than the available tokens are taken in advance, and the following reads wait for the deficit to refill
+    refill(now_);
+    const auto tokens = header().tokens.fetch_sub(bytesize) - static_cast<int64_t>(bytesize);
+    auto due = now;
+    if (tokens < 0)
+    {
+        due += std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(-tokens / static_cast<double>(limit())));
+    }
+
+    // while competing, the process is also limited to its share
+    std::lock_guard<std::mutex> lock(_mutex);
+
+    const double rate = share();
+    const double burst = rate * std::chrono::duration<double>(burst_window).count();
+    _tokens = std::min(_tokens + rate * std::chrono::duration<double>(now - _refilled).count(), burst);
+    _refilled = now;
+    _tokens -= bytesize;
+
+    if (_tokens < 0)
+    {
+        due = std::max(due, now + std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(-_tokens / rate)));
+    }
+
+    if (due > now)
+    {
+        touch();
+    }
+
+    return due;
+}
+
+bool Bandwidth::acquire(size_t bytesize, const std::atomic<bool> & stopped)
+{
+    if (bytesize == 0)
+    {
+        return true;
+    }
+
+    const auto deadline = reserve(bytesize);
+    while (!stopped)
+    {
+        const auto now = Clock::now();
+        if (now >= deadline)
+        {
+            return true;
+        }
+
+        std::this_thread::sleep_for(std::min<Clock::duration>(deadline - now, poll_interval));
+
+        // a waiting process competes, so that the other processes keep leaving it its share
+        touch();
+    }
+
+    release(bytesize);
+    return false;
+}
+
+void Bandwidth::release(size_t bytesize)
+{
+    add(bytesize);
+
+    // tokens above the burst of the share are dropped on its next refill
+    std::lock_guard<std::mutex> lock(_mutex);
+    _tokens += bytesize;
+}
+
+size_t Bandwidth::limit() const
+{
+    return header().limit.load();
+}
+
+unsigned Bandwidth::weight() const
+{
+    return _weight;
+}
+
+}; // namespace runai::llm::streamer::impl
@@ -0,0 +1,102 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <string>
+
+#include "utils/shm/shm.h"
+
+namespace runai::llm::streamer::impl
+{
+
+// Node-wide bandwidth limit, shared by the processes of a node
+//
+// The limit is a single token bucket in a shared memory segment, whose tokens and refill time are updated atomically by all the processes
+// Reads take tokens before they are submitted, and wait once the bucket is exhausted, so a process reading alone uses the whole limit,
+// and tokens which a process does not use are left to the others
+//
+// Weights apply only while processes compete for tokens - a process which waits for the bucket marks its slot as competing,
+// and is also limited to its share, which is the limit divided between the competing processes in proportion to their weights
+// A process which reads within the limit does not compete, and does not take a share from the others
+//
+// Event driven readers reserve the tokens instead of waiting, and defer their submission until the returned time
+// The limit is the one set by the last process which registered
+// Every process holds a lock of its slot, which the kernel releases when the process exits, so slots of processes which exited are reclaimed
+// The streamers of a process share a single slot through instance(), so that the weight applies to the process rather than to each streamer
+
+struct Bandwidth
+{
+    using Clock = std::chrono::steady_clock;
+
+    // limit in bytes per second, and weight of this process
+    Bandwidth(size_t limit, unsigned weight, const std::string & name = default_name);
+    ~Bandwidth();
+
+    Bandwidth(const Bandwidth &)             = delete;
+    Bandwidth & operator=(const Bandwidth &) = delete;
+
+    // the limit shared by the streamers of the process, which is released with the last of them
+    // the limit and weight are those of the streamer which created it
+    static std::shared_ptr<Bandwidth> instance(size_t limit, unsigned weight, const std::string & name = default_name);
+
+    // takes the tokens of a read of the given size, waiting until the bucket and the share of this process allow it
+    // returns false if stopped while waiting, in which case the tokens are returned
+    bool acquire(size_t bytesize, const std::atomic<bool> & stopped);
+
+    // takes the tokens of a read of the given size without waiting
+    // returns the time from which the read may be submitted
+    Clock::time_point reserve(size_t bytesize);
+
+    // returns the tokens of a read which was not submitted, e.g. a deferred read which was canceled, so that the following reads do not wait for them
+    void release(size_t bytesize);
+
+    // marks this process as competing, which a process waiting for its tokens does periodically to keep its share
+    void touch();
+
+    // bytes per second this process gets while competing with the other processes which compete
+    double share() const;
+
+    size_t limit() const;
+    unsigned weight() const;
+
+    static constexpr char default_name[] = "/runai-streamer-bandwidth";
+    static constexpr unsigned max_slots = 256;
+
+    // processes which did not wait for tokens within this window do not take a share
+    static constexpr std::chrono::milliseconds compete_window = std::chrono::milliseconds(200);
+
+    // unused tokens are accumulated up to this window of the limit
+    static constexpr std::chrono::milliseconds burst_window = std::chrono::milliseconds(100);
+
+ private:
+    struct Header;
+    struct Slot;
+
+    Header & header() const;
+    Slot & slot(unsigned index) const;
+
+    // registers this process in a slot which is not locked by another process
+    void claim();
+
+    // adds the tokens accumulated in the shared bucket since its last refill, up to the burst
+    void refill(int64_t now);
+
+    // adds tokens to the shared bucket without exceeding the burst
+    void add(int64_t tokens);
+
+    utils::Shm _shm;
+    const unsigned _weight;
+    unsigned _slot = max_slots;
+
+    // tokens of the share of this process, which limit it only while it competes
+    std::mutex _mutex;
+    double _tokens = 0;
+    Clock::time_point _refilled;
+};
+
+}; // namespace runai::llm::streamer::impl
@@ -0,0 +1,204 @@
+#include "streamer/impl/bandwidth/bandwidth.h"
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "utils/random/random.h"
+
+namespace runai::llm::streamer::impl
+{
+
+struct BandwidthTest : ::testing::Test
+{
+    void TearDown() override
+    {
+        utils::Shm::unlink(name);
+    }
+
+    const std::string name = "/runai-streamer-test-" + utils::random::string();
+    std::atomic<bool> stopped = false;
+};
+
+TEST_F(BandwidthTest, Rate)
+{
+    const size_t limit = 100 * 1024 * 1024;
+    Bandwidth bandwidth(limit, utils::random::number(1, 10), name);
+    EXPECT_EQ(bandwidth.limit(), limit);
+    EXPECT_DOUBLE_EQ(bandwidth.share(), limit);
+
+    const auto start = std::chrono::steady_clock::now();
+    for (unsigned i = 0; i < 5; ++i)
+    {
+        EXPECT_TRUE(bandwidth.acquire(limit / 10, stopped));
+    }
+    const auto elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    EXPECT_GE(elapsed, 0.45);
+    EXPECT_LT(elapsed, 2);
+}
+
+TEST_F(BandwidthTest, Reserve)
+{
+    const size_t limit = 100 * 1024 * 1024;
+    Bandwidth bandwidth(limit, 1, name);
+
+    // reserving does not wait, and each read is due once the previous reads are within the limit
+    const auto start = Bandwidth::Clock::now();
+    Bandwidth::Clock::time_point due;
+    for (unsigned i = 0; i < 5; ++i)
+    {
+        due = bandwidth.reserve(limit / 10);
+    }
+    EXPECT_LT(Bandwidth::Clock::now() - start, std::chrono::milliseconds(100));
+
+    const auto wait = std::chrono::duration<double>(due - start).count();
+    EXPECT_GE(wait, 0.45);
+    EXPECT_LT(wait, 1);
+}
+
+TEST_F(BandwidthTest, Release)
+{
+    const size_t limit = 100 * 1024 * 1024;
+    Bandwidth bandwidth(limit, 1, name);
+
+    // reads which are canceled before they are submitted do not delay the following reads
+    const auto start = Bandwidth::Clock::now();
+    for (unsigned i = 0; i < 5; ++i)
+    {
+        bandwidth.reserve(limit / 10);
+        bandwidth.release(limit / 10);
+    }
+
+    const auto due = bandwidth.reserve(limit / 10);
+    EXPECT_LT(std::chrono::duration<double>(due - start).count(), 0.2);
+}
+
+TEST_F(BandwidthTest, Shared)
+{
+    const size_t limit = 100 * 1024 * 1024;
+    Bandwidth first(limit, 1, name);
+    Bandwidth second(limit, 1, name);
+
+    // the processes take their tokens from the same bucket
+    const auto start = Bandwidth::Clock::now();
+    first.reserve(limit / 2);
+    const auto due = second.reserve(limit / 2);
+
+    const auto wait = std::chrono::duration<double>(due - start).count();
+    EXPECT_GE(wait, 0.85);
+    EXPECT_LT(wait, 1.5);
+}
+
+TEST_F(BandwidthTest, Weights)
+{
+    const size_t limit = utils::random::number(1000, 1000000);
+    Bandwidth first(limit, 1, name);
+    auto second = std::make_unique<Bandwidth>(limit, 3, name);
+
+    // processes which do not wait for tokens do not compete
+    EXPECT_TRUE(first.acquire(1, stopped));
+    EXPECT_TRUE(second->acquire(1, stopped));
+    EXPECT_DOUBLE_EQ(first.share(), limit);
+    EXPECT_DOUBLE_EQ(second->share(), limit);
+
+    // both compete once they wait for tokens
+    first.reserve(limit);
+    second->reserve(limit);
+    EXPECT_DOUBLE_EQ(first.share(), limit / 4.0);
+    EXPECT_DOUBLE_EQ(second->share(), limit * 3 / 4.0);
+
+    // the whole limit is left once the other process is gone
+    second.reset();
+    EXPECT_DOUBLE_EQ(first.share(), limit);
+}
+
+TEST_F(BandwidthTest, Instance)
+{
+    const size_t limit = utils::random::number(1000, 1000000);
+    auto first = Bandwidth::instance(limit, 1, name);
+    auto second = Bandwidth::instance(limit, 1, name);
+
+    // the streamers of a process share its slot
+    EXPECT_EQ(first, second);
+    EXPECT_TRUE(first->acquire(1, stopped));
+    EXPECT_DOUBLE_EQ(second->share(), limit);
+
+    // a new limit is created once the previous one was released
+    const auto weight = utils::random::number(2, 10);
+    first.reset();
+    second.reset();
+    auto third = Bandwidth::instance(limit, weight, name);
+    EXPECT_EQ(third->weight(), weight);
+}
+
+TEST_F(BandwidthTest, Inactive)
+{
+    const size_t limit = utils::random::number(1000, 1000000);
+    Bandwidth first(limit, 1, name);
+    Bandwidth second(limit, 1, name);
+    second.reserve(limit);
+    EXPECT_DOUBLE_EQ(first.share(), limit / 2.0);
+
+    // a process which did not wait for tokens recently does not take a share
+    std::this_thread::sleep_for(Bandwidth::compete_window);
+    EXPECT_DOUBLE_EQ(first.share(), limit);
+}
+
+TEST_F(BandwidthTest, Slots)
+{
+    const size_t limit = utils::random::number(1000, 1000000);
+
+    // the slot of a process which is gone is reclaimed, even when all the slots were taken
+    std::vector<std::unique_ptr<Bandwidth>> bandwidths;
+    for (unsigned i = 0; i < Bandwidth::max_slots; ++i)
+    {
+        bandwidths.push_back(std::make_unique<Bandwidth>(limit, 1, name));
+    }
+
+    const auto index = utils::random::number<size_t>(0, bandwidths.size() - 1);
+    bandwidths[index].reset();
+    bandwidths[index] = std::make_unique<Bandwidth>(limit, 2, name);
+
+    // the new process is seen by the others once it competes
+    auto & other = bandwidths[(index + 1) % bandwidths.size()];
+    bandwidths[index]->reserve(limit);
+    other->reserve(limit);
+    EXPECT_DOUBLE_EQ(other->share(), limit / 3.0);
+}
+
+TEST_F(BandwidthTest, Limit_Changed)
+{
+    const size_t limit = utils::random::number(1000, 1000000);
+    Bandwidth first(limit, 1, name);
+    Bandwidth second(limit * 2, 1, name);
+
+    EXPECT_EQ(first.limit(), limit * 2);
+    EXPECT_EQ(second.limit(), limit * 2);
+}
+
+TEST_F(BandwidthTest, Stopped)
+{
+    // a read of an hour at this limit
+    const size_t limit = 1024;
+    Bandwidth bandwidth(limit, 1, name);
+
+    std::thread stopper([&]()
+    {
+        std::this_thread::sleep_for(std::chrono::milliseconds(100));
+        stopped = true;
+    });
+
+    const auto start = std::chrono::steady_clock::now();
+    EXPECT_FALSE(bandwidth.acquire(limit * 3600, stopped));
+    EXPECT_LT(std::chrono::steady_clock::now() - start, std::chrono::seconds(5));
+
+    stopper.join();
+}
+
+}; // namespace runai::llm::streamer::impl
@@ -12,6 +12,7 @@
 #include "common/exception/exception.h"
 #include "common/s3_wrapper/s3_wrapper.h"
 #include "common/range/range.h"
+#include "common/trace/trace.h"
 #include "streamer/impl/reader/reader.h"
 #include "streamer/impl/file/file.h"
 #include "streamer/impl/s3/s3.h"
@@ -19,7 +20,7 @@
 namespace runai::llm::streamer::impl
 {
 
-Batch::Batch(unsigned worker_index, unsigned file_index, const std::string & path, const common::s3::S3ClientWrapper::Params & params, const Tasks && tasks, std::shared_ptr<common::Responder> responder, std::shared_ptr<const Config> config) :
+Batch::Batch(unsigned worker_index, unsigned file_index, const std::string & path, const common::s3::S3ClientWrapper::Params & params, const Tasks && tasks, std::shared_ptr<common::Responder> responder, std::shared_ptr<const Config> config, std::shared_ptr<Readiness> readiness) :
     worker_index(worker_index),
     file_index(file_index),
     path(path),
@@ -27,9 +28,59 @@ Batch::Batch(unsigned worker_index, unsigned file_index, const std::string & pat
     tasks(tasks),
     range(tasks),
     responder(responder),
-    config(config)
+    config(config),
+    readiness(readiness)
 {
     LOG(DEBUG) << "Batch " << path << " range " << range << " ; " << this->tasks.size() << " tasks";
+
+    if (config != nullptr && config->s3_crt_multipart && is_object_storage())
+    {
+        merge_reads();
+    }
+}
+
+void Batch::merge_reads()
+{
+    const size_t max_bytesize = config->s3_block_bytesize * max_merged_blocks;
+
+    _reads.assign(tasks.size(), 1);
+    size_t first = 0;
+    size_t bytesize = 0;
+    for (size_t i = 0; i < tasks.size(); ++i)
+    {
+        const auto & task = tasks[i];
+        if (i > 0 && bytesize > 0 && task.info.bytesize > 0 && bytesize + task.info.bytesize <= max_bytesize &&
+            task.info.offset == tasks[i - 1].info.end && task.destination() == tasks[i - 1].destination() + tasks[i - 1].info.bytesize)
+        {
+            ++_reads[first];
+            _reads[i] = 0;
+            bytesize += task.info.bytesize;
+            continue;
+        }
+
+        first = i;
+        bytesize = task.info.bytesize;
+    }
+
+    LOG(DEBUG) << "Merged " << tasks.size() << " tasks into " << std::count_if(_reads.begin(), _reads.end(), [](unsigned reads) { return reads > 0; }) << " reads";
+}
+
+size_t Batch::read_bytesize(const Task * task_ptr) const
+{
+    if (_reads.empty())
+    {
+        return task_ptr->info.bytesize;
+    }
+
+    const size_t index = task_ptr - tasks.data();
+    ASSERT(index < tasks.size()) << "Task " << *task_ptr << " does not belong to batch " << *this;
+
+    size_t bytesize = 0;
+    for (size_t i = index; i < index + _reads[index]; ++i)
+    {
+        bytesize += tasks[i].info.bytesize;
+    }
+    return bytesize;
 }
 
 size_t Batch::total_bytes() const
@@ -42,25 +93,51 @@ size_t Batch::end_offset() const
     return range.end;
 }
 
-void Batch::request(std::shared_ptr<Reader> reader, std::atomic<bool> & stopped)
+void Batch::request(std::shared_ptr<Reader> reader, std::atomic<bool> & stopped, size_t bytesize)
 {
     ASSERT(reader != nullptr) << "Reader is not initialized";
     ASSERT(is_object_storage()) << "S3 params are not initialized";
 
-    request_async_read(reader.get(), stopped);
+    request_async_read(reader.get(), stopped, bytesize);
 }
 
-void Batch::execute(std::atomic<bool> & stopped)
+bool Batch::requested() const
 {
-    LOG(DEBUG) << "Start reading from file " << path;
+    return _requested == tasks.size();
+}
+
+size_t Batch::requested_bytesize() const
+{
+    return _requested_bytesize;
+}
 
+unsigned Batch::submitted() const
+{
+    return _submitted;
+}
+
+bool Batch::execute(std::atomic<bool> & stopped, Bandwidth * bandwidth, size_t bytesize)
+{
     auto response_code = common::ResponseCode::Success;
     try
     {
         ASSERT(!is_object_storage()) << "Unsupported reader mode for object storage backends";
 
-        _reader = std::make_unique<File>(path, *config);
-        read(*config, stopped);
+        // the file stays open between the calls
+        if (_reader == nullptr)
+        {
+            LOG(DEBUG) << "Start reading from file " << path;
+            _reader = std::make_unique<File>(path, *config);
+            _offset = range.start;
+
+            // seek just once because tasks are consecutive within the range
+            _reader->seek(_offset);
+        }
+
+        if (read(*config, stopped, bandwidth, bytesize))
+        {
+            return true;
+        }
     }
     catch(const common::Exception & e)
     {
@@ -74,6 +151,7 @@ void Batch::execute(std::atomic<bool> & stopped)
     // in case of an error all of the batch's unfinished tasks are failed with the same error code
     // in case of success the finished tasks were already notified
     handle_error(response_code);
+    return false;
 }
 
 void Batch::handle_error(common::ResponseCode response_code)
@@ -94,77 +172,93 @@ void Batch::handle_error(common::ResponseCode response_code)
 
         // Note:
         // At this point no more tasks are expected to finish, since synchronous reading has ended and for asyncronous reading the thread stopped waiting for finished tasks
+        std::vector<common::Response> responses;
+        size_t bytesize = 0;
         for (auto & task : tasks)
         {
             if (task.finished_request(response_code))
             {
-                common::Response response(file_index, task.request->index, task.request->ret());
-                responder->push(std::move(response), task.request->bytesize);
+                set_ready(*task.request);
+                responses.emplace_back(file_index, task.request->index, task.request->ret());
+                bytesize += task.request->bytesize;
             }
         }
+        responder->push(std::move(responses), bytesize);
     }
 }
 
-// read the entire range and send notifications for each sub range
-void Batch::read(const Config & config, std::atomic<bool> & stopped)
+// read the range in chunks from the current offset, and send notifications for each sub range
+bool Batch::read(const Config & config, std::atomic<bool> & stopped, Bandwidth * bandwidth, size_t bytesize)
 {
     if (tasks.empty())
     {
         LOG(DEBUG) << "Empty batch";
-        return;
+        return false;
     }
 
-    auto file_offset = range.start;
     // For CPU buffer we assume that all the requests are written to a single continous buffer
-    char * buffer = tasks[0].destination();;
-
-    size_t num_chunks = range.size / config.fs_block_bytesize;
+    char * buffer = tasks[0].destination() + (_offset - range.start);
 
-    // seek just once because tasks are consecutive within the range
-    _reader->seek(file_offset);
-
-    // read task's range in chunks
-    size_t i = 0;
-    for (; i < num_chunks && !stopped; ++i)
+    size_t read = 0;
+    while (_offset < range.end && read < bytesize && !stopped)
     {
-        _reader->read(config.fs_block_bytesize, buffer);
+        const auto size = std::min<size_t>(config.fs_block_bytesize, range.end - _offset);
+        if (bandwidth && !bandwidth->acquire(size, stopped))
+        {
+            break;
+        }
 
-        file_offset += config.fs_block_bytesize;
-        buffer += config.fs_block_bytesize;
+        {
+            common::Trace::Scope span("block", size);
+            _reader->read(size, buffer);
+        }
 
-        finished_until(file_offset, common::ResponseCode::Success);
-    }
+        _offset += size;
+        buffer += size;
+        read += size;
 
-    if (file_offset < range.end && !stopped)
-    {
-        num_chunks++;
-        i = 1;
-        _reader->read(range.end - file_offset, buffer);
-        finished_until(range.end, common::ResponseCode::Success);
+        finished_until(_offset, common::ResponseCode::Success);
     }
 
-    LOG(DEBUG) << "Finished reading " << i << "/" << num_chunks << " chunks from file " << path << (stopped ? " - terminated" : " successfully");
-
     if (stopped)
     {
+        LOG(DEBUG) << "Stopped reading from file " << path << " at offset " << _offset << " - terminated";
         throw common::Exception(common::ResponseCode::FinishedError);
     }
-}
 
-void Batch::request_async_read(Reader * reader, std::atomic<bool> & stopped)
-{
-    if (stopped)
+    if (_offset < range.end)
     {
-        throw common::Exception(common::ResponseCode::FinishedError);
+        return true;
     }
 
+    LOG(DEBUG) << "Finished reading " << range.size << " bytes from file " << path << " successfully";
+    return false;
+}
+
+void Batch::request_async_read(Reader * reader, std::atomic<bool> & stopped, size_t bytesize)
+{
     // For CPU buffer we assume that all the requests are written to a single continous buffer
 
-    // request asynchronous read for each task
-    for (auto & task : tasks)
+    // request asynchronous read for each task, or for each group of merged tasks
+    const auto requested = _requested_bytesize;
+    for (; _requested < tasks.size() && _requested_bytesize - requested < bytesize; ++_requested)
     {
+        const auto i = _requested;
+        if (stopped)
+        {
+            LOG(DEBUG) << "Stopped while requesting reads of file index " << file_index;
+            throw common::Exception(common::ResponseCode::FinishedError);
+        }
+
+        const auto & task = tasks[i];
+        if (!_reads.empty() && _reads[i] == 0)
+        {
+            // read by the first task of its merged read
+            continue;
+        }
+
         auto dst = task.destination();
-        common::Range range(task.info.offset, task.info.bytesize);
+        common::Range range(task.info.offset, read_bytesize(&task));
         if (range.size == 0)
         {
             // tensors of size zero are valid, but empty request can be invalid in the storage backend
@@ -173,6 +267,8 @@ void Batch::request_async_read(Reader * reader, std::atomic<bool> & stopped)
             continue;
         }
         reader->async_read(object_storage_params, task.info.global_id, range, dst);
+        ++_submitted;
+        _requested_bytesize += range.size;
     }
 }
 
@@ -187,7 +283,11 @@ void Batch::handle_response(const common::backend_api::Response & response, cons
 
     ASSERT(task_ptr != nullptr) << "Received response from a null task";
 
-    handle_task_response(response.ret, task_ptr);
+    const unsigned reads = _reads.empty() ? 1 : _reads[task_ptr - tasks.data()];
+    for (unsigned i = 0; i < reads; ++i)
+    {
+        handle_task_response(response.ret, task_ptr + i);
+    }
 }
 
 void Batch::handle_task_response(const common::ResponseCode response_code, const Task * task_ptr)
@@ -199,6 +299,7 @@ void Batch::handle_task_response(const common::ResponseCode response_code, const
     LOG(SPAM) << "Received object storage response: File index " << file_index << " request index " << task_ptr->request->index << " ret " << response_code;
     if (task_ptr->finished_request(response_code))
     {
+        set_ready(*task_ptr->request);
         common::Response request_response(file_index, task_ptr->request->index, task_ptr->request->ret());
         responder->push(std::move(request_response), task_ptr->request->bytesize);
     }
@@ -207,6 +308,10 @@ void Batch::handle_task_response(const common::ResponseCode response_code, const
 // notify unfinished tasks up to but not including offset end
 void Batch::finished_until(size_t file_offset, common::ResponseCode ret /*= common::ResponseCode::Success */)
 {
+    // requests completed by the same read are sent together
+    std::vector<common::Response> responses;
+    size_t bytesize = 0;
+
     unsigned i = _unfinished;
     for (; i < tasks.size(); ++i)
     {
@@ -217,12 +322,23 @@ void Batch::finished_until(size_t file_offset, common::ResponseCode ret /*= comm
         if (tasks[i].finished_request(ret))
         {
             const auto & r = tasks[i].request;
-            common::Response response(file_index, r->index, r->ret());
-            LOG(SPAM) << "Sending response " << response;
-            responder->push(std::move(response), tasks[i].request->bytesize);
+            set_ready(*r);
+            responses.emplace_back(file_index, r->index, r->ret());
+            LOG(SPAM) << "Sending response " << responses.back();
+            bytesize += r->bytesize;
         }
     }
     _unfinished = i;
+
+    responder->push(std::move(responses), bytesize);
+}
+
+void Batch::set_ready(const Request & request)
+{
+    if (readiness)
+    {
+        readiness->set(file_index, request.index, request.ret());
+    }
 }
 
 unsigned Batch::finished_until() const
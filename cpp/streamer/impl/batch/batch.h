@@ -1,6 +1,7 @@
 
 #pragma once
 
+#include <limits>
 #include <memory>
 #include <string>
 #include <vector>
@@ -13,9 +14,11 @@
 #include "common/shared_queue/shared_queue.h"
 //#include "common/range/range.h"
 
+#include "streamer/impl/bandwidth/bandwidth.h"
 #include "streamer/impl/config/config.h"
 #include "streamer/impl/task/task.h"
 #include "streamer/impl/reader/reader.h"
+#include "streamer/impl/readiness/readiness.h"
 
 namespace runai::llm::streamer::impl
 {
@@ -56,7 +59,8 @@ struct Batch
         const common::s3::S3ClientWrapper::Params & params,
         const Tasks && tasks,
         std::shared_ptr<common::Responder> responder,
-        std::shared_ptr<const Config> config);
+        std::shared_ptr<const Config> config,
+        std::shared_ptr<Readiness> readiness = nullptr);
 
   // total number of requested bytes
   size_t total_bytes() const;
@@ -64,15 +68,29 @@ struct Batch
   // end offset of the batch
   size_t end_offset() const;
 
-  // read the batch synchronously
-  void execute(std::atomic<bool> & stopped);
+  // read the batch synchronously, within the node bandwidth limit if there is one
+  // reads at least the given number of bytes from where the previous call stopped, and returns true if the batch was not read to its end
+  bool execute(std::atomic<bool> & stopped, Bandwidth * bandwidth = nullptr, size_t bytesize = std::numeric_limits<size_t>::max());
 
   // request the batch asynchronously
-  void request(std::shared_ptr<Reader> reader, std::atomic<bool> & stopped);
+  // requests reads of at least the given number of bytes from where the previous call stopped
+  void request(std::shared_ptr<Reader> reader, std::atomic<bool> & stopped, size_t bytesize = std::numeric_limits<size_t>::max());
 
-  // handle response from the reader
+  // whether all the reads of the batch were requested
+  bool requested() const;
+
+  // number of bytes requested so far
+  size_t requested_bytesize() const;
+
+  // number of reads submitted to the reader so far, each of which is answered by a single response
+  unsigned submitted() const;
+
+  // handle response from the reader, which also answers the tasks merged into the read of the task
   void handle_response(const common::backend_api::Response & response, const Task * task_ptr);
 
+  // number of bytes requested by the read of a task, including the tasks merged into it
+  size_t read_bytesize(const Task * task_ptr) const;
+
   // handle error
   void handle_error(common::ResponseCode response_code);
 
@@ -100,20 +118,45 @@ struct Batch
 
   std::shared_ptr<const Config> config;
 
+  // optional readiness array of the request
+  std::shared_ptr<Readiness> readiness;
+
+  // merged reads span up to this number of blocks, so that the requests are still answered while the batch is read
+  static constexpr unsigned max_merged_blocks = 16;
+
  private:
-  void read(const Config & config, std::atomic<bool> & stopped);
+  // returns true if the range was not read to its end
+  bool read(const Config & config, std::atomic<bool> & stopped, Bandwidth * bandwidth, size_t bytesize);
 
   void async_wait(Reader * reader, std::atomic<bool> & stopped);
 
-  void request_async_read(Reader * reader, std::atomic<bool> & stopped);
+  void request_async_read(Reader * reader, std::atomic<bool> & stopped, size_t bytesize);
 
   // handle response from a single task
   void handle_task_response(const common::ResponseCode response_code, const Task * task_ptr);
 
+  // mark the request of a finished task as ready, before its response is pushed
+  void set_ready(const Request & request);
+
+  // merges contiguous tasks into a single read, for backends which split a read into parallel parts by themselves
+  void merge_reads();
+
+  // number of tasks of the read of each task, where the first task of a merged read submits it and the tasks merged into it have zero
+  // empty if reads are not merged
+  std::vector<unsigned> _reads;
+
  private:
   // index of first unfinished task
   unsigned _unfinished = 0;
 
+  // file offset of the next synchronous read
+  size_t _offset = 0;
+
+  // index of the first task which was not requested
+  size_t _requested = 0;
+  size_t _requested_bytesize = 0;
+  unsigned _submitted = 0;
+
   std::unique_ptr<Reader> _reader;
 };
 
@@ -4,6 +4,7 @@
 #include <utility>
 #include <memory>
 #include <chrono>
+#include <numeric>
 #include <set>
 
 #include "utils/logging/logging.h"
@@ -16,6 +17,7 @@
 #include "common/s3_wrapper/s3_wrapper.h"
 
 #include "streamer/impl/file/file.h"
+#include "streamer/impl/reader/mock/mock.h"
 #include "streamer/impl/workload/workload.h"
 namespace runai::llm::streamer::impl
 {
@@ -482,4 +484,59 @@ TEST(Read, Stopped_During_Async_Read)
     }
 }
 
+TEST(Request, Merged_Reads)
+{
+    const auto num_requests = utils::random::number(2, 20);
+    const auto chunks = utils::random::chunks(utils::random::number(num_requests, 10000), num_requests);
+    const auto data = utils::random::buffer(std::accumulate(chunks.begin(), chunks.end(), 0UL));
+    const std::vector<char> object(data.begin(), data.end());
+
+    for (bool crt_multipart : { false, true })
+    {
+        auto config = std::make_shared<Config>(1, 1, object.size(), object.size(), false /* do not force minimum chunk size */);
+        config->s3_crt_multipart = crt_multipart;
+
+        auto responder = std::make_shared<common::Responder>(num_requests);
+        std::vector<char> dst(object.size());
+
+        Tasks tasks;
+        size_t offset = 0;
+        for (unsigned i = 0; i < num_requests; ++i)
+        {
+            auto request = std::make_shared<Request>(offset, 0, i, 1, chunks[i], dst.data() + offset);
+            tasks.emplace_back(request, offset, chunks[i], 0);
+            tasks.back().info.global_id = i;
+            offset += chunks[i];
+        }
+
+        common::s3::S3ClientWrapper::Params params(std::make_shared<common::s3::StorageUri>("s3://" + utils::random::string() + "/" + utils::random::string()), object.size());
+        Batch batch(0, 0, utils::random::string(), params, std::move(tasks), responder, config);
+
+        // contiguous tasks are read by a single request, which answers every task
+        auto reader = std::make_shared<MockReader>(object);
+        std::atomic<bool> stopped(false);
+        batch.request(reader, stopped);
+        EXPECT_EQ(reader->requests, crt_multipart ? 1 : num_requests);
+
+        std::vector<common::backend_api::Response> responses;
+        EXPECT_EQ(reader->async_response(responses, num_requests, common::backend_api::OBJECT_WAIT_MODE_NON_BLOCKING), common::ResponseCode::Success);
+        for (const auto & response : responses)
+        {
+            const auto task_ptr = &batch.tasks.at(response.handle);
+            EXPECT_EQ(response.bytes_transferred, batch.read_bytesize(task_ptr));
+            batch.handle_response(response, task_ptr);
+        }
+
+        std::set<unsigned> responded;
+        for (unsigned i = 0; i < num_requests; ++i)
+        {
+            const auto response = responder->pop();
+            EXPECT_EQ(response.ret, common::ResponseCode::Success);
+            responded.insert(response.index);
+        }
+        EXPECT_EQ(responded.size(), num_requests);
+        EXPECT_EQ(dst, object);
+    }
+}
+
 }; // namespace runai::llm::streamer::impl
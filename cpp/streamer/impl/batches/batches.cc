@@ -88,10 +88,12 @@ Batches::Batches(unsigned file_index,
                  std::shared_ptr<common::Responder> responder,
                  const std::string & path,
                  const common::s3::S3ClientWrapper::Params & params,
-                 const std::vector<size_t> & internal_sizes) :
+                 const std::vector<size_t> & internal_sizes,
+                 std::shared_ptr<Readiness> readiness) :
     _file_index(file_index),
     _itr(file_read_tasks),
-    _responder(responder)
+    _responder(responder),
+    _readiness(readiness)
 {
     _batches.reserve(file_read_tasks.size());
     build_tasks(config, path, params, internal_sizes);
@@ -150,7 +152,7 @@ void Batches::build_tasks(std::shared_ptr<const Config> config, const std::strin
             continue;
         }
 
-        _batches.emplace_back(worker_index, _file_index, path, params, std::move(tasks), _responder, config);
+        _batches.emplace_back(worker_index, _file_index, path, params, std::move(tasks), _responder, config, _readiness);
     }
 
     for (auto & batch : _batches)
@@ -10,6 +10,7 @@
 #include "streamer/impl/config/config.h"
 #include "streamer/impl/request/request.h"
 #include "streamer/impl/reader/reader.h"
+#include "streamer/impl/readiness/readiness.h"
 #include "streamer/impl/assigner/file_read_task/file_read_task.h"
 
 namespace runai::llm::streamer::impl
@@ -26,7 +27,8 @@ struct Batches
            std::shared_ptr<common::Responder> responder,
            const std::string & path,
            const common::s3::S3ClientWrapper::Params & params,
-           const std::vector<size_t> & internal_sizes);
+           const std::vector<size_t> & internal_sizes,
+           std::shared_ptr<Readiness> readiness = nullptr);
 
     Batches(Batches &&) = default;
     Batches & operator=(Batches &&) = default;
@@ -74,6 +76,7 @@ struct Batches
 
     std::vector<Batch> _batches;
     std::shared_ptr<common::Responder> _responder;
+    std::shared_ptr<Readiness> _readiness;
 
     size_t _total = 0;
 };
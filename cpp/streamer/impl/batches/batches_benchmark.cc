@@ -0,0 +1,60 @@
+#include "streamer/impl/batches/batches.h"
+
+#include <benchmark/benchmark.h>
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "streamer/impl/assigner/assigner.h"
+#include "streamer/impl/config/config.h"
+
+#include "utils/random/random.h"
+
+namespace runai::llm::streamer::impl
+{
+
+// dividing the reads of the files into the tasks of the workers against the number of files and tensors per file
+void BM_Batches(benchmark::State & state)
+{
+    const unsigned num_files = state.range(0);
+    const unsigned num_tensors = state.range(1);
+
+    // tensors of 1 MiB, where the files are not accessed while planning
+    const size_t tensor_bytesize = 1024 * 1024;
+    const size_t file_bytesize = num_tensors * tensor_bytesize;
+
+    std::vector<std::string> paths;
+    std::vector<size_t> offsets(num_files, 0);
+    std::vector<size_t> sizes(num_files, file_bytesize);
+    std::vector<void *> dsts(num_files, nullptr);
+    const std::vector<size_t> internal_sizes(num_tensors, tensor_bytesize);
+
+    for (unsigned i = 0; i < num_files; ++i)
+    {
+        paths.push_back(utils::random::string());
+    }
+
+    auto config = std::make_shared<Config>();
+    common::s3::S3ClientWrapper::Params params;
+    auto responder = std::make_shared<common::Responder>(0);
+
+    for (auto _ : state)
+    {
+        Assigner assigner(paths, offsets, sizes, dsts, config);
+
+        std::vector<Batches> batches;
+        batches.reserve(num_files);
+        for (unsigned i = 0; i < num_files; ++i)
+        {
+            batches.emplace_back(i, assigner.file_assignments(i), config, responder, paths[i], params, internal_sizes);
+        }
+        benchmark::DoNotOptimize(batches.data());
+    }
+
+    state.SetItemsProcessed(state.iterations() * num_files * num_tensors);
+}
+
+BENCHMARK(BM_Batches)->ArgsProduct({{1, 8, 64}, {1, 16, 256, 4096}})->ArgNames({"files", "tensors"});
+
+}; // namespace runai::llm::streamer::impl
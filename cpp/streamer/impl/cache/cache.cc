@@ -0,0 +1,596 @@
+#include "streamer/impl/cache/cache.h"
+
+#include <dirent.h>
+#include <fcntl.h>
+#include <linux/magic.h>
+#include <sys/file.h>
+#include <sys/stat.h>
+#include <sys/statfs.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdio>
+#include <fstream>
+#include <map>
+#include <sstream>
+#include <utility>
+
+#include "common/exception/exception.h"
+
+#include "utils/fd/fd.h"
+#include "utils/hash/hash.h"
+#include "utils/logging/logging.h"
+
+namespace runai::llm::streamer::impl
+{
+
+namespace
+{
+
+constexpr char data_suffix[] = ".data";
+constexpr char metadata_suffix[] = ".meta";
+
+// objects are evicted until the cache is below this fraction of its size, so that not every write evicts
+constexpr double eviction_watermark = 0.9;
+
+// advisory lock of a file, shared by the processes and threads of the node
+struct Lock
+{
+    Lock(const std::string & path, bool exclusive) :
+        _fd(::open(path.c_str(), O_RDWR | O_CREAT | O_CLOEXEC, 0666))
+    {
+        PASSERT(_fd.fd() != -1) << "Failed opening cache lock file " << path;
+        PASSERT(::flock(_fd.fd(), exclusive ? LOCK_EX : LOCK_SH) == 0) << "Failed locking cache lock file " << path;
+    }
+
+ private:
+    // closing the file releases the lock
+    utils::Fd _fd;
+};
+
+bool pread_exactly(int fd, char * buffer, size_t size, size_t offset)
+{
+    while (size > 0)
+    {
+        const auto result = ::pread(fd, buffer, size, offset);
+        if (result <= 0)
+        {
+            if (result == -1 && errno == EINTR)
+            {
+                continue;
+            }
+            return false;
+        }
+        buffer += result;
+        offset += result;
+        size -= result;
+    }
+    return true;
+}
+
+bool pwrite_exactly(int fd, const char * buffer, size_t size, size_t offset)
+{
+    while (size > 0)
+    {
+        const auto result = ::pwrite(fd, buffer, size, offset);
+        if (result <= 0)
+        {
+            if (result == -1 && errno == EINTR)
+            {
+                continue;
+            }
+            return false;
+        }
+        buffer += result;
+        offset += result;
+        size -= result;
+    }
+    return true;
+}
+
+bool ends_with(const std::string & str, const std::string & suffix)
+{
+    return str.size() >= suffix.size() && str.compare(str.size() - suffix.size(), suffix.size(), suffix) == 0;
+}
+
+} // namespace
+
+Cache::Entry::Entry(const std::string & uri, const std::string & version) :
+    uri(uri),
+    version(version)
+{
+    char buffer[17];
+    std::snprintf(buffer, sizeof(buffer), "%016lx", static_cast<unsigned long>(utils::fnv1a(version, utils::fnv1a(uri + '\0'))));
+    name = buffer;
+}
+
+Cache::Cache(const std::string & directory, size_t max_bytesize, bool wait_for_writes) :
+    _directory(directory),
+    _max_bytesize(max_bytesize),
+    _wait_for_writes(wait_for_writes)
+{
+    if (::mkdir(directory.c_str(), 0777) != 0 && errno != EEXIST)
+    {
+        LOG(ERROR) << "Failed creating cache directory " << directory;
+        throw common::Exception(common::ResponseCode::FileAccessError);
+    }
+
+    if (::access(directory.c_str(), R_OK | W_OK | X_OK) != 0)
+    {
+        LOG(ERROR) << "Cache directory " << directory << " is not accessible";
+        throw common::Exception(common::ResponseCode::FileAccessError);
+    }
+
+    struct statfs fs = {};
+    PASSERT(::statfs(directory.c_str(), &fs) == 0) << "Failed querying file system of " << directory;
+
+    // files in hugetlbfs can only be mapped, and not written
+    if (fs.f_type == HUGETLBFS_MAGIC)
+    {
+        LOG(ERROR) << "Cache directory " << directory << " is in hugetlbfs, which is not supported - use a tmpfs mount (e.g. /dev/shm) instead";
+        throw common::Exception(common::ResponseCode::FileAccessError);
+    }
+
+    if (_max_bytesize == 0)
+    {
+        _max_bytesize = fs.f_blocks * fs.f_frsize / 2;
+    }
+
+    validate();
+
+    LOG(DEBUG) << "Caching object storage reads in " << directory << (fs.f_type == TMPFS_MAGIC ? " (memory)" : "") << " up to " << _max_bytesize << " bytes";
+
+    _thread = utils::Thread([this]() { run(); });
+    for (unsigned i = 0; i < reader_threads; ++i)
+    {
+        _readers.emplace_back([this]() { run_reads(); });
+    }
+}
+
+Cache::~Cache()
+{
+    try
+    {
+        flush();
+        {
+            const auto guard = std::unique_lock<std::mutex>(_mutex);
+            _stopped = true;
+        }
+        _cv.notify_all();
+        _thread.join();
+
+        // the pending reads are done before the readers stop
+        for (auto & reader : _readers)
+        {
+            reader.join();
+        }
+    }
+    catch (...)
+    {
+    }
+}
+
+std::string Cache::data_path(const Entry & entry) const
+{
+    return _directory + "/" + entry.name + data_suffix;
+}
+
+std::string Cache::metadata_path(const Entry & entry) const
+{
+    return _directory + "/" + entry.name + metadata_suffix;
+}
+
+std::string Cache::lock_path() const
+{
+    return _directory + "/cache.lock";
+}
+
+size_t Cache::max_bytesize() const
+{
+    return _max_bytesize;
+}
+
+void Cache::validate()
+{
+    Lock lock(lock_path(), true);
+
+    DIR * dir = ::opendir(_directory.c_str());
+    PASSERT(dir != nullptr) << "Failed opening cache directory " << _directory;
+
+    std::vector<std::string> names;
+    while (auto * dirent = ::readdir(dir))
+    {
+        const std::string name = dirent->d_name;
+        if (ends_with(name, metadata_suffix))
+        {
+            names.push_back(name.substr(0, name.size() - sizeof(metadata_suffix) + 1));
+        }
+    }
+    ::closedir(dir);
+
+    for (const auto & name : names)
+    {
+        const auto metadata = _directory + "/" + name + metadata_suffix;
+        const auto data = _directory + "/" + name + data_suffix;
+
+        size_t end = 0;
+        {
+            std::ifstream file(metadata);
+            std::string line;
+            std::getline(file, line); // uri
+            std::getline(file, line); // version
+
+            size_t start;
+            size_t size;
+            while (file >> start >> size)
+            {
+                end = std::max(end, start + size);
+            }
+        }
+
+        struct stat stat = {};
+        if (::stat(data.c_str(), &stat) != 0 || static_cast<size_t>(stat.st_size) < end)
+        {
+            LOG(WARNING) << "Removing cached object " << name << " whose data file is missing or truncated";
+            ::unlink(metadata.c_str());
+            ::unlink(data.c_str());
+        }
+    }
+}
+
+bool Cache::load(const Entry & entry, std::vector<common::Range> & ranges) const
+{
+    ranges.clear();
+
+    std::ifstream file(metadata_path(entry));
+    if (!file.is_open())
+    {
+        return true;
+    }
+
+    std::string uri;
+    std::string version;
+    if (!std::getline(file, uri) || !std::getline(file, version) || uri != entry.uri || version != entry.version)
+    {
+        LOG(DEBUG) << "Cache metadata " << metadata_path(entry) << " does not belong to " << entry.uri << " version " << entry.version;
+        return false;
+    }
+
+    size_t start;
+    size_t size;
+    while (file >> start >> size)
+    {
+        ranges.emplace_back(start, size);
+    }
+    return true;
+}
+
+void Cache::save(const Entry & entry, const std::vector<common::Range> & ranges) const
+{
+    std::stringstream contents;
+    contents << entry.uri << '\n' << entry.version << '\n';
+    for (const auto & range : ranges)
+    {
+        contents << range.start << ' ' << range.size << '\n';
+    }
+    const auto str = contents.str();
+
+    // replace the metadata atomically
+    const auto path = metadata_path(entry);
+    const auto temp = path + "." + std::to_string(::getpid()) + ".tmp";
+    {
+        utils::Fd fd(::open(temp.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0666));
+        PASSERT(fd.fd() != -1) << "Failed creating cache metadata " << temp;
+        fd.write(str.data(), str.size());
+        PASSERT(::fsync(fd.fd()) == 0) << "Failed syncing cache metadata " << temp;
+    }
+    PASSERT(::rename(temp.c_str(), path.c_str()) == 0) << "Failed renaming cache metadata " << temp;
+}
+
+bool Cache::read(const Entry & entry, const common::Range & range, char * buffer)
+{
+    utils::Fd data;
+    {
+        // the data file is opened under the lock, so that it is not evicted in between
+        Lock lock(lock_path(), false);
+
+        std::vector<common::Range> ranges;
+        if (!load(entry, ranges))
+        {
+            return false;
+        }
+
+        const auto covered = std::any_of(ranges.begin(), ranges.end(), [&](const common::Range & cached)
+        {
+            return cached.start <= range.start && range.start + range.size <= cached.start + cached.size;
+        });
+
+        if (!covered)
+        {
+            return false;
+        }
+
+        data = utils::Fd(::open(data_path(entry).c_str(), O_RDONLY | O_CLOEXEC));
+        if (data.fd() == -1)
+        {
+            return false;
+        }
+    }
+
+    if (!pread_exactly(data.fd(), buffer, range.size, range.start))
+    {
+        LOG(WARNING) << "Failed reading " << range << " of " << entry.uri << " from the cache";
+        return false;
+    }
+
+    // recently used objects are evicted last, and an object is marked as used once rather than on every hit
+    bool touch = false;
+    {
+        const auto guard = std::unique_lock<std::mutex>(_mutex);
+        touch = _touched.insert(entry.name).second;
+    }
+
+    if (touch)
+    {
+        ::utimensat(AT_FDCWD, metadata_path(entry).c_str(), nullptr, 0);
+    }
+
+    LOG(SPAM) << "Read " << range << " of " << entry.uri << " from the cache";
+    return true;
+}
+
+void Cache::read(const Entry & entry, const common::Range & range, char * buffer, ReadDone done)
+{
+    {
+        const auto guard = std::unique_lock<std::mutex>(_mutex);
+        _reads.push_back(Read{entry, range, buffer, std::move(done)});
+    }
+    _cv.notify_all();
+}
+
+void Cache::write(const Entry & entry, const common::Range & range, const char * data)
+{
+    {
+        const auto guard = std::unique_lock<std::mutex>(_mutex);
+        if (_pending_bytesize + range.size > max_pending_bytesize)
+        {
+            LOG(SPAM) << "Not caching " << range << " of " << entry.uri << " while " << _pending_bytesize << " bytes are waiting to be cached";
+            return;
+        }
+
+        _writes.push_back(Write{entry, range, std::vector<char>(data, data + range.size), nullptr, nullptr});
+        _pending_bytesize += range.size;
+    }
+    _cv.notify_all();
+}
+
+bool Cache::write(const Entry & entry, const common::Range & range, const char * data, WriteDone done)
+{
+    if (!_wait_for_writes)
+    {
+        write(entry, range, data);
+        return true;
+    }
+
+    {
+        const auto guard = std::unique_lock<std::mutex>(_mutex);
+        _writes.push_back(Write{entry, range, {}, data, std::move(done)});
+    }
+    _cv.notify_all();
+    return false;
+}
+
+void Cache::flush()
+{
+    auto guard = std::unique_lock<std::mutex>(_mutex);
+    _cv.wait(guard, [this]() { return _writes.empty() && !_writing; });
+}
+
+void Cache::run()
+{
+    auto guard = std::unique_lock<std::mutex>(_mutex);
+    while (true)
+    {
+        _cv.wait(guard, [this]() { return _stopped || !_writes.empty(); });
+        if (_writes.empty())
+        {
+            return;
+        }
+
+        auto write = std::move(_writes.front());
+        _writes.pop_front();
+        _writing = true;
+
+        guard.unlock();
+        try
+        {
+            store(write);
+        }
+        catch (const std::exception & e)
+        {
+            LOG(WARNING) << "Failed caching " << write.range << " of " << write.entry.uri;
+        }
+
+        // the caller may release the data of an in place write
+        if (write.done)
+        {
+            write.done();
+        }
+        guard.lock();
+
+        _writing = false;
+        _pending_bytesize -= write.data.size();
+        _cv.notify_all();
+    }
+}
+
+void Cache::run_reads()
+{
+    auto guard = std::unique_lock<std::mutex>(_mutex);
+    while (true)
+    {
+        _cv.wait(guard, [this]() { return _stopped || !_reads.empty(); });
+        if (_reads.empty())
+        {
+            return;
+        }
+
+        auto read = std::move(_reads.front());
+        _reads.pop_front();
+
+        guard.unlock();
+        bool hit = false;
+        try
+        {
+            hit = this->read(read.entry, read.range, read.buffer);
+        }
+        catch (const std::exception & e)
+        {
+            LOG(WARNING) << "Failed reading " << read.range << " of " << read.entry.uri << " from the cache";
+        }
+        read.done(hit);
+        guard.lock();
+    }
+}
+
+void Cache::store(const Write & write)
+{
+    const auto path = data_path(write.entry);
+
+    utils::Fd data(::open(path.c_str(), O_WRONLY | O_CREAT | O_CLOEXEC, 0666));
+    PASSERT(data.fd() != -1) << "Failed opening cache data file " << path;
+
+    // the data is synced before it is recorded in the metadata
+    const char * bytes = write.source != nullptr ? write.source : write.data.data();
+    PASSERT(pwrite_exactly(data.fd(), bytes, write.range.size, write.range.start)) << "Failed writing cache data file " << path;
+    PASSERT(::fdatasync(data.fd()) == 0) << "Failed syncing cache data file " << path;
+
+    struct stat written = {};
+    PASSERT(::fstat(data.fd(), &written) == 0) << "Failed querying stats of " << path;
+
+    Lock lock(lock_path(), true);
+
+    // the data file might have been evicted while it was written
+    struct stat current = {};
+    if (::stat(path.c_str(), &current) != 0 || current.st_ino != written.st_ino)
+    {
+        LOG(DEBUG) << "Cache data file " << path << " was evicted while writing";
+        return;
+    }
+
+    std::vector<common::Range> ranges;
+    if (!load(write.entry, ranges))
+    {
+        return;
+    }
+
+    // merge the overlapping and adjacent ranges
+    ranges.push_back(write.range);
+    std::sort(ranges.begin(), ranges.end(), [](const common::Range & a, const common::Range & b) { return a.start < b.start; });
+    std::vector<common::Range> merged;
+    for (const auto & range : ranges)
+    {
+        if (!merged.empty() && range.start <= merged.back().start + merged.back().size)
+        {
+            auto & last = merged.back();
+            last.size = std::max(last.start + last.size, range.start + range.size) - last.start;
+        }
+        else
+        {
+            merged.push_back(range);
+        }
+    }
+
+    save(write.entry, merged);
+    LOG(SPAM) << "Cached " << write.range << " of " << write.entry.uri;
+
+    evict();
+}
+
+size_t Cache::bytesize() const
+{
+    size_t total = 0;
+    DIR * dir = ::opendir(_directory.c_str());
+    if (dir == nullptr)
+    {
+        return 0;
+    }
+
+    while (auto * dirent = ::readdir(dir))
+    {
+        const std::string name = dirent->d_name;
+        struct stat stat = {};
+        if (ends_with(name, data_suffix) && ::stat((_directory + "/" + name).c_str(), &stat) == 0)
+        {
+            total += stat.st_blocks * 512;
+        }
+    }
+    ::closedir(dir);
+    return total;
+}
+
+// must be called while holding the exclusive lock
+void Cache::evict()
+{
+    struct Object
+    {
+        time_t used = 0;
+        size_t bytesize = 0;
+        bool has_metadata = false;
+    };
+
+    std::map<std::string, Object> objects;
+    size_t total = 0;
+
+    DIR * dir = ::opendir(_directory.c_str());
+    PASSERT(dir != nullptr) << "Failed opening cache directory " << _directory;
+
+    while (auto * dirent = ::readdir(dir))
+    {
+        const std::string name = dirent->d_name;
+        struct stat stat = {};
+        if (ends_with(name, data_suffix) && ::stat((_directory + "/" + name).c_str(), &stat) == 0)
+        {
+            auto & object = objects[name.substr(0, name.size() - sizeof(data_suffix) + 1)];
+            object.bytesize = stat.st_blocks * 512;
+            total += object.bytesize;
+        }
+        else if (ends_with(name, metadata_suffix) && ::stat((_directory + "/" + name).c_str(), &stat) == 0)
+        {
+            auto & object = objects[name.substr(0, name.size() - sizeof(metadata_suffix) + 1)];
+            object.used = stat.st_mtime;
+            object.has_metadata = true;
+        }
+    }
+    ::closedir(dir);
+
+    if (total <= _max_bytesize)
+    {
+        return;
+    }
+
+    // data files without metadata were left by a crash, and are evicted first
+    std::vector<std::pair<std::string, Object>> candidates(objects.begin(), objects.end());
+    std::sort(candidates.begin(), candidates.end(), [](const auto & a, const auto & b)
+    {
+        return std::make_pair(a.second.has_metadata, a.second.used) < std::make_pair(b.second.has_metadata, b.second.used);
+    });
+
+    const size_t target = static_cast<size_t>(_max_bytesize * eviction_watermark);
+    for (const auto & [name, object] : candidates)
+    {
+        if (total <= target)
+        {
+            break;
+        }
+
+        // the metadata is removed first, so that the ranges are not read from a missing data file
+        ::unlink((_directory + "/" + name + metadata_suffix).c_str());
+        ::unlink((_directory + "/" + name + data_suffix).c_str());
+        total -= std::min(total, object.bytesize);
+        LOG(DEBUG) << "Evicted cached object " << name << " of " << object.bytesize << " bytes";
+    }
+}
+
+}; // namespace runai::llm::streamer::impl
@@ -0,0 +1,140 @@
+#pragma once
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <set>
+#include <string>
+#include <vector>
+
+#include "common/range/range.h"
+
+#include "utils/thread/thread.h"
+
+namespace runai::llm::streamer::impl
+{
+
+// Read-through cache of object storage ranges on a local disk, shared by the processes of the node
+//
+// Every object version is cached in a sparse data file, named by a hash of its uri and version, next to a metadata file listing its cached ranges
+// Ranges are recorded in the metadata only after their data was synced, and the metadata is replaced atomically, so that a crash never exposes missing data
+// The files are updated under an advisory lock of the cache directory, and the least recently used objects are evicted when the cache exceeds its size
+//
+// Ranges are written by a background thread from a copy of the data, so that filling the cache does not delay the reads
+// Ranges are not cached while too many copied bytes are waiting to be written
+// A cache which waits for writes writes every range in place instead, and its caller is called back once the data is written,
+// so that waiting for a slow file system delays the responses of the ranges but never blocks the calling thread
+// Ranges may also be read by background threads, which are called back with whether the range was cached
+//
+// A cache in a memory file system (e.g. /dev/shm) is a snapshot of the objects read, which survives process restarts and is read at memory speed
+// Objects whose data files are missing or truncated (e.g. after a reboot or by an external cleanup) are removed when the cache is opened
+
+struct Cache
+{
+    // a version of an object in the cache
+    struct Entry
+    {
+        Entry(const std::string & uri, const std::string & version);
+
+        std::string uri;
+        std::string version;
+
+        // content address of the object version
+        std::string name;
+    };
+
+    // throws FileAccessError if the directory cannot be created, or is in a file system which does not support writing files (hugetlbfs)
+    // a max bytesize of 0 limits the cache to half of its file system
+    // if wait_for_writes is set, ranges written with a completion are written in place and never dropped, so that every range read is cached
+    Cache(const std::string & directory, size_t max_bytesize, bool wait_for_writes = false);
+
+    // waits for the pending writes
+    ~Cache();
+
+    // called from a background thread once a range was read, with whether the whole range was cached
+    using ReadDone = std::function<void(bool)>;
+
+    // called from a background thread once the data of a range written in place is not accessed anymore
+    using WriteDone = std::function<void()>;
+
+    // reads the range into the buffer, and returns false unless the whole range is cached
+    bool read(const Entry & entry, const common::Range & range, char * buffer);
+
+    // reads the range into the buffer in the background
+    void read(const Entry & entry, const common::Range & range, char * buffer, ReadDone done);
+
+    // caches a copy of the range in the background
+    void write(const Entry & entry, const common::Range & range, const char * data);
+
+    // caches the range in the background - in place if the cache waits for writes, and otherwise from a copy
+    // returns true if the data is not accessed anymore, and otherwise the data is kept until `done` is called
+    bool write(const Entry & entry, const common::Range & range, const char * data, WriteDone done);
+
+    // blocks until the pending writes are done
+    void flush();
+
+    // bytes of the cached data files
+    size_t bytesize() const;
+
+    // bytes above which objects are evicted
+    size_t max_bytesize() const;
+
+    static constexpr size_t max_pending_bytesize = 1024UL * 1024 * 1024;
+
+    // threads reading ranges in the background
+    static constexpr unsigned reader_threads = 4;
+
+ private:
+    struct Write
+    {
+        Entry entry;
+        common::Range range;
+        // a copy of the data, or empty if the data is written in place
+        std::vector<char> data;
+        const char * source = nullptr;
+        WriteDone done;
+    };
+
+    struct Read
+    {
+        Entry entry;
+        common::Range range;
+        char * buffer;
+        ReadDone done;
+    };
+
+    void run();
+    void run_reads();
+    void store(const Write & write);
+    void evict();
+
+    // removes the objects whose data files do not hold their cached ranges
+    void validate();
+
+    // reads the cached ranges of the entry, and returns false if the metadata belongs to another entry
+    bool load(const Entry & entry, std::vector<common::Range> & ranges) const;
+    void save(const Entry & entry, const std::vector<common::Range> & ranges) const;
+
+    std::string data_path(const Entry & entry) const;
+    std::string metadata_path(const Entry & entry) const;
+    std::string lock_path() const;
+
+    const std::string _directory;
+    size_t _max_bytesize;
+    const bool _wait_for_writes;
+
+    std::mutex _mutex;
+    std::condition_variable _cv;
+    std::deque<Write> _writes;
+    std::deque<Read> _reads;
+    size_t _pending_bytesize = 0;
+    bool _writing = false;
+    bool _stopped = false;
+    // names of the entries whose use was recorded, so that the metadata is not written on every hit
+    std::set<std::string> _touched;
+    utils::Thread _thread;
+    std::vector<utils::Thread> _readers;
+};
+
+}; // namespace runai::llm::streamer::impl
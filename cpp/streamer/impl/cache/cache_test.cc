@@ -0,0 +1,280 @@
+#include "streamer/impl/cache/cache.h"
+
+#include <gtest/gtest.h>
+
+#include <sys/stat.h>
+#include <sys/statvfs.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "common/exception/exception.h"
+
+#include "utils/fd/fd.h"
+#include "utils/random/random.h"
+#include "utils/temp/dir/dir.h"
+
+namespace runai::llm::streamer::impl
+{
+
+namespace
+{
+
+std::vector<char> buffer(size_t size)
+{
+    const auto data = utils::random::buffer(size);
+    return std::vector<char>(data.begin(), data.end());
+}
+
+} // namespace
+
+TEST(Entry, Name)
+{
+    const auto uri = "s3://" + utils::random::string() + "/" + utils::random::string();
+    const auto version = utils::random::string();
+
+    EXPECT_EQ(Cache::Entry(uri, version).name, Cache::Entry(uri, version).name);
+    EXPECT_NE(Cache::Entry(uri, version).name, Cache::Entry(uri, version + "x").name);
+    EXPECT_NE(Cache::Entry(uri, version).name, Cache::Entry(uri + "x", version).name);
+    EXPECT_EQ(Cache::Entry(uri, version).name.size(), 16);
+}
+
+TEST(Creation, Directory)
+{
+    utils::temp::Dir dir;
+    const auto path = dir.path + "/" + utils::random::string();
+    Cache cache(path, 1024);
+
+    struct stat stat = {};
+    EXPECT_EQ(::stat(path.c_str(), &stat), 0);
+    EXPECT_TRUE(S_ISDIR(stat.st_mode));
+}
+
+TEST(Creation, Invalid_Directory)
+{
+    EXPECT_THROW(Cache("/" + utils::random::string() + "/" + utils::random::string(), 1024), common::Exception);
+}
+
+TEST(Read, Sanity)
+{
+    utils::temp::Dir dir;
+    Cache cache(dir.path, 1024 * 1024 * 1024);
+
+    const Cache::Entry entry("s3://bucket/" + utils::random::string(), utils::random::string());
+    const auto size = utils::random::number(1, 100000);
+    const auto data = buffer(size);
+    const common::Range range(utils::random::number(0, 100000), size);
+
+    std::vector<char> destination(size);
+    EXPECT_FALSE(cache.read(entry, range, destination.data()));
+
+    cache.write(entry, range, data.data());
+    cache.flush();
+
+    EXPECT_TRUE(cache.read(entry, range, destination.data()));
+    EXPECT_EQ(destination, data);
+
+    // another version of the object is not cached
+    EXPECT_FALSE(cache.read(Cache::Entry(entry.uri, entry.version + "x"), range, destination.data()));
+}
+
+TEST(Read, Partial)
+{
+    utils::temp::Dir dir;
+    Cache cache(dir.path, 1024 * 1024 * 1024);
+
+    const Cache::Entry entry("s3://bucket/" + utils::random::string(), utils::random::string());
+    const auto data = buffer(3000);
+
+    cache.write(entry, common::Range(0, 1000), data.data());
+    cache.write(entry, common::Range(2000, 1000), data.data() + 2000);
+    cache.flush();
+
+    std::vector<char> destination(3000);
+    EXPECT_TRUE(cache.read(entry, common::Range(100, 800), destination.data()));
+    EXPECT_TRUE(std::equal(data.begin() + 100, data.begin() + 900, destination.begin()));
+    EXPECT_TRUE(cache.read(entry, common::Range(2000, 1000), destination.data()));
+    EXPECT_FALSE(cache.read(entry, common::Range(500, 1000), destination.data()));
+    EXPECT_FALSE(cache.read(entry, common::Range(0, 3000), destination.data()));
+
+    // adjacent ranges are merged
+    cache.write(entry, common::Range(1000, 1000), data.data() + 1000);
+    cache.flush();
+    EXPECT_TRUE(cache.read(entry, common::Range(0, 3000), destination.data()));
+    EXPECT_EQ(destination, data);
+}
+
+TEST(Read, Background)
+{
+    utils::temp::Dir dir;
+    Cache cache(dir.path, 1024 * 1024 * 1024);
+
+    const Cache::Entry entry("s3://bucket/" + utils::random::string(), utils::random::string());
+    const auto data = buffer(utils::random::number(1, 100000));
+    const common::Range range(0, data.size());
+    cache.write(entry, range, data.data());
+    cache.flush();
+
+    std::mutex mutex;
+    std::condition_variable cv;
+    std::vector<bool> hits;
+    const auto done = [&](bool hit)
+    {
+        const auto guard = std::unique_lock<std::mutex>(mutex);
+        hits.push_back(hit);
+        cv.notify_all();
+    };
+
+    std::vector<char> destination(data.size());
+    std::vector<char> other(data.size());
+    cache.read(entry, range, destination.data(), done);
+    cache.read(Cache::Entry(entry.uri, entry.version + "x"), range, other.data(), done);
+
+    auto lock = std::unique_lock<std::mutex>(mutex);
+    cv.wait(lock, [&]() { return hits.size() == 2; });
+    EXPECT_EQ(std::count(hits.begin(), hits.end(), true), 1);
+    EXPECT_EQ(destination, data);
+}
+
+TEST(Write, In_Place)
+{
+    utils::temp::Dir dir;
+    const Cache::Entry entry("s3://bucket/" + utils::random::string(), utils::random::string());
+    const auto data = buffer(utils::random::number(1, 100000));
+    const common::Range range(0, data.size());
+
+    // a cache which does not wait for writes copies the data
+    {
+        Cache cache(dir.path + "/copy", 1024 * 1024 * 1024);
+        EXPECT_TRUE(cache.write(entry, range, data.data(), []() { FAIL() << "Copied data is not written in place"; }));
+        cache.flush();
+    }
+
+    // the data is kept until it was written
+    Cache cache(dir.path + "/in_place", 1024 * 1024 * 1024, true);
+    std::atomic<bool> written(false);
+    EXPECT_FALSE(cache.write(entry, range, data.data(), [&]() { written = true; }));
+    cache.flush();
+    EXPECT_TRUE(written);
+
+    std::vector<char> destination(data.size());
+    EXPECT_TRUE(cache.read(entry, range, destination.data()));
+    EXPECT_EQ(destination, data);
+}
+
+TEST(Read, Persistent)
+{
+    utils::temp::Dir dir;
+    const Cache::Entry entry("gs://bucket/" + utils::random::string(), utils::random::string());
+    const auto data = buffer(utils::random::number(1, 100000));
+    const common::Range range(0, data.size());
+
+    {
+        Cache cache(dir.path, 1024 * 1024 * 1024);
+        cache.write(entry, range, data.data());
+    }
+
+    // pending writes are done before destruction, and the cache is shared with following instances
+    Cache cache(dir.path, 1024 * 1024 * 1024);
+    std::vector<char> destination(data.size());
+    EXPECT_TRUE(cache.read(entry, range, destination.data()));
+    EXPECT_EQ(destination, data);
+}
+
+TEST(Creation, Default_Size)
+{
+    utils::temp::Dir dir;
+    Cache cache(dir.path, 0);
+
+    struct statvfs fs = {};
+    ASSERT_EQ(::statvfs(dir.path.c_str(), &fs), 0);
+    EXPECT_EQ(cache.max_bytesize(), fs.f_blocks * fs.f_frsize / 2);
+}
+
+TEST(Validation, Truncated_Data)
+{
+    utils::temp::Dir dir;
+    const Cache::Entry entry("s3://bucket/" + utils::random::string(), utils::random::string());
+    const auto data = buffer(utils::random::number(2, 100000));
+    const common::Range range(0, data.size());
+    std::vector<char> destination(data.size());
+
+    {
+        Cache cache(dir.path, 1024 * 1024 * 1024, true);
+        cache.write(entry, range, data.data());
+        cache.flush();
+        EXPECT_TRUE(cache.read(entry, range, destination.data()));
+    }
+
+    // e.g. a partially restored snapshot
+    ASSERT_EQ(::truncate((dir.path + "/" + entry.name + ".data").c_str(), data.size() - 1), 0);
+
+    Cache cache(dir.path, 1024 * 1024 * 1024, true);
+    EXPECT_FALSE(cache.read(entry, range, destination.data()));
+    EXPECT_FALSE(utils::Fd::exists(dir.path + "/" + entry.name + ".meta"));
+    EXPECT_FALSE(utils::Fd::exists(dir.path + "/" + entry.name + ".data"));
+}
+
+TEST(Validation, Missing_Data)
+{
+    utils::temp::Dir dir;
+    const Cache::Entry entry("s3://bucket/" + utils::random::string(), utils::random::string());
+    const auto data = buffer(utils::random::number(1, 100000));
+    const common::Range range(0, data.size());
+
+    {
+        Cache cache(dir.path, 1024 * 1024 * 1024);
+        cache.write(entry, range, data.data());
+    }
+
+    ASSERT_EQ(::unlink((dir.path + "/" + entry.name + ".data").c_str()), 0);
+
+    Cache cache(dir.path, 1024 * 1024 * 1024);
+    std::vector<char> destination(data.size());
+    EXPECT_FALSE(cache.read(entry, range, destination.data()));
+    EXPECT_FALSE(utils::Fd::exists(dir.path + "/" + entry.name + ".meta"));
+}
+
+TEST(Eviction, Least_Recently_Used)
+{
+    utils::temp::Dir dir;
+    const size_t object_size = 1024 * 1024;
+    Cache cache(dir.path, 3 * object_size + object_size / 2);
+
+    std::vector<Cache::Entry> entries;
+    std::vector<std::vector<char>> data;
+    const common::Range range(0, object_size);
+    std::vector<char> destination(object_size);
+
+    for (unsigned i = 0; i < 3; ++i)
+    {
+        entries.emplace_back("s3://bucket/" + utils::random::string(), "1");
+        data.push_back(buffer(object_size));
+        cache.write(entries.back(), range, data.back().data());
+        cache.flush();
+
+        // modification times have a resolution of a second in some file systems
+        ::sleep(1);
+    }
+
+    // the first object is used, and the second is evicted instead
+    EXPECT_TRUE(cache.read(entries[0], range, destination.data()));
+
+    entries.emplace_back("s3://bucket/" + utils::random::string(), "1");
+    data.push_back(buffer(object_size));
+    cache.write(entries.back(), range, data.back().data());
+    cache.flush();
+
+    EXPECT_LE(cache.bytesize(), 3 * object_size + object_size / 2);
+    EXPECT_TRUE(cache.read(entries[0], range, destination.data()));
+    EXPECT_FALSE(cache.read(entries[1], range, destination.data()));
+    EXPECT_TRUE(cache.read(entries[3], range, destination.data()));
+    EXPECT_EQ(destination, data[3]);
+}
+
+}; // namespace runai::llm::streamer::impl
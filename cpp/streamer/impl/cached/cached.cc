@@ -0,0 +1,280 @@
+#include "streamer/impl/cached/cached.h"
+
+#include <algorithm>
+#include <iterator>
+#include <utility>
+
+#include "common/exception/exception.h"
+#include "common/metrics/metrics.h"
+
+#include "utils/logging/logging.h"
+
+namespace runai::llm::streamer::impl
+{
+
+Cached::Cached(std::shared_ptr<Reader> reader, std::shared_ptr<Cache> cache, Version version, common::backend_api::ObjectCompletionNotification_t notification, void * context, std::shared_ptr<Notifier> notifier) :
+    Reader(Reader::Mode::Async),
+    _reader(reader),
+    _cache(cache),
+    _version(version),
+    _background(std::make_shared<Background>())
+{
+    ASSERT(_reader != nullptr && _cache != nullptr) << "Creating a cached reader without a reader or a cache";
+    _background->notification = notification;
+    _background->context = context;
+    _background->notifier = notifier;
+}
+
+Cached::~Cached()
+{
+    try
+    {
+        // the buffers of the ranges must not be accessed once the reader is destroyed
+        auto lock = std::unique_lock<std::mutex>(_background->mutex);
+        _background->cv.wait(lock, [this]() { return _background->running == 0; });
+    }
+    catch (...)
+    {}
+}
+
+void Cached::Background::complete()
+{
+    cv.notify_all();
+    if (notifier != nullptr)
+    {
+        notifier->notify();
+    }
+    else if (notification != nullptr)
+    {
+        notification(context);
+    }
+
+    {
+        const auto guard = std::unique_lock<std::mutex>(mutex);
+        --running;
+    }
+    cv.notify_all();
+}
+
+void Cached::seek(size_t offset)
+{
+    LOG(ERROR) << "Not implemented";
+    throw common::Exception(common::ResponseCode::UnknownError);
+}
+
+void Cached::read(size_t bytesize, char * buffer)
+{
+    LOG(ERROR) << "Not implemented";
+    throw common::Exception(common::ResponseCode::UnknownError);
+}
+
+const std::optional<Cache::Entry> & Cached::entry(const common::s3::S3ClientWrapper::Params & params)
+{
+    auto it = _entries.find(params.uri->uri);
+    if (it != _entries.end())
+    {
+        return it->second;
+    }
+
+    std::optional<Cache::Entry> entry;
+    const auto version = _version(params);
+    if (version.has_value())
+    {
+        entry.emplace(params.uri->uri, version.value());
+        LOG(DEBUG) << "Caching " << params.uri->uri << " version " << version.value() << " as " << entry->name;
+    }
+    else
+    {
+        LOG(DEBUG) << "Not caching " << params.uri->uri << " of unknown version";
+    }
+
+    return _entries.emplace(params.uri->uri, std::move(entry)).first->second;
+}
+
+void Cached::async_read(const common::s3::S3ClientWrapper::Params & params, common::backend_api::ObjectRequestId_t request_handle, const common::Range & range, char * buffer)
+{
+    const auto & cache_entry = entry(params);
+
+    if (cache_entry.has_value() && !_failed)
+    {
+        {
+            const auto guard = std::unique_lock<std::mutex>(_background->mutex);
+            ++_background->running;
+        }
+        ++_lookups;
+
+        _cache->read(cache_entry.value(), range, buffer, [background = _background, lookup = Lookup{params, request_handle, range, buffer, false}](bool hit) mutable
+            {
+                lookup.hit = hit;
+                {
+                    const auto guard = std::unique_lock<std::mutex>(background->mutex);
+                    background->lookups.push_back(std::move(lookup));
+                }
+                background->complete();
+            });
+        return;
+    }
+
+    _reader->async_read(params, request_handle, range, buffer);
+    _pending.emplace(request_handle, Pending{cache_entry, range, buffer});
+}
+
+void Cached::handle(const common::backend_api::Response & response, std::vector<common::backend_api::Response> & responses)
+{
+    auto it = _pending.find(response.handle);
+    if (it == _pending.end())
+    {
+        LOG(WARNING) << "Received response of unknown request " << response.handle;
+        responses.push_back(response);
+        return;
+    }
+
+    const auto pending = it->second;
+    _pending.erase(it);
+
+    const bool complete = (response.bytes_transferred == pending.range.size);
+    if (response.ret != common::ResponseCode::Success || !complete || !pending.entry.has_value())
+    {
+        responses.push_back(response);
+        return;
+    }
+
+    {
+        const auto guard = std::unique_lock<std::mutex>(_background->mutex);
+        ++_background->running;
+    }
+
+    // a range written in place is responded once it was written, since the caller may release the buffer once it is responded
+    const bool done = _cache->write(pending.entry.value(), pending.range, pending.buffer, [background = _background, response]()
+        {
+            {
+                const auto guard = std::unique_lock<std::mutex>(background->mutex);
+                background->written.push_back(response);
+            }
+            background->complete();
+        });
+
+    if (done)
+    {
+        {
+            const auto guard = std::unique_lock<std::mutex>(_background->mutex);
+            --_background->running;
+        }
+        responses.push_back(response);
+    }
+    else
+    {
+        ++_writes;
+    }
+}
+
+common::ResponseCode Cached::async_response(std::vector<common::backend_api::Response> & responses, unsigned max_responses, common::backend_api::ObjectWaitMode_t wait_mode)
+{
+    const auto initial = responses.size();
+    const auto room = [&]() { return max_responses - (responses.size() - initial); };
+
+    while (true)
+    {
+        std::vector<Lookup> lookups;
+        {
+            const auto guard = std::unique_lock<std::mutex>(_background->mutex);
+
+            auto & written = _background->written;
+            const auto count = std::min<size_t>(room(), written.size());
+            responses.insert(responses.end(), written.begin(), written.begin() + count);
+            written.erase(written.begin(), written.begin() + count);
+            _writes -= count;
+
+            auto & ready = _background->lookups;
+            const auto lookups_count = std::min<size_t>(room(), ready.size());
+            std::move(ready.begin(), ready.begin() + lookups_count, std::back_inserter(lookups));
+            ready.erase(ready.begin(), ready.begin() + lookups_count);
+        }
+
+        for (auto & lookup : lookups)
+        {
+            --_lookups;
+            if (lookup.hit)
+            {
+                responses.emplace_back(lookup.handle, common::ResponseCode::Success, lookup.range.size);
+                ++_total_hits;
+                common::Metrics::read(common::Metrics::Backend::Cache, lookup.range.size);
+            }
+            else if (!_failed)
+            {
+                _reader->async_read(lookup.params, lookup.handle, lookup.range, lookup.buffer);
+                _pending.emplace(lookup.handle, Pending{entry(lookup.params), lookup.range, lookup.buffer});
+            }
+            // otherwise the object storage reader was canceled or stopped, and the range has no completion event
+        }
+
+        if (_pending.empty() && _lookups == 0 && _writes == 0)
+        {
+            // no responses are expected
+            return responses.size() > initial ? common::ResponseCode::Success : _error;
+        }
+
+        if (!_pending.empty() && room() > 0)
+        {
+            // block only when the cache has nothing in progress and no responses are ready
+            const bool background = _lookups > 0 || _writes > 0;
+            const auto mode = (wait_mode == common::backend_api::OBJECT_WAIT_MODE_BLOCK && !background && responses.size() == initial) ? common::backend_api::OBJECT_WAIT_MODE_BLOCK : common::backend_api::OBJECT_WAIT_MODE_NON_BLOCKING;
+
+            std::vector<common::backend_api::Response> ready;
+            const auto r = _reader->async_response(ready, room(), mode);
+            if (r != common::ResponseCode::Success)
+            {
+                if (!background)
+                {
+                    return r;
+                }
+
+                // the requests in flight were canceled or stopped, and the reads and writes of the cache are waited for before returning the error
+                _failed = true;
+                _error = r;
+                _pending.clear();
+            }
+
+            for (const auto & response : ready)
+            {
+                handle(response, responses);
+            }
+        }
+
+        if (responses.size() > initial || wait_mode == common::backend_api::OBJECT_WAIT_MODE_NON_BLOCKING)
+        {
+            return common::ResponseCode::Success;
+        }
+
+        // wait for the cache to complete a lookup or a write, and for the object storage reader if it has pending requests
+        // the reader itself is blocked on only once the cache has nothing in progress
+        if (_lookups > 0 || _writes > 0)
+        {
+            if (!_pending.empty() && _background->notifier != nullptr)
+            {
+                // both notify once ready, including since they were last checked
+                _background->notifier->wait();
+                continue;
+            }
+
+            // without a notifier the object storage reader is polled
+            auto lock = std::unique_lock<std::mutex>(_background->mutex);
+            const auto ready = [this]() { return !_background->lookups.empty() || !_background->written.empty(); };
+            if (_pending.empty())
+            {
+                _background->cv.wait(lock, ready);
+            }
+            else
+            {
+                _background->cv.wait_for(lock, reader_poll_interval, ready);
+            }
+        }
+    }
+}
+
+size_t Cached::hits() const
+{
+    return _total_hits;
+}
+
+}; // namespace runai::llm::streamer::impl
@@ -0,0 +1,114 @@
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "common/backend_api/object_storage/object_storage.h"
+#include "common/range/range.h"
+#include "common/s3_wrapper/s3_wrapper.h"
+#include "streamer/impl/cache/cache.h"
+#include "streamer/impl/notifier/notifier.h"
+#include "streamer/impl/reader/reader.h"
+
+namespace runai::llm::streamer::impl
+{
+
+// Reads object storage ranges through a local cache
+//
+// Ranges are looked up in the cache by its background threads when they are requested, and the ranges which are not fully cached are then read by the object storage reader
+// Ranges read from object storage are cached once they were read successfully, and the response of a range written in place is returned once it was written
+// The notification is called whenever ranges were read from the cache or written to it, so that the calling thread never waits for the file system
+// A blocking caller blocks on the object storage reader only while the cache has nothing in progress
+// With a notifier, which the object storage clients notify too, a blocking caller waits for both the cache and the object storage on the notifier,
+// and otherwise it waits for the cache while polling the object storage reader
+// Objects are cached by their version, and objects without a known version are not cached
+
+struct Cached : Reader
+{
+    // the version of the object of the given parameters, which changes whenever the object is replaced
+    using Version = std::function<std::optional<std::string>(const common::s3::S3ClientWrapper::Params &)>;
+
+    // the notifier, if given, is notified instead of the notification and forwards to it
+    Cached(std::shared_ptr<Reader> reader, std::shared_ptr<Cache> cache, Version version, common::backend_api::ObjectCompletionNotification_t notification = nullptr, void * context = nullptr, std::shared_ptr<Notifier> notifier = nullptr);
+
+    // waits for the reads and writes of the cache in the background
+    virtual ~Cached();
+
+    void read(size_t bytesize, char * buffer) override;
+    void seek(size_t offset) override;
+
+    void async_read(const common::s3::S3ClientWrapper::Params & params, common::backend_api::ObjectRequestId_t request_handle, const common::Range & range, char * buffer) override;
+    common::ResponseCode async_response(std::vector<common::backend_api::Response> & responses, unsigned max_responses, common::backend_api::ObjectWaitMode_t wait_mode) override;
+
+    // number of ranges which were read from the cache
+    size_t hits() const;
+
+ private:
+    struct Pending
+    {
+        std::optional<Cache::Entry> entry;
+        common::Range range;
+        char * buffer;
+    };
+
+    struct Lookup
+    {
+        common::s3::S3ClientWrapper::Params params;
+        common::backend_api::ObjectRequestId_t handle;
+        common::Range range;
+        char * buffer;
+        bool hit;
+    };
+
+    // completions of the background threads of the cache, which outlive the reader until they are done
+    struct Background
+    {
+        std::mutex mutex;
+        std::condition_variable cv;
+        std::vector<Lookup> lookups;
+        std::vector<common::backend_api::Response> written;
+        // reads and writes which did not complete yet
+        size_t running = 0;
+
+        common::backend_api::ObjectCompletionNotification_t notification;
+        void * context;
+        std::shared_ptr<Notifier> notifier;
+
+        void complete();
+    };
+
+    // the cache entry of the object, or none if its version is unknown
+    const std::optional<Cache::Entry> & entry(const common::s3::S3ClientWrapper::Params & params);
+
+    // handles a response of the object storage reader
+    void handle(const common::backend_api::Response & response, std::vector<common::backend_api::Response> & responses);
+
+    std::shared_ptr<Reader> _reader;
+    std::shared_ptr<Cache> _cache;
+    Version _version;
+
+    std::map<std::string, std::optional<Cache::Entry>> _entries;
+    std::map<common::backend_api::ObjectRequestId_t, Pending> _pending;
+
+    std::shared_ptr<Background> _background;
+    // ranges looked up in the cache and written to it, whose completions were not handled yet
+    size_t _lookups = 0;
+    size_t _writes = 0;
+    size_t _total_hits = 0;
+
+    // the object storage reader failed, and returns no more responses
+    bool _failed = false;
+    common::ResponseCode _error = common::ResponseCode::FinishedError;
+
+    // interval of polling the object storage reader while waiting for the cache without a notifier
+    static constexpr auto reader_poll_interval = std::chrono::milliseconds(1);
+};
+
+}; // namespace runai::llm::streamer::impl
@@ -0,0 +1,245 @@
+#include "streamer/impl/cached/cached.h"
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <optional>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "common/exception/exception.h"
+#include "streamer/impl/reader/mock/mock.h"
+
+#include "utils/random/random.h"
+#include "utils/temp/dir/dir.h"
+#include "utils/thread/thread.h"
+
+namespace runai::llm::streamer::impl
+{
+
+struct CachedTest : ::testing::Test
+{
+    CachedTest() :
+        cache(std::make_shared<Cache>(dir.path, 1024 * 1024 * 1024)),
+        params(std::make_shared<common::s3::StorageUri>("s3://bucket/" + utils::random::string()), 0)
+    {
+        const auto data = utils::random::buffer(utils::random::number(10000, 100000));
+        object.assign(data.begin(), data.end());
+    }
+
+    // reads the object in ranges and returns the number of responses
+    size_t read(Cached & cached, std::vector<char> & destination, common::ResponseCode expected = common::ResponseCode::Success)
+    {
+        const size_t range_size = 1000;
+        size_t requests = 0;
+        for (size_t start = 0; start < object.size(); start += range_size, ++requests)
+        {
+            cached.async_read(params, requests, common::Range(start, std::min(range_size, object.size() - start)), destination.data() + start);
+        }
+
+        size_t responses = 0;
+        while (true)
+        {
+            std::vector<common::backend_api::Response> ready;
+            const auto r = cached.async_response(ready, utils::random::number(1, 10), common::backend_api::OBJECT_WAIT_MODE_BLOCK);
+            if (r == common::ResponseCode::FinishedError)
+            {
+                break;
+            }
+            EXPECT_EQ(r, common::ResponseCode::Success);
+            for (const auto & response : ready)
+            {
+                EXPECT_EQ(response.ret, expected);
+            }
+            responses += ready.size();
+        }
+
+        EXPECT_EQ(responses, requests);
+        cache->flush();
+        return responses;
+    }
+
+    utils::temp::Dir dir;
+    std::shared_ptr<Cache> cache;
+    common::s3::S3ClientWrapper::Params params;
+    std::vector<char> object;
+};
+
+TEST_F(CachedTest, Sanity)
+{
+    const std::string version = utils::random::string();
+    Cached::Version get_version = [&](const common::s3::S3ClientWrapper::Params &) { return std::optional<std::string>(version); };
+
+    // the first read fills the cache
+    {
+        auto reader = std::make_shared<MockReader>(object);
+        Cached cached(reader, cache, get_version);
+        std::vector<char> destination(object.size());
+        const auto requests = read(cached, destination);
+        EXPECT_EQ(destination, object);
+        EXPECT_EQ(cached.hits(), 0);
+        EXPECT_EQ(reader->requests, requests);
+    }
+
+    // the following read is served from the cache
+    {
+        auto reader = std::make_shared<MockReader>(object);
+        Cached cached(reader, cache, get_version);
+        std::vector<char> destination(object.size());
+        const auto requests = read(cached, destination);
+        EXPECT_EQ(destination, object);
+        EXPECT_EQ(cached.hits(), requests);
+        EXPECT_EQ(reader->requests, 0);
+    }
+}
+
+TEST_F(CachedTest, Snapshot)
+{
+    const std::string version = utils::random::string();
+    Cached::Version get_version = [&](const common::s3::S3ClientWrapper::Params &) { return std::optional<std::string>(version); };
+
+    // ranges are written in place, and responded once written
+    cache = std::make_shared<Cache>(dir.path + "/snapshot", 0, true);
+
+    std::atomic<unsigned> notifications(0);
+    const common::backend_api::ObjectCompletionNotification_t notification = [](void * context) { ++*static_cast<std::atomic<unsigned> *>(context); };
+
+    for (unsigned i = 0; i < 2; ++i)
+    {
+        auto reader = std::make_shared<MockReader>(object);
+        Cached cached(reader, cache, get_version, notification, &notifications);
+        std::vector<char> destination(object.size());
+        const auto requests = read(cached, destination);
+        EXPECT_EQ(destination, object);
+        EXPECT_EQ(cached.hits(), i == 0 ? 0 : requests);
+        EXPECT_EQ(reader->requests, i == 0 ? requests : 0);
+        EXPECT_GT(notifications, 0u);
+    }
+}
+
+TEST_F(CachedTest, New_Version)
+{
+    std::string version = utils::random::string();
+    Cached::Version get_version = [&](const common::s3::S3ClientWrapper::Params &) { return std::optional<std::string>(version); };
+
+    {
+        Cached cached(std::make_shared<MockReader>(object), cache, get_version);
+        std::vector<char> destination(object.size());
+        read(cached, destination);
+    }
+
+    // the object was replaced
+    version += "x";
+    const auto data = utils::random::buffer(object.size());
+    object.assign(data.begin(), data.end());
+
+    auto reader = std::make_shared<MockReader>(object);
+    Cached cached(reader, cache, get_version);
+    std::vector<char> destination(object.size());
+    const auto requests = read(cached, destination);
+    EXPECT_EQ(destination, object);
+    EXPECT_EQ(cached.hits(), 0);
+    EXPECT_EQ(reader->requests, requests);
+}
+
+TEST_F(CachedTest, Unknown_Version)
+{
+    Cached::Version get_version = [](const common::s3::S3ClientWrapper::Params &) { return std::nullopt; };
+
+    for (unsigned i = 0; i < 2; ++i)
+    {
+        Cached cached(std::make_shared<MockReader>(object), cache, get_version);
+        std::vector<char> destination(object.size());
+        read(cached, destination);
+        EXPECT_EQ(cached.hits(), 0);
+    }
+    EXPECT_EQ(cache->bytesize(), 0);
+}
+
+TEST_F(CachedTest, Failed_Reads_Are_Not_Cached)
+{
+    const std::string version = utils::random::string();
+    Cached::Version get_version = [&](const common::s3::S3ClientWrapper::Params &) { return std::optional<std::string>(version); };
+
+    {
+        Cached cached(std::make_shared<MockReader>(object, common::ResponseCode::FileAccessError), cache, get_version);
+        std::vector<char> destination(object.size());
+        read(cached, destination, common::ResponseCode::FileAccessError);
+    }
+
+    Cached cached(std::make_shared<MockReader>(object), cache, get_version);
+    std::vector<char> destination(object.size());
+    read(cached, destination);
+    EXPECT_EQ(cached.hits(), 0);
+}
+
+TEST_F(CachedTest, Partial_Hit)
+{
+    const std::string version = utils::random::string();
+    Cached::Version get_version = [&](const common::s3::S3ClientWrapper::Params &) { return std::optional<std::string>(version); };
+
+    // cache the first half of the object
+    cache->write(Cache::Entry(params.uri->uri, version), common::Range(0, object.size() / 2), object.data());
+    cache->flush();
+
+    auto reader = std::make_shared<MockReader>(object);
+    Cached cached(reader, cache, get_version);
+    std::vector<char> destination(object.size());
+    const auto requests = read(cached, destination);
+    EXPECT_EQ(destination, object);
+    EXPECT_GT(cached.hits(), 0);
+    EXPECT_GT(reader->requests, 0);
+    EXPECT_EQ(cached.hits() + reader->requests, requests);
+}
+
+TEST_F(CachedTest, Notifier)
+{
+    // completes its requests only once released, like a client which notifies when its responses are ready
+    struct ReleasedReader : MockReader
+    {
+        ReleasedReader(const std::vector<char> & object) : MockReader(object) {}
+
+        common::ResponseCode async_response(std::vector<common::backend_api::Response> & responses, unsigned max_responses, common::backend_api::ObjectWaitMode_t wait_mode) override
+        {
+            if (!released && !pending.empty())
+            {
+                return common::ResponseCode::Success;
+            }
+            return MockReader::async_response(responses, max_responses, wait_mode);
+        }
+
+        std::atomic<bool> released = false;
+    };
+
+    const std::string version = utils::random::string();
+    Cached::Version get_version = [&](const common::s3::S3ClientWrapper::Params &) { return std::optional<std::string>(version); };
+
+    // the first half of the object is read from the cache, and the rest from the object storage reader
+    cache->write(Cache::Entry(params.uri->uri, version), common::Range(0, object.size() / 2), object.data());
+    cache->flush();
+
+    auto notifier = std::make_shared<Notifier>();
+    auto reader = std::make_shared<ReleasedReader>(object);
+    Cached cached(reader, cache, get_version, nullptr, nullptr, notifier);
+
+    auto releasing = utils::Thread([&]()
+    {
+        std::this_thread::sleep_for(std::chrono::milliseconds(utils::random::number(10)));
+        reader->released = true;
+        notifier->notify();
+    });
+
+    // a blocking caller is woken by both the cache and the object storage reader
+    std::vector<char> destination(object.size());
+    const auto requests = read(cached, destination);
+    EXPECT_EQ(destination, object);
+    EXPECT_GT(cached.hits(), 0);
+    EXPECT_EQ(cached.hits() + reader->requests, requests);
+
+    releasing.join();
+}
+
+}; // namespace runai::llm::streamer::impl
@@ -0,0 +1,44 @@
+#include "streamer/impl/cancellation/cancellation.h"
+
+#include "utils/logging/logging.h"
+
+namespace runai::llm::streamer::impl
+{
+
+void Cancellation::cancel()
+{
+    _stopped = true;
+
+    const auto guard = std::unique_lock<std::mutex>(_mutex);
+
+    LOG(DEBUG) << "Canceling " << _clients.size() << " object storage clients";
+
+    for (auto client : _clients)
+    {
+        client->cancel();
+    }
+}
+
+void Cancellation::reset()
+{
+    _stopped = false;
+}
+
+std::atomic<bool> & Cancellation::stopped()
+{
+    return _stopped;
+}
+
+void Cancellation::add(common::s3::S3ClientWrapper * client)
+{
+    const auto guard = std::unique_lock<std::mutex>(_mutex);
+    _clients.insert(client);
+}
+
+void Cancellation::remove(common::s3::S3ClientWrapper * client)
+{
+    const auto guard = std::unique_lock<std::mutex>(_mutex);
+    _clients.erase(client);
+}
+
+}; // namespace runai::llm::streamer::impl
@@ -0,0 +1,38 @@
+#pragma once
+
+#include <atomic>
+#include <mutex>
+#include <set>
+
+#include "common/s3_wrapper/s3_wrapper.h"
+
+namespace runai::llm::streamer::impl
+{
+
+// Cancellation of the running request
+//
+// Workers poll the stopped flag between reads of file system storage, and between submitting requests to object storage
+// Object storage clients are registered while they are in use, so that their pending requests can be canceled in the backend
+
+struct Cancellation
+{
+    Cancellation() = default;
+
+    // sets the stopped flag and cancels the pending requests of all the registered clients
+    void cancel();
+
+    // clears the stopped flag after the canceled request has drained
+    void reset();
+
+    std::atomic<bool> & stopped();
+
+    void add(common::s3::S3ClientWrapper * client);
+    void remove(common::s3::S3ClientWrapper * client);
+
+ private:
+    std::atomic<bool> _stopped = false;
+    std::mutex _mutex;
+    std::set<common::s3::S3ClientWrapper *> _clients;
+};
+
+}; // namespace runai::llm::streamer::impl
@@ -41,7 +41,23 @@ Config::Config(bool enforce_minimum /* = true */) :
            utils::getenv<unsigned long>("RUNAI_STREAMER_CONCURRENCY", 8UL),
            utils::getenv<size_t>("RUNAI_STREAMER_CHUNK_BYTESIZE", common::s3::S3ClientWrapper::default_chunk_bytesize),
            utils::getenv<size_t>("RUNAI_STREAMER_CHUNK_BYTESIZE", min_fs_block_bytesize), enforce_minimum)
-{}
+{
+    executor_threads = utils::getenv<unsigned long>("RUNAI_STREAMER_EXECUTOR_THREADS", 0UL);
+    s3_crt_multipart = utils::getenv<bool>("RUNAI_STREAMER_S3_CRT_MULTIPART", false);
+    mirrors = common::s3::Mirrors(utils::getenv<std::string>("RUNAI_STREAMER_S3_MIRRORS", ""));
+    cache_directory = utils::getenv<std::string>("RUNAI_STREAMER_CACHE_DIR", "");
+    cache_max_bytesize = utils::getenv<size_t>("RUNAI_STREAMER_CACHE_MAX_BYTESIZE", default_cache_max_bytesize);
+    snapshot_directory = utils::getenv<std::string>("RUNAI_STREAMER_SNAPSHOT_DIR", "");
+    snapshot_max_bytesize = utils::getenv<size_t>("RUNAI_STREAMER_SNAPSHOT_MAX_BYTESIZE", 0);
+    dedup = utils::getenv<bool>("RUNAI_STREAMER_NODE_DEDUP", false);
+    bandwidth_limit = utils::getenv<size_t>("RUNAI_STREAMER_NODE_BANDWIDTH_LIMIT", 0);
+    bandwidth_weight = utils::getenv<unsigned long>("RUNAI_STREAMER_NODE_BANDWIDTH_WEIGHT", 1UL);
+    ASSERT(bandwidth_weight) << "Bandwidth weight must be a positive number";
+    usage = utils::getenv<bool>("RUNAI_STREAMER_USAGE", false);
+    trace_path = utils::getenv<std::string>("RUNAI_STREAMER_TRACE", "");
+    autotune_profile = utils::getenv<std::string>("RUNAI_STREAMER_AUTOTUNE_PROFILE", "");
+    fs_strategy = utils::getenv<bool>("RUNAI_STREAMER_FS_STRATEGY", false);
+}
 
 unsigned Config::max_concurrency() const
 {
@@ -50,7 +66,23 @@ unsigned Config::max_concurrency() const
 
 std::ostream & operator<<(std::ostream & os, const Config & config)
 {
-    return os << "Streamer concurrency " << config.concurrency << " ; s3 concurrency " << config.s3_concurrency << " ; s3 block size " << config.s3_block_bytesize << " bytes; " << " ; file system block size " << config.fs_block_bytesize << " bytes; ";
+    return os << "Streamer concurrency " << config.concurrency
+              << " ; s3 concurrency " << config.s3_concurrency
+              << " ; s3 block size " << config.s3_block_bytesize << " bytes"
+              << " ; file system block size " << config.fs_block_bytesize << " bytes"
+              << " ; executor threads " << config.executor_threads
+              << " ; s3 crt multipart " << (config.s3_crt_multipart ? "enabled" : "disabled")
+              << " ; mirror sets " << config.mirrors.size()
+              << " ; cache directory " << (config.cache_directory.empty() ? "none" : config.cache_directory)
+              << " ; cache size " << config.cache_max_bytesize << " bytes"
+              << " ; snapshot directory " << (config.snapshot_directory.empty() ? "none" : config.snapshot_directory)
+              << " ; node deduplication " << (config.dedup ? "enabled" : "disabled")
+              << " ; node bandwidth limit " << config.bandwidth_limit << " bytes per second"
+              << " ; bandwidth weight " << config.bandwidth_weight
+              << " ; usage " << (config.usage ? "enabled" : "disabled")
+              << " ; trace " << (config.trace_path.empty() ? "none" : config.trace_path)
+              << " ; autotune profile " << (config.autotune_profile.empty() ? "none" : config.autotune_profile)
+              << " ; file system strategy " << (config.fs_strategy ? "enabled" : "disabled");
 }
 
 }; // namespace runai::llm::streamer::impl
@@ -2,6 +2,9 @@
 #pragma once
 
 #include <ostream>
+#include <string>
+
+#include "common/mirrors/mirrors.h"
 
 namespace runai::llm::streamer::impl
 {
@@ -9,11 +12,26 @@ namespace runai::llm::streamer::impl
 // Reading from file system path
 //     Concurrency :       number of readers - default 20
 //     fs_block_bytesize : number of bytes in a single os call to read from file - minimum and default is 2 MiB
+//     fs_strategy :       choose the concurrency, the block size and the way files are read by the type of their file system - default false
 
 // Reading from S3 path
 //     Concurrency :       number of asynchronous S3 clients - default 20
 //     s3_block_bytesize : number of bytes in a single request to the S3 client - minimum is 5 MiB and default is 8 MiB
+//     executor_threads :  number of threads driving the S3 clients by completion notifications - default 0, which dedicates a thread to each client
+//     s3_crt_multipart :  contiguous reads of a worker are merged into a single request, which the S3 CRT splits into parallel parts of s3_block_bytesize - default false
+//     mirrors :           sets of locations holding the same objects, which are read from all the locations of their set - default none
+//     cache_directory :   local directory caching the objects read, across processes and restarts - default none
+//     cache_max_bytesize: bytesize of the cached objects, above which the least recently used objects are evicted - default 100 GiB
+//     snapshot_directory :    memory file system directory holding a snapshot of the objects read, which survives process restarts - default none
+//     snapshot_max_bytesize : bytesize of the snapshot, above which the least recently used objects are evicted - default half of the file system
+//     dedup :             read every range once per node, sharing it with the other processes of the node through shared memory - default false
 
+// Reading from any path
+//     bandwidth_limit :   bytes per second read by all the processes of the node together - default unlimited
+//     bandwidth_weight :  share of this process in the node bandwidth limit, relative to the other processes reading at the same time - default 1
+//     usage :             record the usage of the worker threads in the metrics (CPU cycles, page faults, context switches and CPU times) - default false
+//     trace_path :        file to which the timeline of the streamer threads is written when a streamer ends - default none, and nothing is traced
+//     autotune_profile :  file of the host persisting the block size and concurrency tuned for every storage target, which enables autotuning - default none
 struct Config
 {
     Config(unsigned concurrency, unsigned s3_concurrency, size_t s3_block_bytesize, size_t fs_block_bytesize, bool enforce_minimum = true);
@@ -27,6 +45,22 @@ struct Config
     unsigned s3_concurrency;
     size_t s3_block_bytesize;
     size_t fs_block_bytesize;
+    unsigned executor_threads = 0;
+    bool s3_crt_multipart = false;
+    common::s3::Mirrors mirrors;
+    std::string cache_directory;
+    size_t cache_max_bytesize = default_cache_max_bytesize;
+    std::string snapshot_directory;
+    size_t snapshot_max_bytesize = 0;
+    bool dedup = false;
+    size_t bandwidth_limit = 0;
+    unsigned bandwidth_weight = 1;
+    bool usage = false;
+    std::string trace_path;
+    std::string autotune_profile;
+    bool fs_strategy = false;
+
+    static constexpr size_t default_cache_max_bytesize = 100UL * 1024 * 1024 * 1024;
 };
 
 std::ostream & operator<<(std::ostream &, const Config &);
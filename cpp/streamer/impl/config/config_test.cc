@@ -18,6 +18,141 @@ TEST(Creation, Default)
     EXPECT_EQ(config.s3_concurrency, 8UL);
     EXPECT_EQ(config.s3_block_bytesize, 8 * 1024 * 1024);
     EXPECT_EQ(config.fs_block_bytesize, 2 * 1024 * 1024);
+    EXPECT_EQ(config.executor_threads, 0UL);
+}
+
+TEST(Creation, Executor_Threads)
+{
+    const auto expected = utils::random::number<int>(0, 10);
+    utils::temp::Env size_("RUNAI_STREAMER_EXECUTOR_THREADS", expected);
+
+    Config config;
+    EXPECT_EQ(config.executor_threads, expected);
+}
+
+TEST(Creation, Mirrors)
+{
+    {
+        Config config;
+        EXPECT_EQ(config.mirrors.size(), 0);
+    }
+
+    utils::temp::Env mirrors_("RUNAI_STREAMER_S3_MIRRORS", "s3://a,s3://b@http://localhost:9000;s3://c,s3://d");
+    Config config;
+    EXPECT_EQ(config.mirrors.size(), 2);
+}
+
+TEST(Creation, Cache)
+{
+    {
+        Config config;
+        EXPECT_TRUE(config.cache_directory.empty());
+        EXPECT_EQ(config.cache_max_bytesize, Config::default_cache_max_bytesize);
+    }
+
+    const auto directory = utils::random::string();
+    const auto bytesize = utils::random::number<size_t>(1, 1000000);
+    utils::temp::Env directory_("RUNAI_STREAMER_CACHE_DIR", directory);
+    utils::temp::Env bytesize_("RUNAI_STREAMER_CACHE_MAX_BYTESIZE", bytesize);
+    Config config;
+    EXPECT_EQ(config.cache_directory, directory);
+    EXPECT_EQ(config.cache_max_bytesize, bytesize);
+}
+
+TEST(Creation, Snapshot)
+{
+    {
+        Config config;
+        EXPECT_TRUE(config.snapshot_directory.empty());
+        EXPECT_EQ(config.snapshot_max_bytesize, 0);
+    }
+
+    const auto directory = utils::random::string();
+    const auto bytesize = utils::random::number<size_t>(1, 1000000);
+    utils::temp::Env directory_("RUNAI_STREAMER_SNAPSHOT_DIR", directory);
+    utils::temp::Env bytesize_("RUNAI_STREAMER_SNAPSHOT_MAX_BYTESIZE", bytesize);
+    Config config;
+    EXPECT_EQ(config.snapshot_directory, directory);
+    EXPECT_EQ(config.snapshot_max_bytesize, bytesize);
+}
+
+TEST(Creation, Dedup)
+{
+    {
+        Config config;
+        EXPECT_FALSE(config.dedup);
+    }
+
+    utils::temp::Env dedup_("RUNAI_STREAMER_NODE_DEDUP", true);
+    Config config;
+    EXPECT_TRUE(config.dedup);
+}
+
+TEST(Creation, Bandwidth)
+{
+    {
+        Config config;
+        EXPECT_EQ(config.bandwidth_limit, 0);
+        EXPECT_EQ(config.bandwidth_weight, 1);
+    }
+
+    const auto limit = utils::random::number<size_t>(1, 1000000000);
+    const auto weight = utils::random::number<int>(1, 100);
+    utils::temp::Env limit_("RUNAI_STREAMER_NODE_BANDWIDTH_LIMIT", limit);
+    utils::temp::Env weight_("RUNAI_STREAMER_NODE_BANDWIDTH_WEIGHT", weight);
+    Config config;
+    EXPECT_EQ(config.bandwidth_limit, limit);
+    EXPECT_EQ(config.bandwidth_weight, weight);
+}
+
+TEST(Creation, Usage)
+{
+    {
+        Config config;
+        EXPECT_FALSE(config.usage);
+    }
+
+    utils::temp::Env usage_("RUNAI_STREAMER_USAGE", "1");
+    Config config;
+    EXPECT_TRUE(config.usage);
+}
+
+TEST(Creation, Trace)
+{
+    {
+        Config config;
+        EXPECT_TRUE(config.trace_path.empty());
+    }
+
+    const auto path = "/tmp/" + utils::random::string() + ".json";
+    utils::temp::Env trace_("RUNAI_STREAMER_TRACE", path);
+    Config config;
+    EXPECT_EQ(config.trace_path, path);
+}
+
+TEST(Creation, Autotune_Profile)
+{
+    {
+        Config config;
+        EXPECT_TRUE(config.autotune_profile.empty());
+    }
+
+    const auto path = "/tmp/" + utils::random::string();
+    utils::temp::Env autotune_("RUNAI_STREAMER_AUTOTUNE_PROFILE", path);
+    Config config;
+    EXPECT_EQ(config.autotune_profile, path);
+}
+
+TEST(Creation, Fs_Strategy)
+{
+    {
+        Config config;
+        EXPECT_FALSE(config.fs_strategy);
+    }
+
+    utils::temp::Env fs_strategy_("RUNAI_STREAMER_FS_STRATEGY", "1");
+    Config config;
+    EXPECT_TRUE(config.fs_strategy);
 }
 
 TEST(Creation, Concurrency)
@@ -0,0 +1,446 @@
+#include "streamer/impl/dedup/dedup.h"
+
+#include <dirent.h>
+#include <limits.h>
+#include <linux/futex.h>
+#include <sys/statvfs.h>
+#include <sys/syscall.h>
+#include <time.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cctype>
+#include <cstdio>
+#include <cstring>
+#include <new>
+#include <optional>
+#include <thread>
+#include <utility>
+
+#include "utils/hash/hash.h"
+#include "utils/logging/logging.h"
+
+namespace runai::llm::streamer::impl
+{
+
+struct Dedup::Segment::Header
+{
+    // futex word of the publishing state
+    std::atomic<uint32_t> state;
+    // set once the creator has initialized the header
+    std::atomic<uint32_t> magic;
+    // monotonic time the range was published, which is shared by the processes of the node
+    std::atomic<int64_t> published;
+    uint32_t key_bytesize;
+    uint64_t bytesize;
+};
+
+static_assert(std::atomic<uint32_t>::is_always_lock_free, "Futex words must be lock free");
+static_assert(std::atomic<int64_t>::is_always_lock_free, "Shared atomics must be lock free");
+
+namespace
+{
+
+constexpr uint32_t magic = 0x52414931;
+constexpr size_t alignment = 4096;
+constexpr auto poll_interval = std::chrono::milliseconds(1);
+constexpr char shared_memory_path[] = "/dev/shm";
+constexpr char prefix[] = "runai-streamer-";
+// the creator locks the first byte of the segment
+constexpr size_t owner_offset = 0;
+
+long futex(std::atomic<uint32_t> & word, int op, uint32_t value, const struct timespec * timeout)
+{
+    return ::syscall(SYS_futex, reinterpret_cast<uint32_t *>(&word), op, value, timeout, nullptr, 0);
+}
+
+bool low_shared_memory(size_t bytesize)
+{
+    struct statvfs st;
+    if (::statvfs(shared_memory_path, &st) != 0)
+    {
+        return false;
+    }
+
+    const size_t total = st.f_blocks * st.f_frsize;
+    const size_t available = st.f_bavail * st.f_frsize;
+    return available < bytesize || available - bytesize < total * Dedup::min_free_ratio;
+}
+
+int64_t now_ns()
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+// whether a file of the shared memory directory is named as a segment
+bool segment_name(const char * name)
+{
+    const size_t length = sizeof(prefix) - 1;
+    return std::strncmp(name, prefix, length) == 0 && std::strlen(name) == length + 16 && std::all_of(name + length, name + length + 16, [](char c) { return std::isxdigit(static_cast<unsigned char>(c)) != 0; });
+}
+
+} // namespace
+
+Dedup::Segment::Segment(utils::Shm && shm, bool linked) :
+    _shm(std::move(shm)),
+    _linked(linked)
+{}
+
+Dedup::Segment::~Segment()
+{
+    try
+    {
+        if (_linked)
+        {
+            // waiting processes must not wait for a range which is not going to be published
+            if (static_cast<State>(header().state.load()) == State::Fetching)
+            {
+                fail();
+            }
+            _shm.unlink();
+        }
+    }
+    catch (...)
+    {}
+}
+
+std::string Dedup::Segment::name(const std::string & key)
+{
+    char buffer[64];
+    std::snprintf(buffer, sizeof(buffer), "/runai-streamer-%016lx", static_cast<unsigned long>(utils::fnv1a(key)));
+    return buffer;
+}
+
+size_t Dedup::Segment::data_offset(const std::string & key)
+{
+    return (sizeof(Header) + key.size() + alignment - 1) / alignment * alignment;
+}
+
+Dedup::Segment::Header & Dedup::Segment::header() const
+{
+    return *reinterpret_cast<Header *>(_shm.data());
+}
+
+char * Dedup::Segment::data() const
+{
+    return _shm.data() + _shm.size() - bytesize();
+}
+
+size_t Dedup::Segment::bytesize() const
+{
+    return header().bytesize;
+}
+
+const std::string & Dedup::Segment::name() const
+{
+    return _shm.name();
+}
+
+void Dedup::Segment::set(State state)
+{
+    header().state.store(static_cast<uint32_t>(state), std::memory_order_release);
+    futex(header().state, FUTEX_WAKE, INT_MAX, nullptr);
+}
+
+void Dedup::Segment::publish(const char * data)
+{
+    std::memcpy(this->data(), data, bytesize());
+    header().published = now_ns();
+    set(State::Ready);
+}
+
+void Dedup::Segment::fail()
+{
+    set(State::Failed);
+
+    // another process may read and publish the range
+    if (_linked)
+    {
+        _shm.unlink();
+        _linked = false;
+    }
+}
+
+bool Dedup::Segment::owned(const utils::Shm & shm)
+{
+    return shm.locked(owner_offset);
+}
+
+void Dedup::Segment::abandon(const utils::Shm & shm)
+{
+    auto & header = *reinterpret_cast<Header *>(shm.data());
+
+    // only the process which marks the segment as failed removes its name
+    auto state = static_cast<uint32_t>(State::Fetching);
+    if (header.state.compare_exchange_strong(state, static_cast<uint32_t>(State::Failed), std::memory_order_acq_rel))
+    {
+        LOG(DEBUG) << "Publishing process of segment " << shm.name() << " exited without publishing it; removing it";
+        shm.unlink();
+        futex(header.state, FUTEX_WAKE, INT_MAX, nullptr);
+    }
+}
+
+Dedup::Segment::State Dedup::Segment::state() const
+{
+    const auto state = static_cast<State>(header().state.load(std::memory_order_acquire));
+    if (state == State::Fetching && !_linked && !owned(_shm))
+    {
+        abandon(_shm);
+        return State::Failed;
+    }
+    return state;
+}
+
+void Dedup::Segment::wait(std::chrono::milliseconds timeout) const
+{
+    const auto seconds = std::chrono::duration_cast<std::chrono::seconds>(timeout);
+    const struct timespec ts = { seconds.count(), std::chrono::duration_cast<std::chrono::nanoseconds>(timeout - seconds).count() };
+    futex(header().state, FUTEX_WAIT, static_cast<uint32_t>(State::Fetching), &ts);
+}
+
+void Dedup::Segment::copy(char * buffer) const
+{
+    std::memcpy(buffer, data(), bytesize());
+}
+
+Dedup::Dedup(std::chrono::milliseconds retention) :
+    _retention(retention),
+    _thread([this]() { run(); })
+{}
+
+Dedup::~Dedup()
+{
+    {
+        const auto guard = std::unique_lock<std::mutex>(_mutex);
+        _stopped = true;
+    }
+    _cv.notify_all();
+    _thread.join();
+}
+
+void Dedup::run()
+{
+    auto guard = std::unique_lock<std::mutex>(_mutex);
+    auto swept = std::chrono::steady_clock::now();
+    while (!_stopped)
+    {
+        const auto now = std::chrono::steady_clock::now();
+        if (now >= swept + _retention)
+        {
+            guard.unlock();
+            sweep();
+            guard.lock();
+            swept = now;
+            continue;
+        }
+
+        if (!_published.empty() && _published.front().expiration <= now)
+        {
+            // the segment is removed once its publishing is done
+            LOG(SPAM) << "Retention of segment " << _published.front().segment->name() << " ended";
+            _published.pop_front();
+            continue;
+        }
+
+        auto until = swept + _retention;
+        if (!_published.empty())
+        {
+            until = std::min(until, _published.front().expiration);
+        }
+        _cv.wait_until(guard, until);
+    }
+}
+
+void Dedup::sweep() const
+{
+    DIR * dir = ::opendir(shared_memory_path);
+    if (dir == nullptr)
+    {
+        return;
+    }
+
+    while (const struct dirent * entry = ::readdir(dir))
+    {
+        if (!segment_name(entry->d_name))
+        {
+            continue;
+        }
+
+        try
+        {
+            const auto shm = utils::Shm::open(std::string("/") + entry->d_name);
+            if (shm.has_value())
+            {
+                collect(shm.value());
+            }
+        }
+        catch (const std::exception & e)
+        {
+            LOG(DEBUG) << "Failed sweeping segment " << entry->d_name << ": " << e.what();
+        }
+    }
+
+    ::closedir(dir);
+}
+
+bool Dedup::collect(const utils::Shm & shm) const
+{
+    // the creator sizes the segment before initializing its header
+    const auto & header = *reinterpret_cast<const Segment::Header *>(shm.data());
+    if (shm.size() < sizeof(Segment::Header) || header.magic.load(std::memory_order_acquire) != magic)
+    {
+        if (std::chrono::system_clock::now() - shm.modified() < initialization_timeout)
+        {
+            return false;
+        }
+
+        LOG(DEBUG) << "Removing segment " << shm.name() << " which was not initialized by its creator";
+        shm.unlink();
+        return true;
+    }
+
+    if (Segment::owned(shm))
+    {
+        return false;
+    }
+
+    switch (static_cast<Segment::State>(header.state.load(std::memory_order_acquire)))
+    {
+        case Segment::State::Fetching:
+            Segment::abandon(shm);
+            return true;
+        case Segment::State::Ready:
+            if (std::chrono::nanoseconds(now_ns() - header.published.load()) < _retention)
+            {
+                return false;
+            }
+            break;
+        case Segment::State::Failed:
+            break;
+    }
+
+    LOG(DEBUG) << "Removing segment " << shm.name() << " of a process which exited";
+    shm.unlink();
+    return true;
+}
+
+std::shared_ptr<Dedup::Segment> Dedup::publish(const std::string & key, size_t bytesize)
+{
+    const auto name = Segment::name(key);
+    const auto total = Segment::data_offset(key) + bytesize;
+
+    if (low_shared_memory(total))
+    {
+        LOG(DEBUG) << "Not sharing " << bytesize << " bytes since shared memory is low";
+        return nullptr;
+    }
+
+    std::optional<utils::Shm> shm;
+    try
+    {
+        shm = utils::Shm::create(name, total);
+    }
+    catch (const std::exception & e)
+    {
+        LOG(WARNING) << "Not sharing " << bytesize << " bytes: " << e.what();
+        return nullptr;
+    }
+
+    if (!shm.has_value())
+    {
+        return nullptr;
+    }
+
+    // the lock is held until the segment is removed, or until this process exits
+    ASSERT(shm->lock(owner_offset)) << "Segment " << name << " is locked by another process";
+
+    auto header = new (shm->data()) Segment::Header{};
+    header->key_bytesize = key.size();
+    header->bytesize = bytesize;
+    std::memcpy(shm->data() + sizeof(Segment::Header), key.data(), key.size());
+    header->magic.store(magic, std::memory_order_release);
+
+    auto segment = std::shared_ptr<Segment>(new Segment(std::move(shm.value()), true));
+    LOG(SPAM) << "Publishing " << bytesize << " bytes in segment " << name;
+
+    {
+        const auto guard = std::unique_lock<std::mutex>(_mutex);
+        // failed segments are not published anymore
+        _published.erase(std::remove_if(_published.begin(), _published.end(), [](const Published & published) { return !published.segment->_linked; }), _published.end());
+        _published.push_back(Published{segment, std::chrono::steady_clock::now() + _retention});
+    }
+    _cv.notify_all();
+    return segment;
+}
+
+std::shared_ptr<Dedup::Segment> Dedup::wait(const std::string & key, size_t bytesize)
+{
+    const auto name = Segment::name(key);
+    const auto total = Segment::data_offset(key) + bytesize;
+    const auto deadline = std::chrono::steady_clock::now() + initialization_timeout;
+
+    while (true)
+    {
+        std::optional<utils::Shm> shm;
+        try
+        {
+            shm = utils::Shm::open(name);
+        }
+        catch (const std::exception & e)
+        {
+            LOG(WARNING) << "Failed opening segment " << name << ": " << e.what();
+            return nullptr;
+        }
+
+        if (!shm.has_value())
+        {
+            return nullptr;
+        }
+
+        // the creator sizes the segment before initializing its header
+        if (shm->size() >= sizeof(Segment::Header))
+        {
+            const auto & header = *reinterpret_cast<const Segment::Header *>(shm->data());
+            if (header.magic.load(std::memory_order_acquire) == magic)
+            {
+                if (shm->size() != total || header.key_bytesize != key.size() || header.bytesize != bytesize || std::memcmp(shm->data() + sizeof(Segment::Header), key.data(), key.size()) != 0)
+                {
+                    LOG(DEBUG) << "Segment " << name << " belongs to another range";
+                    return nullptr;
+                }
+
+                // a range published by a process which exited is still copied, after its segment is removed
+                if (collect(shm.value()) && static_cast<Segment::State>(header.state.load(std::memory_order_acquire)) != Segment::State::Ready)
+                {
+                    return nullptr;
+                }
+
+                LOG(SPAM) << "Waiting for " << bytesize << " bytes of segment " << name;
+                return std::shared_ptr<Segment>(new Segment(std::move(shm.value()), false));
+            }
+        }
+
+        // a segment whose creator exited before initializing it is removed, so that the range may be published again
+        if (collect(shm.value()))
+        {
+            return nullptr;
+        }
+
+        if (std::chrono::steady_clock::now() > deadline)
+        {
+            LOG(WARNING) << "Segment " << name << " was not initialized by its creator; removing it";
+            shm->unlink();
+            return nullptr;
+        }
+
+        std::this_thread::sleep_for(poll_interval);
+    }
+}
+
+size_t Dedup::size() const
+{
+    const auto guard = std::unique_lock<std::mutex>(_mutex);
+    return _published.size();
+}
+
+}; // namespace runai::llm::streamer::impl
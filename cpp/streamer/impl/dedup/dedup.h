@@ -0,0 +1,141 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+
+#include "utils/shm/shm.h"
+#include "utils/thread/thread.h"
+
+namespace runai::llm::streamer::impl
+{
+
+// Deduplication of object storage reads between the processes of a node
+//
+// The first process to request a range creates a shared memory segment for it, reads the range from the object storage and publishes it in the segment
+// Processes which request the same range wait for the segment to be published and copy the range from it, instead of reading it from the object storage
+// Segments are named by a hash of their key, which identifies the object version and the range, and hold the full key so that collisions are detected
+// A waiting process reads the range by itself if the publishing process fails or exits before publishing, and the first waiting process to find the publishing process exited removes the segment
+// The publishing process holds a lock of its segment, which the kernel releases when it exits, so it is found exited also from another pid namespace
+//
+// Published segments are kept for a retention period, so that processes which request the range a bit later also copy it, and are then removed
+// Segments of processes which exited are removed by any other process, once their retention ended or if their creator exited before initializing them
+// Segments are not created when shared memory is low, since other users of shared memory (e.g. NCCL) must not run out of it
+
+struct Dedup
+{
+    struct Segment
+    {
+        enum class State : uint32_t
+        {
+            Fetching = 0,
+            Ready    = 1,
+            Failed   = 2,
+        };
+
+        ~Segment();
+
+        // publishing
+
+        // copies the range into the segment and wakes the waiting processes
+        void publish(const char * data);
+
+        // wakes the waiting processes, which read the range by themselves
+        void fail();
+
+        // waiting
+
+        // returns Failed if the publishing process exited without publishing, in which case the segment is removed so that another process may publish the range
+        State state() const;
+
+        // waits for the range to be published, up to the timeout
+        void wait(std::chrono::milliseconds timeout) const;
+
+        // copies the published range
+        void copy(char * buffer) const;
+
+        size_t bytesize() const;
+        const std::string & name() const;
+
+     private:
+        friend struct Dedup;
+
+        struct Header;
+
+        Segment(utils::Shm && shm, bool linked);
+
+        Header & header() const;
+        char * data() const;
+        void set(State state);
+
+        static std::string name(const std::string & key);
+        static size_t data_offset(const std::string & key);
+
+        // whether the process which created the segment still holds it
+        static bool owned(const utils::Shm & shm);
+
+        // marks the segment of a process which exited without publishing as failed, and removes it
+        static void abandon(const utils::Shm & shm);
+
+        utils::Shm _shm;
+        // whether the name of the segment was created by this process, which removes it
+        bool _linked;
+    };
+
+    Dedup(std::chrono::milliseconds retention = default_retention);
+    ~Dedup();
+
+    // creates the segment of a range which this process reads and publishes
+    // returns null if another process already created it, or if the range cannot be shared
+    std::shared_ptr<Segment> publish(const std::string & key, size_t bytesize);
+
+    // opens the segment of a range which another process publishes
+    // returns null if there is no such segment
+    std::shared_ptr<Segment> wait(const std::string & key, size_t bytesize);
+
+    // number of segments published by this process which were not removed yet
+    size_t size() const;
+
+    // segments are removed after this time, by the process which published them or by another process if it exited
+    static constexpr std::chrono::milliseconds default_retention = std::chrono::minutes(1);
+
+    // segments are created only while this fraction of the shared memory remains free
+    static constexpr double min_free_ratio = 0.2;
+
+    // segments which are not initialized by their creator within this time are abandoned
+    static constexpr std::chrono::seconds initialization_timeout = std::chrono::seconds(10);
+
+ private:
+    struct Published
+    {
+        std::shared_ptr<Segment> segment;
+        std::chrono::steady_clock::time_point expiration;
+    };
+
+    // removes the segments whose retention period ended, and periodically sweeps the segments of processes which exited
+    void run();
+
+    // removes all the segments of processes which exited
+    void sweep() const;
+
+    // removes the segment if its creator exited and it is not used anymore
+    // returns whether it was removed
+    bool collect(const utils::Shm & shm) const;
+
+    const std::chrono::milliseconds _retention;
+    mutable std::mutex _mutex;
+    std::condition_variable _cv;
+    bool _stopped = false;
+    // ordered by expiration
+    std::deque<Published> _published;
+    utils::Thread _thread;
+};
+
+}; // namespace runai::llm::streamer::impl
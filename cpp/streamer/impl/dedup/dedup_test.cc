@@ -0,0 +1,309 @@
+#include "streamer/impl/dedup/dedup.h"
+
+#include <gtest/gtest.h>
+
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <sys/wait.h>
+#include <time.h>
+#include <unistd.h>
+
+#include <cstdio>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "utils/hash/hash.h"
+#include "utils/random/random.h"
+
+namespace runai::llm::streamer::impl
+{
+
+namespace
+{
+
+std::string name(const std::string & key)
+{
+    char buffer[64];
+    std::snprintf(buffer, sizeof(buffer), "/runai-streamer-%016lx", static_cast<unsigned long>(utils::fnv1a(key)));
+    return buffer;
+}
+
+// publishes a range from a child process, which exits without removing its segment
+// publishes no data if null, in which case the range is left fetching
+int publish_and_exit(const std::string & key, size_t bytesize, const char * data)
+{
+    const auto pid = ::fork();
+    if (pid == 0)
+    {
+        auto dedup = new Dedup();
+        const auto segment = dedup->publish(key, bytesize);
+        if (segment != nullptr && data != nullptr)
+        {
+            segment->publish(data);
+        }
+        ::_exit(segment == nullptr ? 1 : 0);
+    }
+
+    int status = 0;
+    if (pid == -1 || ::waitpid(pid, &status, 0) != pid || !WIFEXITED(status))
+    {
+        return -1;
+    }
+    return WEXITSTATUS(status);
+}
+
+} // namespace
+
+TEST(Publish, Sanity)
+{
+    Dedup dedup;
+    const auto key = utils::random::string();
+    const auto data = utils::random::buffer();
+
+    auto publisher = dedup.publish(key, data.size());
+    ASSERT_NE(publisher, nullptr);
+    EXPECT_EQ(dedup.size(), 1);
+    EXPECT_EQ(publisher->state(), Dedup::Segment::State::Fetching);
+
+    // the range is published once
+    EXPECT_EQ(dedup.publish(key, data.size()), nullptr);
+
+    auto waiter = dedup.wait(key, data.size());
+    ASSERT_NE(waiter, nullptr);
+    EXPECT_EQ(waiter->bytesize(), data.size());
+    EXPECT_EQ(waiter->state(), Dedup::Segment::State::Fetching);
+
+    publisher->publish(reinterpret_cast<const char *>(data.data()));
+    EXPECT_EQ(waiter->state(), Dedup::Segment::State::Ready);
+
+    std::vector<uint8_t> buffer(data.size());
+    waiter->copy(reinterpret_cast<char *>(buffer.data()));
+    EXPECT_EQ(buffer, data);
+}
+
+TEST(Wait, Not_Published)
+{
+    Dedup dedup;
+    EXPECT_EQ(dedup.wait(utils::random::string(), utils::random::number(1, 1000)), nullptr);
+}
+
+TEST(Wait, Other_Range)
+{
+    Dedup dedup;
+    const auto key = utils::random::string();
+    const auto bytesize = utils::random::number(1, 1000);
+
+    auto publisher = dedup.publish(key, bytesize);
+    ASSERT_NE(publisher, nullptr);
+
+    EXPECT_EQ(dedup.wait(key, bytesize + 1), nullptr);
+}
+
+TEST(Wait, Wake_Up)
+{
+    Dedup dedup;
+    const auto key = utils::random::string();
+    const auto data = utils::random::buffer();
+
+    auto publisher = dedup.publish(key, data.size());
+    ASSERT_NE(publisher, nullptr);
+    auto waiter = dedup.wait(key, data.size());
+    ASSERT_NE(waiter, nullptr);
+
+    std::thread thread([&]()
+    {
+        std::this_thread::sleep_for(std::chrono::milliseconds(utils::random::number(10, 100)));
+        publisher->publish(reinterpret_cast<const char *>(data.data()));
+    });
+
+    const auto start = std::chrono::steady_clock::now();
+    while (waiter->state() == Dedup::Segment::State::Fetching)
+    {
+        waiter->wait(std::chrono::seconds(10));
+    }
+    EXPECT_LT(std::chrono::steady_clock::now() - start, std::chrono::seconds(5));
+    EXPECT_EQ(waiter->state(), Dedup::Segment::State::Ready);
+
+    thread.join();
+}
+
+TEST(Wait, Publisher_Exited)
+{
+    const auto key = utils::random::string();
+    const auto bytesize = utils::random::number(1, 1000);
+
+    ASSERT_EQ(publish_and_exit(key, bytesize, nullptr), 0);
+
+    // the segment is removed by the first process to find it, which may read and publish the range
+    Dedup dedup;
+    EXPECT_EQ(dedup.wait(key, bytesize), nullptr);
+    EXPECT_FALSE(utils::Shm::open(name(key)).has_value());
+    EXPECT_NE(dedup.publish(key, bytesize), nullptr);
+}
+
+TEST(Wait, Not_Initialized)
+{
+    const auto key = utils::random::string();
+    const auto bytesize = utils::random::number(1, 1000);
+
+    // a segment whose creator exited before initializing it
+    auto shm = utils::Shm::create(name(key), utils::random::number(1, 1000));
+    ASSERT_TRUE(shm.has_value());
+    const auto path = std::string("/dev/shm") + name(key);
+    const struct timespec times[2] = { { 0, UTIME_OMIT }, { ::time(nullptr) - Dedup::initialization_timeout.count() - 1, 0 } };
+    ASSERT_EQ(::utimensat(AT_FDCWD, path.c_str(), times, 0), 0);
+
+    // the segment is removed without waiting for its initialization
+    Dedup dedup;
+    const auto start = std::chrono::steady_clock::now();
+    EXPECT_EQ(dedup.wait(key, bytesize), nullptr);
+    EXPECT_LT(std::chrono::steady_clock::now() - start, std::chrono::seconds(1));
+    EXPECT_FALSE(utils::Shm::open(name(key)).has_value());
+    EXPECT_NE(dedup.publish(key, bytesize), nullptr);
+}
+
+TEST(Fail, Sanity)
+{
+    Dedup dedup;
+    const auto key = utils::random::string();
+    const auto bytesize = utils::random::number(1, 1000);
+
+    auto publisher = dedup.publish(key, bytesize);
+    ASSERT_NE(publisher, nullptr);
+    auto waiter = dedup.wait(key, bytesize);
+    ASSERT_NE(waiter, nullptr);
+
+    publisher->fail();
+    EXPECT_EQ(waiter->state(), Dedup::Segment::State::Failed);
+
+    // the range can be published again
+    EXPECT_EQ(dedup.wait(key, bytesize), nullptr);
+    auto other = dedup.publish(key, bytesize);
+    ASSERT_NE(other, nullptr);
+    EXPECT_EQ(dedup.size(), 1);
+}
+
+TEST(Fail, Not_Published)
+{
+    const auto key = utils::random::string();
+    const auto bytesize = utils::random::number(1, 1000);
+
+    Dedup dedup;
+    std::shared_ptr<Dedup::Segment> waiter;
+    {
+        Dedup other;
+        auto publisher = other.publish(key, bytesize);
+        ASSERT_NE(publisher, nullptr);
+        waiter = dedup.wait(key, bytesize);
+        ASSERT_NE(waiter, nullptr);
+    }
+
+    // the segment is removed without being published
+    EXPECT_EQ(waiter->state(), Dedup::Segment::State::Failed);
+    EXPECT_EQ(dedup.wait(key, bytesize), nullptr);
+}
+
+TEST(Fail, Publisher_Exited)
+{
+    const auto key = utils::random::string();
+    const auto bytesize = utils::random::number(1, 1000);
+
+    int published[2];
+    int exit[2];
+    ASSERT_EQ(::pipe(published), 0);
+    ASSERT_EQ(::pipe(exit), 0);
+
+    const auto pid = ::fork();
+    ASSERT_NE(pid, -1);
+    if (pid == 0)
+    {
+        auto dedup = new Dedup();
+        const auto segment = dedup->publish(key, bytesize);
+        const char result = segment == nullptr ? 1 : 0;
+        char c;
+        const bool ok = ::write(published[1], &result, 1) == 1 && ::read(exit[0], &c, 1) == 1;
+        ::_exit(ok ? 0 : 1);
+    }
+
+    char result = 1;
+    ASSERT_EQ(::read(published[0], &result, 1), 1);
+    ASSERT_EQ(result, 0);
+
+    Dedup dedup;
+    auto waiter = dedup.wait(key, bytesize);
+    ASSERT_NE(waiter, nullptr);
+    EXPECT_EQ(waiter->state(), Dedup::Segment::State::Fetching);
+
+    // the publishing process exits without publishing
+    const char c = 0;
+    ASSERT_EQ(::write(exit[1], &c, 1), 1);
+    int status = 0;
+    ASSERT_EQ(::waitpid(pid, &status, 0), pid);
+    ASSERT_TRUE(WIFEXITED(status));
+    ASSERT_EQ(WEXITSTATUS(status), 0);
+
+    EXPECT_EQ(waiter->state(), Dedup::Segment::State::Failed);
+
+    // the segment is removed, and this process may read and publish the range
+    EXPECT_EQ(dedup.wait(key, bytesize), nullptr);
+    EXPECT_NE(dedup.publish(key, bytesize), nullptr);
+
+    for (int fd : {published[0], published[1], exit[0], exit[1]})
+    {
+        ::close(fd);
+    }
+}
+
+TEST(Retention, Sanity)
+{
+    const auto retention = std::chrono::milliseconds(utils::random::number(10, 100));
+    Dedup dedup(retention);
+    const auto key = utils::random::string();
+    const auto data = utils::random::buffer();
+    const auto start = std::chrono::steady_clock::now();
+
+    auto publisher = dedup.publish(key, data.size());
+    ASSERT_NE(publisher, nullptr);
+    publisher->publish(reinterpret_cast<const char *>(data.data()));
+    publisher.reset();
+
+    EXPECT_NE(dedup.wait(key, data.size()), nullptr);
+
+    while (dedup.size() != 0)
+    {
+        ASSERT_LT(std::chrono::steady_clock::now() - start, retention + std::chrono::seconds(5));
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+
+    EXPECT_GE(std::chrono::steady_clock::now() - start, retention);
+    EXPECT_EQ(dedup.wait(key, data.size()), nullptr);
+}
+
+TEST(Retention, Publisher_Exited)
+{
+    const auto retention = std::chrono::milliseconds(utils::random::number(10, 100));
+    const auto key = utils::random::string();
+    const auto data = utils::random::buffer();
+
+    ASSERT_EQ(publish_and_exit(key, data.size(), reinterpret_cast<const char *>(data.data())), 0);
+
+    // the published range is copied while its retention lasts
+    Dedup dedup(retention);
+    auto waiter = dedup.wait(key, data.size());
+    ASSERT_NE(waiter, nullptr);
+    ASSERT_EQ(waiter->state(), Dedup::Segment::State::Ready);
+    std::vector<uint8_t> buffer(data.size());
+    waiter->copy(reinterpret_cast<char *>(buffer.data()));
+    EXPECT_EQ(buffer, data);
+
+    // and is then removed by another process
+    const auto start = std::chrono::steady_clock::now();
+    while (utils::Shm::open(name(key)).has_value())
+    {
+        ASSERT_LT(std::chrono::steady_clock::now() - start, retention * 2 + std::chrono::seconds(5));
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+}
+
+}; // namespace runai::llm::streamer::impl
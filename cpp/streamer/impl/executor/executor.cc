@@ -0,0 +1,255 @@
+#include "streamer/impl/executor/executor.h"
+
+#include <memory>
+#include <utility>
+
+#include "utils/logging/logging.h"
+
+namespace runai::llm::streamer::impl
+{
+
+Executor::Executor(unsigned size, std::atomic<bool> & stopped, Scheduler::Queue * queue, size_t slice_bytesize) :
+    _stopped(stopped),
+    _queue(queue),
+    _slice_bytesize(slice_bytesize),
+    _pool(std::make_unique<utils::ThreadPool<std::shared_ptr<Job>>>([&](std::shared_ptr<Job> && job, std::atomic<bool> &)
+        {
+            if (job->run(_stopped))
+            {
+                erase(job);
+            }
+        }, size))
+{
+    ASSERT(size) << "Executor size must be a positive number";
+    LOG(DEBUG) << "Created executor of " << size << " threads";
+}
+
+Executor::~Executor()
+{
+    try
+    {
+        std::set<std::shared_ptr<Job>> jobs;
+        {
+            const auto guard = std::unique_lock<std::mutex>(_mutex);
+            _closed = true;
+        }
+
+        // stop the threads, and handle the remaining workloads synchronously
+        _pool.reset();
+
+        {
+            const auto guard = std::unique_lock<std::mutex>(_mutex);
+            jobs.swap(_jobs);
+        }
+
+        if (jobs.size())
+        {
+            LOG(DEBUG) << "Draining " << jobs.size() << " workloads";
+        }
+
+        for (auto & job : jobs)
+        {
+            job->drain(_stopped);
+        }
+    }
+    catch(...)
+    {
+    }
+}
+
+void Executor::push(Workload && workload)
+{
+    auto job = std::make_shared<Job>(*this, std::move(workload));
+    {
+        const auto guard = std::unique_lock<std::mutex>(_mutex);
+        _jobs.insert(job);
+    }
+
+    admit(job);
+}
+
+void Executor::admit(std::shared_ptr<Job> job)
+{
+    if (_queue == nullptr)
+    {
+        job->admit(nullptr);
+        return;
+    }
+
+    // the executor drains its jobs before it is destroyed, and finished jobs no longer use it
+    _queue->push_async([job](Scheduler::Done && done)
+        {
+            job->admit(std::move(done));
+        }, _slice_bytesize,
+        [job]()
+        {
+            job->cancel();
+        });
+}
+
+void Executor::erase(std::shared_ptr<Job> job)
+{
+    const auto guard = std::unique_lock<std::mutex>(_mutex);
+    _jobs.erase(job);
+}
+
+size_t Executor::size() const
+{
+    const auto guard = std::unique_lock<std::mutex>(_mutex);
+    return _jobs.size();
+}
+
+void Executor::schedule(std::shared_ptr<Job> job)
+{
+    const auto guard = std::unique_lock<std::mutex>(_mutex);
+    if (_closed)
+    {
+        return;
+    }
+
+    _pool->push(std::move(job));
+}
+
+Executor::Job::Job(Executor & executor, Workload && workload) :
+    _executor(executor),
+    _workload(std::move(workload))
+{}
+
+void Executor::Job::notify(void * context)
+{
+    // the workload unregisters the notification before it finishes, and the job outlives its workload
+    auto job = static_cast<Job *>(context);
+    if (!job->scheduled.exchange(true))
+    {
+        job->_executor.schedule(job->shared_from_this());
+    }
+}
+
+bool Executor::Job::run(std::atomic<bool> & stopped)
+{
+    // notifications from now on schedule the job again
+    scheduled = false;
+
+    {
+        const auto guard = std::unique_lock<std::mutex>(_mutex);
+        if (_finished)
+        {
+            return false;
+        }
+
+        if (_admitted)
+        {
+            _admitted = false;
+            _started = true;
+            _slicing = _workload.start(stopped, &Job::notify, this, _executor._slice_bytesize);
+        }
+        else if (_slicing)
+        {
+            _slicing = _workload.poll(stopped);
+        }
+        else
+        {
+            // a notification of a slice which already ended
+            return false;
+        }
+
+        if (_slicing)
+        {
+            return false;
+        }
+
+        _finished = _workload.finished();
+    }
+
+    end_slice();
+    return _finished;
+}
+
+void Executor::Job::end_slice()
+{
+    Scheduler::Done done;
+    bool finished;
+    {
+        const auto guard = std::unique_lock<std::mutex>(_mutex);
+        done = std::exchange(_done, nullptr);
+        finished = _finished;
+    }
+
+    if (done)
+    {
+        done();
+    }
+
+    if (!finished)
+    {
+        _executor.admit(shared_from_this());
+    }
+}
+
+void Executor::Job::admit(Scheduler::Done && done)
+{
+    bool admitted = false;
+    {
+        const auto guard = std::unique_lock<std::mutex>(_mutex);
+        if (!_finished)
+        {
+            _done = std::move(done);
+            _admitted = true;
+            admitted = true;
+        }
+    }
+
+    // a job which finished in the meantime releases the worker at once
+    if (!admitted)
+    {
+        if (done)
+        {
+            done();
+        }
+        return;
+    }
+
+    if (!scheduled.exchange(true))
+    {
+        _executor.schedule(shared_from_this());
+    }
+}
+
+void Executor::Job::drain(std::atomic<bool> & stopped)
+{
+    {
+        const auto guard = std::unique_lock<std::mutex>(_mutex);
+        if (!_finished)
+        {
+            if (_started)
+            {
+                _workload.drain(stopped);
+            }
+            else
+            {
+                _workload.execute(stopped);
+            }
+            _finished = true;
+        }
+    }
+
+    end_slice();
+}
+
+void Executor::Job::cancel()
+{
+    {
+        const auto guard = std::unique_lock<std::mutex>(_mutex);
+        if (_finished)
+        {
+            return;
+        }
+
+        _workload.cancel();
+        _finished = true;
+    }
+
+    _executor.erase(shared_from_this());
+}
+
+}; // namespace runai::llm::streamer::impl
@@ -0,0 +1,93 @@
+#pragma once
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <set>
+
+#include "streamer/impl/scheduler/scheduler.h"
+#include "streamer/impl/workload/workload.h"
+
+#include "utils/threadpool/threadpool.h"
+
+namespace runai::llm::streamer::impl
+{
+
+// Event driven executor of object storage workloads
+//
+// A workload submits its requests and returns, instead of occupying a thread while waiting for responses
+// The storage backend notifies the workload whenever responses are ready, and the workload is then scheduled to handle them
+// The number of threads is therefore independent of the number of workloads and of the concurrency of the storage backend
+//
+// Workloads are read in slices, each of which holds a worker of the scheduler queue of the streamer until its responses arrive,
+// so that the weights of the streamers apply to event driven workloads as well - without a queue, the slices are started at once
+
+struct Executor
+{
+    Executor(unsigned size, std::atomic<bool> & stopped, Scheduler::Queue * queue = nullptr, size_t slice_bytesize = Workload::slice_bytesize);
+
+    // workloads which have not finished are drained on destruction
+    ~Executor();
+
+    void push(Workload && workload);
+
+    // number of workloads which have not finished
+    size_t size() const;
+
+ private:
+    struct Job : std::enable_shared_from_this<Job>
+    {
+        Job(Executor & executor, Workload && workload);
+
+        // called by the storage backend whenever responses are ready
+        static void notify(void * context);
+
+        // returns true if the workload has finished
+        bool run(std::atomic<bool> & stopped);
+
+        // starts the next slice, which holds the worker of the scheduler until it ends
+        void admit(Scheduler::Done && done);
+
+        void drain(std::atomic<bool> & stopped);
+
+        // responds to the tasks of a workload whose next slice was dropped from the scheduler, without reading
+        void cancel();
+
+        std::atomic<bool> scheduled = false;
+
+     private:
+        // releases the worker of the slice, and admits the next slice if the workload has not finished
+        void end_slice();
+
+        Executor & _executor;
+        std::mutex _mutex;
+        bool _started = false;
+        // whether the next slice was admitted and was not submitted yet
+        bool _admitted = false;
+        // whether responses of the submitted slice are pending
+        bool _slicing = false;
+        bool _finished = false;
+        // releases the worker of the scheduler which the slice holds
+        Scheduler::Done _done;
+        Workload _workload;
+    };
+
+    void schedule(std::shared_ptr<Job> job);
+
+    // pushes the next slice of the workload to the scheduler queue
+    void admit(std::shared_ptr<Job> job);
+
+    // removes a finished job
+    void erase(std::shared_ptr<Job> job);
+
+ private:
+    std::atomic<bool> & _stopped;
+    Scheduler::Queue * _queue;
+    const size_t _slice_bytesize;
+    mutable std::mutex _mutex;
+    bool _closed = false;
+    std::set<std::shared_ptr<Job>> _jobs;
+    std::unique_ptr<utils::ThreadPool<std::shared_ptr<Job>>> _pool;
+};
+
+}; // namespace runai::llm::streamer::impl
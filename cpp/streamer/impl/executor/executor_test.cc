@@ -0,0 +1,216 @@
+#include "streamer/impl/executor/executor.h"
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <memory>
+#include <set>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "streamer/impl/assigner/assigner.h"
+#include "streamer/impl/batches/batches.h"
+
+#include "common/responder/responder.h"
+#include "utils/dylib/dylib.h"
+#include "utils/random/random.h"
+#include "utils/scope_guard/scope_guard.h"
+
+namespace runai::llm::streamer::impl
+{
+
+namespace
+{
+
+struct Helper
+{
+    Helper(unsigned num_files, std::shared_ptr<common::Responder> responder)
+    {
+        config = std::make_shared<Config>(1, utils::random::number(1, 20), utils::random::number<size_t>(1, 1024), utils::random::number<size_t>(1, 1024), false /* do not force minimum chunk size */);
+
+        std::vector<std::string> paths;
+        std::vector<size_t> file_offsets;
+        std::vector<size_t> bytesizes;
+        std::vector<unsigned> num_chunks(num_files);
+
+        size_t total_bytes = 0;
+        for (unsigned i = 0; i < num_files; ++i)
+        {
+            auto size = utils::random::number(1000, 100000);
+            num_chunks[i] = utils::random::number(1, 20);
+            responder->increment(num_chunks[i]);
+            total_responses += num_chunks[i];
+            total_bytes += size;
+
+            paths.push_back("s3://test-bucket/" + utils::random::string());
+            file_offsets.push_back(0);
+            bytesizes.push_back(size);
+        }
+
+        buffer.resize(total_bytes);
+        std::vector<void*> dsts = { buffer.data() };
+
+        Assigner assigner(paths, file_offsets, bytesizes, dsts, config);
+        workloads.resize(assigner.num_workloads());
+
+        for (unsigned file_idx = 0; file_idx < num_files; ++file_idx)
+        {
+            auto chunks = utils::random::chunks(bytesizes[file_idx], num_chunks[file_idx]);
+            auto uri = std::make_shared<common::s3::StorageUri>(paths[file_idx]);
+            common::s3::S3ClientWrapper::Params s3_params(uri, common::s3::Credentials(), utils::random::number<size_t>());
+
+            Batches batches(file_idx, assigner.file_assignments(file_idx), config, responder, paths[file_idx], s3_params, chunks);
+            for (size_t j = 0; j < batches.size(); ++j)
+            {
+                auto & batch = batches[j];
+                workloads[batch.worker_index].add_batch(std::move(batch));
+            }
+        }
+    }
+
+    std::shared_ptr<Config> config;
+    std::vector<char> buffer;
+    std::vector<Workload> workloads;
+    unsigned total_responses = 0;
+};
+
+} // namespace
+
+TEST(Executor, Sanity)
+{
+    utils::Dylib dylib("libstreamers3.so");
+    auto mock_response_time = dylib.dlsym<void(*)(unsigned)>("runai_mock_s3_set_response_time_ms");
+    auto mock_cleanup = dylib.dlsym<void(*)()>("runai_mock_s3_cleanup");
+    mock_response_time(utils::random::number(0, 20));
+    auto guard = utils::ScopeGuard([&mock_cleanup](){
+        mock_cleanup();
+    });
+
+    std::atomic<bool> stopped(false);
+    auto responder = std::make_shared<common::Responder>(0);
+    Helper helper(utils::random::number(1, 10), responder);
+
+    // more workloads than threads
+    Executor executor(utils::random::number(1, 3), stopped);
+    for (auto & workload : helper.workloads)
+    {
+        executor.push(std::move(workload));
+    }
+
+    for (unsigned i = 0; i < helper.total_responses; ++i)
+    {
+        const auto r = responder->pop();
+        EXPECT_EQ(r.ret, common::ResponseCode::Success);
+    }
+
+    auto r = responder->pop();
+    EXPECT_EQ(r.ret, common::ResponseCode::FinishedError);
+}
+
+TEST(Executor, Slices)
+{
+    utils::Dylib dylib("libstreamers3.so");
+    auto mock_response_time = dylib.dlsym<void(*)(unsigned)>("runai_mock_s3_set_response_time_ms");
+    auto mock_cleanup = dylib.dlsym<void(*)()>("runai_mock_s3_cleanup");
+    mock_response_time(utils::random::number(0, 5));
+    auto guard = utils::ScopeGuard([&mock_cleanup](){
+        mock_cleanup();
+    });
+
+    std::atomic<bool> stopped(false);
+    auto responder = std::make_shared<common::Responder>(0);
+    Helper helper(utils::random::number(1, 10), responder);
+
+    // the slices of the workloads take the workers of a scheduler queue
+    auto queue = Scheduler::queue(std::make_shared<Scheduler>(), 1, utils::random::number(1, 3));
+    {
+        Executor executor(utils::random::number(1, 3), stopped, queue.get(), utils::random::number<size_t>(1, 10000));
+        for (auto & workload : helper.workloads)
+        {
+            executor.push(std::move(workload));
+        }
+
+        for (unsigned i = 0; i < helper.total_responses; ++i)
+        {
+            const auto r = responder->pop();
+            EXPECT_EQ(r.ret, common::ResponseCode::Success);
+        }
+
+        auto r = responder->pop();
+        EXPECT_EQ(r.ret, common::ResponseCode::FinishedError);
+    }
+
+    EXPECT_EQ(queue->size(), 0);
+}
+
+TEST(Executor, Stopped)
+{
+    utils::Dylib dylib("libstreamers3.so");
+    auto mock_response_time = dylib.dlsym<void(*)(unsigned)>("runai_mock_s3_set_response_time_ms");
+    auto mock_cleanup = dylib.dlsym<void(*)()>("runai_mock_s3_cleanup");
+    mock_response_time(1000);
+    auto guard = utils::ScopeGuard([&mock_cleanup](){
+        mock_cleanup();
+    });
+
+    std::atomic<bool> stopped(false);
+    auto responder = std::make_shared<common::Responder>(0);
+    Helper helper(utils::random::number(1, 10), responder);
+
+    Executor executor(utils::random::number(1, 3), stopped);
+    for (auto & workload : helper.workloads)
+    {
+        executor.push(std::move(workload));
+    }
+
+    ::usleep(utils::random::number(100));
+
+    stopped = true;
+    common::s3::S3ClientWrapper::stop();
+
+    // every sub request is responded once the backend is stopped
+    for (unsigned i = 0; i < helper.total_responses; ++i)
+    {
+        const auto r = responder->pop();
+        EXPECT_TRUE(r.ret == common::ResponseCode::Success || r.ret == common::ResponseCode::FinishedError);
+    }
+
+    auto r = responder->pop();
+    EXPECT_EQ(r.ret, common::ResponseCode::FinishedError);
+}
+
+TEST(Executor, Destruction)
+{
+    utils::Dylib dylib("libstreamers3.so");
+    auto mock_response_time = dylib.dlsym<void(*)(unsigned)>("runai_mock_s3_set_response_time_ms");
+    auto mock_cleanup = dylib.dlsym<void(*)()>("runai_mock_s3_cleanup");
+    mock_response_time(utils::random::number(0, 20));
+    auto guard = utils::ScopeGuard([&mock_cleanup](){
+        mock_cleanup();
+    });
+
+    std::atomic<bool> stopped(false);
+    auto responder = std::make_shared<common::Responder>(0);
+    Helper helper(utils::random::number(1, 10), responder);
+
+    {
+        Executor executor(utils::random::number(1, 3), stopped);
+        for (auto & workload : helper.workloads)
+        {
+            executor.push(std::move(workload));
+        }
+        // d'tor drains the workloads which have not finished
+    }
+
+    for (unsigned i = 0; i < helper.total_responses; ++i)
+    {
+        const auto r = responder->pop();
+        EXPECT_EQ(r.ret, common::ResponseCode::Success);
+    }
+
+    auto r = responder->pop();
+    EXPECT_EQ(r.ret, common::ResponseCode::FinishedError);
+}
+
+}; // namespace runai::llm::streamer::impl
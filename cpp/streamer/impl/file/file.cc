@@ -2,31 +2,219 @@
 
 #include <sys/stat.h>
 #include <fcntl.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <limits>
+#include <map>
+#include <mutex>
+#include <optional>
 #include <utility>
 
 #include "common/exception/exception.h"
+#include "common/metrics/metrics.h"
+#include "streamer/impl/fs_strategy/fs_strategy.h"
 #include "utils/logging/logging.h"
 
 namespace runai::llm::streamer::impl
 {
 
+namespace
+{
+
+// a descriptor which is counted as open until it is closed, or null if the open failed
+std::shared_ptr<utils::Fd> counted(int fd)
+{
+    if (fd == -1)
+    {
+        return nullptr;
+    }
+
+    common::Metrics::add(common::Metrics::Counter::OpenDescriptors);
+    return std::shared_ptr<utils::Fd>(new utils::Fd(fd), [](utils::Fd * fd)
+        {
+            delete fd;
+            common::Metrics::add(common::Metrics::Counter::OpenDescriptors, -1);
+        });
+}
+
+// descriptors kept open by the process for file systems whose open is a round trip to a server
+// a descriptor is reused as long as the file it was opened for is still at the path and was not modified
+//
+// a modification of the file is checked by fstat() of the cached descriptor, which the client answers from its attribute cache,
+// while a replacement of the file at the path (e.g. a rename over it) takes a stat() of the path, which is a round trip on NFS,
+// and is therefore checked at most once per revalidation interval - so a replaced file may be read from its previous descriptor for that long
+struct Descriptors
+{
+    static std::shared_ptr<utils::Fd> get(const std::string & path, bool sequential)
+    {
+        static Descriptors descriptors;
+        return descriptors.open(path, sequential);
+    }
+
+ private:
+    using Clock = std::chrono::steady_clock;
+
+    struct Entry
+    {
+        std::shared_ptr<utils::Fd> fd;
+        struct stat st;
+        // last time the file was verified to be at the path
+        Clock::time_point validated;
+    };
+
+    static bool same(const struct stat & a, const struct stat & b)
+    {
+        return a.st_dev == b.st_dev && a.st_ino == b.st_ino && a.st_size == b.st_size &&
+               a.st_mtim.tv_sec == b.st_mtim.tv_sec && a.st_mtim.tv_nsec == b.st_mtim.tv_nsec;
+    }
+
+    std::shared_ptr<utils::Fd> open(const std::string & path, bool sequential)
+    {
+        const auto now = Clock::now();
+
+        std::optional<Entry> cached;
+        {
+            const auto guard = std::unique_lock<std::mutex>(_mutex);
+            const auto it = _entries.find(path);
+            if (it != _entries.end())
+            {
+                cached = it->second;
+            }
+        }
+
+        if (cached.has_value())
+        {
+            const bool revalidate = now - cached->validated >= revalidate_interval;
+
+            struct stat st = {};
+            const auto result = revalidate ? ::stat(path.c_str(), &st) : ::fstat(cached->fd->fd(), &st);
+            if (result == 0 && same(cached->st, st))
+            {
+                if (revalidate)
+                {
+                    const auto guard = std::unique_lock<std::mutex>(_mutex);
+                    const auto it = _entries.find(path);
+                    if (it != _entries.end() && it->second.fd == cached->fd)
+                    {
+                        it->second.validated = now;
+                    }
+                }
+                return cached->fd;
+            }
+
+            const auto guard = std::unique_lock<std::mutex>(_mutex);
+            const auto it = _entries.find(path);
+            if (it != _entries.end() && it->second.fd == cached->fd)
+            {
+                _entries.erase(it);
+            }
+        }
+
+        auto fd = counted(::open(path.c_str(), O_RDONLY | O_CLOEXEC));
+        if (fd == nullptr)
+        {
+            return nullptr;
+        }
+
+        // the attributes of the opened file, rather than of the path, so that a file replaced meanwhile is not attributed to the descriptor
+        struct stat st = {};
+        if (::fstat(fd->fd(), &st) != 0)
+        {
+            return nullptr;
+        }
+
+        if (sequential)
+        {
+            ::posix_fadvise(fd->fd(), 0, 0, POSIX_FADV_SEQUENTIAL);
+        }
+
+        const auto guard = std::unique_lock<std::mutex>(_mutex);
+
+        if (_entries.size() >= max_entries)
+        {
+            // the descriptors which are not read at the moment are closed
+            for (auto entry = _entries.begin(); entry != _entries.end();)
+            {
+                entry = entry->second.fd.use_count() == 1 ? _entries.erase(entry) : std::next(entry);
+            }
+        }
+
+        _entries[path] = Entry{fd, st, now};
+        return fd;
+    }
+
+    static constexpr size_t max_entries = 256;
+    static constexpr std::chrono::seconds revalidate_interval = std::chrono::seconds(1);
+
+    std::mutex _mutex;
+    std::map<std::string, Entry> _entries;
+};
+
+} // namespace
+
 File::File(const std::string & path, const Config & config) :
     Reader(Reader::Mode::Sync),
-    _fd(::open(path.c_str(), O_RDONLY)),
     _block_size(config.fs_block_bytesize)
 {
-    if (_fd.fd() == -1)
+    const auto strategy = config.fs_strategy ? FsStrategy::detect(path) : FsStrategy();
+
+    if (strategy.cache_descriptors)
+    {
+        _fd = Descriptors::get(path, strategy.sequential);
+    }
+    else
+    {
+        _fd = counted(::open(path.c_str(), O_RDONLY));
+    }
+
+    if (_fd == nullptr)
     {
         LOG(ERROR) << "Failed to access file " << path;
         throw common::Exception(common::ResponseCode::FileAccessError);
     }
+
+    if (config.fs_strategy)
+    {
+        struct stat st = {};
+        if (::fstat(_fd->fd(), &st) != 0)
+        {
+            LOG(ERROR) << "Failed to access file " << path;
+            throw common::Exception(common::ResponseCode::FileAccessError);
+        }
+
+        _positional = true;
+        _size = st.st_size;
+
+        // a truncated file is read short, rather than faulting as a mapping of it would
+        if (strategy.single_read)
+        {
+            _block_size = std::numeric_limits<ssize_t>::max();
+        }
+        else if (strategy.sequential && !strategy.cache_descriptors)
+        {
+            ::posix_fadvise(_fd->fd(), 0, 0, POSIX_FADV_SEQUENTIAL);
+        }
+    }
 }
 
 void File::seek(size_t offset)
 {
+    if (_positional)
+    {
+        if (offset > _size)
+        {
+            throw common::Exception(common::ResponseCode::EofError);
+        }
+        _offset = offset;
+        return;
+    }
+
     try
     {
-        _fd.seek(offset);
+        _fd->seek(offset);
     }
     catch(const std::exception& e)
     {
@@ -34,23 +222,63 @@ void File::seek(size_t offset)
     }
 }
 
+size_t File::pread(size_t bytesize, char * buffer)
+{
+    size_t result = 0;
+    while (result < bytesize)
+    {
+        const auto count = std::min(bytesize - result, _block_size);
+        const auto got = ::pread(_fd->fd(), buffer + result, count, _offset + result);
+        if (got == -1)
+        {
+            if (errno == EINTR)
+            {
+                continue;
+            }
+            LOG(ERROR) << "Failed reading " << count << " bytes at offset " << _offset + result << " with fd " << _fd->fd();
+            throw common::Exception(common::ResponseCode::UnknownError);
+        }
+
+        if (got == 0)
+        {
+            break;
+        }
+        result += got;
+    }
+
+    _offset += result;
+    return result;
+}
+
 void File::read(size_t bytesize, char * buffer)
 {
+    const auto start = std::chrono::steady_clock::now();
+
     size_t result = 0;
-    try
+    if (_positional)
     {
-        result = _fd.read(bytesize, buffer, utils::Fd::Read::Eof, _block_size);
+        result = pread(bytesize, buffer);
     }
-    catch(const std::exception& e)
+    else
     {
-        throw common::Exception(common::ResponseCode::UnknownError);
+        try
+        {
+            result = _fd->read(bytesize, buffer, utils::Fd::Read::Eof, _block_size);
+        }
+        catch(const std::exception& e)
+        {
+            throw common::Exception(common::ResponseCode::UnknownError);
+        }
     }
 
     if (result != bytesize)
     {
-        LOG(ERROR) << "Read " << result << " bytes. Expected " << bytesize << " bytes with fd " << _fd.fd();
+        LOG(ERROR) << "Read " << result << " bytes. Expected " << bytesize << " bytes with fd " << _fd->fd();
         throw common::Exception(common::ResponseCode::EofError);
     }
+
+    common::Metrics::read(common::Metrics::Backend::File, bytesize);
+    common::Metrics::record(common::Metrics::Histogram::ChunkLatency, std::chrono::steady_clock::now() - start);
 }
 
 void File::async_read(const common::s3::S3ClientWrapper::Params & params, common::backend_api::ObjectRequestId_t request_handle, const common::Range & range, char * buffer)
@@ -59,7 +287,7 @@ void File::async_read(const common::s3::S3ClientWrapper::Params & params, common
     throw common::Exception(common::ResponseCode::UnknownError);
 }
 
-common::ResponseCode File::async_response(std::vector<common::backend_api::Response> & responses, unsigned max_responses)
+common::ResponseCode File::async_response(std::vector<common::backend_api::Response> & responses, unsigned max_responses, common::backend_api::ObjectWaitMode_t wait_mode)
 {
     LOG(ERROR) << "Not implemented";
     throw common::Exception(common::ResponseCode::UnknownError);
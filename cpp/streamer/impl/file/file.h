@@ -1,6 +1,6 @@
-
 #pragma once
 
+#include <memory>
 #include <string>
 #include <vector>
 
@@ -15,18 +15,26 @@ namespace runai::llm::streamer::impl
 struct File : Reader
 {
     File(const std::string & path, const Config & config);
-    virtual ~File() {}
+    virtual ~File() = default;
 
     void read(size_t bytesize, char * buffer) override;
 
     void seek(size_t offset) override;
 
     void async_read(const common::s3::S3ClientWrapper::Params & params, common::backend_api::ObjectRequestId_t request_handle, const common::Range & range, char * buffer) override;
-    common::ResponseCode async_response(std::vector<common::backend_api::Response> & responses, unsigned max_responses) override;
+    common::ResponseCode async_response(std::vector<common::backend_api::Response> & responses, unsigned max_responses, common::backend_api::ObjectWaitMode_t wait_mode) override;
 
  private:
-    utils::Fd _fd;
+    // reads at the offset of this reader without moving the offset of the descriptor, which may be shared with other readers
+    size_t pread(size_t bytesize, char * buffer);
+
+    std::shared_ptr<utils::Fd> _fd;
     size_t _block_size;
+
+    // the file system strategy reads at an offset kept by the reader
+    bool _positional = false;
+    size_t _size = 0;
+    size_t _offset = 0;
 };
 
 }; // namespace runai::llm::streamer::impl
@@ -0,0 +1,219 @@
+#include "streamer/impl/fs_strategy/fs_strategy.h"
+
+#include <string.h>
+#include <sys/statfs.h>
+#include <sys/xattr.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <optional>
+#include <vector>
+
+#include "utils/logging/logging.h"
+
+namespace runai::llm::streamer::impl
+{
+
+namespace
+{
+
+// magic numbers of the file systems (linux/magic.h)
+constexpr unsigned long ext4_magic    = 0xEF53;
+constexpr unsigned long xfs_magic     = 0x58465342;
+constexpr unsigned long btrfs_magic   = 0x9123683E;
+constexpr unsigned long f2fs_magic    = 0xF2F52010;
+constexpr unsigned long overlay_magic = 0x794C7630;
+constexpr unsigned long tmpfs_magic   = 0x01021994;
+constexpr unsigned long ramfs_magic   = 0x858458F6;
+constexpr unsigned long nfs_magic     = 0x6969;
+constexpr unsigned long lustre_magic  = 0x0BD00BD0;
+constexpr unsigned long fuse_magic    = 0x65735546;
+
+FsStrategy::Type fs_type(unsigned long magic)
+{
+    switch (magic)
+    {
+        case ext4_magic:
+        case xfs_magic:
+        case btrfs_magic:
+        case f2fs_magic:
+        case overlay_magic:
+            return FsStrategy::Type::Local;
+        case tmpfs_magic:
+        case ramfs_magic:
+            return FsStrategy::Type::Memory;
+        case nfs_magic:
+            return FsStrategy::Type::Nfs;
+        case lustre_magic:
+            return FsStrategy::Type::Lustre;
+        case fuse_magic:
+            return FsStrategy::Type::Fuse;
+        default:
+            return FsStrategy::Type::Other;
+    }
+}
+
+// stripe size of the layout of a Lustre file (struct lov_user_md), which starts with
+// its magic (4 bytes), pattern (4 bytes), object id (16 bytes), stripe size (4 bytes) and stripe count (2 bytes)
+// only plain layouts (V1 and V3) are read, while composite layouts (e.g. progressive file layouts) have a stripe size per component and are left unknown
+size_t lustre_stripe_bytesize(const std::string & path)
+{
+    constexpr uint32_t lov_user_magic_v1 = 0x0BD10BD0;
+    constexpr uint32_t lov_user_magic_v3 = 0x0BD30BD0;
+    constexpr size_t stripe_offset = 24;
+
+    std::vector<uint8_t> layout(64 * 1024);
+    const auto size = ::getxattr(path.c_str(), "lustre.lov", layout.data(), layout.size());
+    if (size < static_cast<ssize_t>(stripe_offset + sizeof(uint32_t)))
+    {
+        LOG(DEBUG) << "Failed reading the Lustre layout of " << path;
+        return 0;
+    }
+
+    uint32_t magic;
+    ::memcpy(&magic, layout.data(), sizeof(magic));
+    if (magic != lov_user_magic_v1 && magic != lov_user_magic_v3)
+    {
+        LOG(DEBUG) << "Lustre layout of " << path << " is not a plain layout (magic " << std::hex << magic << std::dec << ")";
+        return 0;
+    }
+
+    uint32_t stripe;
+    ::memcpy(&stripe, layout.data() + stripe_offset, sizeof(stripe));
+    return stripe;
+}
+
+std::string directory(const std::string & path)
+{
+    const auto slash = path.rfind('/');
+    if (slash == std::string::npos)
+    {
+        return ".";
+    }
+    return slash == 0 ? "/" : path.substr(0, slash);
+}
+
+} // namespace
+
+FsStrategy FsStrategy::detect(const std::string & path)
+{
+    static std::mutex mutex;
+    static std::map<std::string, Type> types;
+
+    // the file system is cached by directory, while the stripe size is of each file
+    const auto key = directory(path);
+    std::optional<Type> type;
+    {
+        const auto guard = std::unique_lock<std::mutex>(mutex);
+        const auto it = types.find(key);
+        if (it != types.end())
+        {
+            type = it->second;
+        }
+    }
+
+    if (!type.has_value())
+    {
+        struct statfs st = {};
+        if (::statfs(path.c_str(), &st) != 0)
+        {
+            // the file is not cached, and its open fails as usual
+            LOG(DEBUG) << "Failed detecting the file system of " << path;
+            return FsStrategy();
+        }
+
+        type = fs_type(st.f_type);
+        LOG(DEBUG) << "File system of " << key << " is " << std::hex << st.f_type << std::dec << " (" << type.value() << ")";
+
+        const auto guard = std::unique_lock<std::mutex>(mutex);
+        types.emplace(key, type.value());
+    }
+
+    return of(type.value(), type.value() == Type::Lustre ? lustre_stripe_bytesize(path) : 0);
+}
+
+FsStrategy FsStrategy::of(Type type, size_t stripe_bytesize)
+{
+    FsStrategy strategy;
+    strategy.type = type;
+
+    switch (type)
+    {
+        case Type::Local:
+            strategy.sequential = true;
+            break;
+        case Type::Memory:
+            strategy.single_read = true;
+            break;
+        case Type::Nfs:
+            strategy.block_bytesize = 8 * 1024 * 1024;
+            strategy.concurrency = 32;
+            strategy.cache_descriptors = true;
+            strategy.sequential = true;
+            break;
+        case Type::Lustre:
+            strategy.stripe_bytesize = stripe_bytesize;
+            strategy.cache_descriptors = true;
+            strategy.sequential = true;
+            break;
+        case Type::Fuse:
+            strategy.block_bytesize = 16 * 1024 * 1024;
+            strategy.concurrency = max_concurrency;
+            strategy.cache_descriptors = true;
+            break;
+        case Type::Other:
+            break;
+    }
+
+    return strategy;
+}
+
+void FsStrategy::apply(Config & config) const
+{
+    if (block_bytesize)
+    {
+        config.fs_block_bytesize = block_bytesize;
+    }
+
+    if (stripe_bytesize)
+    {
+        // whole stripes, so that every read is served by a single storage target
+        config.fs_block_bytesize = std::max<size_t>(1, (config.fs_block_bytesize + stripe_bytesize - 1) / stripe_bytesize) * stripe_bytesize;
+    }
+
+    if (concurrency)
+    {
+        config.concurrency = concurrency;
+    }
+}
+
+std::ostream & operator<<(std::ostream & os, FsStrategy::Type type)
+{
+    switch (type)
+    {
+        case FsStrategy::Type::Local:
+            return os << "local";
+        case FsStrategy::Type::Memory:
+            return os << "memory";
+        case FsStrategy::Type::Nfs:
+            return os << "nfs";
+        case FsStrategy::Type::Lustre:
+            return os << "lustre";
+        case FsStrategy::Type::Fuse:
+            return os << "fuse";
+        default:
+            return os << "other";
+    }
+}
+
+std::ostream & operator<<(std::ostream & os, const FsStrategy & strategy)
+{
+    return os << strategy.type << " file system ; block size " << strategy.block_bytesize << " bytes ; concurrency " << strategy.concurrency
+              << " ; stripe size " << strategy.stripe_bytesize << " bytes ; " << (strategy.single_read ? "single read" : "read in blocks")
+              << " ; descriptors " << (strategy.cache_descriptors ? "cached" : "not cached")
+              << " ; " << (strategy.sequential ? "sequential" : "normal") << " read ahead";
+}
+
+}; // namespace runai::llm::streamer::impl
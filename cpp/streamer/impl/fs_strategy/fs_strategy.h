@@ -0,0 +1,71 @@
+#pragma once
+
+#include <stddef.h>
+
+#include <ostream>
+#include <string>
+
+#include "streamer/impl/config/config.h"
+
+namespace runai::llm::streamer::impl
+{
+
+// Strategy of reading the files of a file system, by the type of the file system detected with statfs
+//
+//     local    - ext4, xfs, btrfs and f2fs on a block device, and overlayfs whose layers are usually local -
+//                the configuration is kept, and the kernel is advised that the files are read sequentially to read ahead more
+//     memory   - tmpfs and ramfs, whose pages are already in memory - every range is read by a single read call instead of in blocks
+//     nfs      - every open is a round trip to the server - descriptors are cached, and larger blocks are read by more workers
+//     lustre   - reads are aligned to the stripe size of the file, which is read from its layout, and descriptors are cached
+//     fuse     - e.g. gcsfuse and s3fs, where every call is a round trip to a user space daemon, which is usually backed by object storage -
+//                descriptors are cached, and large blocks are read by many workers
+//
+// Reads remain buffered - the destination buffers and the tensor offsets are not aligned as direct I/O requires
+
+struct FsStrategy
+{
+    enum class Type
+    {
+        Local,
+        Memory,
+        Nfs,
+        Lustre,
+        Fuse,
+        Other,
+    };
+
+    // detects the file system of a path, where the file systems of the directories are cached by the process and the stripe size is read per file
+    static FsStrategy detect(const std::string & path);
+
+    // strategy of a file system type, and the stripe size of Lustre files (zero if unknown)
+    static FsStrategy of(Type type, size_t stripe_bytesize = 0);
+
+    // sets the block size and the concurrency of the strategy
+    void apply(Config & config) const;
+
+    Type type = Type::Other;
+
+    // block size and number of workers, where zero keeps the configuration
+    size_t block_bytesize = 0;
+    unsigned concurrency = 0;
+
+    // stripe size to which the block size is aligned, where zero does not align
+    size_t stripe_bytesize = 0;
+
+    // ranges are read by a single call each instead of in blocks of the block size
+    bool single_read = false;
+
+    // descriptors are kept open by the process and shared by the readers of the same file
+    bool cache_descriptors = false;
+
+    // files are read sequentially, which doubles the read ahead window of the kernel
+    bool sequential = false;
+
+    // largest concurrency of the strategies
+    static constexpr unsigned max_concurrency = 64;
+};
+
+std::ostream & operator<<(std::ostream &, FsStrategy::Type);
+std::ostream & operator<<(std::ostream &, const FsStrategy &);
+
+}; // namespace runai::llm::streamer::impl
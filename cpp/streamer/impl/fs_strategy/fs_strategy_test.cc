@@ -0,0 +1,130 @@
+#include "streamer/impl/fs_strategy/fs_strategy.h"
+
+#include <gtest/gtest.h>
+#include <sys/statfs.h>
+
+#include <sstream>
+#include <string>
+
+#include "utils/random/random.h"
+#include "utils/temp/dir/dir.h"
+#include "utils/temp/file/file.h"
+
+namespace runai::llm::streamer::impl
+{
+
+namespace
+{
+
+bool is_tmpfs(const std::string & path)
+{
+    struct statfs st = {};
+    return ::statfs(path.c_str(), &st) == 0 && st.f_type == 0x01021994;
+}
+
+} // namespace
+
+TEST(Detect, Directory)
+{
+    utils::temp::Dir dir;
+    utils::temp::File file(dir.path);
+
+    // files of a directory share its strategy
+    const auto strategy = FsStrategy::detect(file.path);
+    const auto other = FsStrategy::detect(dir.path + "/" + utils::random::string());
+    EXPECT_EQ(strategy.type, other.type);
+    EXPECT_EQ(strategy.type == FsStrategy::Type::Memory, is_tmpfs(dir.path));
+}
+
+TEST(Detect, Memory)
+{
+    if (!is_tmpfs("/dev/shm"))
+    {
+        GTEST_SKIP() << "/dev/shm is not a memory file system";
+    }
+
+    utils::temp::File file("/dev/shm");
+    const auto strategy = FsStrategy::detect(file.path);
+    EXPECT_EQ(strategy.type, FsStrategy::Type::Memory);
+    EXPECT_TRUE(strategy.single_read);
+}
+
+TEST(Detect, Not_Found)
+{
+    // not cached, so that a file system which is mounted later is detected
+    const auto strategy = FsStrategy::detect("/" + utils::random::string() + "/" + utils::random::string());
+    EXPECT_EQ(strategy.type, FsStrategy::Type::Other);
+    EXPECT_EQ(strategy.block_bytesize, 0);
+    EXPECT_EQ(strategy.concurrency, 0);
+}
+
+TEST(Of, Profiles)
+{
+    EXPECT_TRUE(FsStrategy::of(FsStrategy::Type::Memory).single_read);
+
+    const auto nfs = FsStrategy::of(FsStrategy::Type::Nfs);
+    EXPECT_TRUE(nfs.cache_descriptors);
+    EXPECT_GT(nfs.block_bytesize, Config::min_fs_block_bytesize);
+
+    // the largest blocks and concurrency
+    const auto fuse = FsStrategy::of(FsStrategy::Type::Fuse);
+    EXPECT_TRUE(fuse.cache_descriptors);
+    EXPECT_GT(fuse.block_bytesize, nfs.block_bytesize);
+    EXPECT_EQ(fuse.concurrency, FsStrategy::max_concurrency);
+
+    for (auto type : {FsStrategy::Type::Local, FsStrategy::Type::Memory, FsStrategy::Type::Nfs, FsStrategy::Type::Lustre, FsStrategy::Type::Fuse, FsStrategy::Type::Other})
+    {
+        EXPECT_LE(FsStrategy::of(type).concurrency, FsStrategy::max_concurrency);
+    }
+}
+
+TEST(Apply, Keep)
+{
+    const Config config;
+    for (auto type : {FsStrategy::Type::Local, FsStrategy::Type::Memory, FsStrategy::Type::Other})
+    {
+        Config applied(config);
+        FsStrategy::of(type).apply(applied);
+        EXPECT_EQ(applied.fs_block_bytesize, config.fs_block_bytesize);
+        EXPECT_EQ(applied.concurrency, config.concurrency);
+    }
+}
+
+TEST(Apply, Fuse)
+{
+    Config config;
+    const auto strategy = FsStrategy::of(FsStrategy::Type::Fuse);
+    strategy.apply(config);
+    EXPECT_EQ(config.fs_block_bytesize, strategy.block_bytesize);
+    EXPECT_EQ(config.concurrency, strategy.concurrency);
+}
+
+TEST(Apply, Lustre_Stripe)
+{
+    const size_t stripe = utils::random::number<size_t>(1, 8) * 1024 * 1024;
+    const auto strategy = FsStrategy::of(FsStrategy::Type::Lustre, stripe);
+    EXPECT_EQ(strategy.stripe_bytesize, stripe);
+
+    // the block size is rounded up to whole stripes
+    Config config;
+    config.fs_block_bytesize = utils::random::number<size_t>(1, 16 * 1024 * 1024);
+    const auto bytesize = config.fs_block_bytesize;
+    strategy.apply(config);
+    EXPECT_EQ(config.fs_block_bytesize % stripe, 0);
+    EXPECT_GE(config.fs_block_bytesize, bytesize);
+    EXPECT_LT(config.fs_block_bytesize, bytesize + stripe);
+
+    // unknown stripe keeps the block size
+    Config other;
+    FsStrategy::of(FsStrategy::Type::Lustre).apply(other);
+    EXPECT_EQ(other.fs_block_bytesize, Config().fs_block_bytesize);
+}
+
+TEST(Print, Type)
+{
+    std::stringstream ss;
+    ss << FsStrategy::of(FsStrategy::Type::Fuse);
+    EXPECT_EQ(ss.str().compare(0, 4, "fuse"), 0);
+}
+
+}; // namespace runai::llm::streamer::impl
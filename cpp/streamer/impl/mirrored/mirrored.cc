@@ -0,0 +1,288 @@
+#include "streamer/impl/mirrored/mirrored.h"
+
+#include <algorithm>
+#include <thread>
+#include <utility>
+
+#include "common/exception/exception.h"
+#include "common/metrics/metrics.h"
+
+#include "utils/logging/logging.h"
+
+namespace runai::llm::streamer::impl
+{
+
+// weight of the last completed request in the smoothed throughput of a mirror
+constexpr double smoothing = 0.2;
+
+// interval between polling the mirrors when waiting for responses from several mirrors without a notifier
+constexpr auto poll_interval = std::chrono::milliseconds(1);
+
+Mirrored::Mirrored(const std::vector<common::s3::Mirrors::Location> & locations, const std::vector<std::shared_ptr<Reader>> & readers, unsigned default_mirror, std::shared_ptr<Notifier> notifier) :
+    Reader(Reader::Mode::Async),
+    _default_mirror(default_mirror),
+    _notifier(notifier)
+{
+    ASSERT(locations.size() == readers.size()) << "Received " << readers.size() << " readers for " << locations.size() << " mirrors";
+    ASSERT(default_mirror < locations.size()) << "Invalid default mirror " << default_mirror << " of " << locations.size() << " mirrors";
+
+    for (size_t i = 0; i < locations.size(); ++i)
+    {
+        Mirror mirror;
+        mirror.location = locations[i];
+        mirror.reader = readers[i];
+        _mirrors.push_back(std::move(mirror));
+    }
+}
+
+void Mirrored::seek(size_t offset)
+{
+    LOG(ERROR) << "Not implemented";
+    throw common::Exception(common::ResponseCode::UnknownError);
+}
+
+void Mirrored::read(size_t bytesize, char * buffer)
+{
+    LOG(ERROR) << "Not implemented";
+    throw common::Exception(common::ResponseCode::UnknownError);
+}
+
+const std::vector<common::s3::S3ClientWrapper::Params> & Mirrored::mirror_params(const common::s3::S3ClientWrapper::Params & params)
+{
+    auto it = _params_by_uri.find(params.uri->uri);
+    if (it != _params_by_uri.end())
+    {
+        return it->second;
+    }
+
+    std::vector<common::s3::S3ClientWrapper::Params> mirrors;
+    const auto contained = std::any_of(_mirrors.begin(), _mirrors.end(), [&](const Mirror & mirror) { return mirror.location.contains(*params.uri); });
+    if (contained)
+    {
+        for (const auto & mirror : _mirrors)
+        {
+            mirrors.push_back(common::s3::Mirrors::mirror(params, mirror.location));
+        }
+    }
+    else
+    {
+        LOG(DEBUG) << "Object " << params.uri->uri << " is not mirrored";
+    }
+
+    return _params_by_uri.emplace(params.uri->uri, std::move(mirrors)).first->second;
+}
+
+bool Mirrored::select(const Pending & pending, unsigned & selected) const
+{
+    // mirrors without completed requests are expected to be twice as fast as the fastest mirror, so that every mirror is measured early
+    double fastest = 0;
+    for (const auto & mirror : _mirrors)
+    {
+        fastest = std::max(fastest, mirror.throughput);
+    }
+    const double unmeasured = (fastest == 0 ? 1 : 2 * fastest);
+
+    bool found = false;
+    bool found_healthy = false;
+    double earliest = 0;
+    for (unsigned i = 0; i < _mirrors.size(); ++i)
+    {
+        if (pending.tried[i])
+        {
+            continue;
+        }
+
+        const auto & mirror = _mirrors[i];
+        const bool healthy = mirror.failures < max_failures;
+        if (found_healthy && !healthy)
+        {
+            continue;
+        }
+
+        const double throughput = mirror.throughput > 0 ? mirror.throughput : unmeasured;
+        const double completion = static_cast<double>(mirror.inflight_bytesize + pending.range.size) / throughput;
+        if (!found || (healthy && !found_healthy) || completion < earliest)
+        {
+            found = true;
+            found_healthy = healthy;
+            earliest = completion;
+            selected = i;
+        }
+    }
+
+    return found;
+}
+
+void Mirrored::submit(common::backend_api::ObjectRequestId_t request_handle, Pending & pending, unsigned index)
+{
+    auto & mirror = _mirrors[index];
+    pending.tried[index] = true;
+
+    const auto & params = mirror_params(pending.params);
+    mirror.reader->async_read(params.empty() ? pending.params : params[index], request_handle, pending.range, pending.buffer);
+
+    pending.mirror = index;
+    pending.start = Clock::now();
+    ++mirror.inflight;
+    ++mirror.requests;
+    mirror.inflight_bytesize += pending.range.size;
+}
+
+void Mirrored::async_read(const common::s3::S3ClientWrapper::Params & params, common::backend_api::ObjectRequestId_t request_handle, const common::Range & range, char * buffer)
+{
+    Pending pending{params, range, buffer, _default_mirror, std::vector<bool>(_mirrors.size(), false), Clock::now()};
+
+    // objects outside the mirror locations are read only from the default mirror
+    if (mirror_params(params).empty())
+    {
+        pending.tried.assign(_mirrors.size(), true);
+        pending.tried[_default_mirror] = false;
+    }
+
+    unsigned index = _default_mirror;
+    select(pending, index);
+    submit(request_handle, pending, index);
+
+    _pending.emplace(request_handle, std::move(pending));
+}
+
+bool Mirrored::handle(common::backend_api::Response & response)
+{
+    auto it = _pending.find(response.handle);
+    if (it == _pending.end())
+    {
+        LOG(WARNING) << "Received response of unknown request " << response.handle;
+        return true;
+    }
+
+    auto & pending = it->second;
+    auto & mirror = _mirrors[pending.mirror];
+    --mirror.inflight;
+    mirror.inflight_bytesize -= pending.range.size;
+
+    // a truncated read is retried like a failed one
+    if (response.ret == common::ResponseCode::Success && response.bytes_transferred != pending.range.size)
+    {
+        LOG(ERROR) << "Received " << response.bytes_transferred << " bytes of request " << response.handle << " from mirror " << mirror.location << " ; expected " << pending.range.size << " bytes";
+        response.ret = common::ResponseCode::EofError;
+    }
+
+    if (response.ret == common::ResponseCode::Success)
+    {
+        const auto seconds = std::chrono::duration<double>(Clock::now() - pending.start).count();
+        if (seconds > 0)
+        {
+            const double sample = static_cast<double>(pending.range.size) / seconds;
+            mirror.throughput = (mirror.throughput == 0 ? sample : (1 - smoothing) * mirror.throughput + smoothing * sample);
+        }
+        mirror.failures = 0;
+        _pending.erase(it);
+        return true;
+    }
+
+    // canceled requests are not sent again
+    if (response.ret == common::ResponseCode::FinishedError)
+    {
+        _pending.erase(it);
+        return true;
+    }
+
+    ++mirror.failures;
+    LOG(WARNING) << "Request " << response.handle << " failed in mirror " << mirror.location << " with error " << response.ret << " ; " << mirror.failures << " consecutive failures";
+
+    unsigned index;
+    while (select(pending, index))
+    {
+        try
+        {
+            LOG(DEBUG) << "Sending request " << response.handle << " to mirror " << _mirrors[index].location;
+            submit(response.handle, pending, index);
+            common::Metrics::add(common::Metrics::Counter::Retries);
+            return false;
+        }
+        catch (const common::Exception & e)
+        {
+            LOG(ERROR) << "Failed to send request " << response.handle << " to mirror " << _mirrors[index].location << " with error " << e.error();
+        }
+    }
+
+    _pending.erase(it);
+    return true;
+}
+
+common::ResponseCode Mirrored::async_response(std::vector<common::backend_api::Response> & responses, unsigned max_responses, common::backend_api::ObjectWaitMode_t wait_mode)
+{
+    const auto initial = responses.size();
+
+    while (true)
+    {
+        if (_pending.empty())
+        {
+            // no responses are expected
+            return common::ResponseCode::FinishedError;
+        }
+
+        const auto busy = std::count_if(_mirrors.begin(), _mirrors.end(), [](const Mirror & mirror) { return mirror.inflight > 0; });
+
+        for (unsigned i = 0; i < _mirrors.size() && responses.size() - initial < max_responses; ++i)
+        {
+            auto & mirror = _mirrors[(_next + i) % _mirrors.size()];
+            if (mirror.inflight == 0)
+            {
+                continue;
+            }
+
+            // block only when waiting for a single mirror
+            const auto mode = (wait_mode == common::backend_api::OBJECT_WAIT_MODE_BLOCK && busy == 1) ? common::backend_api::OBJECT_WAIT_MODE_BLOCK : common::backend_api::OBJECT_WAIT_MODE_NON_BLOCKING;
+
+            std::vector<common::backend_api::Response> ready;
+            const auto r = mirror.reader->async_response(ready, max_responses - (responses.size() - initial), mode);
+            if (r != common::ResponseCode::Success)
+            {
+                // the requests in flight were canceled or stopped
+                return r;
+            }
+
+            for (auto & response : ready)
+            {
+                if (handle(response))
+                {
+                    responses.push_back(response);
+                }
+            }
+        }
+
+        // start polling from the next mirror on the next call, so that a busy mirror does not starve the others
+        _next = (_next + 1) % _mirrors.size();
+
+        if (responses.size() > initial || wait_mode == common::backend_api::OBJECT_WAIT_MODE_NON_BLOCKING)
+        {
+            return common::ResponseCode::Success;
+        }
+
+        if (busy > 1)
+        {
+            // responses which were ready since polling the mirrors have already notified
+            if (_notifier != nullptr)
+            {
+                _notifier->wait();
+            }
+            else
+            {
+                std::this_thread::sleep_for(poll_interval);
+            }
+        }
+    }
+}
+
+std::vector<size_t> Mirrored::requests() const
+{
+    std::vector<size_t> result;
+    for (const auto & mirror : _mirrors)
+    {
+        result.push_back(mirror.requests);
+    }
+    return result;
+}
+
+}; // namespace runai::llm::streamer::impl
@@ -0,0 +1,95 @@
+#pragma once
+
+#include <chrono>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "common/mirrors/mirrors.h"
+#include "common/range/range.h"
+#include "common/s3_wrapper/s3_wrapper.h"
+#include "streamer/impl/notifier/notifier.h"
+#include "streamer/impl/reader/reader.h"
+
+namespace runai::llm::streamer::impl
+{
+
+// Reads objects from a set of mirror locations, with a reader for each location
+//
+// Requests are sent to the mirror which is expected to complete them first, according to the bytes in flight and the observed throughput of each mirror,
+// so that the requests are spread across the mirrors in proportion to their throughput and a slow mirror receives fewer requests
+// A failed request is sent again to another mirror, and its error is returned only after it failed in all the mirrors
+// A mirror which fails repeatedly is avoided as long as the other mirrors succeed
+//
+// Objects outside the mirror locations are read from the default mirror
+// A blocking caller which waits for several mirrors is woken by the notifier, which the clients of the mirrors notify when their responses are ready
+// Used by a single workload at a time, and is not thread safe
+
+struct Mirrored : Reader
+{
+    // without a notifier (i.e. the backend does not support completion notifications) a blocking caller polls the mirrors
+    Mirrored(const std::vector<common::s3::Mirrors::Location> & locations, const std::vector<std::shared_ptr<Reader>> & readers, unsigned default_mirror, std::shared_ptr<Notifier> notifier = nullptr);
+    virtual ~Mirrored() {}
+
+    void read(size_t bytesize, char * buffer) override;
+    void seek(size_t offset) override;
+
+    void async_read(const common::s3::S3ClientWrapper::Params & params, common::backend_api::ObjectRequestId_t request_handle, const common::Range & range, char * buffer) override;
+    common::ResponseCode async_response(std::vector<common::backend_api::Response> & responses, unsigned max_responses, common::backend_api::ObjectWaitMode_t wait_mode) override;
+
+    // number of requests which were sent to each mirror, including retries
+    std::vector<size_t> requests() const;
+
+    static constexpr unsigned max_failures = 3;
+
+ private:
+    using Clock = std::chrono::steady_clock;
+
+    struct Mirror
+    {
+        common::s3::Mirrors::Location location;
+        std::shared_ptr<Reader> reader;
+
+        size_t inflight = 0;
+        size_t inflight_bytesize = 0;
+        size_t requests = 0;
+
+        // smoothed bytes per second of the completed requests, zero until the first completion
+        double throughput = 0;
+
+        // consecutive failures
+        unsigned failures = 0;
+    };
+
+    struct Pending
+    {
+        common::s3::S3ClientWrapper::Params params;
+        common::Range range;
+        char * buffer;
+        unsigned mirror;
+        std::vector<bool> tried;
+        Clock::time_point start;
+    };
+
+    // the mirror for the next attempt of the request, or false if it was tried in all the mirrors
+    bool select(const Pending & pending, unsigned & mirror) const;
+
+    // sends the request to the given mirror
+    void submit(common::backend_api::ObjectRequestId_t request_handle, Pending & pending, unsigned mirror);
+
+    // returns true if the response is ready for the caller, or false if the request was sent again
+    bool handle(common::backend_api::Response & response);
+
+    // parameters for reading the object of the request from each mirror, or an empty list if the object is not mirrored
+    const std::vector<common::s3::S3ClientWrapper::Params> & mirror_params(const common::s3::S3ClientWrapper::Params & params);
+
+    std::vector<Mirror> _mirrors;
+    const unsigned _default_mirror;
+    std::shared_ptr<Notifier> _notifier;
+    std::map<common::backend_api::ObjectRequestId_t, Pending> _pending;
+    std::map<std::string, std::vector<common::s3::S3ClientWrapper::Params>> _params_by_uri;
+    unsigned _next = 0;
+};
+
+}; // namespace runai::llm::streamer::impl
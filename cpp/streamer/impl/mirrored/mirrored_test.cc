@@ -0,0 +1,254 @@
+#include "streamer/impl/mirrored/mirrored.h"
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <chrono>
+#include <map>
+#include <memory>
+#include <numeric>
+#include <set>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "common/exception/exception.h"
+#include "streamer/impl/reader/mock/mock.h"
+
+#include "utils/random/random.h"
+#include "utils/thread/thread.h"
+
+namespace runai::llm::streamer::impl
+{
+
+// completes its requests only once released, like a client which notifies when its responses are ready
+struct ReleasedReader : MockReader
+{
+    common::ResponseCode async_response(std::vector<common::backend_api::Response> & responses, unsigned max_responses, common::backend_api::ObjectWaitMode_t wait_mode) override
+    {
+        if (!released && !pending.empty())
+        {
+            return common::ResponseCode::Success;
+        }
+        return MockReader::async_response(responses, max_responses, wait_mode);
+    }
+
+    std::atomic<bool> released = false;
+};
+
+struct MirroredTest : ::testing::Test
+{
+    void create(const std::vector<std::shared_ptr<MockReader>> & mock_readers, std::shared_ptr<Notifier> notifier = nullptr)
+    {
+        std::string description;
+        for (unsigned i = 0; i < mock_readers.size(); ++i)
+        {
+            description += (i ? "," : "") + std::string("s3://bucket") + std::to_string(i);
+            readers.push_back(mock_readers[i]);
+        }
+        locations = common::s3::Mirrors(description).of(common::s3::StorageUri("s3://bucket0/path"));
+        ASSERT_EQ(locations.size(), mock_readers.size());
+        mirrored = std::make_unique<Mirrored>(locations, readers, 0, notifier);
+    }
+
+    common::s3::S3ClientWrapper::Params params(const std::string & bucket = "bucket0")
+    {
+        return common::s3::S3ClientWrapper::Params(std::make_shared<common::s3::StorageUri>("s3://" + bucket + "/" + path), 0);
+    }
+
+    // returns the response code of every request
+    std::map<common::backend_api::ObjectRequestId_t, common::ResponseCode> wait(common::backend_api::ObjectWaitMode_t wait_mode)
+    {
+        std::map<common::backend_api::ObjectRequestId_t, common::ResponseCode> result;
+        while (true)
+        {
+            std::vector<common::backend_api::Response> responses;
+            const auto r = mirrored->async_response(responses, utils::random::number(1, 10), wait_mode);
+            if (r == common::ResponseCode::FinishedError)
+            {
+                return result;
+            }
+            EXPECT_EQ(r, common::ResponseCode::Success);
+
+            for (const auto & response : responses)
+            {
+                EXPECT_EQ(result.count(response.handle), 0) << "Duplicate response of request " << response.handle;
+                result[response.handle] = response.ret;
+            }
+        }
+    }
+
+    const std::string path = utils::random::string();
+    std::vector<std::shared_ptr<Reader>> readers;
+    std::vector<common::s3::Mirrors::Location> locations;
+    std::unique_ptr<Mirrored> mirrored;
+};
+
+TEST_F(MirroredTest, Sanity)
+{
+    const auto num_mirrors = utils::random::number(2, 5);
+    std::vector<std::shared_ptr<MockReader>> mocks;
+    for (unsigned i = 0; i < num_mirrors; ++i)
+    {
+        mocks.push_back(std::make_shared<MockReader>());
+    }
+    create(mocks);
+
+    const auto num_requests = utils::random::number(num_mirrors, 100);
+    for (unsigned i = 0; i < num_requests; ++i)
+    {
+        mirrored->async_read(params(), i, common::Range(i * 100, 100), nullptr);
+    }
+
+    // the requests are spread across the mirrors
+    const auto requests = mirrored->requests();
+    EXPECT_EQ(std::accumulate(requests.begin(), requests.end(), size_t(0)), num_requests);
+    for (unsigned i = 0; i < num_mirrors; ++i)
+    {
+        EXPECT_GT(requests[i], 0);
+        for (const auto & uri : mocks[i]->uris)
+        {
+            EXPECT_EQ(uri, "s3://bucket" + std::to_string(i) + "/" + path);
+        }
+    }
+
+    const auto wait_mode = utils::random::boolean() ? common::backend_api::OBJECT_WAIT_MODE_BLOCK : common::backend_api::OBJECT_WAIT_MODE_NON_BLOCKING;
+    const auto result = wait(wait_mode);
+    EXPECT_EQ(result.size(), num_requests);
+    for (const auto & [handle, response_code] : result)
+    {
+        EXPECT_EQ(response_code, common::ResponseCode::Success);
+    }
+}
+
+TEST_F(MirroredTest, Notified)
+{
+    auto notifier = std::make_shared<Notifier>();
+    std::vector<std::shared_ptr<ReleasedReader>> released;
+    std::vector<std::shared_ptr<MockReader>> mocks;
+    for (unsigned i = 0; i < 2; ++i)
+    {
+        released.push_back(std::make_shared<ReleasedReader>());
+        mocks.push_back(released.back());
+    }
+    create(mocks, notifier);
+
+    const auto num_requests = utils::random::number(2, 100);
+    for (unsigned i = 0; i < num_requests; ++i)
+    {
+        mirrored->async_read(params(), i, common::Range(i * 100, 100), nullptr);
+    }
+
+    // a blocking caller waiting for both mirrors returns once notified
+    auto releasing = utils::Thread([&]()
+    {
+        std::this_thread::sleep_for(std::chrono::milliseconds(utils::random::number(10)));
+        for (auto & reader : released)
+        {
+            reader->released = true;
+        }
+        notifier->notify();
+    });
+
+    const auto result = wait(common::backend_api::OBJECT_WAIT_MODE_BLOCK);
+    EXPECT_EQ(result.size(), num_requests);
+
+    releasing.join();
+}
+
+TEST_F(MirroredTest, Failover)
+{
+    create({std::make_shared<MockReader>(common::ResponseCode::FileAccessError), std::make_shared<MockReader>()});
+
+    const auto num_requests = utils::random::number(10, 100);
+    for (unsigned i = 0; i < num_requests; ++i)
+    {
+        mirrored->async_read(params(), i, common::Range(i * 100, 100), nullptr);
+
+        // a failing mirror is avoided after consecutive failures
+        const auto result = wait(common::backend_api::OBJECT_WAIT_MODE_BLOCK);
+        ASSERT_EQ(result.size(), 1);
+        EXPECT_EQ(result.at(i), common::ResponseCode::Success);
+    }
+
+    EXPECT_EQ(mirrored->requests()[0], Mirrored::max_failures);
+    EXPECT_EQ(mirrored->requests()[1], num_requests);
+}
+
+TEST_F(MirroredTest, All_Mirrors_Fail)
+{
+    create({std::make_shared<MockReader>(common::ResponseCode::FileAccessError), std::make_shared<MockReader>(common::ResponseCode::EofError)});
+
+    const auto num_requests = utils::random::number(1, 20);
+    for (unsigned i = 0; i < num_requests; ++i)
+    {
+        mirrored->async_read(params(), i, common::Range(i * 100, 100), nullptr);
+    }
+
+    const auto result = wait(common::backend_api::OBJECT_WAIT_MODE_NON_BLOCKING);
+    EXPECT_EQ(result.size(), num_requests);
+    for (const auto & [handle, response_code] : result)
+    {
+        EXPECT_NE(response_code, common::ResponseCode::Success);
+    }
+
+    // every request was tried in both mirrors
+    EXPECT_EQ(mirrored->requests()[0], num_requests);
+    EXPECT_EQ(mirrored->requests()[1], num_requests);
+}
+
+TEST_F(MirroredTest, Throughput)
+{
+    create({std::make_shared<MockReader>(common::ResponseCode::Success, std::chrono::milliseconds(5)), std::make_shared<MockReader>()});
+
+    const auto num_requests = utils::random::number(10, 20);
+    for (unsigned i = 0; i < num_requests; ++i)
+    {
+        mirrored->async_read(params(), i, common::Range(i * 1024 * 1024, 1024 * 1024), nullptr);
+        EXPECT_EQ(wait(common::backend_api::OBJECT_WAIT_MODE_BLOCK).size(), 1);
+    }
+
+    // the slow mirror is measured once, and the following requests are sent to the faster mirror
+    EXPECT_EQ(mirrored->requests()[0], 1);
+    EXPECT_EQ(mirrored->requests()[1], num_requests - 1);
+}
+
+TEST_F(MirroredTest, Not_Mirrored)
+{
+    auto mock = std::make_shared<MockReader>();
+    create({mock, std::make_shared<MockReader>(), std::make_shared<MockReader>()});
+
+    const auto num_requests = utils::random::number(1, 20);
+    for (unsigned i = 0; i < num_requests; ++i)
+    {
+        mirrored->async_read(params("other"), i, common::Range(i * 100, 100), nullptr);
+    }
+
+    EXPECT_EQ(mirrored->requests()[0], num_requests);
+    for (const auto & uri : mock->uris)
+    {
+        EXPECT_EQ(uri, "s3://other/" + path);
+    }
+
+    EXPECT_EQ(wait(common::backend_api::OBJECT_WAIT_MODE_BLOCK).size(), num_requests);
+}
+
+TEST_F(MirroredTest, Stopped)
+{
+    auto mock = std::make_shared<MockReader>(common::ResponseCode::FinishedError);
+    create({mock, std::make_shared<MockReader>(common::ResponseCode::FinishedError)});
+
+    const auto num_requests = utils::random::number(1, 20);
+    for (unsigned i = 0; i < num_requests; ++i)
+    {
+        mirrored->async_read(params(), i, common::Range(i * 100, 100), nullptr);
+    }
+
+    // canceled requests are not sent again
+    const auto result = wait(common::backend_api::OBJECT_WAIT_MODE_NON_BLOCKING);
+    EXPECT_EQ(result.size(), num_requests);
+    const auto requests = mirrored->requests();
+    EXPECT_EQ(requests[0] + requests[1], num_requests);
+}
+
+}; // namespace runai::llm::streamer::impl
@@ -0,0 +1,37 @@
+#include "streamer/impl/notifier/notifier.h"
+
+namespace runai::llm::streamer::impl
+{
+
+Notifier::Notifier(common::backend_api::ObjectCompletionNotification_t notification, void * context) :
+    _notification(notification),
+    _context(context)
+{}
+
+void Notifier::notify(void * context)
+{
+    static_cast<Notifier *>(context)->notify();
+}
+
+void Notifier::notify()
+{
+    {
+        const auto guard = std::unique_lock<std::mutex>(_mutex);
+        _notified = true;
+    }
+    _cv.notify_all();
+
+    if (_notification != nullptr)
+    {
+        _notification(_context);
+    }
+}
+
+void Notifier::wait()
+{
+    auto lock = std::unique_lock<std::mutex>(_mutex);
+    _cv.wait(lock, [this]() { return _notified; });
+    _notified = false;
+}
+
+}; // namespace runai::llm::streamer::impl
@@ -0,0 +1,37 @@
+#pragma once
+
+#include <condition_variable>
+#include <mutex>
+
+#include "common/backend_api/object_storage/object_storage.h"
+
+namespace runai::llm::streamer::impl
+{
+
+// Wakes a caller which blocks on several sources of responses (e.g. mirrors, other processes, local caches), from the completion notifications of the sources
+//
+// A notification which arrives before the caller waits is kept, so that the caller checks its sources without blocking and only then waits
+// Notifications are forwarded to the notification of an event driven caller, if there is one
+
+struct Notifier
+{
+    Notifier(common::backend_api::ObjectCompletionNotification_t notification = nullptr, void * context = nullptr);
+
+    // completion notification, which is registered with the notifier as its context
+    static void notify(void * context);
+
+    void notify();
+
+    // returns once notified since the previous wait
+    void wait();
+
+ private:
+    common::backend_api::ObjectCompletionNotification_t _notification;
+    void * _context;
+
+    std::mutex _mutex;
+    std::condition_variable _cv;
+    bool _notified = false;
+};
+
+}; // namespace runai::llm::streamer::impl
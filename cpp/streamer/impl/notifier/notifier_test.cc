@@ -0,0 +1,83 @@
+#include "streamer/impl/notifier/notifier.h"
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <unistd.h>
+
+#include "utils/random/random.h"
+#include "utils/thread/thread.h"
+
+namespace runai::llm::streamer::impl
+{
+
+TEST(Wait, Notified_Before)
+{
+    Notifier notifier;
+
+    notifier.notify();
+
+    // returns without blocking
+    notifier.wait();
+}
+
+TEST(Wait, Notified_While_Waiting)
+{
+    Notifier notifier;
+    std::atomic<bool> notified = false;
+
+    auto notifying = utils::Thread([&]()
+    {
+        usleep(utils::random::number(10 * 1000));
+        notified = true;
+        Notifier::notify(&notifier);
+    });
+
+    notifier.wait();
+    EXPECT_TRUE(notified);
+
+    notifying.join();
+}
+
+TEST(Wait, Consumes_Notifications)
+{
+    Notifier notifier;
+    std::atomic<bool> notified = false;
+
+    // several notifications before waiting wake a single wait
+    for (unsigned i = 0; i < utils::random::number(1, 10); ++i)
+    {
+        notifier.notify();
+    }
+    notifier.wait();
+
+    auto notifying = utils::Thread([&]()
+    {
+        usleep(utils::random::number(10 * 1000));
+        notified = true;
+        notifier.notify();
+    });
+
+    notifier.wait();
+    EXPECT_TRUE(notified);
+
+    notifying.join();
+}
+
+TEST(Notify, Forwarded)
+{
+    std::atomic<unsigned> notifications = 0;
+    auto notify = [](void * context) { ++*static_cast<std::atomic<unsigned> *>(context); };
+
+    Notifier notifier(notify, &notifications);
+
+    const auto count = utils::random::number(1, 10);
+    for (unsigned i = 0; i < count; ++i)
+    {
+        notifier.notify();
+    }
+
+    EXPECT_EQ(notifications, count);
+}
+
+}; // namespace runai::llm::streamer::impl
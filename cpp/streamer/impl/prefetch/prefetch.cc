@@ -0,0 +1,258 @@
+#include "streamer/impl/prefetch/prefetch.h"
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <utility>
+
+#include "common/exception/exception.h"
+#include "streamer/impl/cached/cached.h"
+#include "streamer/impl/s3/s3.h"
+
+#include "utils/fd/fd.h"
+#include "utils/logging/logging.h"
+
+namespace runai::llm::streamer::impl
+{
+
+Prefetch::Prefetch(std::shared_ptr<const Config> config, const std::vector<std::shared_ptr<Cache>> & caches, std::shared_ptr<Bandwidth> bandwidth) :
+    _config(config),
+    _caches(caches),
+    _bandwidth(bandwidth),
+    _cancellation(std::make_shared<Cancellation>()),
+    _queue(Scheduler::queue(Scheduler::instance(), 1, 1, true))
+{}
+
+Prefetch::~Prefetch()
+{
+    try
+    {
+        // running jobs stop reading, and the pending jobs are dropped with the queue
+        _cancellation->cancel();
+        _queue.reset();
+    }
+    catch (...)
+    {}
+}
+
+void Prefetch::request(const std::string & path, const common::s3::S3ClientWrapper::Params & params, const common::Range & range)
+{
+    if (params.valid() && _caches.empty())
+    {
+        LOG(ERROR) << "Prefetching from object storage requires a local cache (RUNAI_STREAMER_CACHE_DIR or RUNAI_STREAMER_SNAPSHOT_DIR)";
+        throw common::Exception(common::ResponseCode::InvalidParameterError);
+    }
+
+    LOG(DEBUG) << "Prefetching " << range << " of " << path;
+
+    // the jobs of an object share its version and its clients, rather than retrieving them for every job
+    std::shared_ptr<Object> object;
+    if (params.valid())
+    {
+        object = std::make_shared<Object>(params);
+    }
+
+    for (size_t offset = 0; offset < range.size; offset += job_bytesize)
+    {
+        const common::Range job_range(range.start + offset, std::min(job_bytesize, range.size - offset));
+        {
+            const auto lock = std::unique_lock<std::mutex>(_mutex);
+            ++_pending;
+        }
+
+        _queue->push([this, path, object, job_range]()
+            {
+                try
+                {
+                    if (!_cancellation->stopped())
+                    {
+                        if (object != nullptr)
+                        {
+                            this->object(*object, job_range);
+                        }
+                        else
+                        {
+                            file(path, job_range);
+                        }
+                    }
+                }
+                catch (const common::Exception & e)
+                {
+                    LOG(WARNING) << "Failed prefetching " << job_range << " of " << path << " ; error " << e.error();
+                }
+                catch (...)
+                {
+                    LOG(WARNING) << "Failed prefetching " << job_range << " of " << path;
+                }
+                done();
+            }, job_range.size);
+    }
+}
+
+void Prefetch::file(const std::string & path, const common::Range & range)
+{
+    utils::Fd fd(::open(path.c_str(), O_RDONLY | O_CLOEXEC));
+    if (fd.fd() == -1)
+    {
+        LOG(ERROR) << "Failed to access file " << path;
+        throw common::Exception(common::ResponseCode::FileAccessError);
+    }
+
+    auto & stopped = _cancellation->stopped();
+    for (size_t offset = 0; offset < range.size && !stopped; offset += _config->fs_block_bytesize)
+    {
+        const auto bytesize = std::min(_config->fs_block_bytesize, range.size - offset);
+        if (_bandwidth && !_bandwidth->acquire(bytesize, stopped))
+        {
+            break;
+        }
+
+        // readahead fills the page cache without copying, and is not supported by every file system
+        if (::readahead(fd.fd(), range.start + offset, bytesize) != 0)
+        {
+            ::posix_fadvise(fd.fd(), range.start + offset, bytesize, POSIX_FADV_WILLNEED);
+        }
+    }
+}
+
+void Prefetch::object(Object & object, const common::Range & range)
+{
+    const auto & params = object.params;
+    auto client = object.acquire();
+
+    const auto version = object.version(*client);
+    if (!version.has_value())
+    {
+        LOG(WARNING) << "Not prefetching " << params.uri->uri << " since its version is unknown";
+        object.release(client);
+        return;
+    }
+
+    // the buffer outlives the readers, which wait for the caches to read and write it
+    std::vector<char> buffer(range.size);
+
+    // ranges are read through the caches like the requests, so that they are kept in every cache which does not hold them yet
+    std::shared_ptr<Reader> reader = std::make_shared<S3>(client, *_config, _bandwidth, _cancellation);
+    Cached::Version get_version = [version](const common::s3::S3ClientWrapper::Params &) { return version; };
+    for (auto it = _caches.rbegin(); it != _caches.rend(); ++it)
+    {
+        reader = std::make_shared<Cached>(reader, *it, get_version);
+    }
+
+    _cancellation->add(client.get());
+
+    common::backend_api::ObjectRequestId_t requests = 0;
+    try
+    {
+        for (size_t offset = 0; offset < range.size && !_cancellation->stopped(); offset += _config->s3_block_bytesize)
+        {
+            const common::Range block(range.start + offset, std::min(_config->s3_block_bytesize, range.size - offset));
+            reader->async_read(params, requests, block, buffer.data() + offset);
+            ++requests;
+        }
+
+        size_t received = 0;
+        while (received < requests)
+        {
+            std::vector<common::backend_api::Response> responses;
+            const auto r = reader->async_response(responses, requests - received, common::backend_api::OBJECT_WAIT_MODE_BLOCK);
+            if (r != common::ResponseCode::Success)
+            {
+                throw common::Exception(r);
+            }
+
+            for (const auto & response : responses)
+            {
+                if (response.ret != common::ResponseCode::Success)
+                {
+                    LOG(WARNING) << "Failed prefetching a range of " << params.uri->uri << " ; error " << response.ret;
+                }
+            }
+            received += responses.size();
+        }
+    }
+    catch (...)
+    {
+        // the backend must not write to the buffer once it is released
+        client->cancel();
+        _cancellation->remove(client.get());
+        throw;
+    }
+
+    _cancellation->remove(client.get());
+    object.release(client);
+}
+
+Prefetch::Object::Object(const common::s3::S3ClientWrapper::Params & params) :
+    params(params)
+{}
+
+std::shared_ptr<common::s3::S3ClientWrapper> Prefetch::Object::acquire()
+{
+    {
+        const auto lock = std::unique_lock<std::mutex>(_mutex);
+        if (!_clients.empty())
+        {
+            auto client = _clients.back();
+            _clients.pop_back();
+            return client;
+        }
+    }
+
+    return std::make_shared<common::s3::S3ClientWrapper>(params);
+}
+
+void Prefetch::Object::release(std::shared_ptr<common::s3::S3ClientWrapper> client)
+{
+    const auto lock = std::unique_lock<std::mutex>(_mutex);
+    _clients.push_back(client);
+}
+
+const std::optional<std::string> & Prefetch::Object::version(common::s3::S3ClientWrapper & client)
+{
+    std::call_once(_resolved, [&]() { _version = client.object_version(params); });
+    return _version;
+}
+
+void Prefetch::done()
+{
+    {
+        const auto lock = std::unique_lock<std::mutex>(_mutex);
+        --_pending;
+    }
+    _cv.notify_all();
+}
+
+void Prefetch::cancel()
+{
+    LOG(DEBUG) << "Canceling prefetching";
+
+    // the running jobs stop reading, and the pending jobs are dropped
+    _cancellation->cancel();
+    const auto dropped = _queue->clear();
+    {
+        const auto lock = std::unique_lock<std::mutex>(_mutex);
+        _pending -= dropped;
+    }
+    wait();
+    _cancellation->reset();
+}
+
+void Prefetch::wait()
+{
+    auto lock = std::unique_lock<std::mutex>(_mutex);
+    _cv.wait(lock, [&]() { return _pending == 0; });
+}
+
+size_t Prefetch::size() const
+{
+    const auto lock = std::unique_lock<std::mutex>(_mutex);
+    return _pending;
+}
+
+}; // namespace runai::llm::streamer::impl
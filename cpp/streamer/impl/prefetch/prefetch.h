@@ -0,0 +1,91 @@
+#pragma once
+
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "common/range/range.h"
+#include "common/s3_wrapper/s3_wrapper.h"
+#include "streamer/impl/bandwidth/bandwidth.h"
+#include "streamer/impl/cache/cache.h"
+#include "streamer/impl/cancellation/cancellation.h"
+#include "streamer/impl/config/config.h"
+#include "streamer/impl/scheduler/scheduler.h"
+
+namespace runai::llm::streamer::impl
+{
+
+// Warms the storage of ranges which are going to be read soon, without destination buffers
+//
+// File system ranges are read ahead into the page cache, and object storage ranges are read into the local caches (cache directory or snapshot),
+// from which the following requests read them
+// Ranges are divided into jobs which run on the workers shared by the streamers of the process, in a background queue whose jobs run only while no request is pending
+// Prefetching is best effort - failures are logged, and the following requests read the ranges from the storage
+
+struct Prefetch
+{
+    Prefetch(std::shared_ptr<const Config> config, const std::vector<std::shared_ptr<Cache>> & caches, std::shared_ptr<Bandwidth> bandwidth);
+
+    // stops prefetching, and returns once no more data is read
+    ~Prefetch();
+
+    // throws InvalidParameterError for object storage ranges if there is no local cache
+    void request(const std::string & path, const common::s3::S3ClientWrapper::Params & params, const common::Range & range);
+
+    // drops the pending ranges, and returns once no more data is read
+    void cancel();
+
+    // blocks until the requested ranges were prefetched
+    void wait();
+
+    // number of jobs which have not finished
+    size_t size() const;
+
+    // bytes of a single job, which is also the bytesize of the buffer of an object storage job
+    static constexpr size_t job_bytesize = 64UL * 1024 * 1024;
+
+ private:
+    // an object of a prefetch request, whose jobs share its version and its clients
+    struct Object
+    {
+        Object(const common::s3::S3ClientWrapper::Params & params);
+
+        // an idle client, or a new client if the idle clients are in use by other jobs of the object
+        std::shared_ptr<common::s3::S3ClientWrapper> acquire();
+
+        // returns a client whose reads have completed to the idle clients
+        void release(std::shared_ptr<common::s3::S3ClientWrapper> client);
+
+        // the version is retrieved once, by the first job of the object
+        const std::optional<std::string> & version(common::s3::S3ClientWrapper & client);
+
+        const common::s3::S3ClientWrapper::Params params;
+
+     private:
+        std::mutex _mutex;
+        std::vector<std::shared_ptr<common::s3::S3ClientWrapper>> _clients;
+        std::once_flag _resolved;
+        std::optional<std::string> _version;
+    };
+
+    void file(const std::string & path, const common::Range & range);
+    void object(Object & object, const common::Range & range);
+    void done();
+
+    std::shared_ptr<const Config> _config;
+    std::vector<std::shared_ptr<Cache>> _caches;
+    std::shared_ptr<Bandwidth> _bandwidth;
+    std::shared_ptr<Cancellation> _cancellation;
+
+    mutable std::mutex _mutex;
+    std::condition_variable _cv;
+    size_t _pending = 0;
+
+    // destroyed first, so that no job runs once the other members are destroyed
+    std::unique_ptr<Scheduler::Queue> _queue;
+};
+
+}; // namespace runai::llm::streamer::impl
@@ -0,0 +1,118 @@
+#include "streamer/impl/prefetch/prefetch.h"
+
+#include <gtest/gtest.h>
+
+#include <unistd.h>
+
+#include <atomic>
+#include <future>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "common/exception/exception.h"
+
+#include "utils/random/random.h"
+#include "utils/temp/dir/dir.h"
+#include "utils/temp/file/file.h"
+
+namespace runai::llm::streamer::impl
+{
+
+namespace
+{
+
+std::shared_ptr<const Config> config()
+{
+    const auto block_bytesize = utils::random::number<size_t>(1, 1024);
+    return std::make_shared<Config>(1, 1, block_bytesize, block_bytesize, false /* do not force minimum block size */);
+}
+
+} // namespace
+
+TEST(Prefetch, File)
+{
+    const auto data = utils::random::buffer(utils::random::number(1, 100000));
+    utils::temp::File file(data);
+
+    Prefetch prefetch(config(), {}, nullptr);
+    prefetch.request(file.path, common::s3::S3ClientWrapper::Params(), common::Range(0, data.size()));
+    prefetch.wait();
+    EXPECT_EQ(prefetch.size(), 0);
+}
+
+TEST(Prefetch, File_Not_Found)
+{
+    // prefetching is best effort, and the error is returned by the following request
+    Prefetch prefetch(config(), {}, nullptr);
+    EXPECT_NO_THROW(prefetch.request(utils::random::string(), common::s3::S3ClientWrapper::Params(), common::Range(0, utils::random::number(1, 1000))));
+    prefetch.wait();
+    EXPECT_EQ(prefetch.size(), 0);
+}
+
+TEST(Prefetch, Object_Without_Cache)
+{
+    auto uri = std::make_shared<common::s3::StorageUri>("s3://" + utils::random::string() + "/" + utils::random::string());
+    common::s3::S3ClientWrapper::Params params(uri, Config().s3_block_bytesize);
+
+    Prefetch prefetch(config(), {}, nullptr);
+    try
+    {
+        prefetch.request(uri->uri, params, common::Range(0, utils::random::number(1, 1000)));
+        FAIL() << "Prefetching from object storage without a cache";
+    }
+    catch (const common::Exception & e)
+    {
+        EXPECT_EQ(e.error(), common::ResponseCode::InvalidParameterError);
+    }
+}
+
+TEST(Prefetch, Object)
+{
+    utils::temp::Dir dir;
+    auto cache = std::make_shared<Cache>(dir.path, Config::default_cache_max_bytesize);
+
+    auto uri = std::make_shared<common::s3::StorageUri>("s3://" + utils::random::string() + "/" + utils::random::string());
+    const auto c = config();
+    common::s3::S3ClientWrapper::Params params(uri, c->s3_block_bytesize);
+
+    const common::Range range(utils::random::number(0, 1000), utils::random::number(1, 100000));
+    {
+        Prefetch prefetch(c, { cache }, nullptr);
+        prefetch.request(uri->uri, params, range);
+        prefetch.wait();
+    }
+    cache->flush();
+
+    // the mock object storage reports version 1 of every object
+    std::vector<char> buffer(range.size);
+    EXPECT_TRUE(cache->read(Cache::Entry(uri->uri, "1"), range, buffer.data()));
+}
+
+TEST(Prefetch, Cancel)
+{
+    // a request occupies the single worker, so that the prefetching jobs are pending
+    auto scheduler = Scheduler::instance();
+    auto requests = Scheduler::queue(scheduler, 1, 1);
+    Prefetch prefetch(config(), {}, nullptr);
+    ASSERT_EQ(scheduler->workers(), 1);
+
+    std::promise<void> release;
+    auto released = release.get_future().share();
+    std::promise<void> running;
+    requests->push([&]() { running.set_value(); released.wait(); }, 1);
+    running.get_future().wait();
+
+    utils::temp::File file(utils::random::buffer(utils::random::number(1, 1000)));
+    const auto jobs = utils::random::number(2, 10);
+    prefetch.request(file.path, common::s3::S3ClientWrapper::Params(), common::Range(0, jobs * Prefetch::job_bytesize));
+    EXPECT_EQ(prefetch.size(), jobs);
+
+    // the pending jobs are dropped without waiting for the worker
+    prefetch.cancel();
+    EXPECT_EQ(prefetch.size(), 0);
+
+    release.set_value();
+}
+
+}; // namespace runai::llm::streamer::impl
@@ -0,0 +1,73 @@
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "streamer/impl/reader/reader.h"
+
+namespace runai::llm::streamer::impl
+{
+
+// Asynchronous reader for tests, which completes every request on the following call to async_response
+// Requests are read from an object in memory, unless the object is empty
+
+struct MockReader : Reader
+{
+    MockReader(const std::vector<char> & object, common::ResponseCode response_code = common::ResponseCode::Success) :
+        Reader(Reader::Mode::Async),
+        object(object),
+        response_code(response_code)
+    {}
+
+    MockReader(common::ResponseCode response_code = common::ResponseCode::Success, std::chrono::milliseconds delay = std::chrono::milliseconds(0)) :
+        Reader(Reader::Mode::Async),
+        response_code(response_code),
+        delay(delay)
+    {}
+
+    void read(size_t bytesize, char * buffer) override {}
+    void seek(size_t offset) override {}
+
+    void async_read(const common::s3::S3ClientWrapper::Params & params, common::backend_api::ObjectRequestId_t request_handle, const common::Range & range, char * buffer) override
+    {
+        if (!object.empty())
+        {
+            std::copy(object.begin() + range.start, object.begin() + range.start + range.size, buffer);
+        }
+        uris.push_back(params.uri->uri);
+        pending.emplace_back(request_handle, range.size);
+        ++requests;
+    }
+
+    common::ResponseCode async_response(std::vector<common::backend_api::Response> & responses, unsigned max_responses, common::backend_api::ObjectWaitMode_t wait_mode) override
+    {
+        if (pending.empty())
+        {
+            return common::ResponseCode::FinishedError;
+        }
+
+        std::this_thread::sleep_for(delay);
+        while (!pending.empty() && responses.size() < max_responses)
+        {
+            const auto [handle, bytesize] = pending.front();
+            responses.emplace_back(handle, response_code, response_code == common::ResponseCode::Success ? bytesize : 0);
+            pending.erase(pending.begin());
+        }
+        return common::ResponseCode::Success;
+    }
+
+    std::vector<char> object;
+    common::ResponseCode response_code;
+    std::chrono::milliseconds delay = std::chrono::milliseconds(0);
+
+    // handles and bytesizes of the pending requests
+    std::vector<std::pair<common::backend_api::ObjectRequestId_t, size_t>> pending;
+    std::vector<std::string> uris;
+    size_t requests = 0;
+};
+
+}; // namespace runai::llm::streamer::impl
@@ -0,0 +1,97 @@
+#include "streamer/impl/readiness/readiness.h"
+
+#include <errno.h>
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include "common/exception/exception.h"
+#include "utils/logging/logging.h"
+
+namespace runai::llm::streamer::impl
+{
+
+namespace
+{
+
+long futex(uint32_t * entry, int op, uint32_t value)
+{
+    return ::syscall(SYS_futex, entry, op, value, nullptr, nullptr, 0);
+}
+
+} // namespace
+
+Readiness::Readiness(uint32_t * entries, size_t size) :
+    _entries(entries),
+    _size(size)
+{
+    ASSERT(_entries != nullptr || _size == 0) << "Readiness array is null";
+}
+
+void Readiness::reset(const std::vector<unsigned> & num_sizes)
+{
+    _bases.clear();
+
+    size_t total = 0;
+    for (auto num : num_sizes)
+    {
+        _bases.push_back(total);
+        total += num;
+    }
+
+    if (total > _size)
+    {
+        LOG(ERROR) << "Readiness array of " << _size << " entries is too small for " << total << " sub requests";
+        throw common::Exception(common::ResponseCode::InvalidParameterError);
+    }
+
+    // workers receive the request after these stores, through the threadpool
+    for (size_t i = 0; i < total; ++i)
+    {
+        __atomic_store_n(&_entries[i], 0u, __ATOMIC_RELAXED);
+    }
+}
+
+void Readiness::set(unsigned file_index, unsigned index, common::ResponseCode ret)
+{
+    ASSERT(file_index < _bases.size()) << "Invalid file index " << file_index << " for readiness array";
+
+    const auto i = _bases[file_index] + index;
+    ASSERT(i < _size) << "Readiness entry " << i << " overflow (size " << _size << ")";
+
+    const uint32_t value = static_cast<uint32_t>(ret) + 1;
+    const auto previous = __atomic_exchange_n(&_entries[i], value, __ATOMIC_RELEASE);
+    if (previous & Waiting)
+    {
+        futex(&_entries[i], FUTEX_WAKE, INT32_MAX);
+    }
+}
+
+common::ResponseCode Readiness::wait(uint32_t * entry)
+{
+    while (true)
+    {
+        auto value = __atomic_load_n(entry, __ATOMIC_ACQUIRE);
+        if (value & ~Waiting)
+        {
+            return static_cast<common::ResponseCode>(value - 1);
+        }
+
+        if (value == 0)
+        {
+            // announce a waiter - fails if the entry was just set
+            if (!__atomic_compare_exchange_n(entry, &value, Waiting, false, __ATOMIC_ACQUIRE, __ATOMIC_ACQUIRE))
+            {
+                continue;
+            }
+        }
+
+        // returns immediately if the entry is no longer Waiting
+        if (futex(entry, FUTEX_WAIT, Waiting) == -1)
+        {
+            PASSERT(errno == EAGAIN || errno == EINTR) << "Failed waiting on readiness entry";
+        }
+    }
+}
+
+}; // namespace runai::llm::streamer::impl
@@ -0,0 +1,44 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <vector>
+
+#include "common/response_code/response_code.h"
+
+namespace runai::llm::streamer::impl
+{
+
+// Readiness array in caller memory, with one entry per sub request of a request
+//
+// Entries are ordered by files and then by sub requests, i.e. the entry of sub request j of file i is num_sizes[0] + ... + num_sizes[i-1] + j
+// An entry is zero while the sub request is pending, and is set by the worker with a release store to the response code + 1 when the sub request completes
+// The most significant bit is set by waiting consumers, and the worker wakes them (futex) only if the bit is set
+// The memory may be shared between processes, so the futex operations are not private
+
+struct Readiness
+{
+    static constexpr uint32_t Waiting = 0x80000000u;
+
+    Readiness(uint32_t * entries, size_t size);
+
+    // zero the entries of a new request
+    // throws common::ResponseCode::InvalidParameterError if the array is too small for the request
+    void reset(const std::vector<unsigned> & num_sizes);
+
+    // mark a sub request as completed and wake its waiters
+    void set(unsigned file_index, unsigned index, common::ResponseCode ret);
+
+    // wait until the entry is set and return the sub request response code
+    static common::ResponseCode wait(uint32_t * entry);
+
+ private:
+    uint32_t * _entries;
+    size_t _size;
+
+    // index of the first entry of each file
+    std::vector<size_t> _bases;
+};
+
+}; // namespace runai::llm::streamer::impl
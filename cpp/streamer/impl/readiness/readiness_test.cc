@@ -0,0 +1,110 @@
+#include "streamer/impl/readiness/readiness.h"
+
+#include <gtest/gtest.h>
+
+#include <unistd.h>
+
+#include <vector>
+
+#include "common/exception/exception.h"
+#include "utils/random/random.h"
+#include "utils/thread/thread.h"
+
+namespace runai::llm::streamer::impl
+{
+
+TEST(Reset, Sanity)
+{
+    std::vector<unsigned> num_sizes;
+    size_t total = 0;
+    for (unsigned i = 0; i < utils::random::number(1, 10); ++i)
+    {
+        num_sizes.push_back(utils::random::number(1, 100));
+        total += num_sizes.back();
+    }
+
+    std::vector<uint32_t> entries(total + utils::random::number(10), utils::random::number(1, 10));
+    Readiness readiness(entries.data(), entries.size());
+    readiness.reset(num_sizes);
+
+    for (size_t i = 0; i < total; ++i)
+    {
+        EXPECT_EQ(entries[i], 0);
+    }
+}
+
+TEST(Reset, Too_Small)
+{
+    const auto size = utils::random::number(1, 100);
+    std::vector<uint32_t> entries(size);
+    Readiness readiness(entries.data(), size - 1);
+
+    try
+    {
+        readiness.reset({size});
+        FAIL() << "Expected exception";
+    }
+    catch (const common::Exception & e)
+    {
+        EXPECT_EQ(e.error(), common::ResponseCode::InvalidParameterError);
+    }
+}
+
+TEST(Set, Order)
+{
+    std::vector<unsigned> num_sizes = { utils::random::number(1, 100), utils::random::number(1, 100) };
+    std::vector<uint32_t> entries(num_sizes[0] + num_sizes[1]);
+    Readiness readiness(entries.data(), entries.size());
+    readiness.reset(num_sizes);
+
+    const auto index = utils::random::number(num_sizes[1] - 1);
+    readiness.set(1, index, common::ResponseCode::EofError);
+
+    for (size_t i = 0; i < entries.size(); ++i)
+    {
+        if (i == num_sizes[0] + index)
+        {
+            EXPECT_EQ(entries[i], static_cast<uint32_t>(common::ResponseCode::EofError) + 1);
+            EXPECT_EQ(Readiness::wait(&entries[i]), common::ResponseCode::EofError);
+        }
+        else
+        {
+            EXPECT_EQ(entries[i], 0);
+        }
+    }
+}
+
+TEST(Wait, Threads)
+{
+    const auto size = utils::random::number(1, 100);
+    std::vector<uint32_t> entries(size);
+    Readiness readiness(entries.data(), size);
+    readiness.reset({size});
+
+    std::vector<utils::Thread> waiters;
+    for (unsigned i = 0; i < size; ++i)
+    {
+        waiters.emplace_back([&, i]()
+        {
+            EXPECT_EQ(Readiness::wait(&entries[i]), common::ResponseCode::Success);
+        });
+    }
+
+    for (unsigned i = 0; i < size; ++i)
+    {
+        usleep(utils::random::number(1000));
+        readiness.set(0, i, common::ResponseCode::Success);
+    }
+
+    for (auto & waiter : waiters)
+    {
+        waiter.join();
+    }
+
+    for (unsigned i = 0; i < size; ++i)
+    {
+        EXPECT_EQ(entries[i], 1);
+    }
+}
+
+}; // namespace runai::llm::streamer::impl
@@ -1,5 +1,8 @@
+#include <algorithm>
+#include <atomic>
 #include <memory>
 #include <regex>
+#include <thread>
 #include <vector>
 
 #include "common/exception/exception.h"
@@ -12,13 +15,56 @@
 namespace runai::llm::streamer::impl
 {
 
-S3::S3(std::shared_ptr<common::s3::S3ClientWrapper> client, const Config & config) :
+namespace
+{
+
+common::Metrics::Backend backend(const common::s3::S3ClientWrapper::Params & params)
+{
+    switch (common::s3::S3ClientWrapper::BackendHandle::get_libstreamers_plugin_type(params.uri).id())
+    {
+        case common::s3::PluginID::GCS:
+            return common::Metrics::Backend::GCS;
+        case common::s3::PluginID::AZURE:
+            return common::Metrics::Backend::Azure;
+        case common::s3::PluginID::EMULATED:
+            return common::Metrics::Backend::Emulated;
+        default:
+            return common::Metrics::Backend::S3;
+    }
+}
+
+} // namespace
+
+S3::S3(std::shared_ptr<common::s3::S3ClientWrapper> client, const Config & config, std::shared_ptr<Bandwidth> bandwidth, std::shared_ptr<Cancellation> cancellation, common::backend_api::ObjectCompletionNotification_t notification, void * context) :
     Reader(Reader::Mode::Async),
     _client(client),
-    _config(config)
+    _config(config),
+    _bandwidth(bandwidth),
+    _cancellation(cancellation),
+    _notification(notification),
+    _context(context)
 {
 }
 
+S3::~S3()
+{
+    {
+        const auto guard = std::unique_lock<std::mutex>(_mutex);
+        _stop = true;
+    }
+    _cv.notify_one();
+
+    if (_timer.joinable())
+    {
+        _timer.join();
+    }
+
+    drop_deferred();
+
+    // requests which were canceled without a response are no longer in flight
+    common::Metrics::add(common::Metrics::Counter::InflightRequests, -static_cast<int64_t>(_submitted.size()));
+}
+
 void S3::seek(size_t offset)
 {
     LOG(ERROR) << "Not implemented";
@@ -31,19 +77,186 @@ void S3::read(size_t bytesize, char * buffer)
     throw common::Exception(common::ResponseCode::UnknownError);
 }
 
+bool S3::stopped() const
+{
+    return _cancellation && _cancellation->stopped();
+}
+
 void S3::async_read(const common::s3::S3ClientWrapper::Params & params, common::backend_api::ObjectRequestId_t request_handle, const common::Range & range, char * buffer)
 {
-    auto response_code = _client->async_read(params, request_handle, range, buffer);
+    if (_bandwidth && _notification != nullptr)
+    {
+        // requests are submitted in order, so a request is deferred while earlier requests are
+        const auto due = _bandwidth->reserve(range.size);
+        if (!_deferred.empty() || due > Bandwidth::Clock::now())
+        {
+            _deferred.push_back(Deferred{params, request_handle, range, buffer, due});
+            schedule(_deferred.front().due);
+            return;
+        }
+    }
+    else if (_bandwidth)
+    {
+        std::atomic<bool> not_stopped(false);
+        if (!_bandwidth->acquire(range.size, _cancellation ? _cancellation->stopped() : not_stopped))
+        {
+            LOG(DEBUG) << "Stopped while waiting for the node bandwidth limit";
+            throw common::Exception(common::ResponseCode::FinishedError);
+        }
+    }
+
+    try
+    {
+        submit(params, request_handle, range, buffer);
+    }
+    catch (const common::Exception &)
+    {
+        // the tokens of a request which was not submitted are not used
+        if (_bandwidth)
+        {
+            _bandwidth->release(range.size);
+        }
+        throw;
+    }
+}
+
+void S3::submit(const common::s3::S3ClientWrapper::Params & params, common::backend_api::ObjectRequestId_t request_handle, const common::Range & range, char * buffer)
+{
+    common::ResponseCode response_code;
+    {
+        common::Trace::Scope span("submit", range.size);
+        response_code = _client->async_read(params, request_handle, range, buffer);
+    }
+
     if (response_code != common::ResponseCode::Success)
     {
         throw common::Exception(response_code);
     }
+
+    _submitted[request_handle] = Submitted{std::chrono::steady_clock::now(), backend(params), range.size};
+    common::Metrics::add(common::Metrics::Counter::InflightRequests);
+}
+
+void S3::submit_deferred(std::vector<common::backend_api::Response> & responses, common::backend_api::ObjectWaitMode_t wait_mode)
+{
+    while (!_deferred.empty() && !stopped())
+    {
+        const auto & deferred = _deferred.front();
+        const auto now = Bandwidth::Clock::now();
+        if (deferred.due > now)
+        {
+            if (wait_mode == common::backend_api::OBJECT_WAIT_MODE_NON_BLOCKING)
+            {
+                schedule(deferred.due);
+                return;
+            }
+
+            std::this_thread::sleep_for(std::min<Bandwidth::Clock::duration>(deferred.due - now, touch_interval));
+            _bandwidth->touch();
+            continue;
+        }
+
+        // a request which failed to be submitted is responded with its error, as if it failed in the backend
+        try
+        {
+            submit(deferred.params, deferred.request_handle, deferred.range, deferred.buffer);
+        }
+        catch (const common::Exception & e)
+        {
+            _bandwidth->release(deferred.range.size);
+            responses.emplace_back(deferred.request_handle, e.error());
+        }
+        _deferred.pop_front();
+    }
+}
+
+void S3::drop_deferred()
+{
+    if (_deferred.empty())
+    {
+        return;
+    }
+
+    size_t bytesize = 0;
+    for (const auto & deferred : _deferred)
+    {
+        bytesize += deferred.range.size;
+    }
+
+    LOG(DEBUG) << "Returning the tokens of " << _deferred.size() << " deferred requests of " << bytesize << " bytes";
+    _bandwidth->release(bytesize);
+    _deferred.clear();
+}
+
+void S3::schedule(Bandwidth::Clock::time_point due)
+{
+    {
+        const auto guard = std::unique_lock<std::mutex>(_mutex);
+        if (_due.has_value() && *_due <= due)
+        {
+            return;
+        }
+
+        _due = due;
+        if (!_timer.joinable())
+        {
+            _timer = std::thread([this]() { run_timer(); });
+        }
+    }
+    _cv.notify_one();
 }
 
-common::ResponseCode S3::async_response(std::vector<common::backend_api::Response> & responses, unsigned max_responses)
+void S3::run_timer()
 {
+    auto lock = std::unique_lock<std::mutex>(_mutex);
+    while (!_stop)
+    {
+        if (!_due.has_value())
+        {
+            _cv.wait(lock);
+            continue;
+        }
+
+        const auto now = Bandwidth::Clock::now();
+        if (now >= *_due)
+        {
+            _due.reset();
+            lock.unlock();
+            _notification(_context);
+            lock.lock();
+            continue;
+        }
+
+        _cv.wait_until(lock, std::min<Bandwidth::Clock::time_point>(*_due, now + touch_interval));
+
+        // a process waiting for its tokens competes, so that the other processes keep leaving it its share
+        _bandwidth->touch();
+    }
+}
+
+common::ResponseCode S3::async_response(std::vector<common::backend_api::Response> & responses, unsigned max_responses, common::backend_api::ObjectWaitMode_t wait_mode)
+{
+    const auto initial = responses.size();
+    submit_deferred(responses, wait_mode);
+
+    if (stopped() && !_deferred.empty())
+    {
+        LOG(DEBUG) << "Stopped while waiting for the node bandwidth limit";
+        drop_deferred();
+        return common::ResponseCode::FinishedError;
+    }
+
+    // the backend is not polled while all the requests are deferred, or once the responses are full
+    max_responses -= std::min<size_t>(max_responses, responses.size() - initial);
+    if (max_responses == 0 || (_submitted.empty() && responses.size() > initial) || (_submitted.empty() && !_deferred.empty()))
+    {
+        return common::ResponseCode::Success;
+    }
+
+    // the latency of a request is recorded up to its completion, rather than up to the poll which retrieved it
     std::vector<common::backend_api::ObjectCompletionEvent_t> event_buffer(max_responses);
-    auto response_code = _client->async_read_response(event_buffer, max_responses);
+    std::vector<std::chrono::steady_clock::time_point> completed;
+    auto response_code = _client->async_read_response(event_buffer, max_responses, wait_mode, &completed);
     if (response_code != common::ResponseCode::Success)
     {
         return response_code;
@@ -53,6 +266,21 @@ common::ResponseCode S3::async_response(std::vector<common::backend_api::Respons
     for (unsigned i = 0; i < event_buffer.size(); ++i)
     {
         responses.emplace_back(event_buffer[i]);
+
+        const auto & response = responses.back();
+        auto it = _submitted.find(response.handle);
+        if (it != _submitted.end())
+        {
+            if (response.ret == common::ResponseCode::Success)
+            {
+                common::Metrics::read(it->second.backend, it->second.bytesize);
+                const auto end = std::max(completed[i], it->second.start);
+                common::Metrics::record(common::Metrics::Histogram::ChunkLatency, end - it->second.start);
+                common::Trace::span("object_request", it->second.start, end, it->second.bytesize);
+            }
+            common::Metrics::add(common::Metrics::Counter::InflightRequests, -1);
+            _submitted.erase(it);
+        }
     }
     return common::ResponseCode::Success;
 }
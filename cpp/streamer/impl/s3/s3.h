@@ -1,11 +1,22 @@
 #pragma once
 
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <map>
 #include <memory>
+#include <mutex>
+#include <optional>
+#include <thread>
 #include <vector>
 
+#include "common/metrics/metrics.h"
+#include "common/trace/trace.h"
 #include "common/s3_wrapper/s3_wrapper.h"
 #include "streamer/impl/reader/reader.h"
 #include "streamer/impl/config/config.h"
+#include "streamer/impl/bandwidth/bandwidth.h"
+#include "streamer/impl/cancellation/cancellation.h"
 
 namespace runai::llm::streamer::impl
 {
@@ -26,18 +37,72 @@ struct S3Stop
 
 struct S3 : Reader
 {
-    S3(std::shared_ptr<common::s3::S3ClientWrapper> client, const Config & config);
-    virtual ~S3() {}
+    // requests are submitted once the node bandwidth limit allows them, if there is a limit
+    // with a notification, requests which exceed the limit are deferred instead of waiting, and the notification is called once they are due,
+    // so that the caller polls and the deferred requests are submitted without occupying the calling thread in the meantime
+    S3(std::shared_ptr<common::s3::S3ClientWrapper> client, const Config & config, std::shared_ptr<Bandwidth> bandwidth = nullptr, std::shared_ptr<Cancellation> cancellation = nullptr, common::backend_api::ObjectCompletionNotification_t notification = nullptr, void * context = nullptr);
+    virtual ~S3();
 
     void read(size_t bytesize, char * buffer) override;
     void seek(size_t offset) override;
 
     void async_read(const common::s3::S3ClientWrapper::Params & params, common::backend_api::ObjectRequestId_t request_handle, const common::Range & range, char * buffer) override;
-    common::ResponseCode async_response(std::vector<common::backend_api::Response> & responses, unsigned max_responses) override;
+    common::ResponseCode async_response(std::vector<common::backend_api::Response> & responses, unsigned max_responses, common::backend_api::ObjectWaitMode_t wait_mode) override;
+
+    // a waiting process touches the bandwidth limit at this interval, to keep its share
+    static constexpr std::chrono::milliseconds touch_interval = std::chrono::milliseconds(100);
 
  private:
+    void submit(const common::s3::S3ClientWrapper::Params & params, common::backend_api::ObjectRequestId_t request_handle, const common::Range & range, char * buffer);
+
+    // submits the deferred requests which are due, or waits for all of them in blocking mode
+    void submit_deferred(std::vector<common::backend_api::Response> & responses, common::backend_api::ObjectWaitMode_t wait_mode);
+
+    // drops the deferred requests, and returns their tokens to the bandwidth limit
+    void drop_deferred();
+
+    // calls the notification once the deferred request is due
+    void schedule(Bandwidth::Clock::time_point due);
+    void run_timer();
+
+    bool stopped() const;
+
     std::shared_ptr<common::s3::S3ClientWrapper> _client;
     const Config & _config;
+    std::shared_ptr<Bandwidth> _bandwidth;
+    std::shared_ptr<Cancellation> _cancellation;
+
+    // submitted requests, for recording their latency in the metrics
+    struct Submitted
+    {
+        std::chrono::steady_clock::time_point start;
+        common::Metrics::Backend backend;
+        size_t bytesize;
+    };
+
+    std::map<common::backend_api::ObjectRequestId_t, Submitted> _submitted;
+
+    // requests waiting for the bandwidth limit, in the order of their due time
+    struct Deferred
+    {
+        common::s3::S3ClientWrapper::Params params;
+        common::backend_api::ObjectRequestId_t request_handle;
+        common::Range range;
+        char * buffer;
+        Bandwidth::Clock::time_point due;
+    };
+
+    std::deque<Deferred> _deferred;
+
+    common::backend_api::ObjectCompletionNotification_t _notification;
+    void * _context;
+
+    // timer of the deferred requests, which is started once a request is deferred
+    std::mutex _mutex;
+    std::condition_variable _cv;
+    std::optional<Bandwidth::Clock::time_point> _due;
+    bool _stop = false;
+    std::thread _timer;
 };
 
 }; //namespace runai::llm::streamer::impl
@@ -0,0 +1,257 @@
+#include "streamer/impl/scheduler/scheduler.h"
+
+#include <algorithm>
+#include <atomic>
+#include <memory>
+#include <utility>
+
+#include "common/metrics/metrics.h"
+#include "utils/logging/logging.h"
+
+namespace runai::llm::streamer::impl
+{
+
+Scheduler::Queue::Queue(std::shared_ptr<Scheduler> scheduler, unsigned weight, bool background) :
+    _scheduler(scheduler),
+    _background(background),
+    _weight(weight)
+{
+    ASSERT(weight) << "Scheduling weight must be a positive number";
+}
+
+Scheduler::Queue::~Queue()
+{
+    try
+    {
+        auto lock = std::unique_lock<std::mutex>(_scheduler->_mutex);
+        if (_pending.size())
+        {
+            LOG(DEBUG) << "Dropping " << _pending.size() << " pending jobs";
+        }
+        common::Metrics::add(common::Metrics::Counter::QueuedJobs, -static_cast<int64_t>(_pending.size()));
+        _pending.clear();
+        _scheduler->_queues.erase(this);
+
+        _scheduler->_cv.wait(lock, [&]() { return _running == 0; });
+    }
+    catch (...)
+    {}
+}
+
+void Scheduler::Queue::push(Job && job, size_t cost, Job && drop)
+{
+    // a job which throws is released by the worker
+    push_async([job = std::move(job)](Done && done)
+        {
+            job();
+            done();
+        }, cost, std::move(drop));
+}
+
+void Scheduler::Queue::push_async(AsyncJob && job, size_t cost, Job && drop)
+{
+    {
+        const auto lock = std::unique_lock<std::mutex>(_scheduler->_mutex);
+
+        // an idle queue starts from the current virtual time, and does not accumulate a share while it is idle
+        const double start = std::max(_scheduler->_time, _finish);
+        _finish = start + static_cast<double>(std::max<size_t>(cost, 1)) / _weight;
+        _pending.push_back(Pending{ start, std::move(job), std::move(drop) });
+    }
+
+    common::Metrics::add(common::Metrics::Counter::QueuedJobs);
+
+    _scheduler->_cv.notify_all();
+}
+
+size_t Scheduler::Queue::clear()
+{
+    std::deque<Pending> dropped;
+    {
+        const auto lock = std::unique_lock<std::mutex>(_scheduler->_mutex);
+        dropped.swap(_pending);
+    }
+    common::Metrics::add(common::Metrics::Counter::QueuedJobs, -static_cast<int64_t>(dropped.size()));
+
+    // the drop handlers are called outside the lock, since they may push jobs or wait for other queues
+    for (auto & pending : dropped)
+    {
+        if (pending.drop)
+        {
+            try
+            {
+                pending.drop();
+            }
+            catch (...)
+            {
+                LOG(WARNING) << "Failed handling dropped job";
+            }
+        }
+    }
+    return dropped.size();
+}
+
+void Scheduler::Queue::set_weight(unsigned weight)
+{
+    ASSERT(weight) << "Scheduling weight must be a positive number";
+
+    const auto lock = std::unique_lock<std::mutex>(_scheduler->_mutex);
+    _weight = weight;
+}
+
+unsigned Scheduler::Queue::weight() const
+{
+    const auto lock = std::unique_lock<std::mutex>(_scheduler->_mutex);
+    return _weight;
+}
+
+size_t Scheduler::Queue::size() const
+{
+    const auto lock = std::unique_lock<std::mutex>(_scheduler->_mutex);
+    return _pending.size();
+}
+
+void Scheduler::Queue::grow(unsigned workers)
+{
+    const auto lock = std::unique_lock<std::mutex>(_scheduler->_mutex);
+    _scheduler->grow(workers);
+}
+
+Scheduler::~Scheduler()
+{
+    {
+        const auto lock = std::unique_lock<std::mutex>(_mutex);
+        _stopped = true;
+    }
+
+    _cv.notify_all();
+
+    // join the workers
+    _threads.clear();
+}
+
+std::shared_ptr<Scheduler> Scheduler::instance()
+{
+    static std::mutex mutex;
+    static std::weak_ptr<Scheduler> instance;
+
+    const auto lock = std::unique_lock<std::mutex>(mutex);
+    auto scheduler = instance.lock();
+    if (scheduler == nullptr)
+    {
+        scheduler = std::make_shared<Scheduler>();
+        instance = scheduler;
+    }
+    return scheduler;
+}
+
+std::unique_ptr<Scheduler::Queue> Scheduler::queue(std::shared_ptr<Scheduler> scheduler, unsigned weight, unsigned workers, bool background)
+{
+    ASSERT(scheduler != nullptr) << "Scheduler is not initialized";
+
+    auto queue = std::unique_ptr<Queue>(new Queue(scheduler, weight, background));
+
+    const auto lock = std::unique_lock<std::mutex>(scheduler->_mutex);
+    scheduler->_queues.insert(queue.get());
+    scheduler->grow(workers);
+
+    return queue;
+}
+
+void Scheduler::grow(unsigned workers)
+{
+    if (_threads.size() < workers)
+    {
+        LOG(DEBUG) << "Adding " << workers - _threads.size() << " workers to the scheduler of " << _queues.size() << " queues";
+        while (_threads.size() < workers)
+        {
+            _threads.emplace_back([this]() { routine(); });
+        }
+    }
+}
+
+unsigned Scheduler::workers() const
+{
+    const auto lock = std::unique_lock<std::mutex>(_mutex);
+    return _threads.size();
+}
+
+Scheduler::Queue * Scheduler::next()
+{
+    Queue * selected = nullptr;
+    for (auto queue : _queues)
+    {
+        if (queue->_pending.empty() || (selected != nullptr && queue->_background && !selected->_background))
+        {
+            continue;
+        }
+
+        if (selected == nullptr || (selected->_background && !queue->_background) || queue->_pending.front().start < selected->_pending.front().start)
+        {
+            selected = queue;
+        }
+    }
+    return selected;
+}
+
+void Scheduler::routine()
+{
+    auto lock = std::unique_lock<std::mutex>(_mutex);
+    while (true)
+    {
+        Queue * queue = nullptr;
+        _cv.wait(lock, [&]() { return _stopped || (_busy < _threads.size() && (queue = next()) != nullptr); });
+        if (_stopped)
+        {
+            return;
+        }
+
+        auto pending = std::move(queue->_pending.front());
+        queue->_pending.pop_front();
+        ++queue->_running;
+        ++_busy;
+        common::Metrics::add(common::Metrics::Counter::QueuedJobs, -1);
+
+        // background jobs do not advance the virtual time of the other queues
+        if (!queue->_background)
+        {
+            _time = pending.start;
+        }
+
+        lock.unlock();
+
+        auto released = std::make_shared<std::atomic<bool>>(false);
+        Done done = [this, queue, released]()
+        {
+            if (!released->exchange(true))
+            {
+                release(queue);
+            }
+        };
+
+        try
+        {
+            pending.job(Done(done));
+        }
+        catch (...)
+        {
+            LOG(WARNING) << "Failed handling job";
+            done();
+        }
+        pending.job = nullptr;
+        pending.drop = nullptr;
+        lock.lock();
+    }
+}
+
+void Scheduler::release(Queue * queue)
+{
+    {
+        const auto lock = std::unique_lock<std::mutex>(_mutex);
+        --queue->_running;
+        --_busy;
+    }
+    _cv.notify_all();
+}
+
+}; // namespace runai::llm::streamer::impl
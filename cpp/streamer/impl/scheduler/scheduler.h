@@ -0,0 +1,123 @@
+#pragma once
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <utility>
+#include <vector>
+
+#include "utils/thread/thread.h"
+
+namespace runai::llm::streamer::impl
+{
+
+// Worker pool shared by the streamers of a process, with weighted fair queuing between them
+//
+// Each streamer pushes its jobs to its own queue, and the workers take the next job from the queue which is most behind its weighted share,
+// so that concurrent requests share the workers in proportion to the weights of their streamers, and a streamer which is alone uses all the workers
+// The share of a job is its cost (e.g. the bytesize of a slice of a workload), so that a queue of large jobs does not take more than its weight
+// Jobs are not preempted, so their cost should be bounded - a long task is pushed as a sequence of jobs, each pushing the next once it ends
+// Jobs of background queues (e.g. prefetching) are taken only while no other queue has pending jobs
+//
+// An asynchronous job holds its worker until it calls its done handler, but not the thread of the worker,
+// e.g. a slice of an event driven workload which holds its worker until its responses arrive
+//
+// The number of workers is the largest number requested by the queues, and is not multiplied by the number of streamers
+
+struct Scheduler
+{
+    using Job = std::function<void()>;
+
+    // releases the worker of an asynchronous job, and may be called from any thread - calls after the first are ignored
+    using Done = std::function<void()>;
+    using AsyncJob = std::function<void(Done && done)>;
+
+    struct Queue
+    {
+        // pending jobs are dropped (without calling their drop handlers), and returns once the running jobs have finished
+        ~Queue();
+
+        // the drop handler, if any, is called instead of the job if it is dropped by clear()
+        void push(Job && job, size_t cost, Job && drop = nullptr);
+
+        // the worker is released when the job calls its done handler, or if the job throws
+        void push_async(AsyncJob && job, size_t cost, Job && drop = nullptr);
+
+        // drops the pending jobs and calls their drop handlers, and returns their number
+        size_t clear();
+
+        // the weight applies to the following jobs
+        void set_weight(unsigned weight);
+        unsigned weight() const;
+
+        // number of pending jobs
+        size_t size() const;
+
+        // adds workers to the scheduler up to the given number, e.g. for a request which reads with more workers
+        void grow(unsigned workers);
+
+     private:
+        friend struct Scheduler;
+
+        Queue(std::shared_ptr<Scheduler> scheduler, unsigned weight, bool background);
+
+        std::shared_ptr<Scheduler> _scheduler;
+        const bool _background;
+
+        // guarded by the mutex of the scheduler
+
+        unsigned _weight;
+        // virtual finish time of the last job pushed
+        double _finish = 0;
+        struct Pending
+        {
+            // virtual start time
+            double start;
+            AsyncJob job;
+            Job drop;
+        };
+
+        // pending jobs by their virtual start time
+        std::deque<Pending> _pending;
+        // jobs which hold a worker
+        unsigned _running = 0;
+    };
+
+    Scheduler() = default;
+    ~Scheduler();
+
+    // the scheduler shared by the streamers of the process, which is destroyed with the last of them
+    static std::shared_ptr<Scheduler> instance();
+
+    // creates a queue, and adds workers up to the given number
+    static std::unique_ptr<Queue> queue(std::shared_ptr<Scheduler> scheduler, unsigned weight, unsigned workers, bool background = false);
+
+    unsigned workers() const;
+
+ private:
+    void routine();
+
+    // the queue of the pending job with the earliest virtual start time, preferring queues which are not in the background
+    Queue * next();
+
+    // adds workers up to the given number, while holding the mutex
+    void grow(unsigned workers);
+
+    // releases the worker of a job of the queue
+    void release(Queue * queue);
+
+    mutable std::mutex _mutex;
+    std::condition_variable _cv;
+    bool _stopped = false;
+    std::set<Queue *> _queues;
+    // virtual start time of the last job taken
+    double _time = 0;
+    // jobs which hold a worker, where asynchronous jobs may hold one without its thread
+    unsigned _busy = 0;
+    std::vector<utils::Thread> _threads;
+};
+
+}; // namespace runai::llm::streamer::impl
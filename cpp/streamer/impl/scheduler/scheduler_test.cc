@@ -0,0 +1,285 @@
+#include "streamer/impl/scheduler/scheduler.h"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+#include "utils/random/random.h"
+
+namespace runai::llm::streamer::impl
+{
+
+namespace
+{
+
+bool wait_for(const std::function<bool()> & condition)
+{
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+    while (!condition())
+    {
+        if (std::chrono::steady_clock::now() > deadline)
+        {
+            return false;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    return true;
+}
+
+} // namespace
+
+TEST(Scheduler, Sanity)
+{
+    const auto workers = utils::random::number(1, 8);
+    const auto jobs = utils::random::number(1, 100);
+
+    auto scheduler = std::make_shared<Scheduler>();
+    std::atomic<unsigned> handled = 0;
+    auto queue = Scheduler::queue(scheduler, 1, workers);
+    EXPECT_EQ(scheduler->workers(), workers);
+
+    for (unsigned i = 0; i < jobs; ++i)
+    {
+        queue->push([&]() { ++handled; }, utils::random::number(0, 1000));
+    }
+
+    EXPECT_TRUE(wait_for([&]() { return handled == jobs; }));
+    EXPECT_EQ(queue->size(), 0);
+}
+
+TEST(Scheduler, Clear)
+{
+    auto scheduler = std::make_shared<Scheduler>();
+    auto queue = Scheduler::queue(scheduler, 1, 1);
+
+    std::promise<void> release;
+    auto released = release.get_future().share();
+    std::atomic<int> handled = 0;
+    std::atomic<unsigned> dropped = 0;
+    auto job = [&]() { released.wait(); ++handled; };
+
+    const auto jobs = utils::random::number(2, 10);
+    for (unsigned i = 0; i < jobs; ++i)
+    {
+        queue->push(job, 1, [&]() { ++dropped; });
+    }
+    ASSERT_TRUE(wait_for([&]() { return queue->size() == jobs - 1; }));
+
+    // the running job is not dropped, and the dropped jobs are handled by the caller
+    EXPECT_EQ(queue->clear(), jobs - 1);
+    EXPECT_EQ(queue->size(), 0);
+    EXPECT_EQ(dropped, jobs - 1);
+
+    release.set_value();
+    EXPECT_TRUE(wait_for([&]() { return handled == 1; }));
+    EXPECT_EQ(dropped, jobs - 1);
+}
+
+TEST(Scheduler, Shared_Workers)
+{
+    auto scheduler = std::make_shared<Scheduler>();
+    auto first = Scheduler::queue(scheduler, 1, 3);
+    auto second = Scheduler::queue(scheduler, 1, 5);
+    auto third = Scheduler::queue(scheduler, 1, 2, true);
+
+    EXPECT_EQ(scheduler->workers(), 5);
+
+    // a queue may add workers later, and never removes them
+    first->grow(8);
+    EXPECT_EQ(scheduler->workers(), 8);
+    second->grow(4);
+    EXPECT_EQ(scheduler->workers(), 8);
+}
+
+TEST(Scheduler, Instance)
+{
+    auto scheduler = Scheduler::instance();
+    EXPECT_EQ(Scheduler::instance(), scheduler);
+}
+
+TEST(Scheduler, Weights)
+{
+    auto scheduler = std::make_shared<Scheduler>();
+
+    std::mutex mutex;
+    std::vector<int> order;
+    auto record = [&](int id) { const auto lock = std::unique_lock<std::mutex>(mutex); order.push_back(id); };
+
+    // occupy the single worker until both queues are full
+    std::promise<void> release;
+    auto released = release.get_future().share();
+    std::atomic<bool> blocking = false;
+    auto blocker = Scheduler::queue(scheduler, 1, 1);
+
+    auto heavy = Scheduler::queue(scheduler, 3, 1);
+    auto light = Scheduler::queue(scheduler, 1, 1);
+    EXPECT_EQ(heavy->weight(), 3);
+    EXPECT_EQ(scheduler->workers(), 1);
+
+    blocker->push([&]() { blocking = true; released.wait(); }, 1);
+    ASSERT_TRUE(wait_for([&]() { return blocking.load(); }));
+
+    // jobs of the same cost
+    const auto cost = utils::random::number(1, 1000);
+    constexpr int jobs = 12;
+    for (int i = 0; i < jobs; ++i)
+    {
+        heavy->push([&]() { record(3); }, cost);
+        light->push([&]() { record(1); }, cost);
+    }
+
+    release.set_value();
+    ASSERT_TRUE(wait_for([&]() { const auto lock = std::unique_lock<std::mutex>(mutex); return order.size() == 2 * jobs; }));
+
+    // the heavy queue takes three jobs for every job of the light queue
+    const auto heavy_first = std::count(order.begin(), order.begin() + 8, 3);
+    EXPECT_GE(heavy_first, 5);
+    EXPECT_LE(heavy_first, 7);
+}
+
+TEST(Scheduler, Slices)
+{
+    auto scheduler = std::make_shared<Scheduler>();
+
+    std::mutex mutex;
+    std::vector<int> order;
+    auto record = [&](int id) { const auto lock = std::unique_lock<std::mutex>(mutex); order.push_back(id); };
+
+    // a long task of a light queue which started first, pushed as a sequence of slices
+    auto light = Scheduler::queue(scheduler, 1, 1);
+    auto heavy = Scheduler::queue(scheduler, 3, 1);
+    constexpr int slices = 40;
+    std::atomic<bool> heavy_pushed = false;
+    std::function<void(int)> slice = [&](int remaining)
+    {
+        record(1);
+        if (remaining == slices - 2)
+        {
+            ASSERT_TRUE(wait_for([&]() { return heavy_pushed.load(); }));
+        }
+
+        if (remaining > 1)
+        {
+            light->push([&, remaining]() { slice(remaining - 1); }, 1);
+        }
+    };
+    light->push([&]() { slice(slices); }, 1);
+
+    // the heavy queue takes the worker between the slices of the light queue, rather than after all of them
+    constexpr int jobs = 6;
+    for (int i = 0; i < jobs; ++i)
+    {
+        heavy->push([&]() { record(3); }, 1);
+    }
+    heavy_pushed = true;
+
+    ASSERT_TRUE(wait_for([&]() { const auto lock = std::unique_lock<std::mutex>(mutex); return order.size() == slices + jobs; }));
+    const auto last_heavy = std::find(order.rbegin(), order.rend(), 3).base() - order.begin();
+    EXPECT_LT(last_heavy, jobs + 6);
+}
+
+TEST(Scheduler, Async)
+{
+    auto scheduler = std::make_shared<Scheduler>();
+    auto queue = Scheduler::queue(scheduler, 1, 1);
+
+    // the asynchronous job returns without releasing its worker
+    std::mutex mutex;
+    Scheduler::Done release;
+    queue->push_async([&](Scheduler::Done && done)
+        {
+            const auto lock = std::unique_lock<std::mutex>(mutex);
+            release = std::move(done);
+        }, 1);
+    ASSERT_TRUE(wait_for([&]() { const auto lock = std::unique_lock<std::mutex>(mutex); return release != nullptr; }));
+
+    std::atomic<bool> handled = false;
+    queue->push([&]() { handled = true; }, 1);
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    EXPECT_FALSE(handled);
+
+    // the worker is released once, by the first call
+    release();
+    release();
+    EXPECT_TRUE(wait_for([&]() { return handled.load(); }));
+
+    // a job which throws releases its worker
+    queue->push_async([](Scheduler::Done &&) { throw std::runtime_error("failed"); }, 1);
+    handled = false;
+    queue->push([&]() { handled = true; }, 1);
+    EXPECT_TRUE(wait_for([&]() { return handled.load(); }));
+}
+
+TEST(Scheduler, Queue_Destroyed)
+{
+    auto scheduler = std::make_shared<Scheduler>();
+
+    std::promise<void> release;
+    auto released = release.get_future().share();
+    std::atomic<int> started = 0;
+    std::atomic<bool> finished = false;
+    auto queue = Scheduler::queue(scheduler, 1, 1);
+
+    auto job = [&]() { ++started; released.wait(); finished = true; };
+    queue->push(job, 1);
+    queue->push(job, 1);
+    ASSERT_TRUE(wait_for([&]() { return started == 1; }));
+
+    // the destruction waits for the running job, and drops the pending one
+    std::atomic<bool> destroyed = false;
+    std::thread destroyer([&]() { queue.reset(); destroyed = true; });
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    EXPECT_FALSE(destroyed);
+
+    release.set_value();
+    destroyer.join();
+    EXPECT_TRUE(finished);
+    EXPECT_EQ(started, 1);
+}
+
+TEST(Scheduler, Background)
+{
+    auto scheduler = std::make_shared<Scheduler>();
+
+    std::mutex mutex;
+    std::vector<int> order;
+    auto record = [&](int id) { const auto lock = std::unique_lock<std::mutex>(mutex); order.push_back(id); };
+
+    std::promise<void> release;
+    auto released = release.get_future().share();
+    std::atomic<bool> blocking = false;
+    auto blocker = Scheduler::queue(scheduler, 1, 1);
+    auto background = Scheduler::queue(scheduler, utils::random::number(1, 100), 1, true);
+    auto foreground = Scheduler::queue(scheduler, 1, 1);
+
+    blocker->push([&]() { blocking = true; released.wait(); }, 1);
+    ASSERT_TRUE(wait_for([&]() { return blocking.load(); }));
+
+    // background jobs wait for all the foreground jobs, even if pushed first
+    constexpr int jobs = 5;
+    for (int i = 0; i < jobs; ++i)
+    {
+        background->push([&]() { record(0); }, 1);
+    }
+    for (int i = 0; i < jobs; ++i)
+    {
+        foreground->push([&]() { record(1); }, utils::random::number(1, 1000000));
+    }
+
+    release.set_value();
+    ASSERT_TRUE(wait_for([&]() { const auto lock = std::unique_lock<std::mutex>(mutex); return order.size() == 2 * jobs; }));
+
+    EXPECT_EQ(std::count(order.begin(), order.begin() + jobs, 1), jobs);
+}
+
+}; // namespace runai::llm::streamer::impl
@@ -0,0 +1,339 @@
+#include "streamer/impl/shared/shared.h"
+
+#include <algorithm>
+#include <iterator>
+#include <utility>
+
+#include "common/exception/exception.h"
+
+#include "utils/logging/logging.h"
+
+namespace runai::llm::streamer::impl
+{
+
+Shared::Shared(std::shared_ptr<Reader> reader, std::shared_ptr<Dedup> dedup, Version version, std::shared_ptr<Cancellation> cancellation, common::backend_api::ObjectCompletionNotification_t notification, void * context, std::shared_ptr<Notifier> notifier) :
+    Reader(Reader::Mode::Async),
+    _reader(reader),
+    _dedup(dedup),
+    _version(version),
+    _cancellation(cancellation),
+    _notification(notification),
+    _context(context),
+    _notifier(notifier)
+{
+    ASSERT(_reader != nullptr && _dedup != nullptr) << "Creating a shared reader without a reader or a deduplication";
+}
+
+Shared::~Shared()
+{
+    try
+    {
+        {
+            const auto guard = std::unique_lock<std::mutex>(_mutex);
+            _stop = true;
+        }
+        _cv.notify_all();
+
+        if (_thread.joinable())
+        {
+            _thread.join();
+        }
+
+        // ranges which were not read are not going to be published
+        for (auto & [handle, request] : _forwarded)
+        {
+            if (request.segment != nullptr)
+            {
+                request.segment->fail();
+            }
+        }
+    }
+    catch (...)
+    {}
+}
+
+void Shared::seek(size_t offset)
+{
+    LOG(ERROR) << "Not implemented";
+    throw common::Exception(common::ResponseCode::UnknownError);
+}
+
+void Shared::read(size_t bytesize, char * buffer)
+{
+    LOG(ERROR) << "Not implemented";
+    throw common::Exception(common::ResponseCode::UnknownError);
+}
+
+const std::optional<std::string> & Shared::key(const common::s3::S3ClientWrapper::Params & params)
+{
+    auto it = _keys.find(params.uri->uri);
+    if (it != _keys.end())
+    {
+        return it->second;
+    }
+
+    std::optional<std::string> key;
+    const auto version = _version(params);
+    if (version.has_value())
+    {
+        key = params.credentials.endpoint.value_or("") + "\n" + params.uri->uri + "\n" + version.value();
+    }
+    else
+    {
+        LOG(DEBUG) << "Not sharing " << params.uri->uri << " of unknown version";
+    }
+
+    return _keys.emplace(params.uri->uri, std::move(key)).first->second;
+}
+
+void Shared::async_read(const common::s3::S3ClientWrapper::Params & params, common::backend_api::ObjectRequestId_t request_handle, const common::Range & range, char * buffer)
+{
+    Request request { "", params, request_handle, range, buffer, nullptr };
+
+    const auto & object = key(params);
+    if (object.has_value() && range.size > 0)
+    {
+        request.key = object.value() + "\n" + std::to_string(range.start) + "\n" + std::to_string(range.size);
+
+        // wait for the range if another process is already reading it
+        request.segment = _dedup->publish(request.key, range.size);
+        if (request.segment == nullptr && (request.segment = _dedup->wait(request.key, range.size)) != nullptr)
+        {
+            {
+                const auto guard = std::unique_lock<std::mutex>(_mutex);
+                _incoming.push_back(std::move(request));
+                if (!_thread.joinable())
+                {
+                    _thread = std::thread([this]() { run(); });
+                }
+            }
+            _cv.notify_one();
+            ++_waiting;
+            return;
+        }
+    }
+
+    forward(std::move(request));
+}
+
+void Shared::forward(Request && request)
+{
+    try
+    {
+        _reader->async_read(request.params, request.handle, request.range, request.buffer);
+    }
+    catch (...)
+    {
+        if (request.segment != nullptr)
+        {
+            request.segment->fail();
+        }
+        throw;
+    }
+
+    const auto handle = request.handle;
+    _forwarded.emplace(handle, std::move(request));
+}
+
+void Shared::handle(Waited & waited, std::vector<common::backend_api::Response> & responses)
+{
+    --_waiting;
+
+    auto & request = waited.request;
+    switch (waited.outcome)
+    {
+        case Waited::Outcome::Copied:
+            responses.emplace_back(request.handle, common::ResponseCode::Success, request.range.size);
+            ++_copied;
+            break;
+
+        case Waited::Outcome::Failed:
+            LOG(DEBUG) << "Reading " << request.range << " of " << request.params.uri->uri << " since it was not published";
+            // another process might be waiting for the range too
+            request.segment = _dedup->publish(request.key, request.range.size);
+            forward(std::move(request));
+            break;
+
+        case Waited::Outcome::Canceled:
+            // canceled requests have no completion events
+            break;
+    }
+}
+
+void Shared::run()
+{
+    std::vector<Request> waiting;
+
+    while (true)
+    {
+        {
+            auto lock = std::unique_lock<std::mutex>(_mutex);
+            if (waiting.empty())
+            {
+                _cv.wait(lock, [&]() { return _stop || !_incoming.empty(); });
+            }
+
+            if (_stop)
+            {
+                return;
+            }
+
+            std::move(_incoming.begin(), _incoming.end(), std::back_inserter(waiting));
+            _incoming.clear();
+        }
+
+        const bool canceled = (_cancellation != nullptr && _cancellation->stopped());
+
+        std::vector<Waited> waited;
+        for (auto it = waiting.begin(); it != waiting.end();)
+        {
+            const auto state = it->segment->state();
+            if (canceled)
+            {
+                waited.push_back({ std::move(*it), Waited::Outcome::Canceled });
+            }
+            else if (state == Dedup::Segment::State::Ready)
+            {
+                it->segment->copy(it->buffer);
+                waited.push_back({ std::move(*it), Waited::Outcome::Copied });
+            }
+            else if (state == Dedup::Segment::State::Failed)
+            {
+                waited.push_back({ std::move(*it), Waited::Outcome::Failed });
+            }
+            else
+            {
+                ++it;
+                continue;
+            }
+            it = waiting.erase(it);
+        }
+
+        if (waited.empty())
+        {
+            waiting.front().segment->wait(poll_interval);
+            continue;
+        }
+
+        {
+            const auto guard = std::unique_lock<std::mutex>(_mutex);
+            std::move(waited.begin(), waited.end(), std::back_inserter(_waited));
+        }
+        _ready.notify_all();
+
+        if (_notifier != nullptr)
+        {
+            _notifier->notify();
+        }
+        else if (_notification != nullptr)
+        {
+            _notification(_context);
+        }
+    }
+}
+
+common::ResponseCode Shared::async_response(std::vector<common::backend_api::Response> & responses, unsigned max_responses, common::backend_api::ObjectWaitMode_t wait_mode)
+{
+    const auto initial = responses.size();
+
+    while (true)
+    {
+        std::vector<Waited> waited;
+        {
+            const auto guard = std::unique_lock<std::mutex>(_mutex);
+            const auto count = std::min<size_t>(max_responses - (responses.size() - initial), _waited.size());
+            std::move(_waited.begin(), _waited.begin() + count, std::back_inserter(waited));
+            _waited.erase(_waited.begin(), _waited.begin() + count);
+        }
+
+        for (auto & w : waited)
+        {
+            handle(w, responses);
+        }
+
+        if (_forwarded.empty() && _waiting == 0)
+        {
+            // no responses are expected
+            return responses.size() > initial ? common::ResponseCode::Success : common::ResponseCode::FinishedError;
+        }
+
+        if (!_forwarded.empty() && responses.size() - initial < max_responses)
+        {
+            // block only when there are no waited ranges nor ready responses
+            const auto mode = (wait_mode == common::backend_api::OBJECT_WAIT_MODE_BLOCK && _waiting == 0 && responses.size() == initial) ? common::backend_api::OBJECT_WAIT_MODE_BLOCK : common::backend_api::OBJECT_WAIT_MODE_NON_BLOCKING;
+
+            std::vector<common::backend_api::Response> ready;
+            const auto r = _reader->async_response(ready, max_responses - (responses.size() - initial), mode);
+            if (r != common::ResponseCode::Success)
+            {
+                // the requests in flight were canceled or stopped
+                return r;
+            }
+
+            for (const auto & response : ready)
+            {
+                auto it = _forwarded.find(response.handle);
+                if (it == _forwarded.end())
+                {
+                    LOG(WARNING) << "Received response of unknown request " << response.handle;
+                }
+                else
+                {
+                    auto & request = it->second;
+                    if (request.segment != nullptr)
+                    {
+                        const bool complete = (response.bytes_transferred == request.range.size);
+                        if (response.ret == common::ResponseCode::Success && complete)
+                        {
+                            request.segment->publish(request.buffer);
+                            ++_published;
+                        }
+                        else
+                        {
+                            request.segment->fail();
+                        }
+                    }
+                    _forwarded.erase(it);
+                }
+
+                responses.push_back(response);
+            }
+        }
+
+        if (responses.size() > initial || wait_mode == common::backend_api::OBJECT_WAIT_MODE_NON_BLOCKING)
+        {
+            return common::ResponseCode::Success;
+        }
+
+        // wait for the ranges published by other processes, and for the object storage reader if it has pending requests
+        if (!_forwarded.empty() && _notifier != nullptr)
+        {
+            // both notify once ready, including since they were last checked
+            _notifier->wait();
+            continue;
+        }
+
+        // without a notifier the object storage reader is polled
+        auto lock = std::unique_lock<std::mutex>(_mutex);
+        if (_forwarded.empty())
+        {
+            _ready.wait(lock, [&]() { return !_waited.empty(); });
+        }
+        else
+        {
+            _ready.wait_for(lock, reader_poll_interval, [&]() { return !_waited.empty(); });
+        }
+    }
+}
+
+size_t Shared::copied() const
+{
+    return _copied;
+}
+
+size_t Shared::published() const
+{
+    return _published;
+}
+
+}; // namespace runai::llm::streamer::impl
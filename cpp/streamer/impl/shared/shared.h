@@ -0,0 +1,123 @@
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "common/backend_api/object_storage/object_storage.h"
+#include "common/range/range.h"
+#include "common/s3_wrapper/s3_wrapper.h"
+#include "streamer/impl/cancellation/cancellation.h"
+#include "streamer/impl/dedup/dedup.h"
+#include "streamer/impl/notifier/notifier.h"
+#include "streamer/impl/reader/reader.h"
+
+namespace runai::llm::streamer::impl
+{
+
+// Reads object storage ranges once per node, sharing them between the processes of the node
+//
+// The first process to request a range reads it from the object storage and publishes it, and the other processes copy it once published
+// Published ranges are waited for by a background thread, which calls the notification whenever waited ranges are ready
+// With a notifier, which the object storage clients notify too, a blocking caller waits for both the published ranges and the object storage on the notifier
+// Ranges are read from the object storage if they cannot be shared, or if their publishing process failed
+// Objects are shared by their version, and objects without a known version are not shared
+
+struct Shared : Reader
+{
+    // the version of the object of the given parameters, which changes whenever the object is replaced
+    using Version = std::function<std::optional<std::string>(const common::s3::S3ClientWrapper::Params &)>;
+
+    // the notifier, if given, is notified instead of the notification and forwards to it
+    Shared(std::shared_ptr<Reader> reader, std::shared_ptr<Dedup> dedup, Version version, std::shared_ptr<Cancellation> cancellation = nullptr, common::backend_api::ObjectCompletionNotification_t notification = nullptr, void * context = nullptr, std::shared_ptr<Notifier> notifier = nullptr);
+    virtual ~Shared();
+
+    void read(size_t bytesize, char * buffer) override;
+    void seek(size_t offset) override;
+
+    void async_read(const common::s3::S3ClientWrapper::Params & params, common::backend_api::ObjectRequestId_t request_handle, const common::Range & range, char * buffer) override;
+    common::ResponseCode async_response(std::vector<common::backend_api::Response> & responses, unsigned max_responses, common::backend_api::ObjectWaitMode_t wait_mode) override;
+
+    // number of ranges which were copied from other processes
+    size_t copied() const;
+
+    // number of ranges which were published to other processes
+    size_t published() const;
+
+ private:
+    struct Request
+    {
+        // the object version and range, or empty if the range is not shared
+        std::string key;
+        common::s3::S3ClientWrapper::Params params;
+        common::backend_api::ObjectRequestId_t handle;
+        common::Range range;
+        char * buffer;
+        std::shared_ptr<Dedup::Segment> segment;
+    };
+
+    struct Waited
+    {
+        enum class Outcome
+        {
+            Copied,
+            Failed,
+            Canceled,
+        };
+
+        Request request;
+        Outcome outcome;
+    };
+
+    // the key of the object version, or none if its version is unknown
+    const std::optional<std::string> & key(const common::s3::S3ClientWrapper::Params & params);
+
+    // reads the range from the object storage, and publishes it once read if the request has a segment
+    void forward(Request && request);
+
+    void handle(Waited & waited, std::vector<common::backend_api::Response> & responses);
+
+    // background thread waiting for the published ranges
+    void run();
+
+    std::shared_ptr<Reader> _reader;
+    std::shared_ptr<Dedup> _dedup;
+    Version _version;
+    std::shared_ptr<Cancellation> _cancellation;
+    common::backend_api::ObjectCompletionNotification_t _notification;
+    void * _context;
+    std::shared_ptr<Notifier> _notifier;
+
+    std::map<std::string, std::optional<std::string>> _keys;
+
+    // requests read from the object storage
+    std::map<common::backend_api::ObjectRequestId_t, Request> _forwarded;
+    // number of requests waiting for ranges published by other processes
+    size_t _waiting = 0;
+
+    size_t _copied = 0;
+    size_t _published = 0;
+
+    // requests passed to the background thread, and the ranges it waited for
+    std::mutex _mutex;
+    std::condition_variable _cv;
+    std::condition_variable _ready;
+    std::vector<Request> _incoming;
+    std::vector<Waited> _waited;
+    bool _stop = false;
+    std::thread _thread;
+
+    // interval of checking whether the publishing processes are alive
+    static constexpr auto poll_interval = std::chrono::milliseconds(10);
+    // interval of polling the object storage reader while waiting for published ranges without a notifier
+    static constexpr auto reader_poll_interval = std::chrono::milliseconds(1);
+};
+
+}; // namespace runai::llm::streamer::impl
@@ -0,0 +1,290 @@
+#include "streamer/impl/shared/shared.h"
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <memory>
+#include <optional>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "common/exception/exception.h"
+#include "streamer/impl/reader/mock/mock.h"
+
+#include "utils/random/random.h"
+#include "utils/thread/thread.h"
+
+namespace runai::llm::streamer::impl
+{
+
+struct SharedTest : ::testing::Test
+{
+    SharedTest() :
+        params(std::make_shared<common::s3::StorageUri>("s3://bucket/" + utils::random::string()), 0),
+        version(utils::random::string())
+    {
+        const auto data = utils::random::buffer(utils::random::number(10000, 100000));
+        object.assign(data.begin(), data.end());
+    }
+
+    Shared::Version get_version() const
+    {
+        return [version = version](const common::s3::S3ClientWrapper::Params &) { return std::optional<std::string>(version); };
+    }
+
+    // requests the object in ranges and returns the number of requests
+    size_t request(Shared & shared, std::vector<char> & destination)
+    {
+        size_t requests = 0;
+        for (size_t start = 0; start < object.size(); start += range_size, ++requests)
+        {
+            shared.async_read(params, requests, common::Range(start, std::min(range_size, object.size() - start)), destination.data() + start);
+        }
+        return requests;
+    }
+
+    // waits for all the responses and returns their number
+    size_t drain(Shared & shared, common::ResponseCode expected = common::ResponseCode::Success)
+    {
+        size_t responses = 0;
+        while (true)
+        {
+            std::vector<common::backend_api::Response> ready;
+            const auto r = shared.async_response(ready, utils::random::number(1, 10), common::backend_api::OBJECT_WAIT_MODE_BLOCK);
+            if (r == common::ResponseCode::FinishedError)
+            {
+                break;
+            }
+            EXPECT_EQ(r, common::ResponseCode::Success);
+            for (const auto & response : ready)
+            {
+                EXPECT_EQ(response.ret, expected);
+            }
+            responses += ready.size();
+        }
+        return responses;
+    }
+
+    static constexpr size_t range_size = 1000;
+
+    common::s3::S3ClientWrapper::Params params;
+    std::string version;
+    std::vector<char> object;
+};
+
+TEST_F(SharedTest, Sanity)
+{
+    // each reader stands for another process
+    auto publisher_reader = std::make_shared<MockReader>(object);
+    Shared publisher(publisher_reader, std::make_shared<Dedup>(), get_version());
+    std::vector<char> published(object.size());
+    const auto requests = request(publisher, published);
+
+    auto waiter_reader = std::make_shared<MockReader>(object);
+    Shared waiter(waiter_reader, std::make_shared<Dedup>(), get_version());
+    std::vector<char> copied(object.size());
+    EXPECT_EQ(request(waiter, copied), requests);
+
+    EXPECT_EQ(drain(publisher), requests);
+    EXPECT_EQ(drain(waiter), requests);
+
+    EXPECT_EQ(published, object);
+    EXPECT_EQ(copied, object);
+
+    // the object was read once
+    EXPECT_EQ(publisher_reader->requests, requests);
+    EXPECT_EQ(waiter_reader->requests, 0);
+    EXPECT_EQ(publisher.published(), requests);
+    EXPECT_EQ(waiter.copied(), requests);
+}
+
+TEST_F(SharedTest, Published_Before_Request)
+{
+    auto publisher_reader = std::make_shared<MockReader>(object);
+    Shared publisher(publisher_reader, std::make_shared<Dedup>(), get_version());
+    std::vector<char> published(object.size());
+    const auto requests = request(publisher, published);
+    EXPECT_EQ(drain(publisher), requests);
+
+    // published ranges are kept while the publisher exists
+    auto waiter_reader = std::make_shared<MockReader>(object);
+    Shared waiter(waiter_reader, std::make_shared<Dedup>(), get_version());
+    std::vector<char> copied(object.size());
+    request(waiter, copied);
+    EXPECT_EQ(drain(waiter), requests);
+
+    EXPECT_EQ(copied, object);
+    EXPECT_EQ(waiter_reader->requests, 0);
+}
+
+TEST_F(SharedTest, Publisher_Failed)
+{
+    auto publisher_reader = std::make_shared<MockReader>(object, common::ResponseCode::FileAccessError);
+    Shared publisher(publisher_reader, std::make_shared<Dedup>(), get_version());
+    std::vector<char> published(object.size());
+    const auto requests = request(publisher, published);
+
+    auto waiter_reader = std::make_shared<MockReader>(object);
+    Shared waiter(waiter_reader, std::make_shared<Dedup>(), get_version());
+    std::vector<char> copied(object.size());
+    request(waiter, copied);
+
+    EXPECT_EQ(drain(publisher, common::ResponseCode::FileAccessError), requests);
+
+    // the waiter reads the ranges by itself
+    EXPECT_EQ(drain(waiter), requests);
+    EXPECT_EQ(copied, object);
+    EXPECT_EQ(waiter_reader->requests, requests);
+    EXPECT_EQ(waiter.copied(), 0);
+    EXPECT_EQ(waiter.published(), requests);
+}
+
+TEST_F(SharedTest, Publisher_Destroyed)
+{
+    auto waiter_reader = std::make_shared<MockReader>(object);
+    std::vector<char> copied(object.size());
+    auto waiter = std::make_unique<Shared>(waiter_reader, std::make_shared<Dedup>(), get_version());
+
+    size_t requests = 0;
+    {
+        Shared publisher(std::make_shared<MockReader>(object), std::make_shared<Dedup>(), get_version());
+        std::vector<char> published(object.size());
+        requests = request(publisher, published);
+        request(*waiter, copied);
+    }
+
+    EXPECT_EQ(drain(*waiter), requests);
+    EXPECT_EQ(copied, object);
+    EXPECT_EQ(waiter_reader->requests, requests);
+}
+
+TEST_F(SharedTest, Unknown_Version)
+{
+    Shared::Version unknown = [](const common::s3::S3ClientWrapper::Params &) { return std::nullopt; };
+
+    auto publisher_reader = std::make_shared<MockReader>(object);
+    Shared publisher(publisher_reader, std::make_shared<Dedup>(), unknown);
+    std::vector<char> published(object.size());
+    const auto requests = request(publisher, published);
+
+    auto waiter_reader = std::make_shared<MockReader>(object);
+    Shared waiter(waiter_reader, std::make_shared<Dedup>(), unknown);
+    std::vector<char> copied(object.size());
+    request(waiter, copied);
+
+    EXPECT_EQ(drain(publisher), requests);
+    EXPECT_EQ(drain(waiter), requests);
+    EXPECT_EQ(copied, object);
+    EXPECT_EQ(waiter_reader->requests, requests);
+    EXPECT_EQ(publisher.published(), 0);
+}
+
+TEST_F(SharedTest, Notification)
+{
+    std::atomic<unsigned> notifications = 0;
+    auto notify = [](void * context) { ++*static_cast<std::atomic<unsigned> *>(context); };
+
+    Shared publisher(std::make_shared<MockReader>(object), std::make_shared<Dedup>(), get_version());
+    std::vector<char> published(object.size());
+    const auto requests = request(publisher, published);
+
+    Shared waiter(std::make_shared<MockReader>(object), std::make_shared<Dedup>(), get_version(), nullptr, notify, &notifications);
+    std::vector<char> copied(object.size());
+    request(waiter, copied);
+
+    // nothing is ready before the ranges are published
+    std::vector<common::backend_api::Response> responses;
+    EXPECT_EQ(waiter.async_response(responses, requests, common::backend_api::OBJECT_WAIT_MODE_NON_BLOCKING), common::ResponseCode::Success);
+    EXPECT_TRUE(responses.empty());
+
+    drain(publisher);
+
+    // every notification is followed by polling the ready responses
+    while (responses.size() < requests)
+    {
+        while (notifications == 0)
+        {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        --notifications;
+        EXPECT_EQ(waiter.async_response(responses, requests, common::backend_api::OBJECT_WAIT_MODE_NON_BLOCKING), common::ResponseCode::Success);
+    }
+
+    EXPECT_EQ(responses.size(), requests);
+    EXPECT_EQ(copied, object);
+    EXPECT_EQ(waiter.async_response(responses, requests, common::backend_api::OBJECT_WAIT_MODE_NON_BLOCKING), common::ResponseCode::FinishedError);
+}
+
+TEST_F(SharedTest, Notifier)
+{
+    // completes its requests only once released, like a client which notifies when its responses are ready
+    struct ReleasedReader : MockReader
+    {
+        ReleasedReader(const std::vector<char> & object) : MockReader(object) {}
+
+        common::ResponseCode async_response(std::vector<common::backend_api::Response> & responses, unsigned max_responses, common::backend_api::ObjectWaitMode_t wait_mode) override
+        {
+            if (!released && !pending.empty())
+            {
+                return common::ResponseCode::Success;
+            }
+            return MockReader::async_response(responses, max_responses, wait_mode);
+        }
+
+        std::atomic<bool> released = false;
+    };
+
+    // the publisher reads the first half of the ranges
+    Shared publisher(std::make_shared<MockReader>(object), std::make_shared<Dedup>(), get_version());
+    std::vector<char> published(object.size());
+    const size_t half = (object.size() / range_size) / 2 * range_size;
+    size_t published_requests = 0;
+    for (size_t start = 0; start < half; start += range_size, ++published_requests)
+    {
+        publisher.async_read(params, published_requests, common::Range(start, range_size), published.data() + start);
+    }
+
+    // the waiter waits for the first half and reads the rest by itself
+    auto notifier = std::make_shared<Notifier>();
+    auto waiter_reader = std::make_shared<ReleasedReader>(object);
+    Shared waiter(waiter_reader, std::make_shared<Dedup>(), get_version(), nullptr, nullptr, nullptr, notifier);
+    std::vector<char> copied(object.size());
+    const auto requests = request(waiter, copied);
+
+    auto releasing = utils::Thread([&]()
+    {
+        std::this_thread::sleep_for(std::chrono::milliseconds(utils::random::number(10)));
+        EXPECT_EQ(drain(publisher), published_requests);
+
+        std::this_thread::sleep_for(std::chrono::milliseconds(utils::random::number(10)));
+        waiter_reader->released = true;
+        notifier->notify();
+    });
+
+    // a blocking caller is woken by both the published ranges and the object storage reader
+    EXPECT_EQ(drain(waiter), requests);
+    EXPECT_EQ(copied, object);
+    EXPECT_EQ(waiter.copied(), published_requests);
+
+    releasing.join();
+}
+
+TEST_F(SharedTest, Canceled)
+{
+    auto cancellation = std::make_shared<Cancellation>();
+
+    Shared publisher(std::make_shared<MockReader>(object), std::make_shared<Dedup>(), get_version());
+    std::vector<char> published(object.size());
+    request(publisher, published);
+
+    Shared waiter(std::make_shared<MockReader>(object), std::make_shared<Dedup>(), get_version(), cancellation);
+    std::vector<char> copied(object.size());
+    request(waiter, copied);
+
+    // the canceled ranges are not waited for anymore
+    cancellation->cancel();
+    EXPECT_EQ(drain(waiter), 0);
+}
+
+}; // namespace runai::llm::streamer::impl
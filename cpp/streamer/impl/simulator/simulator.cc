@@ -0,0 +1,435 @@
+#include "streamer/impl/simulator/simulator.h"
+
+#include <algorithm>
+#include <cmath>
+#include <deque>
+#include <functional>
+#include <map>
+#include <queue>
+#include <random>
+#include <sstream>
+#include <tuple>
+#include <utility>
+
+#include "common/exception/exception.h"
+#include "common/responder/responder.h"
+#include "common/s3_wrapper/s3_wrapper.h"
+#include "streamer/impl/assigner/assigner.h"
+#include "streamer/impl/batches/batches.h"
+
+#include "utils/logging/logging.h"
+
+namespace runai::llm::streamer::impl
+{
+
+namespace
+{
+
+// a file system block or an object storage chunk, which is transferred by a single request to the backend
+struct Block
+{
+    unsigned worker;
+    size_t bytesize;
+    // tasks which overlap the block, where a task is finished when all its blocks are transferred
+    std::vector<unsigned> tasks;
+};
+
+struct Event
+{
+    std::chrono::microseconds time;
+    unsigned lane;
+    unsigned block;
+
+    // the earliest event first, and events of the same time in the order of the lanes for reproducibility
+    bool operator>(const Event & other) const
+    {
+        return std::tie(time, lane) > std::tie(other.time, other.lane);
+    }
+};
+
+std::chrono::microseconds transfer(size_t bytesize, size_t bandwidth)
+{
+    if (bandwidth == 0)
+    {
+        return std::chrono::microseconds(0);
+    }
+    return std::chrono::microseconds(static_cast<long>(std::ceil(bytesize * 1e6 / bandwidth)));
+}
+
+// planned reads of a model - the blocks of the workers and the counters of the tasks and the requests
+struct Plan
+{
+    unsigned add_task(unsigned file_index, unsigned index)
+    {
+        const auto key = std::make_pair(file_index, index);
+        auto it = request_ids.find(key);
+        if (it == request_ids.end())
+        {
+            it = request_ids.emplace(key, request_tasks.size()).first;
+            request_tasks.push_back(0);
+        }
+
+        ++request_tasks[it->second];
+        task_request.push_back(it->second);
+        task_blocks.push_back(0);
+        return task_request.size() - 1;
+    }
+
+    void add_block(unsigned worker, size_t bytesize, std::vector<unsigned> && tasks)
+    {
+        for (auto task : tasks)
+        {
+            ++task_blocks[task];
+        }
+        blocks.push_back(Block{worker, bytesize, std::move(tasks)});
+    }
+
+    // the file system is read sequentially in blocks, where a task is finished by the last block it overlaps
+    void plan_blocks(const Batch & batch, unsigned first_task, size_t block_bytesize)
+    {
+        unsigned t = 0;
+        for (size_t offset = batch.range.start; offset < batch.range.end; offset += block_bytesize)
+        {
+            const size_t end = std::min(offset + block_bytesize, batch.range.end);
+            std::vector<unsigned> tasks;
+            for (unsigned i = t; i < batch.tasks.size() && batch.tasks[i].info.offset < end; ++i)
+            {
+                tasks.push_back(first_task + i);
+            }
+            while (t < batch.tasks.size() && batch.tasks[t].info.end <= end)
+            {
+                ++t;
+            }
+            add_block(batch.worker_index, end - offset, std::move(tasks));
+        }
+    }
+
+    // every object storage task is requested separately, and the client splits it into chunks
+    void plan_chunks(const Batch & batch, unsigned first_task, size_t chunk_bytesize, bool coalesce)
+    {
+        unsigned t = 0;
+        while (t < batch.tasks.size())
+        {
+            const auto & info = batch.tasks[t].info;
+            if (coalesce && info.bytesize < chunk_bytesize)
+            {
+                const size_t start = info.offset;
+                size_t bytesize = 0;
+                std::vector<unsigned> tasks;
+                while (t < batch.tasks.size() && batch.tasks[t].info.offset == start + bytesize && bytesize + batch.tasks[t].info.bytesize <= chunk_bytesize)
+                {
+                    bytesize += batch.tasks[t].info.bytesize;
+                    tasks.push_back(first_task + t);
+                    ++t;
+                }
+                add_block(batch.worker_index, bytesize, std::move(tasks));
+                continue;
+            }
+
+            for (size_t offset = info.offset; offset < info.end; offset += chunk_bytesize)
+            {
+                add_block(batch.worker_index, std::min(chunk_bytesize, info.end - offset), {first_task + t});
+            }
+            ++t;
+        }
+    }
+
+    std::vector<Block> blocks;
+    std::vector<unsigned> task_blocks;
+    std::vector<unsigned> task_request;
+    std::vector<unsigned> request_tasks;
+    // requests in the order of the files
+    std::map<std::pair<unsigned, unsigned>, unsigned> request_ids;
+};
+
+} // namespace
+
+Layout Layout::synthetic(unsigned seed, unsigned num_files, unsigned num_tensors, size_t median_bytesize, double sigma)
+{
+    ASSERT(num_files && num_tensors && median_bytesize) << "Synthetic layout must have files and tensors";
+
+    std::mt19937_64 engine(seed);
+    std::lognormal_distribution<double> distribution(std::log(static_cast<double>(median_bytesize)), sigma);
+
+    Layout layout;
+    layout.files.resize(num_files);
+    for (auto & file : layout.files)
+    {
+        for (unsigned i = 0; i < num_tensors; ++i)
+        {
+            file.push_back(std::max<size_t>(1, static_cast<size_t>(distribution(engine))));
+        }
+    }
+    return layout;
+}
+
+size_t Layout::bytesize() const
+{
+    size_t result = 0;
+    for (const auto & file : files)
+    {
+        for (auto bytesize : file)
+        {
+            result += bytesize;
+        }
+    }
+    return result;
+}
+
+size_t Layout::tensors() const
+{
+    size_t result = 0;
+    for (const auto & file : files)
+    {
+        result += file.size();
+    }
+    return result;
+}
+
+Policy Policy::parse(const std::string & name)
+{
+    Policy policy;
+    if (name == "default")
+    {
+        return policy;
+    }
+
+    std::stringstream ss(name);
+    std::string item;
+    while (std::getline(ss, item, '+'))
+    {
+        if (item == "stealing")
+        {
+            policy.work_stealing = true;
+        }
+        else if (item == "ordered")
+        {
+            policy.ordered = true;
+        }
+        else if (item == "coalesce")
+        {
+            policy.coalesce = true;
+        }
+        else
+        {
+            LOG(ERROR) << "Unknown simulation policy '" << item << "' in '" << name << "'";
+            throw common::Exception(common::ResponseCode::InvalidParameterError);
+        }
+    }
+    return policy;
+}
+
+std::ostream & operator<<(std::ostream & os, const Policy & policy)
+{
+    if (!policy.work_stealing && !policy.ordered && !policy.coalesce)
+    {
+        return os << "default";
+    }
+
+    std::string separator;
+    if (policy.work_stealing)
+    {
+        os << "stealing";
+        separator = "+";
+    }
+    if (policy.ordered)
+    {
+        os << separator << "ordered";
+        separator = "+";
+    }
+    if (policy.coalesce)
+    {
+        os << separator << "coalesce";
+    }
+    return os;
+}
+
+Simulator::Simulator(std::shared_ptr<const Config> config, const emulated::Profile & profile, std::chrono::microseconds overhead, const Policy & policy) :
+    _config(config),
+    _profile(profile),
+    _overhead(overhead),
+    _policy(policy)
+{
+    ASSERT(_profile.connections) << "Simulated object storage clients must have connections";
+}
+
+Simulation Simulator::run(const Layout & layout, bool object_storage, unsigned stream) const
+{
+    Simulation result;
+    if (layout.tensors() == 0)
+    {
+        return result;
+    }
+
+    // plan the reads like the streamer, where the files are not accessed
+    const unsigned num_files = layout.files.size();
+    std::vector<std::string> paths;
+    std::vector<size_t> offsets(num_files, 0);
+    std::vector<size_t> sizes;
+    std::vector<void *> dsts(num_files, nullptr);
+    for (unsigned i = 0; i < num_files; ++i)
+    {
+        paths.push_back(object_storage ? "s3://simulated/model-" + std::to_string(i) : "/simulated/model-" + std::to_string(i));
+
+        size_t bytesize = 0;
+        for (auto tensor : layout.files[i])
+        {
+            bytesize += tensor;
+        }
+        sizes.push_back(bytesize);
+    }
+
+    Assigner assigner(paths, offsets, sizes, dsts, _config);
+    const unsigned num_workers = assigner.num_workloads();
+
+    Plan plan;
+    {
+        common::s3::S3ClientWrapper::Params params;
+        auto responder = std::make_shared<common::Responder>(0);
+        for (unsigned i = 0; i < num_files; ++i)
+        {
+            Batches batches(i, assigner.file_assignments(i), _config, responder, paths[i], params, layout.files[i]);
+            for (unsigned j = 0; j < batches.size(); ++j)
+            {
+                const auto & batch = batches[j];
+                const unsigned first_task = plan.task_request.size();
+                for (const auto & task : batch.tasks)
+                {
+                    plan.add_task(task.request->file_index, task.request->index);
+                }
+
+                if (object_storage)
+                {
+                    plan.plan_chunks(batch, first_task, _config->s3_block_bytesize, _policy.coalesce);
+                }
+                else
+                {
+                    plan.plan_blocks(batch, first_task, _config->fs_block_bytesize);
+                }
+            }
+        }
+    }
+
+    LOG(DEBUG) << "Simulating " << plan.blocks.size() << " blocks of " << layout.tensors() << " tensors by " << num_workers << " workers with policy " << _policy;
+
+    // pending blocks of each worker in the order of the files, or of all the workers for ordered completion
+    std::vector<std::deque<unsigned>> pending(_policy.ordered ? 1 : num_workers);
+    for (unsigned b = 0; b < plan.blocks.size(); ++b)
+    {
+        pending[_policy.ordered ? 0 : plan.blocks[b].worker].push_back(b);
+    }
+
+    const auto next = [&](unsigned worker, unsigned & block) -> bool
+    {
+        auto & own = pending[_policy.ordered ? 0 : worker];
+        if (!own.empty())
+        {
+            block = own.front();
+            own.pop_front();
+            return true;
+        }
+
+        if (!_policy.work_stealing)
+        {
+            return false;
+        }
+
+        auto victim = std::max_element(pending.begin(), pending.end(), [](const auto & a, const auto & b) { return a.size() < b.size(); });
+        if (victim->empty())
+        {
+            return false;
+        }
+        block = victim->back();
+        victim->pop_back();
+        return true;
+    };
+
+    // a file system worker reads sequentially, and an object storage worker over the connections of its client
+    const unsigned lanes_per_worker = object_storage ? _profile.connections : 1;
+    const unsigned num_lanes = num_workers * lanes_per_worker;
+
+    emulated::Model model(_profile, stream);
+    std::chrono::microseconds aggregate(0);
+    result.busy.resize(num_workers, std::chrono::microseconds(0));
+
+    std::priority_queue<Event, std::vector<Event>, std::greater<Event>> events;
+
+    const auto start = [&](unsigned lane, std::chrono::microseconds now)
+    {
+        const unsigned worker = lane / lanes_per_worker;
+        unsigned block;
+        if (!next(worker, block))
+        {
+            return;
+        }
+
+        // failures are not simulated, and a failed request is timed like a successful one
+        const auto outcome = model.draw();
+        ++result.requests;
+        result.throttled += outcome.throttled;
+
+        const auto bytesize = plan.blocks[block].bytesize;
+        const auto first_byte = now + _overhead + outcome.delay;
+        auto end = first_byte + transfer(bytesize, _profile.connection_bandwidth);
+        if (_profile.bandwidth)
+        {
+            aggregate = std::max(aggregate, first_byte) + transfer(bytesize, _profile.bandwidth);
+            end = std::max(end, aggregate);
+        }
+
+        result.busy[worker] += end - now;
+        events.push(Event{end, lane, block});
+    };
+
+    for (unsigned lane = 0; lane < num_lanes; ++lane)
+    {
+        start(lane, std::chrono::microseconds(0));
+    }
+
+    std::vector<std::chrono::microseconds> ready(plan.request_tasks.size(), std::chrono::microseconds(0));
+    std::vector<std::pair<unsigned, unsigned>> keys(plan.request_tasks.size());
+    for (const auto & [key, id] : plan.request_ids)
+    {
+        keys[id] = key;
+    }
+
+    while (!events.empty())
+    {
+        const auto event = events.top();
+        events.pop();
+
+        for (auto task : plan.blocks[event.block].tasks)
+        {
+            if (--plan.task_blocks[task] == 0)
+            {
+                const auto request = plan.task_request[task];
+                if (--plan.request_tasks[request] == 0)
+                {
+                    ready[request] = event.time;
+                    result.completions.push_back(Simulation::Completion{keys[request].first, keys[request].second, event.time});
+                }
+            }
+        }
+
+        start(event.lane, event.time);
+    }
+
+    ASSERT(result.completions.size() == ready.size()) << "Simulated " << result.completions.size() << " responses of " << ready.size() << " requests";
+
+    result.first = result.completions.front().time;
+    result.total = result.completions.back().time;
+
+    // a consumer in the order of the files waits for the tensors before
+    std::chrono::microseconds available(0);
+    std::chrono::microseconds sum(0);
+    for (const auto & [key, id] : plan.request_ids)
+    {
+        available = std::max(available, ready[id]);
+        sum += available;
+    }
+    result.in_order = sum / static_cast<long>(ready.size());
+
+    return result;
+}
+
+}; // namespace runai::llm::streamer::impl
@@ -0,0 +1,101 @@
+#pragma once
+
+#include <stddef.h>
+
+#include <chrono>
+#include <memory>
+#include <ostream>
+#include <string>
+#include <vector>
+
+#include "emulated/model/model.h"
+#include "streamer/impl/config/config.h"
+
+namespace runai::llm::streamer::impl
+{
+
+// Discrete event simulator of loading a model, which predicts the load time and the completion order of the tensors
+//
+// The reads are planned by the real Assigner and Batches, and the batches are grouped into workloads by their worker index like the streamer does
+// The workers are then simulated on a virtual clock against a modeled backend, instead of reading -
+// a file system worker reads its batches sequentially in blocks of the file system block size,
+// while an object storage worker requests every task in chunks of the object storage block size over the connections of its client
+//
+// Every block or chunk waits for a per request overhead and for a latency drawn by the emulated model (including stragglers and throttling back offs),
+// and its bytes are paced to the bandwidth of a connection and to the aggregate bandwidth of the backend
+//
+// Simulating is reproducible for a given layout, profile and stream
+
+// sizes of the tensors in each file of a model
+struct Layout
+{
+    // random tensor sizes drawn from a log-normal distribution around the median size - e.g. mostly small tensors and a few large ones
+    static Layout synthetic(unsigned seed, unsigned num_files, unsigned num_tensors, size_t median_bytesize, double sigma = 1.0);
+
+    size_t bytesize() const;
+    size_t tensors() const;
+
+    std::vector<std::vector<size_t>> files;
+};
+
+// scheduling policies of the workers, on top of the planning of the configuration (e.g. the concurrency and the block sizes)
+struct Policy
+{
+    // parses a policy name - "default" or a combination of "stealing", "ordered" and "coalesce" joined with '+'
+    static Policy parse(const std::string & name);
+
+    // an idle worker steals the last pending block of the worker with the most pending blocks
+    bool work_stealing = false;
+
+    // all the workers read the pending blocks in the order of the files, so that the tensors complete in order
+    bool ordered = false;
+
+    // consecutive small tasks of an object storage batch are requested together, in requests of up to the block size
+    bool coalesce = false;
+};
+
+std::ostream & operator<<(std::ostream &, const Policy &);
+
+struct Simulation
+{
+    // response of a single tensor
+    struct Completion
+    {
+        unsigned file_index;
+        unsigned index;
+        std::chrono::microseconds time;
+    };
+
+    // time until all the tensors are ready, and until the first tensor is ready
+    std::chrono::microseconds total = std::chrono::microseconds(0);
+    std::chrono::microseconds first = std::chrono::microseconds(0);
+
+    // mean time at which a consumer of the tensors in the order of the files can use a tensor
+    std::chrono::microseconds in_order = std::chrono::microseconds(0);
+
+    // responses in the order of completion
+    std::vector<Completion> completions;
+
+    // requests to the backend, and their throttled attempts
+    size_t requests = 0;
+    size_t throttled = 0;
+
+    // busy time of each worker
+    std::vector<std::chrono::microseconds> busy;
+};
+
+struct Simulator
+{
+    Simulator(std::shared_ptr<const Config> config, const emulated::Profile & profile, std::chrono::microseconds overhead, const Policy & policy);
+
+    // the files are read from object storage or from the file system, and the stream selects the drawn sequence of the model
+    Simulation run(const Layout & layout, bool object_storage, unsigned stream = 0) const;
+
+ private:
+    std::shared_ptr<const Config> _config;
+    const emulated::Profile _profile;
+    const std::chrono::microseconds _overhead;
+    const Policy _policy;
+};
+
+}; // namespace runai::llm::streamer::impl
@@ -0,0 +1,142 @@
+#include "streamer/impl/simulator/simulator.h"
+
+#include <gtest/gtest.h>
+
+#include <memory>
+#include <set>
+#include <sstream>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "common/exception/exception.h"
+
+#include "utils/random/random.h"
+
+namespace runai::llm::streamer::impl
+{
+
+struct SimulatorTest : ::testing::Test
+{
+    SimulatorTest() :
+        config(std::make_shared<Config>(utils::random::number(1, 16), utils::random::number(1, 16), utils::random::number(1024, 64 * 1024), utils::random::number(1024, 64 * 1024), false)),
+        layout(Layout::synthetic(utils::random::number(), utils::random::number(1, 4), utils::random::number(1, 100), utils::random::number(100, 10 * 1024)))
+    {
+        profile.connections = utils::random::number(1, 8);
+    }
+
+    std::shared_ptr<Config> config;
+    Layout layout;
+    emulated::Profile profile;
+};
+
+TEST_F(SimulatorTest, Completions)
+{
+    profile.latency = std::chrono::microseconds(utils::random::number(1, 1000));
+    profile.latency_sigma = 0.5;
+    profile.tail_probability = 0.1;
+
+    for (const auto & name : {"default", "stealing", "ordered", "coalesce", "stealing+ordered+coalesce"})
+    {
+        for (bool object_storage : {false, true})
+        {
+            Simulator simulator(config, profile, std::chrono::microseconds(10), Policy::parse(name));
+            const auto simulation = simulator.run(layout, object_storage);
+
+            // every tensor responds once
+            std::set<std::pair<unsigned, unsigned>> responses;
+            for (const auto & completion : simulation.completions)
+            {
+                EXPECT_LT(completion.file_index, layout.files.size());
+                EXPECT_LT(completion.index, layout.files[completion.file_index].size());
+                EXPECT_TRUE(responses.emplace(completion.file_index, completion.index).second);
+            }
+            EXPECT_EQ(responses.size(), layout.tensors());
+
+            EXPECT_LE(simulation.first, simulation.in_order);
+            EXPECT_LE(simulation.in_order, simulation.total);
+            EXPECT_GT(simulation.requests, 0);
+
+            // reproducible
+            const auto again = simulator.run(layout, object_storage);
+            EXPECT_EQ(again.total, simulation.total);
+            EXPECT_EQ(again.requests, simulation.requests);
+        }
+    }
+}
+
+TEST_F(SimulatorTest, Latency)
+{
+    // a single worker reads a single block
+    config->concurrency = 1;
+    config->fs_block_bytesize = layout.bytesize();
+
+    const auto overhead = std::chrono::microseconds(utils::random::number(0, 100));
+    profile.latency = std::chrono::microseconds(utils::random::number(1, 1000));
+
+    Simulator simulator(config, profile, overhead, Policy());
+    const auto simulation = simulator.run(layout, false);
+    EXPECT_EQ(simulation.requests, layout.files.size());
+    EXPECT_EQ(simulation.total, (profile.latency + overhead) * layout.files.size());
+}
+
+TEST_F(SimulatorTest, Bandwidth)
+{
+    profile.bandwidth = utils::random::number(1, 100) * 1024 * 1024;
+
+    Simulator simulator(config, profile, std::chrono::microseconds(0), Policy());
+    for (bool object_storage : {false, true})
+    {
+        const auto simulation = simulator.run(layout, object_storage);
+        const auto expected = std::chrono::microseconds(static_cast<long>(layout.bytesize() * 1e6 / profile.bandwidth));
+
+        // up to a microsecond of rounding per request
+        EXPECT_GE(simulation.total, expected);
+        EXPECT_LE(simulation.total, expected + std::chrono::microseconds(simulation.requests));
+    }
+}
+
+TEST_F(SimulatorTest, Coalesce)
+{
+    config->s3_block_bytesize = layout.bytesize();
+
+    const auto separate = Simulator(config, profile, std::chrono::microseconds(0), Policy()).run(layout, true);
+    const auto coalesced = Simulator(config, profile, std::chrono::microseconds(0), Policy::parse("coalesce")).run(layout, true);
+
+    // every task fits in a single request, and the tasks of a batch are requested together
+    EXPECT_GE(separate.requests, layout.tensors());
+    EXPECT_LE(coalesced.requests, separate.requests);
+    EXPECT_LE(coalesced.requests, separate.busy.size() * layout.files.size());
+}
+
+TEST_F(SimulatorTest, Ordered)
+{
+    // the blocks are transferred one after the other in the order they were requested
+    profile.bandwidth = utils::random::number(1, 100) * 1024 * 1024;
+
+    Simulator simulator(config, profile, std::chrono::microseconds(0), Policy::parse("ordered"));
+    for (bool object_storage : {false, true})
+    {
+        const auto simulation = simulator.run(layout, object_storage);
+        for (size_t i = 1; i < simulation.completions.size(); ++i)
+        {
+            const auto & before = simulation.completions[i - 1];
+            const auto & after = simulation.completions[i];
+            EXPECT_LT(std::make_pair(before.file_index, before.index), std::make_pair(after.file_index, after.index));
+        }
+    }
+}
+
+TEST_F(SimulatorTest, Policies)
+{
+    for (const auto & name : {"default", "stealing", "ordered", "coalesce", "stealing+coalesce", "stealing+ordered+coalesce"})
+    {
+        std::stringstream ss;
+        ss << Policy::parse(name);
+        EXPECT_EQ(ss.str(), name);
+    }
+
+    EXPECT_THROW(Policy::parse(utils::random::string()), common::Exception);
+}
+
+}; // namespace runai::llm::streamer::impl
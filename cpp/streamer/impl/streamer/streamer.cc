@@ -1,8 +1,12 @@
 #include "streamer/impl/streamer/streamer.h"
 
+#include <algorithm>
 #include <atomic>
+#include <chrono>
+#include <future>
 #include <memory>
 #include <numeric>
+#include <optional>
 #include <string>
 #include <utility>
 #include <vector>
@@ -12,23 +16,73 @@
 
 #include "streamer/impl/workload/workload.h"
 #include "streamer/impl/assigner/assigner.h"
+#include "streamer/impl/fs_strategy/fs_strategy.h"
 #include "common/exception/exception.h"
+#include "common/metrics/metrics.h"
+#include "common/trace/trace.h"
 #include "common/storage_uri/storage_uri.h"
 
 namespace runai::llm::streamer::impl
 {
 
+namespace
+{
+
+std::vector<std::shared_ptr<Cache>> create_caches(const Config & config)
+{
+    std::vector<std::shared_ptr<Cache>> caches;
+
+    // every range read is kept in the snapshot, so that a restarted process finds all of its objects
+    if (!config.snapshot_directory.empty())
+    {
+        caches.push_back(std::make_shared<Cache>(config.snapshot_directory, config.snapshot_max_bytesize, true));
+    }
+
+    if (!config.cache_directory.empty())
+    {
+        caches.push_back(std::make_shared<Cache>(config.cache_directory, config.cache_max_bytesize));
+    }
+
+    return caches;
+}
+
+// workers of the queue of the streamer, where a tuned concurrency may reach its maximum
+// workers for the concurrency of a file system strategy are added once a strategy which asks for them is detected
+unsigned workers(const Config & config, bool autotune)
+{
+    auto workers = config.executor_threads ? config.concurrency : config.max_concurrency();
+    if (autotune)
+    {
+        workers = std::max(workers, Autotune::max_concurrency);
+    }
+    return workers;
+}
+
+} // namespace
+
 Streamer::Streamer() : Streamer(Config())
 {}
 
 Streamer::Streamer(Config config) :
     _config(std::make_shared<Config>(config)),
-    _pool([&](Workload&& workload, std::atomic<bool> & stopped)
-        {
-            workload.execute(stopped);
-        }, _config->max_concurrency())
+    _cancellation(std::make_shared<Cancellation>()),
+    _caches(create_caches(*_config)),
+    _dedup(_config->dedup ? std::make_shared<Dedup>() : nullptr),
+    _bandwidth(_config->bandwidth_limit ? Bandwidth::instance(_config->bandwidth_limit, _config->bandwidth_weight) : nullptr),
+    _autotune(_config->autotune_profile.empty() ? nullptr : std::make_shared<Autotune>(_config->autotune_profile, *_config)),
+    _queue(Scheduler::queue(Scheduler::instance(), default_weight, workers(*_config, _autotune != nullptr)))
 {
     LOG(DEBUG) << config;
+
+    if (_config->usage)
+    {
+        common::Metrics::enable_usage();
+    }
+
+    if (!_config->trace_path.empty())
+    {
+        common::Trace::enable();
+    }
 }
 
 Streamer::~Streamer()
@@ -36,6 +90,17 @@ Streamer::~Streamer()
     try
     {
         LOG(DEBUG) << "Streamer shutting down";
+        _cancellation->cancel();
+    }
+    catch(...)
+    {}
+
+    try
+    {
+        if (!_config->trace_path.empty())
+        {
+            common::Trace::write(_config->trace_path);
+        }
     }
     catch(...)
     {}
@@ -98,6 +163,159 @@ common::Response Streamer::response()
     return _responder->pop();
 }
 
+common::ResponseCode Streamer::responses(std::vector<common::Response> & responses, unsigned max_responses)
+{
+    if (_responder == nullptr)
+    {
+        responses.clear();
+        return common::ResponseCode::FinishedError;
+    }
+
+    return _responder->try_pop(responses, max_responses);
+}
+
+common::ResponseCode Streamer::set_completion_handler(common::Responder::Handler handler)
+{
+    if (_responder && !_responder->finished())
+    {
+        LOG(ERROR) << "Cannot set completion handler while a request is running";
+        return common::ResponseCode::BusyError;
+    }
+
+    _completion_handler = handler;
+    return common::ResponseCode::Success;
+}
+
+int Streamer::eventfd()
+{
+    if (_eventfd == nullptr)
+    {
+        _eventfd = std::make_shared<utils::EventFd>();
+        LOG(DEBUG) << "Created response eventfd " << _eventfd->fd();
+
+        if (_responder)
+        {
+            _responder->set_notification([eventfd = _eventfd]() { eventfd->signal(); });
+        }
+    }
+
+    return _eventfd->fd();
+}
+
+common::ResponseCode Streamer::set_readiness(uint32_t * entries, size_t size)
+{
+    if (_responder && !_responder->finished())
+    {
+        LOG(ERROR) << "Cannot set readiness array while a request is running";
+        return common::ResponseCode::BusyError;
+    }
+
+    if (entries == nullptr)
+    {
+        _readiness.reset();
+        return common::ResponseCode::Success;
+    }
+
+    LOG(DEBUG) << "Setting readiness array of " << size << " entries";
+    _readiness = std::make_shared<Readiness>(entries, size);
+    return common::ResponseCode::Success;
+}
+
+common::ResponseCode Streamer::prefetch(const std::vector<std::string> & paths, const std::vector<size_t> & file_offsets, const std::vector<size_t> & bytesizes, const common::s3::Credentials & credentials)
+{
+    if (paths.size() != file_offsets.size() || paths.size() != bytesizes.size())
+    {
+        LOG(ERROR) << "Received " << paths.size() << " paths with " << file_offsets.size() << " offsets and " << bytesizes.size() << " sizes";
+        return common::ResponseCode::InvalidParameterError;
+    }
+
+    try
+    {
+        if (_prefetch == nullptr)
+        {
+            _prefetch = std::make_unique<Prefetch>(_config, _caches, _bandwidth);
+        }
+
+        for (size_t i = 0; i < paths.size(); ++i)
+        {
+            const auto params = handle_s3(i, paths[i], credentials, *_config);
+            _prefetch->request(paths[i], params, common::Range(file_offsets[i], bytesizes[i]));
+        }
+    }
+    catch(const common::Exception & e)
+    {
+        return e.error();
+    }
+
+    return common::ResponseCode::Success;
+}
+
+common::ResponseCode Streamer::cancel_prefetch()
+{
+    if (_prefetch)
+    {
+        _prefetch->cancel();
+    }
+
+    return common::ResponseCode::Success;
+}
+
+void Streamer::wait_prefetch()
+{
+    if (_prefetch)
+    {
+        _prefetch->wait();
+    }
+}
+
+common::ResponseCode Streamer::set_weight(unsigned weight)
+{
+    if (weight == 0)
+    {
+        LOG(ERROR) << "Scheduling weight must be a positive number";
+        return common::ResponseCode::InvalidParameterError;
+    }
+
+    LOG(DEBUG) << "Setting scheduling weight to " << weight;
+    _queue->set_weight(weight);
+    return common::ResponseCode::Success;
+}
+
+common::ResponseCode Streamer::cancel()
+{
+    auto responder = _responder;
+    if (responder == nullptr || responder->finished())
+    {
+        LOG(DEBUG) << "No running request to cancel";
+        return common::ResponseCode::Success;
+    }
+
+    LOG(DEBUG) << "Canceling running request";
+
+    _cancellation->cancel();
+
+    // workloads which are still queued behind other streamers are answered without reading,
+    // and the workers respond for every task they did not complete, once they stop reading
+    const auto dropped = _queue->clear();
+    if (dropped)
+    {
+        LOG(DEBUG) << "Dropped " << dropped << " pending workloads";
+    }
+    responder->wait_until_done();
+    responder->cancel();
+
+    _cancellation->reset();
+
+    // wake up event loops waiting for responses
+    if (_eventfd)
+    {
+        _eventfd->signal();
+    }
+
+    LOG(DEBUG) << "Canceled running request";
+    return common::ResponseCode::Success;
+}
+
 common::ResponseCode Streamer::async_request(
     std::vector<std::string> & paths,
     std::vector<size_t> & file_offsets,
@@ -118,25 +336,108 @@ common::ResponseCode Streamer::async_request(
         throw common::Exception(common::ResponseCode::BusyError);
     }
 
+    if (_readiness)
+    {
+        _readiness->reset(num_sizes);
+    }
+
+    common::Trace::Scope span("plan");
+    common::Metrics::add(common::Metrics::Counter::Requests);
+
     // expecting for total of num_sizes responses
     _responder = std::make_shared<common::Responder>(total_sizes);
 
+    if (_completion_handler)
+    {
+        _responder->set_handler(_completion_handler);
+    }
+
+    if (_eventfd)
+    {
+        _responder->set_notification([eventfd = _eventfd]() { eventfd->signal(); });
+    }
+
     // cancel responder in case of an error - cancelled response will not delay sending the next request
     utils::ScopeGuard __responder_release([&](){_responder->cancel();});
 
+    // the block size of every file follows its file system, where object storage paths are not detected,
+    // and the request is read by the largest number of workers which the file systems of its files take
+    auto config = _config;
+    std::vector<std::shared_ptr<const Config>> file_configs(paths.size(), _config);
+    if (_config->fs_strategy)
+    {
+        unsigned concurrency = 0;
+        for (size_t i = 0; i < paths.size(); ++i)
+        {
+            const auto strategy = FsStrategy::detect(paths[i]);
+            if (strategy.type != FsStrategy::Type::Other)
+            {
+                auto adapted = std::make_shared<Config>(*_config);
+                strategy.apply(*adapted);
+                file_configs[i] = adapted;
+                concurrency = std::max(concurrency, strategy.concurrency);
+                LOG(DEBUG) << "Reading " << paths[i] << " with " << strategy;
+            }
+        }
+
+        if (concurrency)
+        {
+            auto adapted = std::make_shared<Config>(*_config);
+            adapted->concurrency = concurrency;
+            config = adapted;
+            _queue->grow(concurrency);
+        }
+    }
+
+    // the block size and the concurrency of the request are tuned for the storage target of its first file, overriding the file system strategy
+    if (_autotune)
+    {
+        const auto target = Autotune::target(paths[0]);
+        const auto setting = _autotune->next(target);
+
+        // only the block size and the concurrency of the storage of the target are used
+        auto tuned = std::make_shared<Config>(*config);
+        tuned->concurrency = setting.concurrency;
+        tuned->s3_concurrency = setting.concurrency;
+        tuned->fs_block_bytesize = setting.block_bytesize;
+        tuned->s3_block_bytesize = setting.block_bytesize;
+        config = tuned;
+        std::fill(file_configs.begin(), file_configs.end(), config);
+
+        LOG(DEBUG) << "Reading " << target << " with " << setting;
+        _responder->set_completion([autotune = _autotune, target, setting](size_t bytesize, std::chrono::steady_clock::duration elapsed)
+            {
+                autotune->report(target, setting, bytesize, elapsed);
+            });
+    }
 
     // divide reading between workers
-    Assigner assigner(paths, file_offsets, bytesizes, dsts, _config);
+    Assigner assigner(paths, file_offsets, bytesizes, dsts, config);
+
+    // object versions of the caches and the deduplication are requested below, and are retrieved while the workloads are executed
+    auto versions = std::make_shared<Workload::Versions>();
 
-    std::vector<Workload> workloads(assigner.num_workloads());
+    std::vector<Workload> workloads;
+    workloads.reserve(assigner.num_workloads());
+    for (unsigned i = 0; i < assigner.num_workloads(); ++i)
+    {
+        workloads.emplace_back(_cancellation, _caches, _dedup, _bandwidth, versions);
+    }
 
     // Create batches for each file
 
     for (size_t i = 0; i < paths.size(); ++i)
     {
-        auto params = handle_s3(i, paths[i], credentials);
+        auto params = handle_s3(i, paths[i], credentials, *file_configs[i]);
+
+        // the version of each object is retrieved once per request, and the versions of the objects are retrieved concurrently
+        if (params.uri != nullptr && (!_caches.empty() || _dedup) && versions->find(params.uri->uri) == versions->end())
+        {
+            versions->emplace(params.uri->uri, version(params));
+        }
+
         LOG(DEBUG) << "Creating batches for file index " << i << " path: " <<  paths[i];
-        Batches batches(i, assigner.file_assignments(i), _config, _responder, paths[i], params, internal_sizes[i]);
+        Batches batches(i, assigner.file_assignments(i), file_configs[i], _responder, paths[i], params, internal_sizes[i], _readiness);
         const auto num_batches = batches.size();
         LOG(DEBUG) << "Created " << num_batches << " batches for file index " << i;
         for (size_t j = 0; j < num_batches; ++j)
@@ -162,14 +463,21 @@ common::ResponseCode Streamer::async_request(
         }
     }
 
-    // send batches to threadpool
+    // send batches to the workers shared by the streamers of the process
     for (auto & workload : workloads)
     {
         if (workload.size() > 0)
         {
             LOG(DEBUG) << "sending workload to worker with batches " << workload.size();
 
-            _pool.push(std::move(workload));
+            if (_executor && workload.is_object_storage())
+            {
+                _executor->push(std::move(workload));
+            }
+            else
+            {
+                schedule(std::make_shared<Workload>(std::move(workload)));
+            }
         }
     }
 
@@ -178,6 +486,40 @@ common::ResponseCode Streamer::async_request(
     return common::ResponseCode::Success;
 }
 
+std::shared_future<std::optional<std::string>> Streamer::version(const common::s3::S3ClientWrapper::Params & params)
+{
+    return std::async(std::launch::async, [params]() -> std::optional<std::string>
+        {
+            try
+            {
+                common::s3::S3ClientWrapper client(params);
+                return client.object_version(params);
+            }
+            catch (...)
+            {
+                // the object is then neither cached nor shared, and reading it reports the error of the object storage
+                LOG(WARNING) << "Failed to retrieve version of object " << params.uri->uri;
+            }
+            return std::nullopt;
+        }).share();
+}
+
+void Streamer::schedule(std::shared_ptr<Workload> workload)
+{
+    // jobs are not preempted, so a workload is read in slices of bounded cost, between which the scheduler may give the worker to another streamer
+    _queue->push([this, workload]()
+        {
+            if (workload->execute(_cancellation->stopped(), Workload::slice_bytesize))
+            {
+                schedule(workload);
+            }
+        }, std::min(workload->bytesize(), Workload::slice_bytesize),
+        [workload]()
+        {
+            workload->cancel();
+        });
+}
+
 void Streamer::verify_requests(std::vector<std::string> & paths, std::vector<size_t> & file_offsets, std::vector<size_t> & bytesizes, std::vector<unsigned> & num_sizes, std::vector<void *> & dsts)
 {
     if (dsts[0] == 0)
@@ -204,7 +546,7 @@ void Streamer::verify_requests(std::vector<std::string> & paths, std::vector<siz
     }
 }
 
-common::s3::S3ClientWrapper::Params Streamer::handle_s3(unsigned file_index, const std::string & path, const common::s3::Credentials & credentials)
+common::s3::S3ClientWrapper::Params Streamer::handle_s3(unsigned file_index, const std::string & path, const common::s3::Credentials & credentials, const Config & config)
 {
     std::shared_ptr<common::s3::StorageUri> uri;
     try
@@ -215,27 +557,43 @@ common::s3::S3ClientWrapper::Params Streamer::handle_s3(unsigned file_index, con
     {
     }
 
+    auto params = common::s3::S3ClientWrapper::Params(uri, credentials, config.s3_block_bytesize);
+
     if (uri != nullptr && _s3 == nullptr)
     {
-        // adjust fd limit acording to concurrency
+        // adjust fd limit acording to concurrency, which may be tuned up to its maximum
+        const auto concurrency = _autotune ? std::max(config.s3_concurrency, Autotune::max_concurrency) : config.s3_concurrency;
         auto fd_limit = utils::get_cur_file_descriptors();
-        LOG(DEBUG) << "Process file descriptors limit is " << fd_limit << " and concurrency level is " << _config->s3_concurrency;
-        const auto desired_fd_limit = _config->s3_concurrency * 64;
+        LOG(DEBUG) << "Process file descriptors limit is " << fd_limit << " and concurrency level is " << concurrency;
+        const auto desired_fd_limit = concurrency * 64;
         if (fd_limit < desired_fd_limit)
         {
             if (desired_fd_limit > utils::get_max_file_descriptors())
             {
-                LOG(ERROR) << "Insufficient file descriptors limit " << fd_limit << " for concurrency level " << _config->s3_concurrency << " ; increase fd limit to " << desired_fd_limit << " or higher, depending on your application fd usage";
+                LOG(ERROR) << "Insufficient file descriptors limit " << fd_limit << " for concurrency level " << concurrency << " ; increase fd limit to " << desired_fd_limit << " or higher, depending on your application fd usage";
                 throw common::Exception(common::ResponseCode::InsufficientFdLimit);
             }
-            LOG(INFO) << "Increasing fd soft limit to " << desired_fd_limit << " for concurrency level " << _config->s3_concurrency;
+            LOG(INFO) << "Increasing fd soft limit to " << desired_fd_limit << " for concurrency level " << concurrency;
             _fd_limit = std::make_unique<utils::FdLimitSetter>(desired_fd_limit);
         }
         _s3_stop = std::make_unique<S3Stop>();
         _s3 = std::make_unique<S3Cleanup>();
+
+        // object storage clients are driven by completion notifications, instead of occupying a worker each
+        if (_config->executor_threads)
+        {
+            if (common::s3::S3ClientWrapper::notification_supported(params))
+            {
+                _executor = std::make_unique<Executor>(_config->executor_threads, _cancellation->stopped(), _queue.get());
+            }
+            else
+            {
+                LOG(DEBUG) << "Object storage backend does not support completion notifications";
+            }
+        }
     }
 
-    return common::s3::S3ClientWrapper::Params(uri, credentials, _config->s3_block_bytesize);
+    return params;
 }
 
 }; // namespace runai::llm::streamer::impl
@@ -1,19 +1,30 @@
 
 #pragma once
 
+#include <future>
 #include <memory>
+#include <optional>
 #include <string>
 #include <vector>
 
-#include "utils/threadpool/threadpool.h"
 #include "utils/fdlimit/fdlimit.h"
+#include "utils/eventfd/eventfd.h"
 
 #include "common/responder/responder.h"
 #include "common/s3_credentials/s3_credentials.h"
+#include "streamer/impl/autotune/autotune.h"
 #include "streamer/impl/config/config.h"
 #include "streamer/impl/workload/workload.h"
+#include "streamer/impl/bandwidth/bandwidth.h"
+#include "streamer/impl/executor/executor.h"
 #include "streamer/impl/s3/s3.h"
 #include "streamer/impl/batches/batches.h"
+#include "streamer/impl/cache/cache.h"
+#include "streamer/impl/cancellation/cancellation.h"
+#include "streamer/impl/dedup/dedup.h"
+#include "streamer/impl/readiness/readiness.h"
+#include "streamer/impl/scheduler/scheduler.h"
+#include "streamer/impl/prefetch/prefetch.h"
 
 namespace runai::llm::streamer::impl
 {
@@ -25,6 +36,8 @@ namespace runai::llm::streamer::impl
 // The streamer can handle a single read request at a time
 // The client must wait for the current request to end, before sending the next request
 
+// Workers are shared by the streamers of the process, which divide them by their scheduling weights while reading concurrently
+
 // Synchronous read -  read a range of a file to a given buffer of host memory
 // Asynchronous read - read a range of a file to a given buffer of host memory in two stages:
 //                          1. request to read a range, specifying a list of sub ranges
@@ -51,6 +64,46 @@ struct Streamer
     // returns common::ResponseCode error if failed
     common::Response response();
 
+    // return ready responses without waiting, up to max_responses
+    // returns common::ResponseCode::FinishedError if no responses are expected
+    common::ResponseCode responses(std::vector<common::Response> & responses, unsigned max_responses);
+
+    // set a handler which is called from the worker threads with batches of completed sub requests, instead of queueing the responses
+    // an empty handler restores queueing the responses
+    // returns common::ResponseCode::BusyError if a request is running
+    common::ResponseCode set_completion_handler(common::Responder::Handler handler);
+
+    // event file descriptor which is signaled when responses are ready, or when the request is canceled
+    // created on the first call and owned by the streamer
+    int eventfd();
+
+    // set a readiness array in caller memory, which is zeroed by every following request and marked by the workers as sub requests complete
+    // a null array stops marking readiness
+    // returns common::ResponseCode::BusyError if a request is running
+    common::ResponseCode set_readiness(uint32_t * entries, size_t size);
+
+    // warm the storage of ranges which are going to be requested, without destination buffers
+    // file system ranges are read ahead into the page cache, and object storage ranges are read into the local caches
+    // prefetching runs in the background while no request is pending, and may be sent while a request is running
+    // returns common::ResponseCode::InvalidParameterError for object storage paths if there is no local cache
+    common::ResponseCode prefetch(const std::vector<std::string> & paths, const std::vector<size_t> & file_offsets, const std::vector<size_t> & bytesizes, const common::s3::Credentials & credentials);
+
+    // stop prefetching
+    // returns when no more data is prefetched
+    common::ResponseCode cancel_prefetch();
+
+    // set the weight of the following requests in the workers shared with the other streamers of the process
+    // returns common::ResponseCode::InvalidParameterError if the weight is zero
+    common::ResponseCode set_weight(unsigned weight);
+
+    static constexpr unsigned default_weight = 1;
+
+    // cancel the running request
+    // returns when no more data is written to the destination buffers of the request, which can then be released
+    // a pending or following call to response() returns common::ResponseCode::FinishedError, and a new request can be sent
+    // may be called while another thread is waiting for a response
+    common::ResponseCode cancel();
+
     // For testing only:
 
     // single synchronous read request from offset in file
@@ -61,17 +114,42 @@ struct Streamer
     // returns common::ResponseCode::Success if successful or error code
     common::ResponseCode async_read(const std::string & path, size_t offset, size_t bytesize, void * dst, unsigned num_sizes, size_t * internal_sizes, const common::s3::Credentials & credentials);
 
+    // block until the prefetched ranges are warm
+    void wait_prefetch();
+
  private:
-    common::s3::S3ClientWrapper::Params handle_s3(unsigned file_index, const std::string & path, const common::s3::Credentials & credentials);
+    common::s3::S3ClientWrapper::Params handle_s3(unsigned file_index, const std::string & path, const common::s3::Credentials & credentials, const Config & config);
     void verify_requests(std::vector<std::string> & paths, std::vector<size_t> & file_offsets, std::vector<size_t> & bytesizes, std::vector<unsigned> & num_sizes, std::vector<void *> & dsts);
 
+    // retrieves the version of an object asynchronously
+    static std::shared_future<std::optional<std::string>> version(const common::s3::S3ClientWrapper::Params & params);
+
+    // pushes the next slice of the workload to the scheduler queue, which pushes the following slice once it ends
+    void schedule(std::shared_ptr<Workload> workload);
+
  private:
     std::shared_ptr<const Config> _config;
     std::unique_ptr<S3Cleanup> _s3;
-    utils::ThreadPool<Workload> _pool;
+    std::shared_ptr<Cancellation> _cancellation;
+    // local caches of object storage reads from the fastest, shared by the workloads
+    std::vector<std::shared_ptr<Cache>> _caches;
+    // ranges read by this process and shared with the other processes of the node
+    std::shared_ptr<Dedup> _dedup;
+    // bandwidth limit shared with the other processes of the node
+    std::shared_ptr<Bandwidth> _bandwidth;
+    // tuning of the block size and the concurrency of every storage target, shared with the completions of the requests
+    std::shared_ptr<Autotune> _autotune;
+    // queue of the workers shared with the other streamers of the process
+    std::unique_ptr<Scheduler::Queue> _queue;
+    std::unique_ptr<Executor> _executor;
     std::unique_ptr<S3Stop> _s3_stop;
     std::unique_ptr<utils::FdLimitSetter> _fd_limit;
     std::shared_ptr<common::Responder> _responder;
+    common::Responder::Handler _completion_handler;
+    std::shared_ptr<utils::EventFd> _eventfd;
+    std::shared_ptr<Readiness> _readiness;
+    // created by the first prefetch, and destroyed first so that it stops before the object storage backends
+    std::unique_ptr<Prefetch> _prefetch;
 };
 
 }; // namespace runai::llm::streamer::impl
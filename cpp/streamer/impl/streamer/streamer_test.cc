@@ -1,7 +1,12 @@
 #include "streamer/impl/streamer/streamer.h"
 
 #include <gtest/gtest.h>
+#include <unistd.h>
+
+#include <algorithm>
 #include <atomic>
+#include <fstream>
+#include <string>
 #include <vector>
 #include <set>
 
@@ -30,6 +35,54 @@ TEST(Creation, Sanity)
     EXPECT_EQ(r.ret, common::ResponseCode::FinishedError);
 }
 
+TEST(Creation, Shared_Workers)
+{
+    Config small(1, 1, Config().s3_block_bytesize, Config().fs_block_bytesize);
+    Config large(utils::random::number(2, 32), 1, Config().s3_block_bytesize, Config().fs_block_bytesize);
+    large.executor_threads = 1;
+
+    Streamer first(small);
+    Streamer second(large);
+
+    // the workers are shared and are not added up
+    EXPECT_EQ(Scheduler::instance()->workers(), large.concurrency);
+}
+
+TEST(Creation, Weight)
+{
+    Streamer streamer;
+    EXPECT_EQ(streamer.set_weight(0), common::ResponseCode::InvalidParameterError);
+    EXPECT_EQ(streamer.set_weight(utils::random::number(1, 100)), common::ResponseCode::Success);
+}
+
+TEST(Prefetch, Sanity)
+{
+    const auto data = utils::random::buffer(utils::random::number(100, 100000));
+    utils::temp::File file(data);
+
+    Streamer streamer;
+    const common::s3::Credentials credentials;
+    EXPECT_EQ(streamer.prefetch({ file.path }, { 0 }, { data.size() }, credentials), common::ResponseCode::Success);
+    streamer.wait_prefetch();
+
+    // the prefetched range is read as usual
+    std::vector<uint8_t> buffer(data.size());
+    EXPECT_EQ(streamer.sync_read(file.path, 0, data.size(), buffer.data(), credentials), common::ResponseCode::Success);
+    EXPECT_EQ(buffer, data);
+
+    EXPECT_EQ(streamer.cancel_prefetch(), common::ResponseCode::Success);
+}
+
+TEST(Prefetch, Invalid_Parameters)
+{
+    Streamer streamer;
+    const common::s3::Credentials credentials;
+    EXPECT_EQ(streamer.prefetch({ utils::random::string() }, { 0, 0 }, { 1 }, credentials), common::ResponseCode::InvalidParameterError);
+
+    // object storage ranges are prefetched into a local cache
+    EXPECT_EQ(streamer.prefetch({ "s3://" + utils::random::string() + "/" + utils::random::string() }, { 0 }, { 1 }, credentials), common::ResponseCode::InvalidParameterError);
+}
+
 TEST(Sync, Sanity)
 {
     auto size = utils::random::number(100, 1000);
@@ -457,4 +510,79 @@ TEST(AsyncRequest, InvalidScheme)
     EXPECT_THROW(streamer.async_request(paths, file_offsets, bytesizes, dsts, num_sizes, internal_sizes, credentials), runai::llm::streamer::common::Exception);
 }
 
+TEST(Autotune, Sanity)
+{
+    // a request which is large enough to be measured
+    std::vector<uint8_t> data(Autotune::min_bytesize);
+    for (size_t i = 0; i < data.size(); i += 4096)
+    {
+        data[i] = utils::random::number(256);
+    }
+    utils::temp::File file(data);
+    const auto profile = file.path + ".autotune";
+
+    Config config(utils::random::number(2, 16), utils::random::number(2, 16), Config().s3_block_bytesize, Config().fs_block_bytesize);
+    config.autotune_profile = profile;
+
+    {
+        Streamer streamer(config);
+        const common::s3::Credentials credentials;
+
+        // every request reads with another setting
+        const unsigned requests = utils::random::number(2, 4);
+        for (unsigned i = 0; i < requests; ++i)
+        {
+            std::vector<uint8_t> buffer(data.size());
+            EXPECT_EQ(streamer.sync_read(file.path, 0, data.size(), buffer.data(), credentials), common::ResponseCode::Success);
+            EXPECT_EQ(buffer, data);
+        }
+    }
+
+    // the target of the file was persisted
+    std::ifstream stream(profile);
+    std::string line;
+    EXPECT_TRUE(std::getline(stream, line));
+    const auto target = Autotune::target(file.path);
+    EXPECT_EQ(line.substr(line.size() - std::min(line.size(), target.size())), target);
+
+    ::unlink(profile.c_str());
+    ::unlink((profile + ".lock").c_str());
+}
+
+TEST(FsStrategy, Sanity)
+{
+    Config config(utils::random::number(2, 16), utils::random::number(2, 16), Config().s3_block_bytesize, Config().fs_block_bytesize);
+    config.fs_strategy = true;
+    Streamer streamer(config);
+    const common::s3::Credentials credentials;
+
+    // a local file, and a file of a memory file system which is read by single calls
+    std::vector<std::string> dirs = {"."};
+    if (::access("/dev/shm", W_OK) == 0)
+    {
+        dirs.push_back("/dev/shm");
+    }
+
+    for (const auto & dir : dirs)
+    {
+        const auto data = utils::random::buffer(utils::random::number(3 * 1024 * 1024, 8 * 1024 * 1024));
+        utils::temp::File file(dir, utils::random::string(), data);
+
+        // repeated requests of the same file
+        for (unsigned i = 0; i < 2; ++i)
+        {
+            const auto offset = utils::random::number<size_t>(0, data.size() - 1);
+            const auto size = utils::random::number<size_t>(1, data.size() - offset);
+
+            std::vector<uint8_t> buffer(size);
+            EXPECT_EQ(streamer.sync_read(file.path, offset, size, buffer.data(), credentials), common::ResponseCode::Success);
+            EXPECT_TRUE(std::equal(buffer.begin(), buffer.end(), data.begin() + offset)) << dir;
+        }
+
+        std::vector<uint8_t> buffer(data.size());
+        EXPECT_EQ(streamer.sync_read(file.path, 1, data.size(), buffer.data(), credentials), common::ResponseCode::EofError) << dir;
+        EXPECT_EQ(streamer.sync_read(file.path, data.size() + 1, 1, buffer.data(), credentials), common::ResponseCode::EofError) << dir;
+    }
+}
+
 }; // namespace runai::llm::streamer::impl
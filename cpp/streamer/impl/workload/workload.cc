@@ -1,13 +1,24 @@
 
 #include "streamer/impl/workload/workload.h"
 
+#include <algorithm>
+#include <iterator>
+#include <limits>
+#include <map>
 #include <memory>
+#include <optional>
+#include <string>
 #include <utility>
 
 #include "streamer/impl/s3/s3.h"
+#include "streamer/impl/mirrored/mirrored.h"
+#include "streamer/impl/cached/cached.h"
+#include "streamer/impl/shared/shared.h"
 
 #include "common/response_code/response_code.h"
 #include "common/exception/exception.h"
+#include "common/metrics/metrics.h"
+#include "common/trace/trace.h"
 
 #include "utils/logging/logging.h"
 
@@ -16,11 +27,29 @@ namespace runai::llm::streamer::impl
 
 std::atomic<common::backend_api::ObjectRequestId_t> Workload::_async_handle_counter {0};
 
+Workload::Workload(std::shared_ptr<Cancellation> cancellation, const std::vector<std::shared_ptr<Cache>> & caches, std::shared_ptr<Dedup> dedup, std::shared_ptr<Bandwidth> bandwidth, std::shared_ptr<const Versions> versions) :
+    _cancellation(cancellation),
+    _caches(caches),
+    _dedup(dedup),
+    _bandwidth(bandwidth),
+    _versions(versions)
+{}
+
 size_t Workload::size() const
 {
     return _batches_by_file_index.size();
 }
 
+size_t Workload::bytesize() const
+{
+    size_t bytesize = 0;
+    for (const auto & [file_index, batch] : _batches_by_file_index)
+    {
+        bytesize += batch.total_bytes();
+    }
+    return bytesize;
+}
+
 common::ResponseCode Workload::add_batch(Batch && batch)
 {
     const auto file_index = batch.file_index;
@@ -60,24 +89,34 @@ common::ResponseCode Workload::verify_batch(const Batch & batch)
 
 void Workload::execute(std::atomic<bool> & stopped)
 {
-    if (size() == 0)
+    while (execute(stopped, std::numeric_limits<size_t>::max()))
+    {}
+}
+
+bool Workload::execute(std::atomic<bool> & stopped, size_t bytesize)
+{
+    if (size() == 0 || _finished)
     {
-        return;
+        return false;
     }
 
-    // create reader
+    common::Trace::Scope span("workload", std::min(bytesize, this->bytesize()));
+    common::Metrics::Usage usage;
+
     if (is_object_storage())
     {
-        async_read(stopped);
+        return async_read(stopped, bytesize);
     }
-    else
+
+    auto & batch = std::next(_batches_by_file_index.begin(), _current)->second;
+    if (!batch.execute(stopped, _bandwidth.get(), bytesize))
     {
-        for (auto & [file_index, batch] : _batches_by_file_index)
-        {
-            batch.execute(stopped);
-            LOG(DEBUG) << "Finished batch " << batch;
-        }
+        LOG(DEBUG) << "Finished batch " << batch;
+        ++_current;
     }
+
+    _finished = _current == size();
+    return !_finished;
 }
 
 void Workload::assign_global_ids()
@@ -98,46 +137,319 @@ void Workload::assign_global_ids()
     }
 }
 
-void Workload::async_read(std::atomic<bool> & stopped)
+bool Workload::async_read(std::atomic<bool> & stopped, size_t bytesize)
 {
     auto response_code = common::ResponseCode::Success;
     try
     {
-        assign_global_ids();
+        if (_reader == nullptr)
+        {
+            open(nullptr, nullptr);
+        }
+
+        submit(stopped, bytesize);
+
+        // wait for all the reads of the slice to finish
+        // when stopped, some of the reads might have been submitted before a batch was aborted, and the buffers must not be released before they complete
+        wait_for_responses(stopped);
+        return end_slice(stopped);
+    }
+    catch(const common::Exception & e)
+    {
+        if (e.error() != common::ResponseCode::FinishedError)
+        {
+            LOG(ERROR) << "Error " << e.error() << " while reading batches";
+        }
+        response_code = e.error();
+    }
+    catch (...)
+    {
+        LOG(ERROR) << "Unknown error while reading batches";
+        response_code = common::ResponseCode::UnknownError;
+    }
 
-        const auto & config = _batches_by_file_index.begin()->second.config;
+    finish(response_code);
+    return false;
+}
 
-        auto s3_client = std::make_shared<common::s3::S3ClientWrapper>(_batches_by_file_index.begin()->second.object_storage_params);
-        _reader = std::make_shared<S3>(s3_client, *config);
+bool Workload::start(std::atomic<bool> & stopped, common::backend_api::ObjectCompletionNotification_t notification, void * context, size_t bytesize)
+{
+    ASSERT(is_object_storage()) << "Only object storage workloads are driven by completion notifications";
+    common::Metrics::Usage usage;
 
-        unsigned requested_batches = 0;
-        for (auto & [file_index, batch] : _batches_by_file_index)
+    if (size() == 0 || _finished)
+    {
+        return false;
+    }
+
+    auto response_code = common::ResponseCode::Success;
+    try
+    {
+        if (_reader == nullptr)
         {
-            _error_by_file_index[file_index] = handle_batch(file_index, batch, stopped);
-            requested_batches += (_error_by_file_index[file_index] == common::ResponseCode::Success ? 1 : 0);
+            open(notification, context);
         }
 
-        // wait for all the batched to finish
-        if (requested_batches > 0)
+        submit(stopped, bytesize);
+
+        // responses might have been ready before the first notification
+        return handle_ready(stopped);
+    }
+    catch(const common::Exception & e)
+    {
+        if (e.error() != common::ResponseCode::FinishedError)
         {
-            LOG(DEBUG) << "Waiting for responses";
-            wait_for_responses(stopped);
+            LOG(ERROR) << "Error " << e.error() << " while requesting batches";
         }
+        response_code = e.error();
+    }
+    catch (...)
+    {
+        LOG(ERROR) << "Unknown error while requesting batches";
+        response_code = common::ResponseCode::UnknownError;
+    }
+
+    finish(response_code);
+    return false;
+}
+
+bool Workload::poll(std::atomic<bool> & stopped)
+{
+    ASSERT(_reader != nullptr) << "Polling a workload which was not started";
+    common::Metrics::Usage usage;
+
+    return handle_ready(stopped);
+}
+
+bool Workload::handle_ready(std::atomic<bool> & stopped)
+{
+    auto response_code = common::ResponseCode::Success;
+    try
+    {
+        while (inflight() > 0)
+        {
+            std::vector<common::backend_api::Response> responses;
+            auto r = _reader->async_response(responses, std::min(max_responses_per_poll, inflight()), common::backend_api::OBJECT_WAIT_MODE_NON_BLOCKING);
+            if (r != common::ResponseCode::Success)
+            {
+                if (r == common::ResponseCode::FinishedError)
+                {
+                    LOG(DEBUG) << "FinishedError while polling for responses";
+                }
+                throw common::Exception(r);
+            }
+
+            if (responses.empty())
+            {
+                return true;
+            }
+
+            for (const auto & response : responses)
+            {
+                handle_response(response);
+            }
+        }
+
+        // the slice has ended, and the workload finishes unless batches remain to be requested
+        end_slice(stopped);
+        return false;
     }
     catch(const common::Exception & e)
     {
         if (e.error() != common::ResponseCode::FinishedError)
         {
-            LOG(ERROR) << "Error " << e.error() << " while reading batches";
+            LOG(ERROR) << "Error " << e.error() << " while polling for responses";
         }
         response_code = e.error();
     }
     catch (...)
     {
-        LOG(ERROR) << "Unknown error while reading batches";
+        LOG(ERROR) << "Unknown error while polling for responses";
         response_code = common::ResponseCode::UnknownError;
     }
 
+    LOG(DEBUG) << "Finished reading files - terminated";
+    finish(response_code);
+    return false;
+}
+
+bool Workload::end_slice(std::atomic<bool> & stopped)
+{
+    // the remaining batches are not requested once stopped
+    if (_current < size() && !stopped)
+    {
+        return true;
+    }
+
+    LOG(DEBUG) << "Finished reading files "  << (stopped ? " - terminated" : " successfully");
+    finish(stopped ? common::ResponseCode::FinishedError : common::ResponseCode::Success);
+    return false;
+}
+
+void Workload::drain(std::atomic<bool> & stopped)
+{
+    if (_reader == nullptr || _finished)
+    {
+        return;
+    }
+
+    // the pending reads and the remaining slices are read synchronously
+    common::Metrics::Usage usage;
+    while (async_read(stopped, std::numeric_limits<size_t>::max()))
+    {}
+}
+
+bool Workload::finished() const
+{
+    return _finished;
+}
+
+unsigned Workload::inflight() const
+{
+    unsigned submitted = 0;
+    for (const auto & [file_index, batch] : _batches_by_file_index)
+    {
+        submitted += batch.submitted();
+    }
+    return submitted - _handled;
+}
+
+void Workload::open(common::backend_api::ObjectCompletionNotification_t notification, void * context)
+{
+    assign_global_ids();
+    for (const auto & [file_index, batch] : _batches_by_file_index)
+    {
+        _error_by_file_index[file_index] = common::ResponseCode::Success;
+    }
+
+    const auto & batch = _batches_by_file_index.begin()->second;
+    const auto & params = batch.object_storage_params;
+    const auto locations = batch.config->mirrors.of(*params.uri);
+    // the client of the requested location
+    unsigned default_mirror = 0;
+
+    // the clients wake a caller which blocks on several sources (mirrors, other processes or caches), and the notifier forwards their completions to an event driven caller
+    if ((!locations.empty() || _dedup || !_caches.empty()) && (notification != nullptr || common::s3::S3ClientWrapper::notification_supported(params)))
+    {
+        _notifier = std::make_shared<Notifier>(notification, context);
+    }
+
+    if (locations.empty())
+    {
+        _reader = create_reader(params, *batch.config, notification, context);
+    }
+    else
+    {
+        LOG(DEBUG) << "Reading from " << locations.size() << " mirrors";
+        std::vector<std::shared_ptr<Reader>> readers;
+        for (unsigned i = 0; i < locations.size(); ++i)
+        {
+            readers.push_back(create_reader(common::s3::Mirrors::mirror(params, locations[i]), *batch.config, notification, context));
+            if (locations[i].contains(*params.uri))
+            {
+                default_mirror = i;
+            }
+        }
+        _reader = std::make_shared<Mirrored>(locations, readers, default_mirror, _notifier);
+    }
+
+    // object versions are retrieved by the streamer concurrently, and are usually ready by the time the object is read
+    auto version = [versions = _versions](const common::s3::S3ClientWrapper::Params & params) -> std::optional<std::string>
+    {
+        if (versions == nullptr)
+        {
+            return std::nullopt;
+        }
+
+        const auto it = versions->find(params.uri->uri);
+        return it == versions->end() ? std::nullopt : it->second.get();
+    };
+
+    // the local caches are checked before waiting for other processes or reading from the object storage
+    // ranges found in a slower cache are also kept in the faster caches
+    if (_dedup)
+    {
+        _reader = std::make_shared<Shared>(_reader, _dedup, version, _cancellation, notification, context, _notifier);
+    }
+
+    for (auto it = _caches.rbegin(); it != _caches.rend(); ++it)
+    {
+        _reader = std::make_shared<Cached>(_reader, *it, version, notification, context, _notifier);
+    }
+}
+
+void Workload::submit(std::atomic<bool> & stopped, size_t bytesize)
+{
+    size_t requested = 0;
+    while (_current < size() && requested < bytesize)
+    {
+        auto & [file_index, batch] = *std::next(_batches_by_file_index.begin(), _current);
+        const auto before = batch.requested_bytesize();
+        const auto response_code = handle_batch(file_index, batch, stopped, bytesize - requested);
+        requested += batch.requested_bytesize() - before;
+
+        // a batch which failed is not requested anymore, and its tasks are answered with its error when the workload finishes
+        if (response_code != common::ResponseCode::Success || batch.requested())
+        {
+            _error_by_file_index[file_index] = response_code;
+            ++_current;
+        }
+    }
+}
+
+std::shared_ptr<Reader> Workload::create_reader(const common::s3::S3ClientWrapper::Params & params, const Config & config, common::backend_api::ObjectCompletionNotification_t notification, void * context)
+{
+    auto client = std::make_shared<common::s3::S3ClientWrapper>(params);
+    _clients.push_back(client);
+
+    // the notification is registered before submitting, so that no completion is missed
+    // with a notifier, the client notifies it and the notifier forwards the completions to the notification
+    auto client_notification = notification;
+    void * client_context = context;
+    if (_notifier != nullptr)
+    {
+        client_notification = Notifier::notify;
+        client_context = _notifier.get();
+    }
+
+    if (client_notification != nullptr && !client->set_notification(client_notification, client_context))
+    {
+        LOG(ERROR) << "Object storage backend does not support completion notifications";
+        throw common::Exception(common::ResponseCode::UnknownError);
+    }
+
+    // register the client so that its pending requests are canceled in the backend when the request is canceled
+    if (_cancellation)
+    {
+        _cancellation->add(client.get());
+    }
+
+    // only reads from the object storage are limited, while ranges found in the caches or in other processes are not
+    // reads of event driven workloads which exceed the limit are deferred, so that they do not occupy the executor threads while waiting
+    return std::make_shared<S3>(client, config, _bandwidth, _cancellation, notification, context);
+}
+
+void Workload::cancel()
+{
+    finish(common::ResponseCode::FinishedError);
+}
+
+void Workload::finish(common::ResponseCode response_code)
+{
+    _finished = true;
+
+    // release the clients, which also unregisters their notifications
+    _reader.reset();
+    for (auto & client : _clients)
+    {
+        if (_cancellation)
+        {
+            _cancellation->remove(client.get());
+        }
+    }
+    _clients.clear();
+    _notifier.reset();
+
     for (auto & [file_index, batch] : _batches_by_file_index)
     {
         auto error_code = response_code;
@@ -151,18 +463,21 @@ void Workload::async_read(std::atomic<bool> & stopped)
     }
 }
 
-common::ResponseCode Workload::handle_batch(unsigned file_index, Batch & batch, std::atomic<bool> & stopped)
+common::ResponseCode Workload::handle_batch(unsigned file_index, Batch & batch, std::atomic<bool> & stopped, size_t bytesize)
 {
     LOG(SPAM) << "Requesting batch " << batch;
     auto batch_response_code = common::ResponseCode::Success;
 
     try
     {
-        batch.request(_reader, stopped);
+        batch.request(_reader, stopped, bytesize);
     }
     catch(const common::Exception & e)
     {
-        LOG(ERROR) << "Error " << e.error() << " while requesting batch " << batch;
+        if (e.error() != common::ResponseCode::FinishedError)
+        {
+            LOG(ERROR) << "Error " << e.error() << " while requesting batch " << batch;
+        }
         batch_response_code = e.error();
     }
     catch (...)
@@ -176,52 +491,58 @@ common::ResponseCode Workload::handle_batch(unsigned file_index, Batch & batch,
 
 void Workload::wait_for_responses(std::atomic<bool> & stopped)
 {
-    if (stopped)
-    {
-        LOG(DEBUG) << "Terminated while waiting for responses";
-        throw common::Exception(common::ResponseCode::FinishedError);
-    }
-
-    // wait for responses from the reader
-    // stopped flag was propagated to the storage backend when the request was made, and the storage backend is responsible for returning FinishedError when stopped flag is set
-    while (true)
+    // wait for the responses of the submitted reads from the reader
+    // pending requests are canceled in the storage backend when the workload is stopped, and the storage backend is responsible for returning FinishedError once they were canceled
+    while (inflight() > 0)
     {
         std::vector<common::backend_api::Response> responses;
-        auto r = _reader->async_response(responses, 1);
-        if (r == common::ResponseCode::FinishedError)
+        auto r = _reader->async_response(responses, 1, common::backend_api::OBJECT_WAIT_MODE_BLOCK);
+        if (r != common::ResponseCode::Success || responses.empty())
         {
-            LOG(DEBUG) << "FinishedError while waiting for responses";
-            throw common::Exception(common::ResponseCode::FinishedError);
+            LOG(DEBUG) << "Error " << r << " while waiting for responses";
+            throw common::Exception(r == common::ResponseCode::Success ? common::ResponseCode::UnknownError : r);
         }
 
-        const auto & response = responses.back();
+        handle_response(responses.back());
+    }
+}
 
-        if (response.ret == common::ResponseCode::FinishedError)
-        {
-            LOG(DEBUG) << "FinishedError while waiting for responses";
-            throw common::Exception(common::ResponseCode::FinishedError);
-        }
+void Workload::handle_response(const common::backend_api::Response & response)
+{
+    ++_handled;
 
-        ASSERT(response.handle >= _global_id_base) << "Received response with invalid handle " << response.handle << " expected at least " << _global_id_base;
+    if (response.ret == common::ResponseCode::FinishedError)
+    {
+        LOG(DEBUG) << "FinishedError while waiting for responses";
+        throw common::Exception(common::ResponseCode::FinishedError);
+    }
 
-        auto index = response.handle - _global_id_base;
-        ASSERT(index < _tasks.size()) << "Received response with invalid handle " << response.handle << " expected at most " << _global_id_base + _tasks.size();
+    ASSERT(response.handle >= _global_id_base) << "Received response with invalid handle " << response.handle << " expected at least " << _global_id_base;
 
-        const Task * task_ptr = _tasks[index];
-        ASSERT(task_ptr != nullptr) << "Received response from a null task ; response: " << response;
+    auto index = response.handle - _global_id_base;
+    ASSERT(index < _tasks.size()) << "Received response with invalid handle " << response.handle << " expected at most " << _global_id_base + _tasks.size();
 
-        auto file_index = task_ptr->request->file_index;
-        auto & batch = _batches_by_file_index.at(file_index);
+    const Task * task_ptr = _tasks[index];
+    ASSERT(task_ptr != nullptr) << "Received response from a null task ; response: " << response;
 
-        if (response.ret != common::ResponseCode::Success)
-        {
-            _error_by_file_index.at(file_index) = response.ret;
-        }
+    auto file_index = task_ptr->request->file_index;
+    auto & batch = _batches_by_file_index.at(file_index);
 
-        batch.handle_response(response, task_ptr);
+    // backends report the bytes they transferred on success
+    auto checked = response;
+    const auto expected = batch.read_bytesize(task_ptr);
+    if (checked.ret == common::ResponseCode::Success && checked.bytes_transferred != expected)
+    {
+        LOG(ERROR) << "Received " << checked.bytes_transferred << " bytes for task " << *task_ptr << " ; expected " << expected << " bytes";
+        checked.ret = common::ResponseCode::EofError;
     }
 
-    LOG(DEBUG) << "Finished reading files "  << (stopped ? " - terminated" : " successfully");
+    if (checked.ret != common::ResponseCode::Success)
+    {
+        _error_by_file_index.at(file_index) = checked.ret;
+    }
+
+    batch.handle_response(checked, task_ptr);
 }
 
 }; // namespace runai::llm::streamer::impl
@@ -2,11 +2,20 @@
 #pragma once
 
 #include <atomic>
+#include <limits>
 #include <vector>
+#include <future>
 #include <map>
 #include <memory>
+#include <optional>
 #include <set>
+#include <string>
+#include "streamer/impl/bandwidth/bandwidth.h"
 #include "streamer/impl/batch/batch.h"
+#include "streamer/impl/cache/cache.h"
+#include "streamer/impl/cancellation/cancellation.h"
+#include "streamer/impl/dedup/dedup.h"
+#include "streamer/impl/notifier/notifier.h"
 #include "streamer/impl/reader/reader.h"
 #include "common/s3_wrapper/s3_wrapper.h"
 #include "common/response_code/response_code.h"
@@ -16,33 +25,104 @@ namespace runai::llm::streamer::impl
 
 struct Workload
 {
+    // versions of the objects by their uri, which the streamer retrieves concurrently while the workloads are executed
+    // a workload waits for the version of an object only when its caches or its deduplication first read the object
+    using Versions = std::map<std::string, std::shared_future<std::optional<std::string>>>;
+
     Workload() = default;
+    Workload(std::shared_ptr<Cancellation> cancellation, const std::vector<std::shared_ptr<Cache>> & caches = {}, std::shared_ptr<Dedup> dedup = nullptr, std::shared_ptr<Bandwidth> bandwidth = nullptr, std::shared_ptr<const Versions> versions = nullptr);
     Workload(Workload &&) = default;
     Workload & operator=(Workload &&) = default;
 
     void execute(std::atomic<bool> & stopped);
 
+    // Workloads are read in slices of a bounded number of bytes, so that a scheduler may interleave the slices of several workloads
+    // A slice reads at least the given number of bytes from where the previous slice ended, unless the workload ends first
+
+    // reads the next slice, and returns true if the workload has not finished
+    bool execute(std::atomic<bool> & stopped, size_t bytesize);
+
+    // Event driven execution of object storage workloads, without occupying a thread while waiting for responses
+    // The storage backend calls the notification whenever responses are ready, and the caller then calls poll()
+
+    // submits the requests of the next slice, or of all the batches by default
+    // returns true if responses are pending, or false if the slice has ended, in which case the workload has finished unless finished() is false
+    bool start(std::atomic<bool> & stopped, common::backend_api::ObjectCompletionNotification_t notification, void * context, size_t bytesize = std::numeric_limits<size_t>::max());
+
+    // handles the ready responses without blocking
+    // returns true if responses of the slice are still pending, or false if the slice has ended
+    bool poll(std::atomic<bool> & stopped);
+
+    // blocks until the started workload has finished, reading its remaining slices
+    void drain(std::atomic<bool> & stopped);
+
+    // whether all the tasks of the workload were answered
+    bool finished() const;
+
+    // responds to all the tasks of a workload which was not started, without reading
+    void cancel();
+
     common::ResponseCode add_batch(Batch && batch);
 
     size_t size() const;
 
+    // total number of bytes requested by the batches
+    size_t bytesize() const;
+
     bool is_object_storage() const;
 
+    // slices of the workloads which are scheduled between streamers, which are large enough to keep the storage busy,
+    // and small enough that a request of another streamer does not wait long for a worker
+    static constexpr size_t slice_bytesize = 128 * 1024 * 1024;
+
  private:
     common::ResponseCode verify_batch(const Batch & batch);
     void wait_for_responses(std::atomic<bool> & stopped);
-    void async_read(std::atomic<bool> & stopped);
-    common::ResponseCode handle_batch(unsigned file_index, Batch & batch, std::atomic<bool> & stopped);
+    // reads a slice of object storage batches synchronously, and returns true if the workload has not finished
+    bool async_read(std::atomic<bool> & stopped, size_t bytesize);
+    // creates the reader of the workload
+    void open(common::backend_api::ObjectCompletionNotification_t notification, void * context);
+    // requests the reads of the next slice
+    void submit(std::atomic<bool> & stopped, size_t bytesize);
+    // number of submitted reads which were not answered
+    unsigned inflight() const;
+    // finishes the workload once all its reads were requested and answered, and returns true if batches remain to be requested
+    bool end_slice(std::atomic<bool> & stopped);
+    std::shared_ptr<Reader> create_reader(const common::s3::S3ClientWrapper::Params & params, const Config & config, common::backend_api::ObjectCompletionNotification_t notification, void * context);
+    void handle_response(const common::backend_api::Response & response);
+    // handles the ready responses without blocking, within the usage scope of the caller
+    bool handle_ready(std::atomic<bool> & stopped);
+    void finish(common::ResponseCode response_code);
+    common::ResponseCode handle_batch(unsigned file_index, Batch & batch, std::atomic<bool> & stopped, size_t bytesize);
     void assign_global_ids();
  private:
     std::map<unsigned, Batch> _batches_by_file_index;
     std::map<unsigned, common::ResponseCode> _error_by_file_index;
+    // index of the first batch which was not read or requested to its end
+    unsigned _current = 0;
+    // number of responses handled
+    unsigned _handled = 0;
+    bool _finished = false;
     bool _is_object_storage = false;
+    // a client for each mirror of the object storage location, or a single client if the location is not mirrored
+    std::vector<std::shared_ptr<common::s3::S3ClientWrapper>> _clients;
     std::shared_ptr<Reader> _reader;
+    // wakes a caller waiting for several mirrors or for other processes, or null if the reader has a single source
+    std::shared_ptr<Notifier> _notifier;
     size_t _total_tasks = 0;
     static std::atomic<common::backend_api::ObjectRequestId_t> _async_handle_counter;
+    static constexpr unsigned max_responses_per_poll = 64;
     common::backend_api::ObjectRequestId_t _global_id_base;
     std::vector<const Task*> _tasks;
+    std::shared_ptr<Cancellation> _cancellation;
+    // local caches of object storage reads from the fastest, or none if caching is disabled
+    std::vector<std::shared_ptr<Cache>> _caches;
+    // deduplication of reads between the processes of the node, or null if disabled
+    std::shared_ptr<Dedup> _dedup;
+    // node bandwidth limit of the reads from storage, or null if unlimited
+    std::shared_ptr<Bandwidth> _bandwidth;
+    // versions of the objects for the caches and the deduplication, where objects without a version are neither cached nor shared
+    std::shared_ptr<const Versions> _versions;
 };
 
 }; // namespace runai::llm::streamer::impl
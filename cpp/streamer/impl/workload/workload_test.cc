@@ -3,6 +3,8 @@
 #include <gtest/gtest.h>
 #include <memory>
 #include <atomic>
+#include <algorithm>
+#include <chrono>
 #include <numeric>
 #include <set>
 #include <string>
@@ -129,6 +131,56 @@ TEST(Workload, Sanity)
     }
 }
 
+TEST(Workload, Slices)
+{
+    common::s3::S3ClientWrapper::Params s3_params;
+    std::atomic<bool> stopped(false);
+
+    const auto size = utils::random::number(10000, 100000);
+    const auto data = utils::random::buffer(size);
+    utils::temp::File file(data);
+    const auto num_chunks = utils::random::number(1, 20);
+    const auto chunk_size = utils::random::number<size_t>(1, 1024);
+
+    auto config = std::make_shared<Config>(1, 1, chunk_size, chunk_size, false /* do not force minimum chunk size */);
+    auto responder = std::make_shared<common::Responder>(0);
+    responder->increment(num_chunks);
+
+    std::vector<char> buffer(size);
+    std::vector<std::string> paths = { file.path };
+    std::vector<size_t> file_offsets = { 0 };
+    std::vector<size_t> bytesizes = { static_cast<size_t>(size) };
+    std::vector<void*> dsts = { buffer.data() };
+
+    Assigner assigner(paths, file_offsets, bytesizes, dsts, config);
+    ASSERT_EQ(assigner.num_workloads(), 1);
+    Workload workload;
+    Batches batches(0, assigner.file_assignments(0), config, responder, file.path, s3_params, utils::random::chunks(size, num_chunks));
+    for (size_t j = 0; j < batches.size(); ++j)
+    {
+        workload.add_batch(std::move(batches[j]));
+    }
+
+    // each slice reads at least its bytes, and the workload is read to its end over several slices
+    const auto slice = utils::random::number<size_t>(1000, 5000);
+    unsigned slices = 1;
+    while (workload.execute(stopped, slice))
+    {
+        EXPECT_FALSE(workload.finished());
+        ++slices;
+    }
+    EXPECT_TRUE(workload.finished());
+    EXPECT_LE(slices, (size + slice - 1) / slice);
+    EXPECT_GE(slices, size / (slice + chunk_size));
+
+    for (unsigned i = 0; i < num_chunks; ++i)
+    {
+        EXPECT_EQ(responder->pop().ret, common::ResponseCode::Success);
+    }
+    EXPECT_EQ(responder->pop().ret, common::ResponseCode::FinishedError);
+    EXPECT_TRUE(std::equal(data.begin(), data.end(), reinterpret_cast<const uint8_t *>(buffer.data())));
+}
+
 TEST(Workload, Stopped)
 {
     auto num_files = utils::random::number(1, 10);
@@ -351,4 +403,146 @@ TEST(Workload, Stopped_Async)
     EXPECT_EQ(r.ret, common::ResponseCode::FinishedError);
 }
 
+TEST(Workload, Mirrors)
+{
+    // mock S3
+    utils::Dylib dylib("libstreamers3.so");
+    auto mock_clients = dylib.dlsym<int(*)()>("runai_mock_s3_clients");
+    auto mock_cleanup = dylib.dlsym<void(*)()>("runai_mock_s3_cleanup");
+    mock_cleanup();
+    common::s3::S3ClientWrapper::shutdown();
+    auto guard = utils::ScopeGuard([&mock_cleanup](){
+        mock_cleanup();
+        common::s3::S3ClientWrapper::shutdown();
+    });
+
+    auto num_files = utils::random::number(1, 10);
+
+    std::atomic<bool> stopped(false);
+    std::vector<std::string> paths;
+    std::vector<size_t> file_offsets;
+    std::vector<size_t> bytesizes;
+    std::vector<void*> dsts;
+    std::vector<unsigned> num_chunks(num_files);
+
+    auto config = std::make_shared<Config>(1, 1, utils::random::number<size_t>(1, 1024), utils::random::number<size_t>(1, 1024), false /* do not force minimum chunk size */);
+    config->mirrors = common::s3::Mirrors("s3://test-bucket,s3://mirror-bucket@http://localhost:9000,s3://other-bucket");
+    auto responder = std::make_shared<common::Responder>(0);
+
+    size_t total_bytes = 0;
+    for (unsigned i = 0; i < num_files; ++i)
+    {
+        auto size = utils::random::number(1000, 100000);
+        num_chunks[i] = utils::random::number(1, 20);
+        responder->increment(num_chunks[i]);
+        total_bytes += size;
+
+        paths.push_back("s3://test-bucket/" + utils::random::string());
+        file_offsets.push_back(0);
+        bytesizes.push_back(size);
+    }
+
+    std::vector<char> buffer(total_bytes);
+    dsts.push_back(buffer.data());
+
+    Assigner assigner(paths, file_offsets, bytesizes, dsts, config);
+
+    Workload workload;
+    size_t total_chunks = 0;
+    for (unsigned file_idx = 0; file_idx < num_files; ++file_idx)
+    {
+        auto chunks = utils::random::chunks(bytesizes[file_idx], num_chunks[file_idx]);
+        total_chunks += chunks.size();
+
+        common::s3::S3ClientWrapper::Params s3_params(std::make_shared<common::s3::StorageUri>(paths[file_idx]), utils::random::number<size_t>());
+        Batches batches(file_idx, assigner.file_assignments(file_idx), config, responder, paths[file_idx], s3_params, chunks);
+
+        for (size_t j = 0; j < batches.size(); ++j)
+        {
+            workload.add_batch(std::move(batches[j]));
+        }
+    }
+
+    workload.execute(stopped);
+
+    // a client was created for every mirror
+    EXPECT_EQ(mock_clients(), 3);
+
+    for (size_t i = 0; i < total_chunks; ++i)
+    {
+        const auto r = responder->pop();
+        EXPECT_EQ(r.ret, common::ResponseCode::Success);
+    }
+
+    auto r = responder->pop();
+    EXPECT_EQ(r.ret, common::ResponseCode::FinishedError);
+}
+
+TEST(Workload, Bandwidth_Async)
+{
+    // mock S3
+    utils::Dylib dylib("libstreamers3.so");
+    auto mock_response_time = dylib.dlsym<void(*)(unsigned)>("runai_mock_s3_set_response_time_ms");
+    auto mock_cleanup = dylib.dlsym<void(*)()>("runai_mock_s3_cleanup");
+    mock_response_time(utils::random::number(0, 20));
+    auto guard = utils::ScopeGuard([&mock_cleanup](){
+        mock_cleanup();
+    });
+
+    const std::string name = "/runai-streamer-test-" + utils::random::string();
+    auto unlink = utils::ScopeGuard([&name](){
+        utils::Shm::unlink(name);
+    });
+
+    std::atomic<bool> stopped(false);
+    const auto size = utils::random::number(10000, 100000);
+    const auto num_chunks = utils::random::number(2, 20);
+    std::vector<std::string> paths = { "s3://test-bucket/" + utils::random::string() };
+    std::vector<size_t> file_offsets = { 0 };
+    std::vector<size_t> bytesizes = { static_cast<size_t>(size) };
+    std::vector<char> buffer(size);
+    std::vector<void*> dsts = { buffer.data() };
+
+    auto config = std::make_shared<Config>(1, 1, utils::random::number<size_t>(1, 1024), utils::random::number<size_t>(1, 1024), false /* do not force minimum chunk size */);
+    auto responder = std::make_shared<common::Responder>(0);
+    responder->increment(num_chunks);
+
+    // reading the file takes about half a second at this limit
+    auto bandwidth = std::make_shared<Bandwidth>(size * 2, 1, name);
+
+    Assigner assigner(paths, file_offsets, bytesizes, dsts, config);
+    common::s3::S3ClientWrapper::Params s3_params(std::make_shared<common::s3::StorageUri>(paths[0]), utils::random::number<size_t>());
+    Batches batches(0, assigner.file_assignments(0), config, responder, paths[0], s3_params, utils::random::chunks(size, num_chunks));
+
+    Workload workload(nullptr, {}, nullptr, bandwidth);
+    for (size_t j = 0; j < batches.size(); ++j)
+    {
+        workload.add_batch(std::move(batches[j]));
+    }
+
+    auto sem = utils::Semaphore(0);
+    auto notification = [](void * context) { static_cast<utils::Semaphore *>(context)->post(); };
+
+    // the requests which exceed the limit are deferred instead of blocking the calling thread
+    const auto start = std::chrono::steady_clock::now();
+    auto pending = workload.start(stopped, notification, &sem);
+    EXPECT_LT(std::chrono::steady_clock::now() - start, std::chrono::milliseconds(200));
+
+    while (pending)
+    {
+        sem.wait();
+        pending = workload.poll(stopped);
+    }
+    EXPECT_GE(std::chrono::steady_clock::now() - start, std::chrono::milliseconds(300));
+
+    for (unsigned i = 0; i < num_chunks; ++i)
+    {
+        const auto r = responder->pop();
+        EXPECT_EQ(r.ret, common::ResponseCode::Success);
+    }
+
+    auto r = responder->pop();
+    EXPECT_EQ(r.ret, common::ResponseCode::FinishedError);
+}
+
 }; // namespace runai::llm::streamer::impl
@@ -0,0 +1,264 @@
+// Compares scheduling policies and configurations of the streamer by simulating loads of synthetic models, without reading
+//
+// Usage: simulate [--layouts=<n>] [--files=<n>] [--tensors=<n>] [--tensor-bytesize=<n>] [--sigma=<x>] [--storage=<fs|object>]
+//                 [--concurrency=<n>,...] [--block-bytesize=<n>,...] [--policies=<policy>,...] [--overhead-us=<n>]
+//
+// Every combination of concurrency, block bytesize (of the file system or of object storage) and policy is simulated for the given number of
+// random layouts (default 1000), each of the given files of tensors whose sizes are log-normal around the median tensor bytesize
+// A policy is "default" or a combination of "stealing", "ordered" and "coalesce" joined with '+' (default: default,stealing,ordered,coalesce)
+//
+// The backend is modeled by the RUNAI_STREAMER_EMULATED_* environment variables (e.g. the latency, the stragglers and the bandwidth),
+// and every request waits for the given overhead on top of its latency
+//
+// Every combination reports the mean, median and 99th percentile of the load time, the mean time to first tensor,
+// the mean time at which an in order consumer can use a tensor, and the mean number of requests
+// The combination of the best mean load time is printed at the end
+
+#include <algorithm>
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "emulated/model/model.h"
+#include "streamer/impl/config/config.h"
+#include "streamer/impl/simulator/simulator.h"
+
+namespace runai::llm::streamer::impl
+{
+
+namespace
+{
+
+struct Options
+{
+    unsigned layouts = 1000;
+    unsigned files = 4;
+    unsigned tensors = 256;
+    size_t tensor_bytesize = 4 * 1024 * 1024;
+    double sigma = 1.0;
+    bool object_storage = true;
+
+    std::vector<unsigned> concurrency = { 16 };
+    std::vector<size_t> block_bytesize = { 8 * 1024 * 1024 };
+    std::vector<std::string> policies = { "default", "stealing", "ordered", "coalesce" };
+    std::chrono::microseconds overhead = std::chrono::microseconds(0);
+};
+
+struct Configuration
+{
+    unsigned concurrency;
+    size_t block_bytesize;
+    Policy policy;
+};
+
+std::ostream & operator<<(std::ostream & os, const Configuration & configuration)
+{
+    return os << "concurrency " << configuration.concurrency
+              << ", block bytesize " << configuration.block_bytesize
+              << ", policy " << configuration.policy;
+}
+
+std::vector<std::string> split(const std::string & s)
+{
+    std::vector<std::string> values;
+    size_t begin = 0;
+    while (begin <= s.size())
+    {
+        const auto end = std::min(s.find(',', begin), s.size());
+        values.push_back(s.substr(begin, end - begin));
+        begin = end + 1;
+    }
+    return values;
+}
+
+bool parse(int argc, char * argv[], Options & options)
+{
+    for (int i = 1; i < argc; ++i)
+    {
+        const std::string arg = argv[i];
+        const auto equal = arg.find('=');
+        if (arg.compare(0, 2, "--") != 0 || equal == std::string::npos)
+        {
+            std::cerr << "Expected --<option>=<value> instead of " << arg << std::endl;
+            return false;
+        }
+
+        const auto name = arg.substr(2, equal - 2);
+        const auto value = arg.substr(equal + 1);
+        const auto values = split(value);
+
+        if (name == "layouts")
+        {
+            options.layouts = std::stoul(value);
+        }
+        else if (name == "files")
+        {
+            options.files = std::stoul(value);
+        }
+        else if (name == "tensors")
+        {
+            options.tensors = std::stoul(value);
+        }
+        else if (name == "tensor-bytesize")
+        {
+            options.tensor_bytesize = std::stoul(value);
+        }
+        else if (name == "sigma")
+        {
+            options.sigma = std::stod(value);
+        }
+        else if (name == "storage" && (value == "fs" || value == "object"))
+        {
+            options.object_storage = value == "object";
+        }
+        else if (name == "concurrency")
+        {
+            options.concurrency.clear();
+            for (const auto & v : values)
+            {
+                options.concurrency.push_back(std::stoul(v));
+            }
+        }
+        else if (name == "block-bytesize")
+        {
+            options.block_bytesize.clear();
+            for (const auto & v : values)
+            {
+                options.block_bytesize.push_back(std::stoul(v));
+            }
+        }
+        else if (name == "policies")
+        {
+            options.policies = values;
+        }
+        else if (name == "overhead-us")
+        {
+            options.overhead = std::chrono::microseconds(std::stoul(value));
+        }
+        else
+        {
+            std::cerr << "Unknown option " << arg << std::endl;
+            return false;
+        }
+    }
+
+    const auto positive = [](const auto & values) { return std::find(values.begin(), values.end(), 0) == values.end(); };
+
+    return options.layouts && options.files && options.tensors && options.tensor_bytesize && options.sigma >= 0 &&
+           positive(options.concurrency) && positive(options.block_bytesize);
+}
+
+double seconds(std::chrono::microseconds duration)
+{
+    return std::chrono::duration<double>(duration).count();
+}
+
+double percentile(std::vector<double> values, double p)
+{
+    std::sort(values.begin(), values.end());
+    return values[std::min(values.size() - 1, static_cast<size_t>(p * values.size()))];
+}
+
+} // namespace
+
+int simulate(int argc, char * argv[])
+{
+    Options options;
+    std::vector<Configuration> configurations;
+    try
+    {
+        if (!parse(argc, argv, options))
+        {
+            throw std::invalid_argument("options");
+        }
+
+        for (auto concurrency : options.concurrency)
+        {
+            for (auto block_bytesize : options.block_bytesize)
+            {
+                for (const auto & policy : options.policies)
+                {
+                    configurations.push_back({concurrency, block_bytesize, Policy::parse(policy)});
+                }
+            }
+        }
+    }
+    catch (const std::exception &)
+    {
+        std::cerr << "Usage: " << argv[0] << " [--layouts=<n>] [--files=<n>] [--tensors=<n>] [--tensor-bytesize=<n>] [--sigma=<x>] [--storage=<fs|object>]" << std::endl
+                  << "       [--concurrency=<n>,...] [--block-bytesize=<n>,...] [--policies=<policy>,...] [--overhead-us=<n>]" << std::endl;
+        return 1;
+    }
+
+    const auto profile = emulated::Profile::from_env();
+    std::cout << "backend: " << profile << ", overhead " << options.overhead.count() << " us" << std::endl;
+
+    std::vector<Layout> layouts;
+    for (unsigned i = 0; i < options.layouts; ++i)
+    {
+        layouts.push_back(Layout::synthetic(profile.seed + i, options.files, options.tensors, options.tensor_bytesize, options.sigma));
+    }
+
+    std::cout << std::fixed << std::setprecision(3);
+
+    const Configuration * best = nullptr;
+    double best_total = 0;
+
+    for (const auto & configuration : configurations)
+    {
+        // the concurrency and the block bytesize apply to both storages, where only one of them is simulated
+        auto config = std::make_shared<Config>(configuration.concurrency, configuration.concurrency, configuration.block_bytesize, configuration.block_bytesize, false);
+        Simulator simulator(config, profile, options.overhead, configuration.policy);
+
+        const auto start = std::chrono::steady_clock::now();
+
+        std::vector<double> totals;
+        double first = 0;
+        double in_order = 0;
+        double requests = 0;
+        for (unsigned i = 0; i < layouts.size(); ++i)
+        {
+            const auto simulation = simulator.run(layouts[i], options.object_storage, i);
+            totals.push_back(seconds(simulation.total));
+            first += seconds(simulation.first);
+            in_order += seconds(simulation.in_order);
+            requests += simulation.requests;
+        }
+
+        double total = 0;
+        for (auto t : totals)
+        {
+            total += t;
+        }
+        total /= layouts.size();
+
+        std::cout << configuration << ": load " << total << " s (p50 " << percentile(totals, 0.5) << " s, p99 " << percentile(totals, 0.99) << " s), "
+                  << "first tensor " << first / layouts.size() << " s, in order " << in_order / layouts.size() << " s, "
+                  << static_cast<size_t>(requests / layouts.size()) << " requests - simulated in "
+                  << std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count() << " s" << std::endl;
+
+        if (best == nullptr || total < best_total)
+        {
+            best_total = total;
+            best = &configuration;
+        }
+    }
+
+    if (configurations.size() > 1 && best != nullptr)
+    {
+        std::cout << "best: " << *best << " - " << best_total << " s" << std::endl;
+    }
+
+    return 0;
+}
+
+}; // namespace runai::llm::streamer::impl
+
+int main(int argc, char * argv[])
+{
+    return runai::llm::streamer::impl::simulate(argc, argv);
+}
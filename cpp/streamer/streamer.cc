@@ -4,6 +4,9 @@
 #include <string>
 #include <vector>
 
+#include "common/exception/exception.h"
+#include "common/metrics/metrics.h"
+#include "common/trace/trace.h"
 #include "common/response_code/response_code.h"
 #include "streamer/impl/streamer/streamer.h"
 
@@ -113,6 +116,10 @@ _RUNAI_EXTERN_C int runai_request(
 
         return static_cast<int>(s->async_request(paths_v, file_offsets_v, bytesizes_v, dsts_v, num_sizes_v, internal_sizes_vv, credentials));
     }
+    catch(const common::Exception & e)
+    {
+        return static_cast<int>(e.error());
+    }
     catch(...)
     {
     }
@@ -148,6 +155,349 @@ _RUNAI_EXTERN_C int runai_response(void * streamer, unsigned * file_index /* ret
     return static_cast<int>(common::ResponseCode::UnknownError);
 }
 
+// receive the ready responses without waiting
+//
+// streamer : streamer object
+// return Success if num_responses responses are valid (may be 0), or FinishedError if no more responses are expected
+
+_RUNAI_EXTERN_C int runai_responses(void * streamer, unsigned max_responses, unsigned * file_indices, unsigned * indices, int * response_codes, unsigned * num_responses)
+{
+    try
+    {
+        if (streamer == nullptr || file_indices == nullptr || indices == nullptr || response_codes == nullptr || num_responses == nullptr || max_responses == 0)
+        {
+            return static_cast<int>(common::ResponseCode::InvalidParameterError);
+        }
+
+        auto * s = static_cast<impl::Streamer *>(streamer);
+
+        std::vector<common::Response> responses;
+        auto ret = s->responses(responses, max_responses);
+
+        *num_responses = responses.size();
+        for (size_t i = 0; i < responses.size(); ++i)
+        {
+            file_indices[i] = responses[i].file_index;
+            indices[i] = responses[i].index;
+            response_codes[i] = static_cast<int>(responses[i].ret);
+        }
+
+        return static_cast<int>(ret);
+    }
+    catch(...)
+    {
+    }
+    return static_cast<int>(common::ResponseCode::UnknownError);
+}
+
+// event file descriptor signaled when responses are ready
+//
+// streamer : streamer object
+// return Success if fd is valid
+
+_RUNAI_EXTERN_C int runai_response_eventfd(void * streamer, int * fd)
+{
+    try
+    {
+        if (streamer == nullptr || fd == nullptr)
+        {
+            return static_cast<int>(common::ResponseCode::InvalidParameterError);
+        }
+
+        auto * s = static_cast<impl::Streamer *>(streamer);
+        *fd = s->eventfd();
+        return static_cast<int>(common::ResponseCode::Success);
+    }
+    catch(...)
+    {
+    }
+    return static_cast<int>(common::ResponseCode::UnknownError);
+}
+
+// register completion callback
+//
+// streamer : streamer object
+// callback : called from the worker threads with batches of completed sub requests, or null to unregister
+// user_data : passed to the callback
+// return Success if registered
+
+_RUNAI_EXTERN_C int runai_set_completion_callback(void * streamer, runai_completion_callback_t callback, void * user_data)
+{
+    try
+    {
+        if (streamer == nullptr)
+        {
+            return static_cast<int>(common::ResponseCode::InvalidParameterError);
+        }
+
+        auto * s = static_cast<impl::Streamer *>(streamer);
+
+        common::Responder::Handler handler;
+        if (callback != nullptr)
+        {
+            handler = [callback, user_data](const std::vector<common::Response> & responses)
+            {
+                std::vector<unsigned> file_indices(responses.size());
+                std::vector<unsigned> indices(responses.size());
+                std::vector<int> response_codes(responses.size());
+                for (size_t i = 0; i < responses.size(); ++i)
+                {
+                    file_indices[i] = responses[i].file_index;
+                    indices[i] = responses[i].index;
+                    response_codes[i] = static_cast<int>(responses[i].ret);
+                }
+
+                callback(user_data, responses.size(), file_indices.data(), indices.data(), response_codes.data());
+            };
+        }
+
+        return static_cast<int>(s->set_completion_handler(handler));
+    }
+    catch(...)
+    {
+    }
+    return static_cast<int>(common::ResponseCode::UnknownError);
+}
+
+// register a readiness array
+//
+// streamer : streamer object
+// entries : caller memory with an entry per sub request, or null to unregister
+// num_entries : number of entries
+// return Success if registered
+
+_RUNAI_EXTERN_C int runai_set_readiness(void * streamer, unsigned * entries, unsigned num_entries)
+{
+    try
+    {
+        if (streamer == nullptr)
+        {
+            return static_cast<int>(common::ResponseCode::InvalidParameterError);
+        }
+
+        auto * s = static_cast<impl::Streamer *>(streamer);
+        return static_cast<int>(s->set_readiness(reinterpret_cast<uint32_t *>(entries), num_entries));
+    }
+    catch(...)
+    {
+    }
+    return static_cast<int>(common::ResponseCode::UnknownError);
+}
+
+// wait until a readiness entry is set
+//
+// entry : entry of the readiness array
+// return the response code of the sub request
+
+_RUNAI_EXTERN_C int runai_wait_ready(unsigned * entry)
+{
+    try
+    {
+        if (entry == nullptr)
+        {
+            return static_cast<int>(common::ResponseCode::InvalidParameterError);
+        }
+
+        return static_cast<int>(impl::Readiness::wait(reinterpret_cast<uint32_t *>(entry)));
+    }
+    catch(...)
+    {
+    }
+    return static_cast<int>(common::ResponseCode::UnknownError);
+}
+
+// prefetch ranges ahead of the following requests
+//
+// streamer : streamer object
+// num_files : number of files to prefetch
+// paths : list of files paths
+// file_offsets : offset for each file path, from which to prefetch
+// bytesizes : number of bytes to prefetch from each file
+// return Success if the request is valid
+
+_RUNAI_EXTERN_C int runai_prefetch(
+    void * streamer,
+    unsigned num_files,
+    const char ** paths,
+    size_t * file_offsets,
+    size_t * bytesizes,
+    const char * key,
+    const char * secret,
+    const char * token,
+    const char * region,
+    const char * endpoint
+)
+{
+    try
+    {
+        auto s = static_cast<impl::Streamer *>(streamer);
+        if (s == nullptr)
+        {
+            return static_cast<int>(common::ResponseCode::InvalidParameterError);
+        }
+
+        common::s3::Credentials credentials(key, secret, token, region, endpoint);
+
+        std::vector<std::string> paths_v(paths, paths + num_files);
+        std::vector<size_t> file_offsets_v(file_offsets, file_offsets + num_files);
+        std::vector<size_t> bytesizes_v(bytesizes, bytesizes + num_files);
+
+        return static_cast<int>(s->prefetch(paths_v, file_offsets_v, bytesizes_v, credentials));
+    }
+    catch(const common::Exception & e)
+    {
+        return static_cast<int>(e.error());
+    }
+    catch(...)
+    {
+    }
+    return static_cast<int>(common::ResponseCode::UnknownError);
+}
+
+// stop prefetching
+//
+// streamer : streamer object
+// return Success when no more data is prefetched
+
+_RUNAI_EXTERN_C int runai_cancel_prefetch(void * streamer)
+{
+    try
+    {
+        if (streamer == nullptr)
+        {
+            return static_cast<int>(common::ResponseCode::InvalidParameterError);
+        }
+
+        auto * s = static_cast<impl::Streamer *>(streamer);
+        return static_cast<int>(s->cancel_prefetch());
+    }
+    catch(...)
+    {
+    }
+    return static_cast<int>(common::ResponseCode::UnknownError);
+}
+
+// set the scheduling weight of the streamer in the workers shared by the streamers of the process
+//
+// streamer : streamer object
+// weight : positive weight of the following requests
+// return Success, or InvalidParameterError if the weight is zero
+
+_RUNAI_EXTERN_C int runai_set_weight(void * streamer, unsigned weight)
+{
+    try
+    {
+        if (streamer == nullptr)
+        {
+            return static_cast<int>(common::ResponseCode::InvalidParameterError);
+        }
+
+        auto * s = static_cast<impl::Streamer *>(streamer);
+        return static_cast<int>(s->set_weight(weight));
+    }
+    catch(...)
+    {
+    }
+    return static_cast<int>(common::ResponseCode::UnknownError);
+}
+
+// statistics of the streamers of the process
+//
+// values : caller array which receives up to max_values statistics
+// num_values : returns the number of statistics
+// return Success
+
+_RUNAI_EXTERN_C int runai_get_stats(size_t * values, unsigned max_values, unsigned * num_values)
+{
+    try
+    {
+        if (num_values == nullptr || (values == nullptr && max_values > 0))
+        {
+            return static_cast<int>(common::ResponseCode::InvalidParameterError);
+        }
+
+        const auto stats = common::Metrics::values();
+
+        *num_values = stats.size();
+        for (size_t i = 0; i < stats.size() && i < max_values; ++i)
+        {
+            values[i] = stats[i];
+        }
+
+        return static_cast<int>(common::ResponseCode::Success);
+    }
+    catch(...)
+    {
+    }
+    return static_cast<int>(common::ResponseCode::UnknownError);
+}
+
+_RUNAI_EXTERN_C const char * runai_stat_name(unsigned index)
+{
+    try
+    {
+        const auto & names = common::Metrics::names();
+        if (index < names.size())
+        {
+            return names[index].c_str();
+        }
+    }
+    catch(...)
+    {
+    }
+    return nullptr;
+}
+
+// write the recorded timeline
+//
+// path : file to write
+// return Success if written
+
+_RUNAI_EXTERN_C int runai_write_trace(const char * path)
+{
+    try
+    {
+        if (path == nullptr)
+        {
+            return static_cast<int>(common::ResponseCode::InvalidParameterError);
+        }
+
+        common::Trace::write(path);
+        return static_cast<int>(common::ResponseCode::Success);
+    }
+    catch(const common::Exception & e)
+    {
+        return static_cast<int>(e.error());
+    }
+    catch(...)
+    {
+    }
+    return static_cast<int>(common::ResponseCode::UnknownError);
+}
+
+// cancel the running request
+//
+// streamer : streamer object
+// return Success when the request was canceled and its destination buffers can be released
+
+_RUNAI_EXTERN_C int runai_cancel(void * streamer)
+{
+    try
+    {
+        if (streamer == nullptr)
+        {
+            return static_cast<int>(common::ResponseCode::InvalidParameterError);
+        }
+
+        auto * s = static_cast<impl::Streamer *>(streamer);
+        return static_cast<int>(s->cancel());
+    }
+    catch(...)
+    {
+    }
+    return static_cast<int>(common::ResponseCode::UnknownError);
+}
+
 const char * unexpected_error = "Unexpected error occured";
 
 _RUNAI_EXTERN_C const char * runai_response_str(int response_code)
@@ -56,6 +56,140 @@ _RUNAI_EXTERN_C int runai_request(
 
 _RUNAI_EXTERN_C int runai_response(void * streamer, unsigned * file_index /* return parameter */, unsigned * index /* return parameter */);
 
+// receive the ready responses without waiting
+//
+// max_responses : capacity of the output arrays
+// file_indices, indices, response_codes : output arrays of the ready responses
+// num_responses : number of responses written to the output arrays (may be 0)
+// return Success, or FinishedError if no more responses are expected
+
+_RUNAI_EXTERN_C int runai_responses(
+    void * streamer,
+    unsigned max_responses,
+    unsigned * file_indices /* return parameter */,
+    unsigned * indices /* return parameter */,
+    int * response_codes /* return parameter */,
+    unsigned * num_responses /* return parameter */);
+
+// event file descriptor for event loops (e.g. epoll, asyncio)
+//
+// the descriptor is non blocking and becomes readable when responses are ready, or when the request is canceled
+// the caller reads the descriptor to reset it, and then receives the ready responses with runai_responses
+// the descriptor is owned by the streamer and is closed by runai_end
+// return Success
+
+_RUNAI_EXTERN_C int runai_response_eventfd(void * streamer, int * fd /* return parameter */);
+
+// completion callback
+//
+// called with a batch of completed sub requests, where the arrays are valid only during the call
+// threading contract:
+//     - called from the streamer worker threads, possibly concurrently - the callback must be thread safe
+//     - the worker does not read until the callback returns - the callback should not block
+//     - the callback must not call the streamer API (e.g. runai_request, runai_cancel, runai_end)
+//     - all the callbacks of a request have returned when runai_response returns FinishedError
+
+typedef void (*runai_completion_callback_t)(void * user_data, unsigned num_responses, const unsigned * file_indices, const unsigned * indices, const int * response_codes);
+
+// register a completion callback, which replaces receiving responses with runai_response / runai_responses
+// while a callback is registered, runai_response waits until the request is completed and returns FinishedError
+// pass a null callback to unregister
+// return Success, or BusyError if a request is running
+
+_RUNAI_EXTERN_C int runai_set_completion_callback(void * streamer, runai_completion_callback_t callback, void * user_data);
+
+// readiness array
+//
+// caller memory with an entry per sub request, which lets a consumer check whether a specific sub request is ready without calling the library
+// the entry of sub request j of file i is at num_sizes[0] + ... + num_sizes[i-1] + j
+// every following runai_request zeroes the entries of the request, and a worker sets an entry with a release store when its sub request completes:
+//     0 - pending
+//     otherwise - the sub request response code + 1 (i.e. 1 on success)
+// the most significant bit is reserved for waiting consumers, so a spinning consumer should test the lower 31 bits with an acquire load
+// entries are set before the corresponding responses are delivered, and also when the request is canceled (FinishedError)
+// the memory may be shared between processes, and must remain valid until the array is unset or the streamer ends
+
+// register a readiness array of num_entries entries for the following requests
+// runai_request fails with InvalidParameterError if the array is smaller than the number of sub requests
+// pass a null array to unregister
+// return Success, or BusyError if a request is running
+
+_RUNAI_EXTERN_C int runai_set_readiness(void * streamer, unsigned * entries, unsigned num_entries);
+
+// wait until a readiness entry is set (futex wait, no busy loop)
+// return the response code of the sub request
+
+_RUNAI_EXTERN_C int runai_wait_ready(unsigned * entry);
+
+// prefetch
+//
+// warms the storage of ranges which are going to be requested soon, without destination buffers, e.g. once a model is known to be loaded on this node
+// file system ranges are read ahead into the page cache, and object storage ranges are read into the local cache (RUNAI_STREAMER_CACHE_DIR or RUNAI_STREAMER_SNAPSHOT_DIR)
+// prefetching runs in the background on the workers of the process, only while no request is pending, and may be sent while a request is running
+// prefetching is best effort - failures are logged and returned by the following requests of the ranges
+// return Success, or InvalidParameterError for object storage paths if there is no local cache
+
+_RUNAI_EXTERN_C int runai_prefetch(
+    void * streamer,
+    unsigned num_files,
+    const char ** paths,
+    size_t * file_offsets,
+    size_t * bytesizes,
+    const char * key,
+    const char * secret,
+    const char * token,
+    const char * region,
+    const char * endpoint
+);
+
+// stop prefetching
+// returns when no more data is prefetched
+// return Success
+
+_RUNAI_EXTERN_C int runai_cancel_prefetch(void * streamer);
+
+// scheduling weight
+//
+// the streamers of a process share a single pool of workers, which is divided between concurrent requests in proportion to the weights of their streamers
+// requests are read in slices of a bounded size, from files and from object storage alike, so that a long request does not hold the workers of a shorter one
+// e.g. a load of a base model with weight 4 next to a load of an adapter with weight 1 by another streamer reads four slices of the model for every slice of the adapter
+// prefetching runs in the background, only while no request of any streamer is waiting for the workers, regardless of the weight
+// the weight applies to the following requests, and the default weight is 1
+// return Success, or InvalidParameterError if the weight is zero
+
+_RUNAI_EXTERN_C int runai_set_weight(void * streamer, unsigned weight);
+
+// statistics of the streamers of the process, which may be polled from another thread during a load
+//
+// values : caller array which receives up to max_values statistics, in the order of their names
+// num_values : returns the number of statistics, which may exceed max_values
+// statistics are cumulative counts (e.g. bytes and operations of each backend, retries), current levels (e.g. queued jobs, open descriptors)
+// and percentiles of latency histograms in microseconds (e.g. chunk_latency_us_p99, first_response_us_p50)
+// return Success
+
+_RUNAI_EXTERN_C int runai_get_stats(size_t * values, unsigned max_values, unsigned * num_values /* return parameter */);
+
+// name of the statistic of the given index, or null if there is no such statistic
+
+_RUNAI_EXTERN_C const char * runai_stat_name(unsigned index);
+
+// write the timeline of the streamer threads to a file, in the Chrome trace event format which Perfetto opens
+//
+// the timeline is recorded once a streamer was started with RUNAI_STREAMER_TRACE, which also writes it to that file on runai_end
+// spans cover request planning, workloads, file system block reads, object storage requests, and pushing and receiving responses
+// return Success, or FileAccessError if the file could not be written
+
+_RUNAI_EXTERN_C int runai_write_trace(const char * path);
+
+// cancel the running request
+//
+// returns when no more data is written to the destination buffers of the running request, which can then be released
+// a pending or following call to runai_response returns FinishedError, and a new request can be sent
+// may be called from another thread while waiting in runai_response
+// return Success (also if there is no running request)
+
+_RUNAI_EXTERN_C int runai_cancel(void * streamer);
+
 _RUNAI_EXTERN_C const char * runai_response_str(int response_code);
 
 } // namespace runai::llm::streamer
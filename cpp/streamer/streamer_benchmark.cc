@@ -0,0 +1,83 @@
+#include "streamer/streamer.h"
+
+#include <benchmark/benchmark.h>
+
+#include <string>
+#include <vector>
+
+#include "common/response_code/response_code.h"
+
+#include "utils/dylib/dylib.h"
+#include "utils/random/random.h"
+
+namespace runai::llm::streamer
+{
+
+// overhead of a request of small tensors and receiving its responses, where the mock object storage backend responds immediately
+void BM_Request(benchmark::State & state)
+{
+    const unsigned num_files = state.range(0);
+    const unsigned num_tensors = state.range(1);
+    const size_t tensor_bytesize = 4 * 1024;
+
+    const std::string bucket = utils::random::string();
+
+    std::vector<std::string> paths;
+    std::vector<const char *> names;
+    std::vector<size_t> offsets(num_files, 0);
+    std::vector<size_t> sizes(num_files, num_tensors * tensor_bytesize);
+    std::vector<unsigned> num_sizes(num_files, num_tensors);
+    std::vector<size_t> tensor_sizes(num_tensors, tensor_bytesize);
+    std::vector<size_t *> internal_sizes(num_files, tensor_sizes.data());
+    std::vector<char> buffer(num_files * num_tensors * tensor_bytesize);
+    std::vector<void *> dsts = {buffer.data()};
+
+    for (unsigned i = 0; i < num_files; ++i)
+    {
+        paths.push_back("s3://" + bucket + "/" + utils::random::string());
+    }
+    for (const auto & path : paths)
+    {
+        names.push_back(path.c_str());
+    }
+
+    void * streamer;
+    if (runai_start(&streamer) != static_cast<int>(common::ResponseCode::Success))
+    {
+        state.SkipWithError("Failed starting the streamer");
+        return;
+    }
+
+    for (auto _ : state)
+    {
+        if (runai_request(streamer, num_files, names.data(), offsets.data(), sizes.data(), dsts.data(), num_sizes.data(), internal_sizes.data(), nullptr, nullptr, nullptr, nullptr, nullptr) != static_cast<int>(common::ResponseCode::Success))
+        {
+            state.SkipWithError("Failed sending a request");
+            break;
+        }
+
+        unsigned file_index;
+        unsigned index;
+        int response_code;
+        while ((response_code = runai_response(streamer, &file_index, &index)) == static_cast<int>(common::ResponseCode::Success))
+        {}
+
+        if (response_code != static_cast<int>(common::ResponseCode::FinishedError))
+        {
+            state.SkipWithError("Failed receiving the responses");
+            break;
+        }
+    }
+
+    runai_end(streamer);
+
+    // the mock backend is stopped when a streamer ends, and is reset for the following benchmarks
+    utils::Dylib dylib("libstreamers3.so");
+    dylib.dlsym<void(*)()>("runai_mock_s3_cleanup")();
+
+    state.SetItemsProcessed(state.iterations() * num_files * num_tensors);
+}
+
+BENCHMARK(BM_Request)->ArgsProduct({{1, 8, 64}, {1, 64, 1024}})->ArgNames({"files", "tensors"})->UseRealTime();
+
+}; // namespace runai::llm::streamer
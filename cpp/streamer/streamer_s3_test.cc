@@ -364,6 +364,85 @@ TEST_F(StreamerTest, End_During_Async_Read)
     }
 }
 
+TEST_F(StreamerTest, Cancel_During_Async_Read)
+{
+    utils::Dylib dylib("libstreamers3.so");
+    auto verify_mock = dylib.dlsym<int(*)(void)>("runai_mock_s3_clients");
+    auto mock_cleanup = dylib.dlsym<void(*)()>("runai_mock_s3_cleanup");
+    auto mock_response_time = dylib.dlsym<void(*)(unsigned)>("runai_mock_s3_set_response_time_ms");
+    auto set_backend_shutdown_policy = dylib.dlsym<void(*)(common::backend_api::ObjectShutdownPolicy_t)>("runai_s3_mock_set_backend_shutdown_policy");
+    set_backend_shutdown_policy(common::backend_api::ObjectShutdownPolicy_t::OBJECT_SHUTDOWN_POLICY_ON_PROCESS_EXIT);
+
+    void * streamer;
+    auto res = runai_start(&streamer);
+    EXPECT_EQ(res, static_cast<int>(common::ResponseCode::Success));
+
+    // nothing to cancel
+    EXPECT_EQ(runai_cancel(streamer), static_cast<int>(common::ResponseCode::Success));
+
+    mock_response_time(200);
+
+    res = runai_request(streamer,
+                        num_files,
+                        file_names.data(),
+                        file_offsets.data(),
+                        sizes.data(),
+                        dsts.data(),
+                        num_ranges.data(),
+                        internal_sizes.data(),
+                        nullptr,
+                        nullptr,
+                        nullptr,
+                        nullptr,
+                        nullptr);
+    EXPECT_EQ(res, static_cast<int>(common::ResponseCode::Success));
+
+    ::usleep(utils::random::number(300));
+
+    EXPECT_EQ(runai_cancel(streamer), static_cast<int>(common::ResponseCode::Success));
+
+    unsigned r;
+    unsigned file_index;
+    EXPECT_EQ(runai_response(streamer, &file_index, &r), static_cast<int>(common::ResponseCode::FinishedError));
+
+    // the streamer can be used after canceling
+    mock_response_time(0);
+
+    res = runai_request(streamer,
+                        num_files,
+                        file_names.data(),
+                        file_offsets.data(),
+                        sizes.data(),
+                        dsts.data(),
+                        num_ranges.data(),
+                        internal_sizes.data(),
+                        nullptr,
+                        nullptr,
+                        nullptr,
+                        nullptr,
+                        nullptr);
+    EXPECT_EQ(res, static_cast<int>(common::ResponseCode::Success));
+
+    for (unsigned i = 0; i < num_expected_responses; ++i)
+    {
+        auto response_code = runai_response(streamer, &file_index, &r);
+        EXPECT_EQ(response_code, static_cast<int>(common::ResponseCode::Success));
+        if (response_code != static_cast<int>(common::ResponseCode::Success))
+        {
+            break;
+        }
+        EXPECT_LT(file_index, num_files);
+        EXPECT_EQ(expected_response[file_index].count(r), 1);
+        expected_response[file_index].erase(r);
+    }
+
+    EXPECT_EQ(runai_response(streamer, &file_index, &r), static_cast<int>(common::ResponseCode::FinishedError));
+
+    runai_end(streamer);
+    mock_cleanup();
+    EXPECT_EQ(verify_mock(), 0);
+}
+
 TEST_F(StreamerTest, Multiple_Files)
 {
     utils::Dylib dylib("libstreamers3.so");
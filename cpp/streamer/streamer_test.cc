@@ -1,13 +1,18 @@
 #include "streamer/streamer.h"
 
+#include <poll.h>
 #include <unistd.h>
 
 #include <gtest/gtest.h>
 #include <map>
+#include <numeric>
+#include <mutex>
 #include <string>
 #include <vector>
 #include <chrono>
+#include <cstring>
 #include <set>
+#include <thread>
 
 #include "common/response_code/response_code.h"
 
@@ -136,6 +141,84 @@ TEST_F(StreamerTest, Read)
     runai_end(streamer);
 }
 
+TEST_F(StreamerTest, Stats)
+{
+    const auto stats = []()
+    {
+        unsigned num_values = 0;
+        EXPECT_EQ(runai_get_stats(nullptr, 0, &num_values), static_cast<int>(common::ResponseCode::Success));
+        EXPECT_GT(num_values, 0);
+
+        std::vector<size_t> values(num_values);
+        EXPECT_EQ(runai_get_stats(values.data(), values.size(), &num_values), static_cast<int>(common::ResponseCode::Success));
+        EXPECT_EQ(num_values, values.size());
+
+        std::map<std::string, size_t> stats;
+        for (unsigned i = 0; i < num_values; ++i)
+        {
+            const auto name = runai_stat_name(i);
+            EXPECT_NE(name, nullptr);
+            stats[name] = values[i];
+        }
+
+        EXPECT_EQ(runai_stat_name(num_values), nullptr);
+        return stats;
+    };
+
+    const auto before = stats();
+
+    auto size = utils::random::number(100, 1000);
+    utils::temp::File file(utils::random::buffer(size));
+
+    void * streamer;
+    EXPECT_EQ(runai_start(&streamer), static_cast<int>(common::ResponseCode::Success));
+
+    std::vector<unsigned char> v(size);
+    EXPECT_EQ(runai_read_file(streamer, file.path.c_str(), 0, size, v.data()), static_cast<int>(common::ResponseCode::Success));
+
+    auto after = stats();
+    EXPECT_EQ(after.at("file_bytes") - before.at("file_bytes"), size);
+    EXPECT_GT(after.at("file_ops"), before.at("file_ops"));
+    EXPECT_EQ(after.at("requests") - before.at("requests"), 1);
+    EXPECT_EQ(after.at("first_response_us_count") - before.at("first_response_us_count"), 1);
+    EXPECT_GE(after.at("chunk_latency_us_p999"), after.at("chunk_latency_us_p50"));
+
+    runai_end(streamer);
+
+    EXPECT_EQ(runai_get_stats(nullptr, 0, nullptr), static_cast<int>(common::ResponseCode::InvalidParameterError));
+}
+
+TEST_F(StreamerTest, Trace)
+{
+    const auto path = "/tmp/" + utils::random::string() + ".json";
+    auto size = utils::random::number(100, 1000);
+    utils::temp::File file(utils::random::buffer(size));
+
+    {
+        utils::temp::Env trace_("RUNAI_STREAMER_TRACE", path);
+
+        void * streamer;
+        EXPECT_EQ(runai_start(&streamer), static_cast<int>(common::ResponseCode::Success));
+
+        std::vector<unsigned char> v(size);
+        EXPECT_EQ(runai_read_file(streamer, file.path.c_str(), 0, size, v.data()), static_cast<int>(common::ResponseCode::Success));
+
+        runai_end(streamer);
+    }
+
+    // written when the streamer ends
+    const auto data = utils::Fd::read(path);
+    const std::string trace(data.begin(), data.end());
+    for (const auto & span : { "plan", "workload", "block", "push", "pop" })
+    {
+        EXPECT_NE(trace.find("\"name\":\"" + std::string(span) + "\""), std::string::npos) << span;
+    }
+    ::unlink(path.c_str());
+
+    EXPECT_EQ(runai_write_trace(nullptr), static_cast<int>(common::ResponseCode::InvalidParameterError));
+    EXPECT_EQ(runai_write_trace(("/" + utils::random::string() + "/" + utils::random::string()).c_str()), static_cast<int>(common::ResponseCode::FileAccessError));
+}
+
 TEST_F(StreamerTest, Async)
 {
     auto size = utils::random::number(100, 1000);
@@ -296,6 +379,285 @@ TEST_F(StreamerTest, End_Before_Read)
     EXPECT_LT(duration.count(), 1000);
 }
 
+TEST_F(StreamerTest, Cancel)
+{
+    auto size = utils::random::number(10000000, 100000000);
+    const auto data = utils::random::buffer(size);
+    utils::temp::File file(data);
+
+    void * streamer;
+    auto res = runai_start(&streamer);
+    EXPECT_EQ(res, static_cast<int>(common::ResponseCode::Success));
+
+    // nothing to cancel
+    EXPECT_EQ(runai_cancel(streamer), static_cast<int>(common::ResponseCode::Success));
+    EXPECT_EQ(runai_cancel(nullptr), static_cast<int>(common::ResponseCode::InvalidParameterError));
+
+    std::vector<unsigned char> dst(size);
+
+    EXPECT_EQ(runai_request_file(streamer, file.path.c_str(), 0, size, dst.data()), static_cast<int>(common::ResponseCode::Success));
+
+    ::usleep(utils::random::number(400));
+
+    EXPECT_EQ(runai_cancel(streamer), static_cast<int>(common::ResponseCode::Success));
+
+    unsigned r;
+    unsigned rfile;
+    EXPECT_EQ(runai_response(streamer, &rfile, &r), static_cast<int>(common::ResponseCode::FinishedError));
+
+    // the streamer can be used after canceling
+    std::fill(dst.begin(), dst.end(), 0);
+    EXPECT_EQ(runai_read_file(streamer, file.path.c_str(), 0, size, dst.data()), static_cast<int>(common::ResponseCode::Success));
+    EXPECT_EQ(std::memcmp(dst.data(), data.data(), size), 0);
+
+    runai_end(streamer);
+}
+
+TEST_F(StreamerTest, Cancel_While_Waiting)
+{
+    auto size = utils::random::number(10000000, 100000000);
+    const auto data = utils::random::buffer(size);
+    utils::temp::File file(data);
+
+    void * streamer;
+    auto res = runai_start(&streamer);
+    EXPECT_EQ(res, static_cast<int>(common::ResponseCode::Success));
+
+    // many small sub requests, so that the consumer is waiting for the next one
+    const unsigned num_sizes = 1000;
+    auto sizes = utils::random::chunks(size, num_sizes);
+    std::vector<size_t *> internal_sizes{sizes.data()};
+    std::vector<unsigned char> dst(size);
+    void * dsts[] = { dst.data() };
+    const char * path = file.path.c_str();
+    size_t offset = 0;
+    size_t bytesize = size;
+    unsigned num_sizes_[] = { num_sizes };
+
+    EXPECT_EQ(runai_request(streamer, 1, &path, &offset, &bytesize, dsts, num_sizes_, internal_sizes.data(), nullptr, nullptr, nullptr, nullptr, nullptr), static_cast<int>(common::ResponseCode::Success));
+
+    std::thread consumer([&]()
+    {
+        unsigned r;
+        unsigned rfile;
+        int ret;
+        while ((ret = runai_response(streamer, &rfile, &r)) == static_cast<int>(common::ResponseCode::Success))
+        {}
+        EXPECT_EQ(ret, static_cast<int>(common::ResponseCode::FinishedError));
+    });
+
+    ::usleep(utils::random::number(400));
+
+    EXPECT_EQ(runai_cancel(streamer), static_cast<int>(common::ResponseCode::Success));
+
+    consumer.join();
+
+    runai_end(streamer);
+}
+
+TEST_F(StreamerTest, Completion_Callback)
+{
+    auto size = utils::random::number(1000, 1000000);
+    const auto data = utils::random::buffer(size);
+    utils::temp::File file(data);
+
+    void * streamer;
+    auto res = runai_start(&streamer);
+    EXPECT_EQ(res, static_cast<int>(common::ResponseCode::Success));
+
+    struct Completions
+    {
+        std::mutex mutex;
+        std::set<unsigned> indices;
+        unsigned errors = 0;
+    } completions;
+
+    auto callback = [](void * user_data, unsigned num_responses, const unsigned * file_indices, const unsigned * indices, const int * response_codes)
+    {
+        auto * c = static_cast<Completions *>(user_data);
+        const auto guard = std::unique_lock<std::mutex>(c->mutex);
+        for (unsigned i = 0; i < num_responses; ++i)
+        {
+            c->indices.insert(indices[i]);
+            c->errors += (file_indices[i] != 0 || response_codes[i] != static_cast<int>(common::ResponseCode::Success));
+        }
+    };
+
+    EXPECT_EQ(runai_set_completion_callback(streamer, callback, &completions), static_cast<int>(common::ResponseCode::Success));
+
+    const unsigned num_sizes = utils::random::number(1, 100);
+    auto sizes = utils::random::chunks(size, num_sizes);
+    std::vector<size_t *> internal_sizes{sizes.data()};
+    std::vector<unsigned char> dst(size);
+    void * dsts[] = { dst.data() };
+    const char * path = file.path.c_str();
+    size_t offset = 0;
+    size_t bytesize = size;
+    unsigned num_sizes_[] = { num_sizes };
+
+    EXPECT_EQ(runai_request(streamer, 1, &path, &offset, &bytesize, dsts, num_sizes_, internal_sizes.data(), nullptr, nullptr, nullptr, nullptr, nullptr), static_cast<int>(common::ResponseCode::Success));
+
+    // cannot change the callback while a request is running
+    const auto busy = runai_set_completion_callback(streamer, nullptr, nullptr);
+    EXPECT_TRUE(busy == static_cast<int>(common::ResponseCode::BusyError) || busy == static_cast<int>(common::ResponseCode::Success));
+
+    // returns when all the callbacks have returned
+    unsigned r;
+    unsigned rfile;
+    EXPECT_EQ(runai_response(streamer, &rfile, &r), static_cast<int>(common::ResponseCode::FinishedError));
+
+    EXPECT_EQ(completions.indices.size(), num_sizes);
+    EXPECT_EQ(completions.errors, 0);
+    EXPECT_EQ(std::memcmp(dst.data(), data.data(), size), 0);
+
+    runai_end(streamer);
+}
+
+TEST_F(StreamerTest, Eventfd)
+{
+    auto size = utils::random::number(1000, 1000000);
+    const auto data = utils::random::buffer(size);
+    utils::temp::File file(data);
+
+    void * streamer;
+    auto res = runai_start(&streamer);
+    EXPECT_EQ(res, static_cast<int>(common::ResponseCode::Success));
+
+    int fd = -1;
+    EXPECT_EQ(runai_response_eventfd(streamer, &fd), static_cast<int>(common::ResponseCode::Success));
+    EXPECT_GE(fd, 0);
+
+    const unsigned num_sizes = utils::random::number(1, 100);
+    auto sizes = utils::random::chunks(size, num_sizes);
+    std::vector<size_t *> internal_sizes{sizes.data()};
+    std::vector<unsigned char> dst(size);
+    void * dsts[] = { dst.data() };
+    const char * path = file.path.c_str();
+    size_t offset = 0;
+    size_t bytesize = size;
+    unsigned num_sizes_[] = { num_sizes };
+
+    EXPECT_EQ(runai_request(streamer, 1, &path, &offset, &bytesize, dsts, num_sizes_, internal_sizes.data(), nullptr, nullptr, nullptr, nullptr, nullptr), static_cast<int>(common::ResponseCode::Success));
+
+    const unsigned max_responses = utils::random::number(1, 10);
+    std::vector<unsigned> file_indices(max_responses);
+    std::vector<unsigned> indices(max_responses);
+    std::vector<int> response_codes(max_responses);
+    std::set<unsigned> received;
+
+    while (true)
+    {
+        struct pollfd pfd = { fd, POLLIN, 0 };
+        ASSERT_EQ(::poll(&pfd, 1, 10000), 1);
+
+        uint64_t counter;
+        ASSERT_EQ(::read(fd, &counter, sizeof(counter)), sizeof(counter));
+
+        int ret;
+        unsigned num_responses;
+        while ((ret = runai_responses(streamer, max_responses, file_indices.data(), indices.data(), response_codes.data(), &num_responses)) == static_cast<int>(common::ResponseCode::Success) && num_responses > 0)
+        {
+            for (unsigned i = 0; i < num_responses; ++i)
+            {
+                EXPECT_EQ(file_indices[i], 0);
+                EXPECT_EQ(response_codes[i], static_cast<int>(common::ResponseCode::Success));
+                received.insert(indices[i]);
+            }
+        }
+
+        if (ret == static_cast<int>(common::ResponseCode::FinishedError))
+        {
+            break;
+        }
+
+        ASSERT_EQ(ret, static_cast<int>(common::ResponseCode::Success));
+
+        if (received.size() == num_sizes)
+        {
+            unsigned num_responses;
+            EXPECT_EQ(runai_responses(streamer, max_responses, file_indices.data(), indices.data(), response_codes.data(), &num_responses), static_cast<int>(common::ResponseCode::FinishedError));
+            break;
+        }
+    }
+
+    EXPECT_EQ(received.size(), num_sizes);
+    EXPECT_EQ(std::memcmp(dst.data(), data.data(), size), 0);
+
+    runai_end(streamer);
+}
+
+TEST_F(StreamerTest, Readiness)
+{
+    auto num_files = utils::random::number(1, 10);
+    std::vector<utils::temp::File> files(num_files);
+    std::vector<const char *> file_paths(num_files);
+    std::vector<size_t> file_offsets(num_files, 0);
+    std::vector<std::vector<uint8_t>> buffers(num_files);
+    std::vector<size_t> sizes(num_files);
+    std::vector<unsigned> num_ranges(num_files);
+    std::vector<std::vector<size_t>> range_sizes(num_files);
+    std::vector<size_t *> internal_sizes(num_files);
+
+    size_t dst_size = 0;
+    unsigned total_ranges = 0;
+    for (unsigned i = 0; i < num_files; ++i)
+    {
+        sizes[i] = utils::random::number(1000, 1000000);
+        dst_size += sizes[i];
+        buffers[i] = utils::random::buffer(sizes[i]);
+        files[i] = utils::temp::File(buffers[i]);
+        file_paths[i] = files[i].path.c_str();
+        num_ranges[i] = utils::random::number(1, 100);
+        range_sizes[i] = utils::random::chunks(sizes[i], num_ranges[i]);
+        internal_sizes[i] = range_sizes[i].data();
+        total_ranges += num_ranges[i];
+    }
+
+    std::vector<unsigned char> dst(dst_size);
+    std::vector<void *> dsts = { dst.data() };
+
+    void * streamer;
+    EXPECT_EQ(runai_start(&streamer), static_cast<int>(common::ResponseCode::Success));
+
+    // too small
+    std::vector<unsigned> entries(total_ranges - 1);
+    EXPECT_EQ(runai_set_readiness(streamer, entries.data(), entries.size()), static_cast<int>(common::ResponseCode::Success));
+    EXPECT_EQ(runai_request(streamer, num_files, file_paths.data(), file_offsets.data(), sizes.data(), dsts.data(), num_ranges.data(), internal_sizes.data(), nullptr, nullptr, nullptr, nullptr, nullptr), static_cast<int>(common::ResponseCode::InvalidParameterError));
+
+    entries = std::vector<unsigned>(total_ranges, utils::random::number(1, 10));
+    EXPECT_EQ(runai_set_readiness(streamer, entries.data(), entries.size()), static_cast<int>(common::ResponseCode::Success));
+    EXPECT_EQ(runai_request(streamer, num_files, file_paths.data(), file_offsets.data(), sizes.data(), dsts.data(), num_ranges.data(), internal_sizes.data(), nullptr, nullptr, nullptr, nullptr, nullptr), static_cast<int>(common::ResponseCode::Success));
+
+    // consume the sub requests in order
+    size_t offset = 0;
+    unsigned entry = 0;
+    for (unsigned i = 0; i < num_files; ++i)
+    {
+        for (unsigned j = 0; j < num_ranges[i]; ++j, ++entry)
+        {
+            EXPECT_EQ(runai_wait_ready(&entries[entry]), static_cast<int>(common::ResponseCode::Success));
+            EXPECT_EQ(entries[entry], 1);
+
+            const auto range_offset = offset - std::accumulate(sizes.begin(), sizes.begin() + i, size_t(0));
+            EXPECT_EQ(std::memcmp(dst.data() + offset, buffers[i].data() + range_offset, range_sizes[i][j]), 0);
+            offset += range_sizes[i][j];
+        }
+    }
+
+    // responses are still delivered
+    unsigned r;
+    unsigned file_index;
+    for (unsigned i = 0; i < total_ranges; ++i)
+    {
+        EXPECT_EQ(runai_response(streamer, &file_index, &r), static_cast<int>(common::ResponseCode::Success));
+    }
+    EXPECT_EQ(runai_response(streamer, &file_index, &r), static_cast<int>(common::ResponseCode::FinishedError));
+
+    EXPECT_EQ(runai_set_readiness(streamer, nullptr, 0), static_cast<int>(common::ResponseCode::Success));
+
+    runai_end(streamer);
+}
+
 TEST_F(StreamerTest, Multiple_Files)
 {
     auto num_files = utils::random::number(1, 50);
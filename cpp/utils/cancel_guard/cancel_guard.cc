@@ -0,0 +1,57 @@
+#include "utils/cancel_guard/cancel_guard.h"
+
+#include "utils/logging/logging.h"
+
+namespace runai::llm::streamer::utils
+{
+
+bool CancelGuard::enter()
+{
+    const auto guard = std::unique_lock<std::mutex>(_mutex);
+
+    if (_cancelled)
+    {
+        return false;
+    }
+
+    ++_active;
+    return true;
+}
+
+void CancelGuard::leave()
+{
+    {
+        const auto guard = std::unique_lock<std::mutex>(_mutex);
+
+        ASSERT(_active > 0) << "Leaving cancel guard that was not entered";
+
+        if (--_active > 0)
+        {
+            return;
+        }
+    }
+
+    _cv.notify_all();
+}
+
+void CancelGuard::cancel()
+{
+    auto guard = std::unique_lock<std::mutex>(_mutex);
+
+    _cancelled = true;
+
+    if (_active > 0)
+    {
+        LOG(DEBUG) << "Waiting for " << _active << " operations to leave cancel guard";
+    }
+
+    _cv.wait(guard, [this]() { return _active == 0; });
+}
+
+bool CancelGuard::cancelled() const
+{
+    const auto guard = std::unique_lock<std::mutex>(_mutex);
+    return _cancelled;
+}
+
+} // namespace runai::llm::streamer::utils
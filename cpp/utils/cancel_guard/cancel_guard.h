@@ -0,0 +1,31 @@
+#pragma once
+
+#include <condition_variable>
+#include <mutex>
+
+namespace runai::llm::streamer::utils
+{
+
+// Guards the access of asynchronous operations to memory owned by someone else (e.g. destination buffers)
+//
+// An operation enters the guard before accessing the memory, and leaves it when done
+// Cancelling the guard rejects further entries and waits for the operations that already entered to leave,
+// so once `cancel()` returns the memory is not accessed anymore and can be released by its owner
+
+struct CancelGuard
+{
+    // returns false if the guard was cancelled, in which case the memory must not be accessed
+    bool enter();
+    void leave();
+
+    void cancel();
+    bool cancelled() const;
+
+ private:
+    mutable std::mutex _mutex;
+    std::condition_variable _cv;
+    unsigned _active = 0;
+    bool _cancelled = false;
+};
+
+} // namespace runai::llm::streamer::utils
@@ -0,0 +1,60 @@
+#include "utils/cancel_guard/cancel_guard.h"
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <chrono>
+#include <unistd.h>
+
+#include "utils/thread/thread.h"
+
+namespace runai::llm::streamer::utils
+{
+
+TEST(Enter, Sanity)
+{
+    CancelGuard guard;
+
+    EXPECT_TRUE(guard.enter());
+    guard.leave();
+
+    EXPECT_FALSE(guard.cancelled());
+}
+
+TEST(Cancel, Rejects_Entries)
+{
+    CancelGuard guard;
+
+    guard.cancel();
+
+    EXPECT_TRUE(guard.cancelled());
+    EXPECT_FALSE(guard.enter());
+}
+
+TEST(Cancel, Waits_For_Active_Operations)
+{
+    CancelGuard guard;
+    std::atomic<bool> left = false;
+
+    ASSERT_TRUE(guard.enter());
+
+    auto thread = Thread([&]()
+    {
+        ::sleep(1);
+
+        left = true;
+        guard.leave();
+    });
+
+    const auto start = std::chrono::steady_clock::now();
+
+    guard.cancel();
+
+    const auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start);
+
+    EXPECT_TRUE(left);
+    EXPECT_GT(duration.count(), 900);
+    EXPECT_FALSE(guard.enter());
+}
+
+} // namespace runai::llm::streamer::utils
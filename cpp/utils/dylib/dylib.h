@@ -30,6 +30,9 @@ struct Dylib
         return reinterpret_cast<T>(Dylib::dlsym(_h, name));
     }
 
+    // whether the library exports the symbol, without logging an error if it does not
+    inline bool has(const std::string & name) const { return ::dlsym(_h, name.c_str()) != nullptr; }
+
     template <typename T, typename U = typename std::conditional<std::is_function<T>::value, T *, T>::type>
     static U dlsym(void * const h, const std::string & name)
     {
@@ -123,6 +123,14 @@ TEST(Dlsym, NonExisting)
     EXPECT_THROW(dylib.dlsym(random::string()), std::exception);
 }
 
+TEST(Has, Sanity)
+{
+    Dylib dylib(Helper::Path);
+
+    EXPECT_TRUE(dylib.has(Helper::Symbol::Name));
+    EXPECT_FALSE(dylib.has(random::string()));
+}
+
 TEST(StaticDlsym, Sanity)
 {
     for (auto flag : { RTLD_DEFAULT, RTLD_NEXT })
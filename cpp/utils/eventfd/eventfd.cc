@@ -0,0 +1,49 @@
+#include "utils/eventfd/eventfd.h"
+
+#include <errno.h>
+#include <sys/eventfd.h>
+#include <unistd.h>
+
+#include "utils/logging/logging.h"
+
+namespace runai::llm::streamer::utils
+{
+
+EventFd::EventFd() :
+    _fd(::eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC))
+{
+    PASSERT(_fd.fd() != -1) << "Failed creating eventfd";
+}
+
+int EventFd::fd() const
+{
+    return _fd.fd();
+}
+
+void EventFd::signal(uint64_t value)
+{
+    ssize_t ret;
+    while ((ret = ::write(_fd.fd(), &value, sizeof(value))) == -1 && errno == EINTR)
+    {}
+
+    // EAGAIN means the counter is about to overflow, and the descriptor is readable anyway
+    PASSERT(ret == sizeof(value) || errno == EAGAIN) << "Failed signaling eventfd " << _fd.fd();
+}
+
+uint64_t EventFd::reset()
+{
+    uint64_t value = 0;
+    ssize_t ret;
+    while ((ret = ::read(_fd.fd(), &value, sizeof(value))) == -1 && errno == EINTR)
+    {}
+
+    if (ret == -1)
+    {
+        PASSERT(errno == EAGAIN) << "Failed reading eventfd " << _fd.fd();
+        return 0;
+    }
+
+    return value;
+}
+
+} // namespace runai::llm::streamer::utils
@@ -0,0 +1,29 @@
+#pragma once
+
+#include <cstdint>
+
+#include "utils/fd/fd.h"
+
+namespace runai::llm::streamer::utils
+{
+
+// Non blocking event file descriptor, for notifying event loops (e.g. epoll, asyncio) from other threads
+// The descriptor becomes readable when signaled, and is reset by reading its counter
+
+struct EventFd
+{
+    EventFd();
+
+    int fd() const;
+
+    // add to the counter and wake up waiters
+    void signal(uint64_t value = 1);
+
+    // read and reset the counter - returns 0 if the counter was not signaled
+    uint64_t reset();
+
+ private:
+    Fd _fd;
+};
+
+} // namespace runai::llm::streamer::utils
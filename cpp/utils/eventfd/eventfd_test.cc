@@ -0,0 +1,47 @@
+#include "utils/eventfd/eventfd.h"
+
+#include <gtest/gtest.h>
+
+#include <poll.h>
+
+#include "utils/random/random.h"
+
+namespace runai::llm::streamer::utils
+{
+
+namespace
+{
+
+bool readable(const EventFd & eventfd)
+{
+    struct pollfd pfd = { eventfd.fd(), POLLIN, 0 };
+    return ::poll(&pfd, 1, 0) == 1 && (pfd.revents & POLLIN);
+}
+
+} // namespace
+
+TEST(Creation, Sanity)
+{
+    EventFd eventfd;
+
+    EXPECT_GE(eventfd.fd(), 0);
+    EXPECT_FALSE(readable(eventfd));
+    EXPECT_EQ(eventfd.reset(), 0);
+}
+
+TEST(Signal, Sanity)
+{
+    EventFd eventfd;
+
+    const auto times = random::number(1, 100);
+    for (unsigned i = 0; i < times; ++i)
+    {
+        eventfd.signal();
+    }
+
+    EXPECT_TRUE(readable(eventfd));
+    EXPECT_EQ(eventfd.reset(), times);
+    EXPECT_FALSE(readable(eventfd));
+}
+
+} // namespace runai::llm::streamer::utils
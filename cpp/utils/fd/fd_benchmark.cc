@@ -0,0 +1,39 @@
+#include "utils/fd/fd.h"
+
+#include <benchmark/benchmark.h>
+#include <fcntl.h>
+
+#include <vector>
+
+#include "utils/random/random.h"
+#include "utils/temp/file/file.h"
+
+namespace runai::llm::streamer::utils
+{
+
+// reading a file of 64 MiB from the page cache against the block size of the os calls
+void BM_Fd_Read(benchmark::State & state)
+{
+    const size_t bytesize = 64 * 1024 * 1024;
+    const size_t block_bytesize = state.range(0);
+
+    const temp::File file(random::data(bytesize));
+    std::vector<char> buffer(bytesize);
+
+    Fd fd(::open(file.path.c_str(), O_RDONLY));
+
+    // warm the page cache
+    fd.read(bytesize, buffer.data(), Fd::Read::Exactly);
+
+    for (auto _ : state)
+    {
+        fd.seek(0);
+        benchmark::DoNotOptimize(fd.read(bytesize, buffer.data(), Fd::Read::Exactly, block_bytesize));
+    }
+
+    state.SetBytesProcessed(state.iterations() * bytesize);
+}
+
+BENCHMARK(BM_Fd_Read)->RangeMultiplier(4)->Range(4 * 1024, 64 * 1024 * 1024)->ArgName("block_bytesize")->UseRealTime();
+
+}; // namespace runai::llm::streamer::utils
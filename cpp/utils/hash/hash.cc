@@ -0,0 +1,16 @@
+#include "utils/hash/hash.h"
+
+namespace runai::llm::streamer::utils
+{
+
+uint64_t fnv1a(const std::string & str, uint64_t hash)
+{
+    for (unsigned char c : str)
+    {
+        hash ^= c;
+        hash *= 1099511628211ULL;
+    }
+    return hash;
+}
+
+} // namespace runai::llm::streamer::utils
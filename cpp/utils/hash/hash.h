@@ -0,0 +1,17 @@
+#pragma once
+
+#include <stdint.h>
+
+#include <string>
+
+namespace runai::llm::streamer::utils
+{
+
+// 64 bit FNV-1a hash
+// stable across builds and processes, unlike std::hash, so it can name files and shared memory segments of the node
+
+constexpr uint64_t fnv1a_offset_basis = 14695981039346656037ULL;
+
+uint64_t fnv1a(const std::string & str, uint64_t hash = fnv1a_offset_basis);
+
+} // namespace runai::llm::streamer::utils
@@ -0,0 +1,27 @@
+#include "utils/hash/hash.h"
+
+#include <gtest/gtest.h>
+
+#include <string>
+
+#include "utils/random/random.h"
+
+namespace runai::llm::streamer::utils
+{
+
+TEST(Fnv1a, Known_Values)
+{
+    EXPECT_EQ(fnv1a(""), 0xcbf29ce484222325ULL);
+    EXPECT_EQ(fnv1a("a"), 0xaf63dc4c8601ec8cULL);
+    EXPECT_EQ(fnv1a("foobar"), 0x85944171f73967e8ULL);
+}
+
+TEST(Fnv1a, Chained)
+{
+    const auto first = random::string();
+    const auto second = random::string();
+
+    EXPECT_EQ(fnv1a(second, fnv1a(first)), fnv1a(first + second));
+}
+
+}; // namespace runai::llm::streamer::utils
@@ -0,0 +1,120 @@
+#include "utils/perf/perf.h"
+
+#include <linux/perf_event.h>
+#include <sys/resource.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include <cstring>
+
+#include "utils/fd/fd.h"
+#include "utils/logging/logging.h"
+
+namespace runai::llm::streamer::utils
+{
+
+namespace
+{
+
+int open_counter(uint64_t config, int group)
+{
+    perf_event_attr attr;
+    std::memset(&attr, 0, sizeof(attr));
+    attr.size = sizeof(attr);
+    attr.type = PERF_TYPE_HARDWARE;
+    attr.config = config;
+    attr.read_format = PERF_FORMAT_GROUP;
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+
+    // the calling thread on any cpu
+    return ::syscall(SYS_perf_event_open, &attr, 0, -1, group, PERF_FLAG_FD_CLOEXEC);
+}
+
+// hardware counters of a thread, as a group which is read at once
+struct Hardware
+{
+    Hardware() :
+        _cycles(open_counter(PERF_COUNT_HW_CPU_CYCLES, -1)),
+        _instructions(_cycles.fd() == -1 ? -1 : open_counter(PERF_COUNT_HW_INSTRUCTIONS, _cycles.fd()))
+    {
+        if (!available())
+        {
+            LOG(DEBUG) << "Hardware performance counters are not available to thread " << ::syscall(SYS_gettid) << " ; " << std::strerror(errno);
+        }
+    }
+
+    bool available() const
+    {
+        return _cycles.fd() != -1 && _instructions.fd() != -1;
+    }
+
+    void read(Perf::Counters & counters) const
+    {
+        if (!available())
+        {
+            return;
+        }
+
+        // number of counters followed by their values, in the order they were opened
+        uint64_t values[3] = {};
+        if (::read(_cycles.fd(), values, sizeof(values)) == sizeof(values) && values[0] == 2)
+        {
+            counters.cycles = values[1];
+            counters.instructions = values[2];
+        }
+    }
+
+ private:
+    Fd _cycles;
+    Fd _instructions;
+};
+
+Hardware & thread_hardware()
+{
+    thread_local Hardware __hardware;
+    return __hardware;
+}
+
+uint64_t microseconds(const timeval & tv)
+{
+    return static_cast<uint64_t>(tv.tv_sec) * 1000000 + tv.tv_usec;
+}
+
+} // namespace
+
+Perf::Counters Perf::Counters::operator-(const Counters & other) const
+{
+    Counters delta;
+    delta.cycles = cycles - other.cycles;
+    delta.instructions = instructions - other.instructions;
+    delta.page_faults = page_faults - other.page_faults;
+    delta.context_switches = context_switches - other.context_switches;
+    delta.user_us = user_us - other.user_us;
+    delta.system_us = system_us - other.system_us;
+    return delta;
+}
+
+Perf::Counters Perf::sample()
+{
+    Counters counters;
+    thread_hardware().read(counters);
+
+    rusage usage;
+    if (::getrusage(RUSAGE_THREAD, &usage) == 0)
+    {
+        counters.page_faults = usage.ru_minflt + usage.ru_majflt;
+        counters.context_switches = usage.ru_nvcsw + usage.ru_nivcsw;
+        counters.user_us = microseconds(usage.ru_utime);
+        counters.system_us = microseconds(usage.ru_stime);
+    }
+
+    return counters;
+}
+
+bool Perf::hardware()
+{
+    return thread_hardware().available();
+}
+
+} // namespace runai::llm::streamer::utils
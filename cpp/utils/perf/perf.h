@@ -0,0 +1,35 @@
+#pragma once
+
+#include <cstdint>
+
+namespace runai::llm::streamer::utils
+{
+
+// Resources used by the calling thread
+//
+// Hardware counters (cycles and instructions in user mode) are read from perf_event_open counters opened for the thread on its first sample
+// They are zero where the kernel does not allow them (e.g. perf_event_paranoid, containers without CAP_PERFMON, virtual machines without a PMU)
+// Page faults, context switches and CPU times are read from getrusage(RUSAGE_THREAD), which is always available
+
+struct Perf
+{
+    struct Counters
+    {
+        uint64_t cycles = 0;
+        uint64_t instructions = 0;
+        uint64_t page_faults = 0;
+        uint64_t context_switches = 0;
+        uint64_t user_us = 0;
+        uint64_t system_us = 0;
+
+        Counters operator-(const Counters & other) const;
+    };
+
+    // cumulative counters of the calling thread
+    static Counters sample();
+
+    // whether hardware counters are available to the calling thread
+    static bool hardware();
+};
+
+} // namespace runai::llm::streamer::utils
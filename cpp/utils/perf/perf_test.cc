@@ -0,0 +1,73 @@
+#include "utils/perf/perf.h"
+
+#include <gtest/gtest.h>
+
+#include <sys/mman.h>
+#include <unistd.h>
+
+#include <chrono>
+#include <thread>
+
+#include "utils/random/random.h"
+
+namespace runai::llm::streamer::utils
+{
+
+TEST(Perf, Page_Faults)
+{
+    const auto pages = utils::random::number(10, 100);
+    const size_t page = ::sysconf(_SC_PAGESIZE);
+
+    void * memory = ::mmap(nullptr, pages * page, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    ASSERT_NE(memory, MAP_FAILED);
+
+    const auto before = Perf::sample();
+
+    // touching every page faults it in
+    for (unsigned i = 0; i < pages; ++i)
+    {
+        static_cast<volatile char *>(memory)[i * page] = 1;
+    }
+
+    const auto delta = Perf::sample() - before;
+    EXPECT_GE(delta.page_faults, pages);
+
+    ::munmap(memory, pages * page);
+}
+
+TEST(Perf, Context_Switches)
+{
+    const auto before = Perf::sample();
+    std::this_thread::sleep_for(std::chrono::milliseconds(utils::random::number(1, 10)));
+
+    const auto delta = Perf::sample() - before;
+    EXPECT_GE(delta.context_switches, 1);
+}
+
+TEST(Perf, CPU)
+{
+    const auto before = Perf::sample();
+
+    volatile uint64_t sum = 0;
+    const auto start = std::chrono::steady_clock::now();
+    while (std::chrono::steady_clock::now() - start < std::chrono::milliseconds(50))
+    {
+        sum = sum + 1;
+    }
+
+    const auto delta = Perf::sample() - before;
+    EXPECT_GT(delta.user_us + delta.system_us, 0);
+
+    if (Perf::hardware())
+    {
+        EXPECT_GT(delta.cycles, 0);
+        EXPECT_GT(delta.instructions, 0);
+    }
+    else
+    {
+        EXPECT_EQ(delta.cycles, 0);
+        EXPECT_EQ(delta.instructions, 0);
+    }
+}
+
+} // namespace runai::llm::streamer::utils
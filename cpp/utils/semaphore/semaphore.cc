@@ -33,6 +33,23 @@ void Semaphore::wait()
     PASSERT(ret == 0) << "Could not decrement semaphore";
 }
 
+bool Semaphore::try_wait()
+{
+    int ret{};
+    while ((ret = sem_trywait(&_sem)) == -1 && errno == EINTR)
+    {
+        continue;
+    }
+
+    if (ret == -1)
+    {
+        PASSERT(errno == EAGAIN) << "Could not decrement semaphore";
+        return false;
+    }
+
+    return true;
+}
+
 unsigned Semaphore::value()
 {
     int value;
@@ -14,6 +14,10 @@ struct Semaphore
     void post();
     void wait();
 
+    // decrement the semaphore if possible without waiting
+    // returns false if the semaphore value is zero
+    bool try_wait();
+
     // get the semaphore value
     unsigned value();
 
@@ -35,6 +35,21 @@ TEST(Wait, Sanity)
     EXPECT_EQ(sem.value(), 0);
 }
 
+TEST(Wait, Try_Wait)
+{
+    const auto number = random::number(1, 10);
+
+    auto sem = Semaphore(number);
+
+    for (unsigned i = 0; i < number; ++i)
+    {
+        EXPECT_TRUE(sem.try_wait());
+    }
+
+    EXPECT_FALSE(sem.try_wait());
+    EXPECT_EQ(sem.value(), 0);
+}
+
 TEST(Wait, Actually_Wait)
 {
     auto sem = Semaphore(0);
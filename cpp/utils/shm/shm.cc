@@ -0,0 +1,205 @@
+#include "utils/shm/shm.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <system_error>
+#include <utility>
+
+#include "utils/logging/logging.h"
+
+namespace runai::llm::streamer::utils
+{
+
+Shm::Shm(const std::string & name, int fd) :
+    _name(name),
+    _fd(fd)
+{
+    struct stat st;
+    const auto ret = ::fstat(fd, &st);
+    const auto error = errno;
+    if (ret == 0 && st.st_size > 0)
+    {
+        _size = st.st_size;
+        void * data = ::mmap(nullptr, _size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        if (data == MAP_FAILED)
+        {
+            const auto error = errno;
+            close();
+            throw std::system_error(error, std::system_category(), "Failed mapping shared memory segment " + name);
+        }
+        _data = static_cast<char *>(data);
+    }
+
+    if (ret != 0)
+    {
+        close();
+        throw std::system_error(error, std::system_category(), "Failed querying shared memory segment " + name);
+    }
+}
+
+Shm::~Shm()
+{
+    close();
+}
+
+void Shm::close()
+{
+    if (_data != nullptr)
+    {
+        ::munmap(_data, _size);
+        _data = nullptr;
+    }
+
+    // closing the descriptor releases the locks of this segment
+    if (_fd != -1)
+    {
+        ::close(_fd);
+        _fd = -1;
+    }
+}
+
+Shm::Shm(Shm && other) :
+    _name(std::move(other._name)),
+    _fd(std::exchange(other._fd, -1)),
+    _data(std::exchange(other._data, nullptr)),
+    _size(std::exchange(other._size, 0))
+{}
+
+Shm & Shm::operator=(Shm && other)
+{
+    if (this != &other)
+    {
+        close();
+        _name = std::move(other._name);
+        _fd = std::exchange(other._fd, -1);
+        _data = std::exchange(other._data, nullptr);
+        _size = std::exchange(other._size, 0);
+    }
+    return *this;
+}
+
+std::optional<Shm> Shm::create(const std::string & name, size_t bytesize)
+{
+    const int fd = ::shm_open(name.c_str(), O_RDWR | O_CREAT | O_EXCL | O_CLOEXEC, 0600);
+    if (fd == -1 && errno == EEXIST)
+    {
+        return std::nullopt;
+    }
+    PASSERT(fd != -1) << "Failed creating shared memory segment " << name;
+
+    // allocating the memory fails cleanly when shared memory is exhausted, while writing to an unallocated page raises SIGBUS
+    const auto ret = ::posix_fallocate(fd, 0, bytesize);
+    if (ret != 0)
+    {
+        ::close(fd);
+        ::shm_unlink(name.c_str());
+        throw std::system_error(ret, std::system_category(), "Failed allocating " + std::to_string(bytesize) + " bytes of shared memory segment " + name);
+    }
+
+    try
+    {
+        return Shm(name, fd);
+    }
+    catch (...)
+    {
+        ::shm_unlink(name.c_str());
+        throw;
+    }
+}
+
+std::optional<Shm> Shm::open(const std::string & name)
+{
+    const int fd = ::shm_open(name.c_str(), O_RDWR | O_CLOEXEC, 0);
+    if (fd == -1 && errno == ENOENT)
+    {
+        return std::nullopt;
+    }
+    PASSERT(fd != -1) << "Failed opening shared memory segment " << name;
+
+    return Shm(name, fd);
+}
+
+void Shm::unlink(const std::string & name)
+{
+    if (::shm_unlink(name.c_str()) != 0 && errno != ENOENT)
+    {
+        LOG(WARNING) << "Failed removing shared memory segment " << name << ": " << std::error_code(errno, std::system_category()).message();
+    }
+}
+
+void Shm::unlink() const
+{
+    // the name may refer to a segment which was created after this one was unlinked
+    const int fd = ::shm_open(_name.c_str(), O_RDONLY | O_CLOEXEC, 0);
+    if (fd == -1)
+    {
+        return;
+    }
+
+    struct stat named;
+    struct stat own;
+    const bool same = ::fstat(fd, &named) == 0 && ::fstat(_fd, &own) == 0 && named.st_dev == own.st_dev && named.st_ino == own.st_ino;
+    ::close(fd);
+
+    if (same)
+    {
+        unlink(_name);
+    }
+}
+
+bool Shm::lock(size_t offset)
+{
+    struct flock lock = {};
+    lock.l_type = F_WRLCK;
+    lock.l_whence = SEEK_SET;
+    lock.l_start = offset;
+    lock.l_len = 1;
+
+    if (::fcntl(_fd, F_OFD_SETLK, &lock) == 0)
+    {
+        return true;
+    }
+
+    PASSERT(errno == EAGAIN || errno == EACCES) << "Failed locking shared memory segment " << _name;
+    return false;
+}
+
+bool Shm::locked(size_t offset) const
+{
+    struct flock lock = {};
+    lock.l_type = F_WRLCK;
+    lock.l_whence = SEEK_SET;
+    lock.l_start = offset;
+    lock.l_len = 1;
+
+    PASSERT(::fcntl(_fd, F_OFD_GETLK, &lock) == 0) << "Failed querying the locks of shared memory segment " << _name;
+    return lock.l_type != F_UNLCK;
+}
+
+std::chrono::system_clock::time_point Shm::modified() const
+{
+    struct stat st;
+    PASSERT(::fstat(_fd, &st) == 0) << "Failed querying shared memory segment " << _name;
+    return std::chrono::system_clock::time_point(std::chrono::duration_cast<std::chrono::system_clock::duration>(std::chrono::seconds(st.st_mtim.tv_sec) + std::chrono::nanoseconds(st.st_mtim.tv_nsec)));
+}
+
+const std::string & Shm::name() const
+{
+    return _name;
+}
+
+char * Shm::data() const
+{
+    return _data;
+}
+
+size_t Shm::size() const
+{
+    return _size;
+}
+
+} // namespace runai::llm::streamer::utils
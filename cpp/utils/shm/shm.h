@@ -0,0 +1,67 @@
+#pragma once
+
+#include <stddef.h>
+
+#include <chrono>
+#include <optional>
+#include <string>
+
+namespace runai::llm::streamer::utils
+{
+
+// A named POSIX shared memory segment, mapped into the address space of the process
+// Segments are shared by name between the processes of the node, and outlive the processes which created them until they are unlinked
+
+struct Shm
+{
+    Shm() = default;
+    ~Shm();
+
+    Shm(Shm && other);
+    Shm & operator=(Shm && other);
+
+    Shm(const Shm &)             = delete;
+    Shm & operator=(const Shm &) = delete;
+
+    // creates a segment whose memory is allocated up front, so that writing to it does not fault when shared memory runs out
+    // returns nullopt if a segment of the same name already exists
+    static std::optional<Shm> create(const std::string & name, size_t bytesize);
+
+    // maps an existing segment
+    // returns nullopt if no segment of that name exists
+    // the segment is not mapped if it was not sized by its creator yet
+    static std::optional<Shm> open(const std::string & name);
+
+    // removes the name of a segment - processes which mapped it keep using it
+    static void unlink(const std::string & name);
+
+    // removes the name of this segment, unless it was already replaced by another segment of the same name
+    void unlink() const;
+
+    // takes an exclusive lock of the byte at the given offset without waiting, and holds it until this segment is closed
+    // returns false if the byte is locked by another open of the segment, in this process or in any other process of the node
+    // locks are released by the kernel when their holder exits, and unlike process ids they are valid across pid namespaces
+    bool lock(size_t offset);
+
+    // returns whether the byte at the given offset is locked by another open of the segment
+    bool locked(size_t offset) const;
+
+    // time the segment was last sized
+    std::chrono::system_clock::time_point modified() const;
+
+    const std::string & name() const;
+    char * data() const;
+    size_t size() const;
+
+ private:
+    Shm(const std::string & name, int fd);
+
+    void close();
+
+    std::string _name;
+    int _fd = -1;
+    char * _data = nullptr;
+    size_t _size = 0;
+};
+
+} // namespace runai::llm::streamer::utils
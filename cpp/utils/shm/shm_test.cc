@@ -0,0 +1,143 @@
+#include "utils/shm/shm.h"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+#include "utils/random/random.h"
+
+namespace runai::llm::streamer::utils
+{
+
+namespace
+{
+
+std::string name()
+{
+    return "/runai-streamer-test-" + random::string();
+}
+
+} // namespace
+
+TEST(Create, Sanity)
+{
+    const auto name_ = name();
+    const auto bytesize = random::number<size_t>(1, 1024 * 1024);
+
+    auto shm = Shm::create(name_, bytesize);
+    ASSERT_TRUE(shm.has_value());
+    EXPECT_EQ(shm->name(), name_);
+    EXPECT_EQ(shm->size(), bytesize);
+    ASSERT_NE(shm->data(), nullptr);
+
+    // the memory is zeroed
+    EXPECT_TRUE(std::all_of(shm->data(), shm->data() + bytesize, [](char c) { return c == 0; }));
+
+    Shm::unlink(name_);
+}
+
+TEST(Create, Exists)
+{
+    const auto name_ = name();
+
+    auto shm = Shm::create(name_, random::number(1, 1000));
+    ASSERT_TRUE(shm.has_value());
+    EXPECT_FALSE(Shm::create(name_, random::number(1, 1000)).has_value());
+
+    Shm::unlink(name_);
+}
+
+TEST(Open, Sanity)
+{
+    const auto name_ = name();
+    const auto data = random::buffer();
+
+    auto created = Shm::create(name_, data.size());
+    ASSERT_TRUE(created.has_value());
+    std::copy(data.begin(), data.end(), created->data());
+
+    auto opened = Shm::open(name_);
+    ASSERT_TRUE(opened.has_value());
+    ASSERT_EQ(opened->size(), data.size());
+    EXPECT_TRUE(std::equal(data.begin(), data.end(), reinterpret_cast<const uint8_t *>(opened->data())));
+
+    // writes are visible through both mappings
+    opened->data()[0] = ~opened->data()[0];
+    EXPECT_EQ(created->data()[0], opened->data()[0]);
+
+    Shm::unlink(name_);
+}
+
+TEST(Open, Not_Found)
+{
+    EXPECT_FALSE(Shm::open(name()).has_value());
+}
+
+TEST(Unlink, Mapped)
+{
+    const auto name_ = name();
+    const auto data = random::buffer();
+
+    auto shm = Shm::create(name_, data.size());
+    ASSERT_TRUE(shm.has_value());
+    Shm::unlink(name_);
+
+    // the name is removed, and the mapped memory remains usable
+    EXPECT_FALSE(Shm::open(name_).has_value());
+    std::copy(data.begin(), data.end(), shm->data());
+    EXPECT_TRUE(std::equal(data.begin(), data.end(), reinterpret_cast<const uint8_t *>(shm->data())));
+
+    // moving keeps the mapping
+    Shm moved(std::move(shm.value()));
+    EXPECT_EQ(shm->data(), nullptr);
+    EXPECT_TRUE(std::equal(data.begin(), data.end(), reinterpret_cast<const uint8_t *>(moved.data())));
+}
+
+TEST(Unlink, Replaced)
+{
+    const auto name_ = name();
+
+    auto first = Shm::create(name_, random::number(1, 1000));
+    ASSERT_TRUE(first.has_value());
+    first->unlink();
+    EXPECT_FALSE(Shm::open(name_).has_value());
+
+    // a segment does not remove the segment which replaced it
+    auto second = Shm::create(name_, random::number(1, 1000));
+    ASSERT_TRUE(second.has_value());
+    first->unlink();
+    EXPECT_TRUE(Shm::open(name_).has_value());
+
+    second->unlink();
+    EXPECT_FALSE(Shm::open(name_).has_value());
+}
+
+TEST(Lock, Sanity)
+{
+    const auto name_ = name();
+    const auto offset = random::number<size_t>(0, 1000);
+
+    auto first = Shm::create(name_, random::number(1, 1000));
+    ASSERT_TRUE(first.has_value());
+    auto second = Shm::open(name_);
+    ASSERT_TRUE(second.has_value());
+
+    EXPECT_FALSE(second->locked(offset));
+    EXPECT_TRUE(first->lock(offset));
+    EXPECT_TRUE(second->locked(offset));
+    EXPECT_FALSE(second->lock(offset));
+
+    // other bytes are not locked
+    EXPECT_FALSE(second->locked(offset + 1));
+    EXPECT_TRUE(second->lock(offset + 1));
+
+    // the lock is released when the segment is closed
+    first.reset();
+    EXPECT_FALSE(second->locked(offset));
+
+    Shm::unlink(name_);
+}
+
+} // namespace runai::llm::streamer::utils
@@ -0,0 +1,29 @@
+#include "utils/temp/dir/dir.h"
+
+#include <sys/stat.h>
+
+#include <filesystem>
+
+#include "utils/logging/logging.h"
+
+namespace runai::llm::streamer::utils::temp
+{
+
+Dir::Dir(const std::string & parent, const std::string & name) :
+    name(name),
+    path(parent + "/" + name)
+{
+    PASSERT(::mkdir(path.c_str(), 0777) == 0) << "Failed creating directory '" << path << "'";
+}
+
+Dir::~Dir()
+{
+    try
+    {
+        std::filesystem::remove_all(path);
+    }
+    catch (...)
+    {}
+}
+
+} // namespace runai::llm::streamer::utils::temp
@@ -0,0 +1,25 @@
+#pragma once
+
+#include <string>
+
+#include "utils/random/random.h"
+
+namespace runai::llm::streamer::utils::temp
+{
+
+// a directory which is removed with its contents on destruction
+struct Dir
+{
+    Dir(
+        const std::string & parent = ".",
+        const std::string & name = random::string());
+    ~Dir();
+
+    Dir(const Dir &) = delete;
+    Dir & operator=(const Dir &) = delete;
+
+    std::string name;
+    std::string path;
+};
+
+} // namespace runai::llm::streamer::utils::temp
@@ -0,0 +1,43 @@
+#include "utils/temp/dir/dir.h"
+
+#include <gtest/gtest.h>
+
+#include <fcntl.h>
+
+#include "utils/fd/fd.h"
+#include "utils/temp/file/file.h"
+
+namespace runai::llm::streamer::utils::temp
+{
+
+TEST(Creation, Sanity)
+{
+    std::string path;
+    {
+        temp::Dir dir;
+        path = dir.path;
+        EXPECT_TRUE(Path::is_directory(path));
+    }
+    EXPECT_FALSE(Path::exists(path));
+}
+
+TEST(Creation, NonExistingParent)
+{
+    EXPECT_THROW(temp::Dir dir(random::string()), std::exception);
+}
+
+TEST(Removal, Contents)
+{
+    std::string path;
+    {
+        temp::Dir dir;
+        path = dir.path;
+
+        // the file is removed with the directory
+        utils::Fd::write(dir.path + "/" + random::string(), random::buffer(), O_WRONLY | O_CREAT, 0666);
+        utils::Fd::write(dir.path + "/" + random::string(), random::buffer(), O_WRONLY | O_CREAT, 0666);
+    }
+    EXPECT_FALSE(Path::exists(path));
+}
+
+} // namespace runai::llm::streamer::utils::temp
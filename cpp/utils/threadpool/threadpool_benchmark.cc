@@ -0,0 +1,75 @@
+#include "utils/threadpool/threadpool.h"
+
+#include <benchmark/benchmark.h>
+
+#include <atomic>
+#include <chrono>
+
+#include "utils/semaphore/semaphore.h"
+
+namespace runai::llm::streamer::utils
+{
+
+namespace
+{
+
+struct Message
+{
+    std::chrono::steady_clock::time_point pushed;
+};
+
+} // namespace
+
+// latency from pushing a message until a worker handles it, where a single message is in flight
+void BM_ThreadPool_Dispatch(benchmark::State & state)
+{
+    Semaphore handled(0);
+    std::chrono::steady_clock::duration latency{};
+
+    ThreadPool<Message> pool([&](Message && message, std::atomic<bool> &)
+    {
+        latency = std::chrono::steady_clock::now() - message.pushed;
+        handled.post();
+    }, state.range(0));
+
+    for (auto _ : state)
+    {
+        pool.push(Message{std::chrono::steady_clock::now()});
+        handled.wait();
+
+        state.SetIterationTime(std::chrono::duration<double>(latency).count());
+    }
+}
+
+BENCHMARK(BM_ThreadPool_Dispatch)->RangeMultiplier(4)->Range(1, 64)->ArgName("threads")->UseManualTime();
+
+// throughput of messages pushed at once and handled by all the workers
+void BM_ThreadPool_Throughput(benchmark::State & state)
+{
+    const unsigned messages = 1 << 14;
+
+    Semaphore handled(0);
+    ThreadPool<Message> pool([&](Message &&, std::atomic<bool> &)
+    {
+        handled.post();
+    }, state.range(0));
+
+    for (auto _ : state)
+    {
+        for (unsigned i = 0; i < messages; ++i)
+        {
+            pool.push(Message{});
+        }
+
+        for (unsigned i = 0; i < messages; ++i)
+        {
+            handled.wait();
+        }
+    }
+
+    state.SetItemsProcessed(state.iterations() * messages);
+}
+
+BENCHMARK(BM_ThreadPool_Throughput)->RangeMultiplier(4)->Range(1, 64)->ArgName("threads")->UseRealTime();
+
+}; // namespace runai::llm::streamer::utils
@@ -4,7 +4,8 @@ from runai_model_streamer.libstreamer.libstreamer import (
     runai_start,
     runai_end,
     runai_request,
-    runai_response
+    runai_response,
+    runai_cancel,
 )
 from runai_model_streamer.file_streamer.requests_iterator import (
     FilesRequestsIteratorWithBuffer,
@@ -60,6 +61,7 @@ class FileStreamer:
         self.device_str = None
         self.s3_session = None
         self.s3_credentials = None
+        self.cancelled = False
         return self
 
     def __exit__(self, exc_type: any, exc_value: any, traceback: any) -> None:
@@ -99,6 +101,7 @@ class FileStreamer:
             self.total_size += sum(file_stream_request.chunks)
             file_stream_request.path = self.handle_object_store(file_stream_request.path, credentials)
 
+        self.cancelled = False
         self.requests_iterator: FilesRequestsIteratorWithBuffer = FilesRequestsIteratorWithBuffer.with_memory_mode(file_stream_requests)
  
         self.active_request = self.requests_iterator.next_request()
@@ -125,7 +128,10 @@ class FileStreamer:
         
         while True:
             yield from self.request_ready_chunks()
-            
+
+            if self.cancelled:
+                break
+
             self.active_request = self.requests_iterator.next_request()
             if self.active_request is None:
                 break
@@ -140,14 +146,23 @@ class FileStreamer:
                 self.s3_credentials,
             )
 
+    # Cancels the running request and stops streaming the remaining files
+    # Returns when the streamer no longer writes to the chunk buffers
+    # May be called from another thread while iterating over get_chunks()
+    def cancel(self) -> None:
+        self.cancelled = True
+        if self.streamer:
+            runai_cancel(self.streamer)
+
     # This function iterates over indexes of ready chunks.
     # The indexes are relative to the last request that sent
     # And need to be translated to global index in the chunks list
     def request_ready_chunks(self) -> Iterator:
         for i in range(sum(len(file_request.chunks) for file_request in self.active_request.files)):
-            file_relative_index, chunk_relative_index = runai_response(self.streamer)
-            if chunk_relative_index == None:
+            response = runai_response(self.streamer)
+            if response is None:
                 return
+            file_relative_index, chunk_relative_index = response
             
             file_path, chunk_index, chunk_buffer = self.requests_iterator.get_global_file_and_chunk(file_relative_index, chunk_relative_index)
             # create one dimensional tensor from the chunk buffer
@@ -8,6 +8,16 @@ STREAMER_LIBRARY = os.environ.get("STREAMER_LIBRARY", DEFAULT_STREAMER_LIBRARY)
 
 t_streamer = ctypes.c_void_p
 
+# void (*)(void * user_data, unsigned num_responses, const unsigned * file_indices, const unsigned * indices, const int * response_codes)
+t_completion_callback = ctypes.CFUNCTYPE(
+    None,
+    ctypes.c_void_p,
+    ctypes.c_uint32,
+    ctypes.POINTER(ctypes.c_uint32),
+    ctypes.POINTER(ctypes.c_uint32),
+    ctypes.POINTER(ctypes.c_int),
+)
+
 
 class LibstreamerDLLWrapper:
     def __init__(self, library_path):
@@ -42,6 +52,72 @@ class LibstreamerDLLWrapper:
         self.fn_runai_response.argtypes = [t_streamer, ctypes.POINTER(ctypes.c_uint32), ctypes.POINTER(ctypes.c_uint32)]
         self.fn_runai_response.restype = ctypes.c_int
 
+        self.fn_runai_responses = self.lib.runai_responses
+        self.fn_runai_responses.argtypes = [
+            t_streamer,
+            ctypes.c_uint32, # max_responses
+            ctypes.POINTER(ctypes.c_uint32), # file_indices
+            ctypes.POINTER(ctypes.c_uint32), # indices
+            ctypes.POINTER(ctypes.c_int), # response_codes
+            ctypes.POINTER(ctypes.c_uint32), # num_responses
+        ]
+        self.fn_runai_responses.restype = ctypes.c_int
+
+        self.fn_runai_response_eventfd = self.lib.runai_response_eventfd
+        self.fn_runai_response_eventfd.argtypes = [t_streamer, ctypes.POINTER(ctypes.c_int)]
+        self.fn_runai_response_eventfd.restype = ctypes.c_int
+
+        self.fn_runai_set_completion_callback = self.lib.runai_set_completion_callback
+        self.fn_runai_set_completion_callback.argtypes = [t_streamer, t_completion_callback, ctypes.c_void_p]
+        self.fn_runai_set_completion_callback.restype = ctypes.c_int
+
+        self.fn_runai_set_readiness = self.lib.runai_set_readiness
+        self.fn_runai_set_readiness.argtypes = [t_streamer, ctypes.POINTER(ctypes.c_uint32), ctypes.c_uint32]
+        self.fn_runai_set_readiness.restype = ctypes.c_int
+
+        self.fn_runai_wait_ready = self.lib.runai_wait_ready
+        self.fn_runai_wait_ready.argtypes = [ctypes.POINTER(ctypes.c_uint32)]
+        self.fn_runai_wait_ready.restype = ctypes.c_int
+
+        self.fn_runai_prefetch = self.lib.runai_prefetch
+        self.fn_runai_prefetch.argtypes = [
+            t_streamer,
+            ctypes.c_uint32, # num_files
+            ctypes.POINTER(ctypes.c_char_p), # paths
+            ctypes.POINTER(ctypes.c_size_t), # file_offsets
+            ctypes.POINTER(ctypes.c_size_t), # bytesizes
+            ctypes.c_char_p, # key
+            ctypes.c_char_p, # secret
+            ctypes.c_char_p, # token
+            ctypes.c_char_p, # region
+            ctypes.c_char_p, # endpoint
+        ]
+        self.fn_runai_prefetch.restype = ctypes.c_int
+
+        self.fn_runai_cancel_prefetch = self.lib.runai_cancel_prefetch
+        self.fn_runai_cancel_prefetch.argtypes = [t_streamer]
+        self.fn_runai_cancel_prefetch.restype = ctypes.c_int
+
+        self.fn_runai_set_weight = self.lib.runai_set_weight
+        self.fn_runai_set_weight.argtypes = [t_streamer, ctypes.c_uint32]
+        self.fn_runai_set_weight.restype = ctypes.c_int
+
+        self.fn_runai_get_stats = self.lib.runai_get_stats
+        self.fn_runai_get_stats.argtypes = [ctypes.POINTER(ctypes.c_size_t), ctypes.c_uint32, ctypes.POINTER(ctypes.c_uint32)]
+        self.fn_runai_get_stats.restype = ctypes.c_int
+
+        self.fn_runai_stat_name = self.lib.runai_stat_name
+        self.fn_runai_stat_name.argtypes = [ctypes.c_uint32]
+        self.fn_runai_stat_name.restype = ctypes.c_char_p
+
+        self.fn_runai_write_trace = self.lib.runai_write_trace
+        self.fn_runai_write_trace.argtypes = [ctypes.c_char_p]
+        self.fn_runai_write_trace.restype = ctypes.c_int
+
+        self.fn_runai_cancel = self.lib.runai_cancel
+        self.fn_runai_cancel.argtypes = [t_streamer]
+        self.fn_runai_cancel.restype = ctypes.c_int
+
         self.fn_runai_response_str = self.lib.runai_response_str
         self.fn_runai_response_str.argtypes = [ctypes.c_int]
         self.fn_runai_response_str.restype = ctypes.c_char_p
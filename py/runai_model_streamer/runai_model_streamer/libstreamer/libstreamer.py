@@ -1,5 +1,5 @@
-from runai_model_streamer.libstreamer import dll, t_streamer
-from typing import List, Optional, Tuple
+from runai_model_streamer.libstreamer import dll, t_streamer, t_completion_callback
+from typing import Callable, Dict, List, Optional, Tuple
 import ctypes
 
 from runai_model_streamer.s3_utils.s3_utils import (
@@ -91,5 +91,170 @@ def runai_response(streamer: t_streamer) -> Optional[Tuple[int, int]]:
         )
     return file_index.value, range_index.value
 
+def runai_responses(streamer: t_streamer, max_responses: int = 1024) -> Optional[List[Tuple[int, int]]]:
+    # returns the ready responses without waiting (possibly an empty list), or None if no more responses are expected
+    file_indices = (ctypes.c_uint32 * max_responses)()
+    indices = (ctypes.c_uint32 * max_responses)()
+    response_codes = (ctypes.c_int * max_responses)()
+    num_responses = ctypes.c_uint32()
+    error_code = dll.fn_runai_responses(streamer, max_responses, file_indices, indices, response_codes, ctypes.byref(num_responses))
+    if error_code == FINISHED_ERROR_CODE:
+        return None
+    if error_code != SUCCESS_ERROR_CODE:
+        raise ValueError(
+            f"Could not receive runai_responses from libstreamer due to: {runai_response_str(error_code)}"
+        )
+    responses = []
+    for i in range(num_responses.value):
+        if response_codes[i] != SUCCESS_ERROR_CODE:
+            raise ValueError(
+                f"Could not receive runai_responses from libstreamer due to: {runai_response_str(response_codes[i])}"
+            )
+        responses.append((file_indices[i], indices[i]))
+    return responses
+
+def runai_response_eventfd(streamer: t_streamer) -> int:
+    # non blocking descriptor which becomes readable when responses are ready - owned by the streamer
+    fd = ctypes.c_int(-1)
+    error_code = dll.fn_runai_response_eventfd(streamer, ctypes.byref(fd))
+    if error_code != SUCCESS_ERROR_CODE:
+        raise ValueError(
+            f"Could not create response eventfd in libstreamer due to: {runai_response_str(error_code)}"
+        )
+    return fd.value
+
+def runai_set_completion_callback(
+    streamer: t_streamer,
+    callback: Optional[Callable[[List[Tuple[int, int, int]]], None]],
+) -> Optional[t_completion_callback]:
+    # callback is called from the streamer worker threads with a list of (file index, range index, response code)
+    # the returned object must be kept alive while the callback is registered
+    c_callback = None
+    if callback is not None:
+        def _callback(user_data, num_responses, file_indices, indices, response_codes):
+            callback([(file_indices[i], indices[i], response_codes[i]) for i in range(num_responses)])
+        c_callback = t_completion_callback(_callback)
+
+    error_code = dll.fn_runai_set_completion_callback(
+        streamer, c_callback if c_callback is not None else t_completion_callback(), None
+    )
+    if error_code != SUCCESS_ERROR_CODE:
+        raise ValueError(
+            f"Could not set completion callback in libstreamer due to: {runai_response_str(error_code)}"
+        )
+    return c_callback
+
+READINESS_WAITING_BIT = 0x80000000
+
+def runai_readiness_array(num_entries: int) -> ctypes.Array:
+    # one entry per sub request, ordered by files and then by sub requests
+    return (ctypes.c_uint32 * num_entries)()
+
+def runai_set_readiness(streamer: t_streamer, entries: Optional[ctypes.Array]) -> None:
+    # the array must be kept alive while it is registered
+    error_code = dll.fn_runai_set_readiness(
+        streamer,
+        ctypes.cast(entries, ctypes.POINTER(ctypes.c_uint32)) if entries is not None else None,
+        len(entries) if entries is not None else 0,
+    )
+    if error_code != SUCCESS_ERROR_CODE:
+        raise ValueError(
+            f"Could not set readiness array in libstreamer due to: {runai_response_str(error_code)}"
+        )
+
+def runai_ready(entries: ctypes.Array, index: int) -> bool:
+    return (entries[index] & ~READINESS_WAITING_BIT) != 0
+
+def runai_wait_ready(entries: ctypes.Array, index: int) -> None:
+    # returns without calling the library if the sub request is already ready
+    value = entries[index] & ~READINESS_WAITING_BIT
+    error_code = value - 1 if value != 0 else dll.fn_runai_wait_ready(
+        ctypes.cast(ctypes.addressof(entries) + index * ctypes.sizeof(ctypes.c_uint32), ctypes.POINTER(ctypes.c_uint32))
+    )
+    if error_code != SUCCESS_ERROR_CODE:
+        raise ValueError(
+            f"Sub request {index} failed in libstreamer due to: {runai_response_str(error_code)}"
+        )
+
+def runai_prefetch(
+    streamer: t_streamer,
+    paths: List[str],
+    file_offsets: List[int],
+    bytesizes: List[int],
+    s3_credentials: Optional[S3Credentials] = None,
+) -> None:
+    # warms the ranges in the background, without destination buffers
+    c_paths = (ctypes.c_char_p * len(paths))(*[path.encode("utf-8") for path in paths])
+    c_file_offsets = (ctypes.c_uint64 * len(file_offsets))(*file_offsets)
+    c_bytesizes = (ctypes.c_uint64 * len(bytesizes))(*bytesizes)
+
+    error_code = dll.fn_runai_prefetch(
+        streamer,
+        len(paths),
+        c_paths,
+        c_file_offsets,
+        c_bytesizes,
+        ctypes.c_char_p(s3_credentials.access_key_id.encode("utf-8")) if s3_credentials is not None and s3_credentials.access_key_id is not None else None,
+        ctypes.c_char_p(s3_credentials.secret_access_key.encode("utf-8")) if s3_credentials is not None and s3_credentials.secret_access_key is not None else None,
+        ctypes.c_char_p(s3_credentials.session_token.encode("utf-8")) if s3_credentials is not None and s3_credentials.session_token is not None else None,
+        ctypes.c_char_p(s3_credentials.region_name.encode("utf-8")) if s3_credentials is not None and s3_credentials.region_name is not None else None,
+        ctypes.c_char_p(s3_credentials.endpoint.encode("utf-8")) if s3_credentials is not None and s3_credentials.endpoint is not None else None,
+    )
+    if error_code != SUCCESS_ERROR_CODE:
+        raise ValueError(
+            f"Could not send runai_prefetch to libstreamer due to: {runai_response_str(error_code)}"
+        )
+
+def runai_cancel_prefetch(streamer: t_streamer) -> None:
+    error_code = dll.fn_runai_cancel_prefetch(streamer)
+    if error_code != SUCCESS_ERROR_CODE:
+        raise ValueError(
+            f"Could not cancel prefetching in libstreamer due to: {runai_response_str(error_code)}"
+        )
+
+def runai_set_weight(streamer: t_streamer, weight: int) -> None:
+    # the share of this streamer in the workers shared by the streamers of the process
+    error_code = dll.fn_runai_set_weight(streamer, weight)
+    if error_code != SUCCESS_ERROR_CODE:
+        raise ValueError(
+            f"Could not set scheduling weight in libstreamer due to: {runai_response_str(error_code)}"
+        )
+
+def runai_get_stats() -> Dict[str, int]:
+    # statistics of the streamers of the process, which may be polled from another thread during a load
+    num_values = ctypes.c_uint32(0)
+    error_code = dll.fn_runai_get_stats(None, 0, ctypes.byref(num_values))
+    if error_code != SUCCESS_ERROR_CODE:
+        raise ValueError(
+            f"Could not get statistics from libstreamer due to: {runai_response_str(error_code)}"
+        )
+
+    values = (ctypes.c_size_t * num_values.value)()
+    error_code = dll.fn_runai_get_stats(values, len(values), ctypes.byref(num_values))
+    if error_code != SUCCESS_ERROR_CODE:
+        raise ValueError(
+            f"Could not get statistics from libstreamer due to: {runai_response_str(error_code)}"
+        )
+
+    return {
+        dll.fn_runai_stat_name(i).decode("utf-8"): values[i]
+        for i in range(min(len(values), num_values.value))
+    }
+
+def runai_write_trace(path: str) -> None:
+    # timeline of the streamer threads, recorded when RUNAI_STREAMER_TRACE is set
+    error_code = dll.fn_runai_write_trace(path.encode("utf-8"))
+    if error_code != SUCCESS_ERROR_CODE:
+        raise ValueError(
+            f"Could not write trace to {path} due to: {runai_response_str(error_code)}"
+        )
+
+def runai_cancel(streamer: t_streamer) -> None:
+    error_code = dll.fn_runai_cancel(streamer)
+    if error_code != SUCCESS_ERROR_CODE:
+        raise ValueError(
+            f"Could not cancel request in libstreamer due to: {runai_response_str(error_code)}"
+        )
+
 def runai_response_str(response_code: int) -> str:
     return dll.fn_runai_response_str(response_code)
\ No newline at end of file
@@ -3,10 +3,16 @@ import tempfile
 import shutil
 import os
 import mmap
+import json
 from runai_model_streamer.libstreamer.libstreamer import (
     runai_start,
     runai_request,
     runai_response,
+    runai_set_weight,
+    runai_prefetch,
+    runai_cancel_prefetch,
+    runai_get_stats,
+    runai_write_trace,
 )
 from runai_model_streamer.s3_utils.s3_utils import (
     S3Credentials,
@@ -73,6 +79,62 @@ class TestBindings(unittest.TestCase):
             # Assert buffer filled copyless
             self.assertEqual(id(buffer), buffer_ptr)
 
+    def test_runai_set_weight(self):
+        streamer = runai_start()
+        runai_set_weight(streamer, 3)
+
+        # a zero weight is rejected by the library
+        with self.assertRaises(ValueError):
+            runai_set_weight(streamer, 0)
+
+    def test_runai_prefetch(self):
+        file_path = os.path.join(self.temp_dir, "test_file.txt")
+        with open(file_path, "w") as file:
+            file.write("Test Text1")
+
+        streamer = runai_start()
+        runai_prefetch(streamer, [file_path], [0], [10])
+        runai_cancel_prefetch(streamer)
+
+        # object storage ranges are prefetched only into a local cache, which the mock does not have
+        with self.assertRaises(ValueError):
+            runai_prefetch(streamer, ["s3://bucket/model.safetensors"], [0], [10])
+
+    def test_runai_get_stats(self):
+        file_path = os.path.join(self.temp_dir, "test_file.txt")
+        with open(file_path, "w") as file:
+            file.write("Test Text1TestText2")
+
+        before = runai_get_stats()
+        self.assertIn("requests", before)
+        self.assertIn("file_bytes", before)
+        self.assertIn("file_ops", before)
+
+        buffer = mmap.mmap(-1, 19, mmap.MAP_ANONYMOUS | mmap.MAP_PRIVATE)
+        streamer = runai_start()
+        runai_request(streamer, [file_path], [0], [19], [buffer], [[10, 9]])
+        runai_response(streamer)
+        runai_response(streamer)
+
+        # statistics are cumulative values of the process
+        after = runai_get_stats()
+        self.assertEqual(after.keys(), before.keys())
+        self.assertEqual(after["requests"] - before["requests"], 1)
+        self.assertEqual(after["file_bytes"] - before["file_bytes"], 19)
+        self.assertEqual(after["file_ops"] - before["file_ops"], 2)
+
+    def test_runai_write_trace(self):
+        trace_path = os.path.join(self.temp_dir, "trace.json")
+        runai_write_trace(trace_path)
+
+        with open(trace_path) as file:
+            trace = json.load(file)
+        self.assertEqual(trace["displayTimeUnit"], "ms")
+        self.assertIsInstance(trace["traceEvents"], list)
+
+        with self.assertRaises(ValueError):
+            runai_write_trace(os.path.join(self.temp_dir, "missing", "trace.json"))
+
     def tearDown(self):
         shutil.rmtree(self.temp_dir)
 